@@ -76,12 +76,41 @@ constexpr int    IMU_PORT         = 9;    // Brain 上标的端口 10
 // IMU 融合系数 α（alpha）：决定多大程度信任 IMU 的角度
 //   α = 1.0 → 100% 信任 IMU（忽略轮子算出来的角度）
 //   α = 0.0 → 100% 信任轮子编码器（忽略 IMU）
-//   α = 0.98 → 98% 信任 IMU + 2% 信任编码器（推荐值）
+//   α = 0.98 → 每 10 ms 98% 信任 IMU + 2% 信任编码器（推荐值）
 // 为什么不 100% 信任 IMU？因为 IMU 长时间会有一点点漂移
+// 短时间的转动听 IMU，长时间的趋势听轮子（见 localization/heading_fusion.h）；
+// 时间常数 ≈ 10 ms × α / (1 − α) ≈ 0.5 秒
 constexpr double IMU_FUSION_ALPHA = 0.98;
 
-// 注意：垂直双轮方案中，旋转角度 100% 来自 IMU（没有第二个平行轮来计算旋转）。
-// IMU_FUSION_ALPHA 在此方案中仅作为预留参数。
+// 轮子算出来的角度从哪来：
+//   配了平行追踪轮（PARALLEL_TRACKING_PORT >= 0，见第 4 节）→ 纵向轮和平行轮的差
+//   没配 → 左右驱动电机编码器的差（会打滑，只在基本直行时才用）
+// 驱动轮转得比这个快（弧度/秒）就不用它的角度：原地转时轮子横着蹭地，角度不准
+constexpr double HEADING_WHEEL_MAX_RATE_RADPS = 0.5;
+
+// 轮子和 IMU 这一拍的转角差超过这个速度（弧度/秒）= 打滑，这一拍不用轮子
+constexpr double HEADING_SLIP_RATE_RADPS      = 0.3;
+
+// IMU 掉线判断：读数一拍里变化超过这个速度（弧度/秒）、又落回 0 附近，不可能是真的转动
+// （V5 IMU 最多测 1000°/s ≈ 17 rad/s；重新插上时读数会从 0 开始，是个大跳变）
+constexpr double IMU_MAX_RATE_RADPS           = 20.0;
+
+// ── 静止时估计陀螺仪零漂（见 localization/gyro_bias.h）──
+// 下面几条同时满足、并且持续 STATIONARY_SETTLE_MS，才算"真的停住了"：
+//   追踪轮速度、驱动电机速度都几乎为 0，电机没有在给电压，IMU 也几乎没在转
+constexpr double STATIONARY_MAX_WHEEL_MPS   = 0.005;  // 追踪轮（米/秒）
+constexpr double STATIONARY_MAX_MOTOR_MPS   = 0.05;   // 驱动电机（编码器一格 / 10 ms ≈ 8.6 cm/s）
+constexpr double STATIONARY_MAX_VOLTS       = 0.5;    // 电压命令（伏）
+constexpr double STATIONARY_MAX_GYRO_RADPS  = 0.02;   // 比零漂大得多、比真的转动小得多
+constexpr double STATIONARY_GYRO_TAU_S      = 0.1;    // IMU 单拍噪声就有 ~0.02 rad/s，先平滑再比
+constexpr int    STATIONARY_SETTLE_MS       = 250;    // 刹车后车身还会晃一下，等它停稳
+
+// 零漂估计的平均窗口（秒）：静止累计不到这么久时取所有静止读数的平均，
+// 之后按这个时间常数滑动平均（零漂会随温度慢慢变）。单拍噪声大，窗口要够长
+constexpr double GYRO_BIAS_TAU_S            = 10.0;
+
+// 零漂估计的上限（弧度/秒）：V5 IMU 的零漂一般远小于这个，超过说明估错了
+constexpr double GYRO_BIAS_MAX_RADPS        = 0.01;
 
 // ############################################################################
 //  4. 追踪轮 (Dead Wheels) — 机器人的"测量尺"（垂直双轮方案）
@@ -102,7 +131,7 @@ constexpr double IMU_FUSION_ALPHA = 0.98;
 //    两个追踪轮呈十字形安装：
 //    • 纵向轮（Forward）：朝前，测量前后位移
 //    • 横向轮（Lateral）：朝右，测量左右侧滑
-//    旋转角度完全由 IMU 提供。
+//    旋转角度主要由 IMU 提供，轮子算出来的角度用来慢慢修正 IMU 的漂移。
 //
 //    俯视图：
 //                ↑ 前进方向
@@ -128,6 +157,11 @@ constexpr int  LATERAL_TRACKING_PORT  = 8;     // 横向轮端口（Brain 上标
 constexpr bool FORWARD_TRACKING_REVERSED = false;
 constexpr bool LATERAL_TRACKING_REVERSED = false;
 
+// 可选的第二个纵向轮（和纵向轮平行，装在另一侧）：两个轮子的差就是转角，不打滑
+// 没装就写 -1（这时用驱动电机编码器算轮子的角度）
+constexpr int  PARALLEL_TRACKING_PORT     = -1;
+constexpr bool PARALLEL_TRACKING_REVERSED = false;
+
 // 追踪轮轮子直径（2.75 英寸 = 0.06985 米）
 constexpr double TRACKING_WHEEL_DIAMETER      = 0.06985;
 
@@ -152,6 +186,37 @@ constexpr double FORWARD_WHEEL_OFFSET = 0.0;   // 纵向轮的侧向偏移（米
 //    例如：横向轮装在机器人中心后方 5cm → -0.05
 constexpr double LATERAL_WHEEL_OFFSET = -0.05; // 横向轮的纵向偏移（米）
 
+//  【平行轮侧向偏移】（只有 PARALLEL_TRACKING_PORT >= 0 才用）
+//    和纵向轮一样：在中心线右边 → 正数，左边 → 负数
+//    两个轮子离得越远，算出来的角度越准
+constexpr double PARALLEL_WHEEL_OFFSET = -0.12; // 平行轮的侧向偏移（米）
+
+//  【位姿历史】
+//    里程计把最近 N 次更新的（时间, 位姿, 增量）存在一个环形缓冲区里，
+//    用来回答"0.05 秒前我在哪"，并在过去的时刻施加修正（见 localization/pose_history.h）
+//    128 条 × 10 ms ≈ 最近 1.3 秒（比摄像头延迟长得多）
+constexpr int POSE_HISTORY_CAPACITY = 128;
+
+//  【速度估计】
+//    每次更新的增量 ÷ 真实 dt 就是速度，但编码器一格在 10 ms 里就是好几 cm/s 的跳动，
+//    所以再过一个一阶低通（见 localization/twist_estimator.h）。
+//    时间常数越大越平滑，但也越"慢半拍"：0.03 秒 ≈ 3 个周期
+constexpr double ODOM_VELOCITY_FILTER_TAU_S = 0.03;
+
+//    加速度是速度的差分，噪声更大，滤得更狠；用不上可以关掉（快照里加速度恒为 0）
+constexpr bool   ODOM_ESTIMATE_ACCEL        = true;
+constexpr double ODOM_ACCEL_FILTER_TAU_S    = 0.08;
+
+//  【积分方法】每一步的增量（机器人坐标系）怎么加到场地坐标上
+//    中点法：按这一步中间时刻的朝向走直线        （1 次 sin/cos）
+//    圆弧法：假设这一步走的是一段圆弧，弦长精确  （多 1 次 sin，转弯时也没有近似误差）
+//    RK2   ：起点朝向和终点朝向各走一半再平均    （2 次 sin/cos）
+//  make bench 会列出 5/10/20/50 ms 周期下三种方法的误差和耗时
+constexpr int ODOM_INTEGRATOR_MIDPOINT = 0;
+constexpr int ODOM_INTEGRATOR_ARC      = 1;
+constexpr int ODOM_INTEGRATOR_RK2      = 2;
+constexpr int ODOM_INTEGRATOR          = ODOM_INTEGRATOR_ARC;
+
 // ############################################################################
 //  5. 转弯 PID — 控制机器人精确转到指定角度
 // ############################################################################
@@ -178,6 +243,9 @@ constexpr double TURN_SETTLE_RAD     = 0.025;
 // 防止机器人刚好经过目标角度就停下来（像"路过"不算"到达"）
 constexpr double TURN_SETTLE_TIME_MS = 150;
 
+// 到位时角速度也必须低于这个值（弧度/秒）：还在转着"路过"目标的不算
+constexpr double TURN_SETTLE_OMEGA_RADPS = 0.15;
+
 // 超时时间：超过这么久还没到位就强制停止（防止卡死）
 constexpr double TURN_TIMEOUT_MS     = 1500;
 
@@ -204,6 +272,9 @@ constexpr double DRIVE_SETTLE_M       = 0.015;
 // 必须在容差内持续待够 150 毫秒才算稳定
 constexpr double DRIVE_SETTLE_TIME_MS = 150;
 
+// 到位时速度也必须低于 5 cm/s：还在往前滑的不算停稳
+constexpr double DRIVE_SETTLE_SPEED_MPS = 0.05;
+
 // 超时 4 秒：如果 4 秒还没到就放弃（防止卡死）
 constexpr double DRIVE_TIMEOUT_MS     = 4000;
 
@@ -249,6 +320,11 @@ constexpr double BOOMERANG_LEAD   = 0.6;
 //  就像玩游戏的帧率：100 帧比 10 帧更流畅
 constexpr int LOOP_INTERVAL_MS = 10;
 
+// 传感器连不连着（installed()、IMU 在不在校准）每次问都是额外的设备调用，
+// 不用每拍都问：每 SENSOR_STATUS_POLL_TICKS 拍查一次，中间的帧沿用上次的结果
+// （5 拍 = 50 ms，和以前屏幕任务查的频率一样；代价是拔线后最多晚 50 ms 才发现）
+constexpr int SENSOR_STATUS_POLL_TICKS = 5;
+
 // ############################################################################
 //  9. 日志与调试 — 让你能看到机器人"脑子里在想什么"
 // ############################################################################
@@ -262,6 +338,80 @@ constexpr int LOG_VERBOSITY           = 2;
 // Brain 屏幕刷新间隔：50 毫秒 = 每秒 20 次
 constexpr int SCREEN_UPDATE_INTERVAL_MS = 50;
 
+// ── 异步日志 ──
+// 写日志的任务只把消息放进内存里的环形缓冲区（几微秒），
+// 再由一个低优先级的后台任务统一写进 SD 卡（SD 卡写一次要好几毫秒）。
+// 缓冲区最多暂存多少条日志（必须是 2 的幂）；满了新消息会被丢弃并计数
+constexpr int LOG_RING_CAPACITY      = 64;
+
+// 单条日志最多多少个字符（超出部分截断）
+constexpr int LOG_LINE_MAX           = 96;
+
+// 后台写日志任务多久清空一次缓冲区：20 毫秒
+constexpr int LOG_WRITER_INTERVAL_MS = 20;
+
+// ── 二进制里程计日志（/usd/odom_NNN.bin）──
+// 每个控制周期记一帧差分编码的数据（只写"变了多少"，机器人不动时一帧只有 2 字节），
+// 攒满一块再写 SD 卡。块大小 4096 字节 = 8 个 SD 卡扇区
+constexpr int ODOM_LOG_BLOCK_BYTES        = 4096;
+
+// 内存里最多攒几块（4 块 = 16 KB ≈ 4 秒数据），SD 卡偶尔卡顿也不会丢数据
+constexpr int ODOM_LOG_NUM_BLOCKS         = 4;
+
+// 写卡任务多久检查一次有没有攒满的块
+constexpr int ODOM_LOG_WRITER_INTERVAL_MS = 100;
+
+// 每隔多少帧写一个"关键帧"（完整数值，不依赖前面的帧）：100 帧 = 1 秒。
+// 中间有帧被丢弃时，解码从下一个关键帧恢复
+constexpr int ODOM_LOG_KEYFRAME_INTERVAL  = 100;
+
+// ── 飞行记录仪 / 黑匣子（/usd/flight_NNN.bin）──
+// 内存里一直保留最近 N 条记录，出问题时才写 SD 卡。
+// 500 条 × 10 ms = 最近 5 秒（500 × 40 字节 = 20 KB 内存，快照再占 20 KB）
+constexpr int FLIGHT_RECORDER_SAMPLES         = 500;
+
+// 触发后再多录多少毫秒，把"出事之后"的一小段也记下来
+constexpr int FLIGHT_RECORDER_POST_TRIGGER_MS = 500;
+
+// 两次写出之间至少间隔多久（防止连续超时把 SD 卡写爆）
+constexpr int FLIGHT_RECORDER_COOLDOWN_MS     = 3000;
+
+// 每次开机最多写出几个黑匣子文件
+constexpr int FLIGHT_RECORDER_MAX_DUMPS       = 20;
+
+// 后台任务多久检查一次有没有触发
+constexpr int FLIGHT_RECORDER_POLL_MS         = 50;
+
+// ── 循环计时统计（telemetry/loop_stats.h）──
+// 最多统计几个循环（里程计、视觉、屏幕、日志、直线、转向……）
+constexpr int LOOP_STATS_MAX_LOOPS          = 8;
+
+// 每隔多久把所有循环的耗时 / 唤醒延迟写进日志：5 秒
+constexpr int LOOP_STATS_REPORT_INTERVAL_MS = 5000;
+
+// ── 时间线采集（telemetry/trace.h，/usd/trace_NNN.bin）──
+// 总开关：false = 所有 TraceScope 在编译时被删掉，零开销
+constexpr bool TRACE_ENABLED  = true;
+
+// 一次采集最多记多少个事件（每个 12 字节，4096 个 ≈ 48 KB）
+// 100 Hz 里程计 + 100 Hz PID + 20 Hz 视觉 + 写卡，大约够 15 秒自治
+constexpr int  TRACE_CAPACITY = 4096;
+
+// ── USB 串口实时遥测（telemetry/serial_telemetry.h）──
+// 总开关：false = 不启动串口发送任务（stdout 留给 printf 调试用）
+constexpr bool SERIAL_TELEM_ENABLED            = true;
+
+// 每个通道的最短发送间隔：里程计记录 20 ms = 50 Hz，循环计时 1 秒一次
+// 50 Hz × 47 字节 ≈ 2.4 KB/s，USB 串口毫无压力
+constexpr int  SERIAL_TELEM_ODOM_INTERVAL_MS   = 20;
+constexpr int  SERIAL_TELEM_LOOP_INTERVAL_MS   = 1000;
+
+// 发送队列最多暂存几帧（必须是 2 的幂）；满了新帧被丢弃
+constexpr int  SERIAL_TELEM_QUEUE_FRAMES       = 16;
+
+// 串口任务多久清空一次队列
+constexpr int  SERIAL_TELEM_WRITER_INTERVAL_MS = 10;
+
 // ############################################################################
 //  10. AI 视觉传感器 — 用摄像头看 AprilTag 标签来确定位置
 // ############################################################################
@@ -318,6 +468,133 @@ constexpr double VISION_MIN_CONFIDENCE       = 0.15;
 // 单次最大修正距离（米）：如果视觉说你偏了 30cm 以上，不信（可能是误检测）
 constexpr double VISION_MAX_CORRECTION_M     = 0.30;
 
-// 视觉更新间隔：50 毫秒 = 每秒 20 次
-constexpr int    VISION_UPDATE_INTERVAL_MS   = 50;
+// 视觉分两个任务流水线跑（见 main.cpp）：
+//   拍照任务：按传感器的帧率拍，每拍一次发布一帧（hal/vision.h）
+//   估算任务：每 VISION_ESTIMATE_POLL_MS 看一眼有没有新帧，有就只处理最新的那一帧
+// 拍照间隔：AI 视觉传感器大约 30 帧/秒，拍得再快也只是把同一帧再取一遍
+constexpr int    VISION_CAPTURE_INTERVAL_MS  = 33;
+
+// 估算任务查新帧的间隔：新帧最多在这里多等 5 ms，查一次只是看个帧号，几乎不花时间
+constexpr int    VISION_ESTIMATE_POLL_MS     = 5;
+
+// 帧太老就不处理了（估算任务被别的任务挤住的时候）：
+// 结果出来得越晚，延迟补偿要重放的路越长，超过这个就直接丢掉、等下一帧
+constexpr int    VISION_MAX_FRAME_AGE_MS     = 150;
+
+// 拍照延迟（毫秒）：画面曝光的时刻比 vision_snapshot() 被调用早多少
+// 传感器自己 30 帧/秒地拍、识别，takeSnapshot 拿到的是上一帧的结果，平均老 1 帧左右。
+// 视觉结果按"拍照时刻"的位姿计算和修正（见 vision_localizer.cpp），这个值越准，
+// 开得越快也不会把车往回拽。用手机慢动作拍屏幕 + 车轮起步对一下就能量出来
+constexpr int    VISION_CAPTURE_LATENCY_MS   = 33;
+
+// ── 多标签联合求解（localization/multi_tag.h）──
+// 同一帧看到至少这么多个标签时，用所有标签一起解 x、y、θ（按置信度加权），
+// 而不是只挑置信度最高的一个
+constexpr int    VISION_MULTI_TAG_MIN_TAGS   = 2;
+
+// 高斯-牛顿迭代次数（固定，每帧耗时可预估；从里程计位姿出发 2 次就收敛了，多留 1 次余量）
+constexpr int    VISION_MULTI_TAG_ITERATIONS = 3;
+
+// 里程计位姿当作一个很弱的"先验"：只在标签几乎共线、解不出某个方向时起作用
+constexpr double VISION_MULTI_TAG_PRIOR_SIGMA_XY    = 0.5;   // 米
+constexpr double VISION_MULTI_TAG_PRIOR_SIGMA_THETA = 0.2;   // 弧度
+
+// 解完以后每个测量的残差（以标准差为单位）的均方根超过它 → 标签之间互相矛盾
+// （误检、标签地图写错），不用联合解，退回单标签。正常噪声下在 1 以下
+constexpr double VISION_MULTI_TAG_MAX_RMS    = 2.0;
+
+// ── 视觉航向修正（localization/vision_geometry.h 的 vision_heading_from_tag）──
+// 一个标签也能估航向：斜着看标签，它在图片里会变"瘦"（宽 = 高 × cos 斜看的角度），
+// 再加上标签的朝向（FieldTag::facing）和方位角，就能算出车头朝哪
+// 标签宽、高的像素误差（1 像素左右）
+constexpr double VISION_TAG_PIXEL_SIGMA       = 1.0;
+
+// 标签在图片里歪了超过这个角度（TagDetection::angle，度）→ 摄像头没放平或者误检，
+// 宽高比不可信，不用它估航向
+constexpr double VISION_TAG_MAX_ROLL_DEG      = 10.0;
+
+// 航向置信度 = 1 / (1 + (σ / 这个值)²)：估计的误差 σ 等于它时置信度 0.5
+constexpr double VISION_HEADING_SIGMA_REF     = 0.03;   // 约 1.7°
+
+// 航向修正强度：每一帧往视觉航向拉 α × 置信度
+constexpr double VISION_HEADING_CORRECTION_ALPHA = 0.3;
+
+// 每一帧航向最多改这么多（每秒 20 帧 → 最多 0.1 rad/s），车头不会突然一甩
+constexpr double VISION_HEADING_MAX_STEP_RAD  = 0.005;
+
+// 视觉航向和里程计差超过这么多 → 不信（误检、或者宽高比选错了正负号）
+constexpr double VISION_HEADING_MAX_ERROR_RAD = 0.2;
+
+// ── 融合方式 ──
+// VISION_FUSION_BLEND    = 原来的互补滤波：只用置信度最高的一个标签，固定比例 α 拉 x/y
+// VISION_FUSION_EKF      = 扩展卡尔曼滤波（localization/pose_ekf.h）：每个标签的
+//                          距离 + 方位都融合，按不确定度加权，也修正航向
+// VISION_FUSION_PARTICLE = 粒子滤波（localization/particle_filter.h）：
+//                          碰撞多的比赛用，被撞偏以后能自己找回来，但更费 CPU
+// 默认用互补滤波：卡尔曼滤波被撞偏以后能找回来（连续被拒绝会放大协方差），
+// 但航向常常要好几秒才拉得回来。make bench 的 "after shove <10cm" 一栏
+// 和随机噪声关系很大：固定种子下卡尔曼滤波更好，换 8 个种子平均下来
+// 卡尔曼滤波只有 64% 的时间在 10 cm 以内，互补滤波有 89%
+constexpr int    VISION_FUSION_BLEND         = 0;
+constexpr int    VISION_FUSION_EKF           = 1;
+constexpr int    VISION_FUSION_PARTICLE      = 2;
+constexpr int    VISION_FUSION_MODE          = VISION_FUSION_BLEND;
+
+// 初始不确定度（set_pose 之后）：位置 5 cm，航向约 3°
+constexpr double EKF_INIT_SIGMA_XY           = 0.05;
+constexpr double EKF_INIT_SIGMA_THETA        = 0.05;
+
+// 里程计噪声：每走 1 米误差约 5 cm（打滑），另加每次更新 0.2 mm 的底噪
+constexpr double EKF_ODOM_NOISE_PER_M        = 0.05;
+constexpr double EKF_ODOM_NOISE_BASE_M       = 0.0002;
+
+// IMU 噪声：每转 1 弧度误差约 1%，另加每次更新 0.0002 弧度的底噪（漂移）
+constexpr double EKF_IMU_NOISE_PER_RAD       = 0.01;
+constexpr double EKF_IMU_NOISE_BASE_RAD      = 0.0002;
+
+// 标签测量噪声：距离 = 2 cm + 距离的 5%；方位约 1.7°
+constexpr double EKF_RANGE_SIGMA_MIN_M       = 0.02;
+constexpr double EKF_RANGE_SIGMA_PER_M       = 0.05;
+constexpr double EKF_BEARING_SIGMA_RAD       = 0.03;
+
+// 门限：马氏距离² 超过它就拒绝（2 自由度卡方分布的 99% 分位数）
+constexpr double EKF_GATE_CHI2               = 9.21;
+
+// 连续这么多个标签都被门限拒绝 → 不是误检，是自己错了（被撞了、打滑了）：
+// 把协方差放大这么多，后面的标签就能重新把位姿拉回来。
+// 位置放得和粒子滤波的恢复范围一样大；航向只放一点——一个标签的距离 + 方位
+// 分不清"转了"还是"横移了"，航向放太开会收敛到一个错的航向上
+constexpr int    EKF_RECOVERY_GATED_TAGS     = 6;
+constexpr double EKF_RECOVERY_SIGMA_XY       = 0.4;
+constexpr double EKF_RECOVERY_SIGMA_THETA    = 0.05;
+
+// ── 粒子滤波（VISION_FUSION_MODE = VISION_FUSION_PARTICLE 时使用）──
+// 粒子数：越多越稳，但每个 10 ms 周期的计算量和它成正比（make bench 看预算）
+constexpr int    PF_PARTICLE_COUNT           = 500;
+
+// 初始撒点范围（set_pose 之后）
+constexpr double PF_INIT_SIGMA_XY            = 0.05;
+constexpr double PF_INIT_SIGMA_THETA         = 0.05;
+
+// 每个粒子每一步加的随机误差（比 EKF 的大一点，粒子云才不会缩成一个点）
+constexpr double PF_ODOM_NOISE_PER_M         = 0.08;
+constexpr double PF_ODOM_NOISE_BASE_M        = 0.001;
+constexpr double PF_IMU_NOISE_PER_RAD        = 0.02;
+constexpr double PF_IMU_NOISE_BASE_RAD       = 0.001;
+
+// 单个标签最多扣这么多对数似然（一次误检不会把所有粒子杀光）
+constexpr double PF_LOGLIK_FLOOR             = -8.0;
+
+// 有效粒子数低于 n × 这个比例就重采样
+constexpr double PF_RESAMPLE_ESS_RATIO       = 0.5;
+
+// 似然的长期 / 短期平均的更新速度；短期明显变差就撒恢复粒子
+constexpr double PF_ALPHA_SLOW               = 0.05;
+constexpr double PF_ALPHA_FAST               = 0.5;
+
+// 短期似然低于长期的这个比例才撒恢复粒子；一次最多换掉多少比例，撒在估计位置周围多大范围
+constexpr double PF_INJECT_BELOW             = 0.3;
+constexpr double PF_MAX_INJECT_FRACTION      = 0.3;
+constexpr double PF_RECOVERY_SIGMA_XY        = 0.4;
+constexpr double PF_RECOVERY_SIGMA_THETA     = 0.3;
 
@@ -0,0 +1,122 @@
+#pragma once
+// ============================================================================
+//  hal/frame_buffer.h — 一个写者、多个读者，"借看"而不拷贝的帧发布（多缓冲 + 原子切换）
+// ============================================================================
+//
+//  【和 hal/seqlock.h 有什么不一样？】
+//    SeqLock 适合小数据（位姿几十字节）：读者每次拷一份走。
+//    一帧视觉结果有 8 个标签、好几百字节，而且几个任务都要看——
+//    每人每次拷一遍不划算。这里让读者直接"借看"写好的那一帧（const 引用），
+//    看完还回来，全程不加锁、不拷贝。
+//
+//  【算法：几块缓冲 + 借阅计数 + 原子地换"当前帧"】
+//    • _published：当前贴出来的是第几块缓冲（一个原子整数）
+//    • _readers[i]：第 i 块现在有几个读者在看
+//    写者：找一块"没贴出来、也没人在看"的缓冲，写满一整帧，
+//          然后把 _published 原子地改成它——读者要么看到旧帧、要么看到新帧，
+//          不会看到写了一半的。
+//    读者：读 _published → 给那块的借阅计数 +1 → 再确认它还是贴出来的那块
+//          （不是的话说明刚好被换掉了，计数 −1 重来）。
+//          借到以后，写者看到计数不为 0 就不会碰它，读者看多久都行。
+//
+//  【为什么默认 3 块，而不是 2 块？】
+//    2 块时：一块贴着，另一块可能还有读者在看上一帧——写者就没地方写了。
+//    3 块时：贴着的一块 + 慢读者拿着的一块 + 写者用的一块，互不打扰。
+//    真的没有空闲缓冲（好几个读者各拿着一块老帧不还）时，写者不等，
+//    直接丢掉这一帧（dropped() 计数），和 hal/ring_buffer.h 满了丢弃是一个思路。
+//
+//  【用法】
+//    写者：T* f = buf.begin_write();  if (f) { 填 *f;  buf.publish(); }
+//    读者：FrameBuffer<T>::View v = buf.latest();  v->...   // v 离开作用域自动归还
+//
+//  【限制】
+//    • 只能有一个写者
+//    • View 别拿太久（跨好几帧），否则写者可能没缓冲可用而丢帧
+//    • 还没发布过时，latest() 看到的是值初始化的 T（全 0）
+//
+// ============================================================================
+#include <atomic>
+#include <stdint.h>
+
+template <typename T, int BUFFERS = 3>
+class FrameBuffer {
+    static_assert(BUFFERS >= 2, "FrameBuffer needs at least two buffers");
+
+public:
+    /// 借看一帧：只读，离开作用域时自动归还（只能移动，不能复制）
+    class View {
+    public:
+        View(View&& other) : _owner(other._owner), _index(other._index) { other._owner = nullptr; }
+        ~View() { release(); }
+
+        const T& operator*() const { return _owner->_frames[_index]; }
+        const T* operator->() const { return &_owner->_frames[_index]; }
+
+        /// 提前归还（之后不能再用这个 View）
+        void release() {
+            if (_owner != nullptr) {
+                _owner->_readers[_index].fetch_sub(1);
+                _owner = nullptr;
+            }
+        }
+
+    private:
+        friend class FrameBuffer;
+        View(const FrameBuffer* owner, int index) : _owner(owner), _index(index) {}
+        View(const View&);
+        View& operator=(const View&);
+
+        const FrameBuffer* _owner;
+        int                _index;
+    };
+
+    FrameBuffer() : _published(0), _writing(-1), _dropped(0) {
+        for (int i = 0; i < BUFFERS; ++i) {
+            _frames[i] = T();
+            _readers[i].store(0);
+        }
+    }
+
+    /// 拿一块空闲缓冲来写下一帧（只能由唯一的写者调用，永不阻塞）
+    /// @return 要填的帧；没有空闲缓冲（都有人在看）时返回 nullptr，这一帧算丢弃
+    T* begin_write() {
+        int published = _published.load();
+        for (int k = 1; k <= BUFFERS; ++k) {
+            int i = (published + k) % BUFFERS;   // 从贴出来那块的下一块开始找，轮流用
+            if (i == published || _readers[i].load() != 0) continue;
+            _writing = i;
+            return &_frames[i];
+        }
+        _dropped++;
+        return nullptr;
+    }
+
+    /// 把 begin_write() 拿到的那一帧贴出来（之后写者不能再改它）
+    void publish() {
+        if (_writing < 0) return;
+        _published.store(_writing);
+        _writing = -1;
+    }
+
+    /// 借看最新贴出来的一帧（任何任务都能调用，不会等写者，不拷贝）
+    View latest() const {
+        while (true) {
+            int i = _published.load();
+            _readers[i].fetch_add(1);
+            if (_published.load() == i) return View(this, i);
+            _readers[i].fetch_sub(1);   // 刚好被换掉了：还回去，重来
+        }
+    }
+
+    /// 因为没有空闲缓冲而丢掉的帧数
+    uint32_t dropped() const { return _dropped; }
+
+private:
+    // 原子操作都用默认的顺序一致（seq_cst）：读者"计数 +1 再确认"和
+    // 写者"换帧后再查计数"之间要有全局一致的先后，宽松的顺序保证不了
+    T                        _frames[BUFFERS];
+    mutable std::atomic<int> _readers[BUFFERS];
+    std::atomic<int>         _published;
+    int                      _writing;   // 只有写者用
+    uint32_t                 _dropped;   // 只有写者改
+};
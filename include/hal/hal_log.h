@@ -15,9 +15,32 @@
 //    DEBUG = 3 : 超详细数据（每次循环的数值）—— 平时关着，需要调试时再开
 //    只有级别 <= config.h 里的 LOG_VERBOSITY 的日志才会被记录
 //
+//  【异步写入——为什么写日志不会卡住机器人？】
+//    hal_log() 只是把消息复制进内存里的环形缓冲区（几微秒就完事），
+//    真正写 SD 卡的是一个低优先级的后台任务（hal_log_start_writer() 启动），
+//    它把文件一直开着，攒一批再写。缓冲区满了就丢弃新消息并计数，
+//    绝不让里程计、视觉这些重要任务等 SD 卡。
+//
+//  【推荐写法：printf 风格的日志宏（不分配堆内存）】
+//    LOG_INFOF("Vision est: (%.3f, %.3f) conf=%.2f", x, y, conf);
+//
+//    以前的写法 hal_log("x=" + to_str(x)) 每次都要拼接 std::string，
+//    就算这条日志最后被级别过滤掉了，new/delete 也已经做完了。
+//    日志宏在编译时就知道 LOG_VERBOSITY：级别不够的调用整段被编译器删掉，
+//    连参数都不会计算；够级别的直接用 vsnprintf 格式化进栈上的固定缓冲区。
+//    所以在 100 Hz 的循环里写日志，一次 new 都没有。
+//
+//      LOG_ERRORF(...)   严重错误（一定上屏）
+//      LOG_WARNF(...)    警告（一定上屏）
+//      LOG_INFOF(...)    一般信息（只写 SD 卡）
+//      LOG_SCREENF(...)  一般信息，同时显示在 Brain 屏幕上
+//      LOG_DEBUGF(...)   调试细节（LOG_VERBOSITY < 3 时整条被删掉）
+//
 // ============================================================================
 #include <string>
+#include <stdarg.h>
 #include <stdio.h>
+#include "config.h"
 
 // ---- 数字转字符串的辅助函数 ----
 // VEX V5 用的编译器比较旧（GCC 4.9.3），不支持标准库的 std::to_string()，
@@ -38,14 +61,64 @@ constexpr int LOG_WARN  = 1;  // 警告
 constexpr int LOG_INFO  = 2;  // 一般信息
 constexpr int LOG_DEBUG = 3;  // 详细调试（最低优先级，通常关闭）
 
+// ---- printf 风格日志宏（推荐）----
+// if 的条件是编译期常量，级别不够时编译器直接删掉整个调用（参数也不会被计算）
+#define HAL_LOGF(level, to_screen, ...)                                        \
+    do {                                                                       \
+        if ((level) <= LOG_VERBOSITY) hal_log_printf((level), (to_screen), __VA_ARGS__); \
+    } while (0)
+
+#define LOG_ERRORF(...)  HAL_LOGF(LOG_ERROR, true,  __VA_ARGS__)
+#define LOG_WARNF(...)   HAL_LOGF(LOG_WARN,  true,  __VA_ARGS__)
+#define LOG_INFOF(...)   HAL_LOGF(LOG_INFO,  false, __VA_ARGS__)
+#define LOG_SCREENF(...) HAL_LOGF(LOG_INFO,  true,  __VA_ARGS__)
+#define LOG_DEBUGF(...)  HAL_LOGF(LOG_DEBUG, false, __VA_ARGS__)
+
+/// printf 风格记录一条日志：直接格式化进固定缓冲区，不分配堆内存
+/// 一般不直接调用，用上面的 LOG_xxxF 宏（它们会在编译期做级别过滤）
+/// 格式化后超过 LOG_LINE_MAX-1 个字符的部分会被截断
+void hal_log_printf(int level, bool to_screen, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/// 同上，参数用 va_list 传入
+void hal_log_vprintf(int level, bool to_screen, const char* fmt, va_list args);
+
+// ---- 旧接口（std::string 版本）----
+// 每次调用都要构造 std::string，会分配堆内存——只适合开机初始化这种
+// 不在循环里的地方。新代码请用上面的 LOG_xxxF 宏。
+
 /// 记录一条日志（默认会显示在 Brain 屏幕上）
 void hal_log(const std::string& message, bool printToScreen = true);
 
 /// 记录一条指定级别的日志
 /// 只有 level <= config.h 里的 LOG_VERBOSITY 时才会被记录
+/// 不会阻塞：消息进入环形缓冲区，由后台任务写入 SD 卡
 void hal_log_level(int level, const std::string& message, bool printToScreen = false);
 
-/// 往 SD 卡上的 CSV 文件 (/usd/odom_log.csv) 追加一行位姿数据
-/// CSV 格式：时间戳, X坐标, Y坐标, 航向角, 距离误差
-/// 比赛后可以用 Excel 或 Python 打开这个文件，画出机器人的行驶轨迹！
-void hal_log_odom_csv(unsigned long time_ms, double x, double y, double theta, double error);
+// ---- 异步日志的内部接口 ----
+
+/// 环形缓冲区里的一条日志
+struct LogEntry {
+    unsigned long time_ms;            ///< 记录时的系统时间（毫秒）
+    int           level;              ///< 日志级别 LOG_ERROR ~ LOG_DEBUG
+    bool          to_screen;          ///< 是否还要显示在 Brain 屏幕上
+    char          text[LOG_LINE_MAX]; ///< 消息内容（超长会被截断）
+};
+
+/// 日志统计（用于检查缓冲区是否够大）
+struct LogStats {
+    unsigned long enqueued;  ///< 成功放进缓冲区的条数
+    unsigned long dropped;   ///< 缓冲区满了被丢弃的条数
+    unsigned long drained;   ///< 后台任务已经取走的条数
+};
+
+/// 启动后台写日志任务（低优先级），打开 SD 卡日志文件并保持打开
+/// 在 pre_auton() 最开始调用一次；重复调用无副作用
+void hal_log_start_writer();
+
+/// 从缓冲区取出最早的一条日志（只给后台写日志任务用）
+/// @return false = 缓冲区已空
+bool hal_log_pop(LogEntry& out);
+
+/// 读取日志统计
+LogStats hal_log_get_stats();
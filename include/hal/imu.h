@@ -31,6 +31,10 @@ double get_imu_heading_rad();
 /// 比如转了两整圈就返回约 4π ≈ 12.57
 double get_imu_rotation_rad();
 
+/// IMU 能不能用（线松了、或者重新插上后正在自动校准时为 false）
+/// 只是查一下设备状态，不会多读一次传感器
+bool imu_connected();
+
 /// 把 IMU 的角度归零
 void reset_imu();
 
@@ -32,12 +32,18 @@ void set_drive_motors(double left_voltage, double right_voltage);
 /// 立即刹停所有电机
 void stop_drive_motors();
 
+/// 最近一次发给左侧电机的电压命令（伏，限幅后的值；刹停后为 0）
+/// 给日志记录用，不会读取电机硬件
+double get_left_drive_command();
+
+/// 最近一次发给右侧电机的电压命令（伏）
+double get_right_drive_command();
+
 /// 读取左侧电机编码器的累计脉冲数
-/// ⚠ 目前里程计用的是追踪轮，这个函数预留给将来使用
+/// 里程计的位置用追踪轮；没装平行轮时，左右编码器的差用来修正 IMU 航向的漂移
 double get_left_encoder_ticks();
 
 /// 读取右侧电机编码器的累计脉冲数
-/// ⚠ 目前里程计用的是追踪轮，这个函数预留给将来使用
 double get_right_encoder_ticks();
 
 /// 把两侧电机的编码器计数归零
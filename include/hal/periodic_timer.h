@@ -0,0 +1,74 @@
+#pragma once
+// ============================================================================
+//  hal/periodic_timer.h — 按"绝对截止时间"唤醒的周期定时器（不漂移）
+// ============================================================================
+//
+//  【以前的问题】
+//    while (true) { odometry_update(); sleep(10); }
+//    真实周期 = 10 ms + 计算时间 + 调度延迟。计算花 0.3 ms、
+//    视觉任务抢了 1 ms……周期就变成 11.3 ms，而且忽快忽慢。
+//    "100 Hz" 其实只是"大约 100 Hz"。
+//
+//  【现在的做法：睡到下一个绝对时刻】
+//    开始时刻 t0，截止时间依次是 t0+10、t0+20、t0+30 ms……
+//    每次只睡"离下一个截止时间还剩多少"，计算慢了就少睡一点，
+//    误差不会一圈一圈累积。
+//
+//        t0      t0+10     t0+20     t0+30
+//        │ 计算 ░░░│ 计算 ░░░│ 计算 ░░░│      ░ = 睡觉（长短自动调整）
+//
+//  【超时（overrun）】
+//    计算本身超过一个周期 → 到 wait() 时截止时间已经过了：
+//    不睡、直接开始下一轮，并计数。如果落后超过一整个周期，
+//    就放弃追赶（不会连着跑好几轮"补课"），从现在重新对齐。
+//
+//  【真实 dt】
+//    wait() 返回两次唤醒之间实际经过的秒数。控制器用它代替
+//    "假设正好 10 ms"，调度晚了一点也能算对。
+//
+//  【怎么用？】
+//    PeriodicTimer timer(LOOP_INTERVAL_MS, &odom_loop_stats);
+//    while (true) {
+//        double dt = timer.wait();     // 第一次从现在起等一个周期
+//        ScopedLoopTimer t(odom_loop_stats);
+//        odometry_update(dt);
+//    }
+//    传入 LoopStats 时，唤醒延迟按真正的截止时间统计。
+//
+// ============================================================================
+#include "telemetry/loop_stats.h"
+#include <stdint.h>
+
+class PeriodicTimer {
+public:
+    /// @param period_ms  周期（毫秒）
+    /// @param stats      可选：把"比截止时间晚醒了多久"记进这个循环的统计
+    explicit PeriodicTimer(int period_ms, LoopStats* stats = nullptr);
+
+    /// 以现在为起点重新开始（第一次 wait() 在一个周期后返回）
+    /// 没调用过时，第一次 wait() 会自动调用
+    void start();
+
+    /// 睡到下一个截止时间
+    /// @return 距离上一次 wait() 返回（或 start()）实际经过的秒数
+    double wait();
+
+    int           period_ms() const { return _period_ms; }
+    unsigned long ticks() const { return _ticks; }        ///< wait() 返回的次数
+    unsigned long overruns() const { return _overruns; }  ///< 到 wait() 时已经超过截止时间的次数
+    double        last_dt() const { return _last_dt; }    ///< 最近一次 wait() 的返回值（秒）
+
+    /// 从 start() 到现在的平均周期（毫秒）；还没 tick 时返回设定周期
+    double measured_period_ms() const;
+
+private:
+    int           _period_ms;
+    LoopStats*    _stats;
+    bool          _started;
+    unsigned long _deadline_ms;   // 下一个截止时间
+    uint64_t      _start_us;      // start() 的时刻
+    uint64_t      _last_wake_us;  // 上一次 wait() 返回的时刻
+    unsigned long _ticks;
+    unsigned long _overruns;
+    double        _last_dt;
+};
@@ -0,0 +1,107 @@
+#pragma once
+// ============================================================================
+//  hal/ring_buffer.h — 固定容量、无锁的环形队列（多个生产者 → 一个消费者）
+// ============================================================================
+//
+//  【这个文件干什么？】
+//    想象食堂的传菜窗口：厨师（生产者）把菜放进窗口的格子里，
+//    服务员（消费者）从另一边按顺序取走。格子数量是固定的——
+//    格子满了，厨师不会站在那儿等，而是直接放弃这道菜（计一次"丢弃"）。
+//    这样厨师永远不会被服务员拖慢。
+//
+//  【为什么要"无锁"？】
+//    如果用互斥锁，写日志的任务（比如 100 Hz 的里程计）可能要等
+//    正在慢吞吞写 SD 卡的任务释放锁——一等就是好几毫秒。
+//    无锁队列只用几条原子指令抢一个格子，永远不会卡住。
+//
+//  【算法】
+//    每个格子带一个序号 seq（Dmitry Vyukov 的有界队列算法）：
+//      seq == pos      → 格子空着，生产者可以写
+//      seq == pos + 1  → 格子里有数据，消费者可以读
+//    生产者用 compare_exchange 抢 _head，抢到了才写，所以多个任务同时写也安全。
+//
+//  【限制】
+//    • N 必须是 2 的幂（用位与代替取模，更快）
+//    • T 会被整体拷贝进出队列，不要放太大的结构体
+//
+// ============================================================================
+#include <atomic>
+#include <stdint.h>
+
+template <typename T, int N>
+class RingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    RingBuffer() : _head(0), _tail(0) {
+        for (int i = 0; i < N; ++i) {
+            _slots[i].seq.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+        }
+    }
+
+    /// 尝试放入一个元素（任何任务都可以调用，永不阻塞）
+    /// @return true = 放进去了，false = 队列已满（调用者自己决定是否计为丢弃）
+    bool try_push(const T& item) {
+        uint32_t pos = _head.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = _slots[pos & (N - 1)];
+            uint32_t seq = slot.seq.load(std::memory_order_acquire);
+            int32_t diff = static_cast<int32_t>(seq - pos);
+            if (diff == 0) {
+                // 格子空着 → 尝试把 _head 往前推一格，抢到就归我写
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.data = item;
+                    slot.seq.store(pos + 1, std::memory_order_release);  // 发布：可以读了
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 消费者还没取走上一圈的数据 → 满了
+            } else {
+                pos = _head.load(std::memory_order_relaxed);  // 被别的生产者抢先了，重试
+            }
+        }
+    }
+
+    /// 尝试取出最早放入的元素（只应由一个消费者任务调用）
+    /// @return true = 取到了，false = 队列为空
+    bool try_pop(T& out) {
+        uint32_t pos = _tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = _slots[pos & (N - 1)];
+            uint32_t seq = slot.seq.load(std::memory_order_acquire);
+            int32_t diff = static_cast<int32_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = slot.data;
+                    // 把格子"还回去"，序号跳到下一圈生产者期待的值
+                    slot.seq.store(pos + N, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 还没有数据
+            } else {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// 当前大约有多少个元素（多任务同时操作时只是近似值，用于统计显示）
+    int size_approx() const {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        return static_cast<int>(head - tail);
+    }
+
+    /// 队列容量
+    static int capacity() { return N; }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq;  // 格子状态序号（见文件头说明）
+        T                     data;
+    };
+
+    Slot                  _slots[N];
+    std::atomic<uint32_t> _head;  // 下一个要写的位置（生产者共享）
+    std::atomic<uint32_t> _tail;  // 下一个要读的位置（消费者独占）
+};
@@ -0,0 +1,33 @@
+#pragma once
+// ============================================================================
+//  hal/screen.h — Brain 屏幕显示（带缓存，只重画变了的字）
+// ============================================================================
+//
+//  【怎么用？】
+//    任何任务都可以改某一行想显示的内容（很便宜，只是格式化进内存）：
+//        screen_printf_row(2, "X: %.3f m", pose.x);
+//    屏幕任务每个周期调用一次 screen_flush()，把变了的字画到屏幕上。
+//
+//  【行的分配】
+//    1 ~ SCREEN_MESSAGE_ROW - 1 ：屏幕任务的调试信息（位置、朝向、传感器……）
+//    最后两行                   ：最近两条日志消息（LOG_SCREENF / 警告 / 错误）
+//
+//  缓存的实现见 hal/screen_cache.h。
+//
+// ============================================================================
+#include "hal/screen_cache.h"
+
+/// 日志消息占用的第一行（占最后两行）
+constexpr int SCREEN_MESSAGE_ROW = SCREEN_ROWS - 1;
+
+/// 设置某一行要显示的内容（printf 风格，线程安全）
+void screen_printf_row(int row, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/// 显示一条日志消息（上一条上移一行，线程安全）
+void screen_show_message(const char* text);
+
+/// 把变了的部分画到屏幕上（屏幕任务调用）
+void screen_flush();
+
+/// 读取重画统计
+ScreenCacheStats screen_get_stats();
@@ -0,0 +1,65 @@
+#pragma once
+// ============================================================================
+//  hal/screen_cache.h — "只重画变了的字"的屏幕缓存（不依赖硬件）
+// ============================================================================
+//
+//  【以前的问题】
+//    屏幕任务每 50 ms 先 clearScreen() 把整个屏幕擦掉，再把每一行重新打印，
+//    哪怕数字根本没变。擦掉-重画既费 CPU，又会让屏幕闪烁。
+//
+//  【现在的做法：保留模式（retained mode）】
+//    缓存记住"屏幕上现在显示的是什么"（drawn）和"想要显示什么"（pending）。
+//    set_row() 只改 pending（固定大小的字符数组，不分配内存）；
+//    flush() 逐行比较两者，只从第一个不同的字符开始重画，
+//    新文字比旧文字短时用空格盖掉多出来的旧字。
+//    例如 "X: 1.000 m" → "X: 1.250 m"，只重画 "250 m" 这 5 个字符。
+//
+//  【为什么和硬件分开？】
+//    真正往屏幕上画字由 flush() 的回调完成（hal/screen.cpp 里调用 Brain.Screen），
+//    这样电脑上的单元测试也能检查"到底重画了哪些字"。
+//
+// ============================================================================
+#include <stdarg.h>
+
+/// Brain 屏幕行数 / 每行字符数（默认等宽字体 480×272 像素）
+constexpr int SCREEN_ROWS = 12;
+constexpr int SCREEN_COLS = 48;
+
+/// 真正画字的回调：从第 row 行（1 起）第 col 列（1 起）开始画 text
+typedef void (*ScreenDrawFn)(int row, int col, const char* text);
+
+/// 重画统计
+struct ScreenCacheStats {
+    unsigned long flushes;     ///< flush() 调用次数
+    unsigned long rows_drawn;  ///< 实际重画的行数
+    unsigned long chars_drawn; ///< 实际重画的字符数
+};
+
+class ScreenCache {
+public:
+    ScreenCache();
+
+    /// 设置第 row 行（1 ~ SCREEN_ROWS）想要显示的内容（printf 风格，超长截断）
+    void set_row(int row, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+    void vset_row(int row, const char* fmt, va_list args);
+
+    /// 清空一行想要显示的内容
+    void clear_row(int row);
+
+    /// 把变了的部分画出去（通过 draw 回调）
+    /// @return 这次重画了几行
+    int flush(ScreenDrawFn draw);
+
+    /// 告诉缓存"屏幕刚被 clearScreen() 整个擦掉了"，下次 flush 把每一行重画出来
+    void mark_cleared();
+
+    /// 读取想要显示的内容（测试和调试用）
+    const char* pending_row(int row) const;
+
+    ScreenCacheStats stats() const { return _stats; }
+
+private:
+    char _pending[SCREEN_ROWS][SCREEN_COLS + 1];  // 想要显示的
+    char _drawn[SCREEN_ROWS][SCREEN_COLS + 1];    // 屏幕上实际显示的
+    ScreenCacheStats _stats;
+};
@@ -0,0 +1,61 @@
+#pragma once
+// ============================================================================
+//  hal/sensor_frame.h — 每一拍把所有传感器读一遍，打包成一帧（SensorFrame）
+// ============================================================================
+//
+//  【以前的问题】
+//    传感器是各读各的：里程计读追踪轮和 IMU，屏幕任务自己问 IMU 在不在，
+//    日志再去要一次电压命令……每一次都是一次设备调用，
+//    而且大家读到的不是同一时刻的值——日志里的"追踪轮读数"和"电压"可能差了半拍。
+//
+//  【现在：采集一次，大家共用】
+//    里程计任务每 10 ms 调一次 sensor_frame_acquire()：
+//      所有传感器按固定顺序各读一次 → 盖上时间戳和序号 → 发布出去。
+//    里程计直接用这一帧算位姿；屏幕、日志、控制用 sensor_frame_latest()
+//    拷一份最新的帧——不碰硬件、不加锁（用 hal/seqlock.h 发布）。
+//    发布出去的帧不会再被改，所以同一个序号的帧谁读到的都一模一样。
+//
+//  【帧里已经"洗"过的东西】
+//    • IMU 掉线或正在校准 → imu_ok = false，imu_rotation_rad 为 0（不去读它）
+//    • IMU 读出 NaN / 无穷大 → 同样当成掉线
+//    用的人只看 imu_ok，不用再自己判断一遍。
+//
+//  【连接状态不是每拍都查】
+//    读数每拍都读，但"连没连着"（追踪轮 2～3 次 installed()，IMU installed() +
+//    isCalibrating()）每 SENSOR_STATUS_POLL_TICKS 拍才问一次，中间的帧沿用上次的结果。
+//    所以 imu_ok / tracking_ok 可能比实际晚几拍；NaN 检查还是每拍都做。
+//
+// ============================================================================
+#include <stdint.h>
+
+/// 某一拍所有传感器的读数（采集之后不再改变）
+struct SensorFrame {
+    uint64_t time_us;            ///< 采集时刻（get_time_us()）
+    uint32_t seq;                ///< 第几帧（从 1 开始；0 = 还没采集过）
+    uint32_t reserved;           ///< 对齐用，恒为 0
+
+    double   forward_m;          ///< 纵向追踪轮累计距离（米）
+    double   lateral_m;          ///< 横向追踪轮累计距离（米）
+    double   parallel_m;         ///< 平行追踪轮累计距离（米；没装为 0）
+    double   imu_rotation_rad;   ///< IMU 累计旋转（弧度；imu_ok = false 时为 0）
+    double   left_ticks;         ///< 左侧驱动电机编码器累计脉冲
+    double   right_ticks;        ///< 右侧驱动电机编码器累计脉冲
+    double   left_command_v;     ///< 这一拍时左侧的电压命令（伏）
+    double   right_command_v;    ///< 这一拍时右侧的电压命令（伏）
+
+    bool     imu_ok;             ///< IMU 连着、没在校准（按最近一次查的）、读数是有限值
+    bool     tracking_ok;        ///< 追踪轮传感器都连着（按最近一次查的连接状态）
+    bool     has_parallel;       ///< 装了平行追踪轮
+    bool     pad;                ///< 对齐用
+};
+
+/// 读所有传感器一次，打包、盖时间戳并发布，返回这一帧
+/// 只能由一个任务调用（里程计任务；测试里由 odometry_update() 调用）
+SensorFrame sensor_frame_acquire();
+
+/// 最近一次采集的帧（无锁拷贝，不会读硬件；还没采集过时 seq == 0）
+SensorFrame sensor_frame_latest();
+
+/// 让下一次 sensor_frame_acquire() 马上重新查连接状态，不等 SENSOR_STATUS_POLL_TICKS
+/// （任何任务都能调用；测试里改了模拟的连接状态后用）
+void sensor_frame_refresh_status();
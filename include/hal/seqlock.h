@@ -0,0 +1,94 @@
+#pragma once
+// ============================================================================
+//  hal/seqlock.h — 一个写者、多个读者的无锁"快照发布"（序号锁 seqlock）
+// ============================================================================
+//
+//  【这个文件干什么？】
+//    里程计每 10 ms 算出一个新位姿，运动控制、视觉、屏幕、日志都要读它。
+//    以前用互斥锁：读者拿着锁的时候，100 Hz 的写者只能干等；
+//    写者算三角函数时拿着锁，读者也只能干等。
+//    这里换成"发布快照"：写者写好一份完整的数据再"贴出来"，
+//    读者随时拷一份走，谁都不用等谁。
+//
+//  【算法：序号 + 几个轮流用的格子】
+//    每个格子带一个序号 seq：
+//      seq == 2 × 版本号 - 1  → 写者正在往里写第"版本号"份数据（写了一半）
+//      seq == 2 × 版本号      → 第"版本号"份数据已经写完整
+//    写者：把下一个版本写进下一个格子（不碰当前贴出来的那个），
+//          写完以后再把"当前版本号"改过去。
+//    读者：看当前版本号 → 拷它的格子 → 再检查一遍 seq 没变。
+//          变了说明拷的时候正好被覆盖（写者已经又写了 SLOTS 次），重来一次。
+//
+//  【为什么要好几个格子？（而不是经典 seqlock 的一个）】
+//    VEX 的任务有优先级。如果一个高优先级的读者正好打断了写了一半的写者，
+//    单格子的读者会一直看到"正在写"而原地空转——写者又没机会跑，永远卡死。
+//    多个格子时，当前贴出来的版本永远是写完的，读者一次就能拷到。
+//
+//  【限制】
+//    • 只能有一个写者（多个写者请自己先用互斥锁排队）
+//    • T 会被按 4 字节一个字拷贝，大小必须是 4 的倍数，只放普通数据（double、int 等）
+//
+// ============================================================================
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+template <typename T, int SLOTS = 4>
+class SeqLock {
+    static_assert(sizeof(T) % 4 == 0, "SeqLock payload size must be a multiple of 4 bytes");
+    static_assert(SLOTS >= 2, "SeqLock needs at least two slots");
+
+public:
+    SeqLock() : _version(0) {
+        for (int i = 0; i < SLOTS; ++i) {
+            _slots[i].seq.store(0, std::memory_order_relaxed);
+            for (int w = 0; w < WORDS; ++w) _slots[i].words[w].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /// 发布一份新数据（只能由唯一的写者调用，永不阻塞）
+    void write(const T& value) {
+        uint32_t version = _version.load(std::memory_order_relaxed) + 1;
+        Slot& slot = _slots[version % SLOTS];
+
+        uint32_t words[WORDS];
+        memcpy(words, &value, sizeof(T));
+
+        slot.seq.store(2 * version - 1, std::memory_order_relaxed);  // 标记"写了一半"
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int w = 0; w < WORDS; ++w) slot.words[w].store(words[w], std::memory_order_relaxed);
+        slot.seq.store(2 * version, std::memory_order_release);      // 标记"写完整了"
+        _version.store(version, std::memory_order_release);          // 贴出来
+    }
+
+    /// 读取最新的一份完整数据（任何任务都能调用，不会等写者）
+    T read() const {
+        uint32_t words[WORDS];
+        while (true) {
+            uint32_t version = _version.load(std::memory_order_acquire);
+            const Slot& slot = _slots[version % SLOTS];
+            uint32_t before = slot.seq.load(std::memory_order_acquire);
+            for (int w = 0; w < WORDS; ++w) words[w] = slot.words[w].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint32_t after = slot.seq.load(std::memory_order_relaxed);
+            if (before == after && before == 2 * version) break;  // 拷的过程中格子没被动过
+        }
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /// 已经发布了多少次
+    uint32_t version() const { return _version.load(std::memory_order_acquire); }
+
+private:
+    static constexpr int WORDS = sizeof(T) / 4;
+
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint32_t> words[WORDS];
+    };
+
+    Slot                  _slots[SLOTS];
+    std::atomic<uint32_t> _version;
+};
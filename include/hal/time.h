@@ -6,7 +6,8 @@
 //  【这个文件干什么？】
 //    提供三个功能：
 //    1. "现在几点？" —— 告诉你程序开机到现在过了多少秒/毫秒
-//    2. "等一会儿" —— 让程序休眠指定毫秒
+//    2. "精确计时" —— 微秒级时间戳，用来测量一段代码跑了多久
+//    3. "等一会儿" —— 让程序休眠指定毫秒，或者休眠到某个时刻
 //
 //  【为什么要单独写这几个函数？】
 //    在真实机器人上用 VEX 的计时器，在电脑上的单元测试里用假的计时器。
@@ -17,6 +18,7 @@
 //
 // ============================================================================
 #include "hal/hal_log.h"
+#include <stdint.h>
 
 /// 获取程序开机到现在经过的时间（单位：秒，带小数）
 /// 例如返回 3.456 表示开机已经 3.456 秒了
@@ -26,7 +28,15 @@ double get_time_sec();
 /// 例如返回 3456 表示开机已经 3456 毫秒了
 unsigned long get_time_ms();
 
+/// 获取程序开机到现在经过的时间（单位：微秒，1 毫秒 = 1000 微秒）
+/// 毫秒太粗，量不出"一次里程计计算花了 80 微秒"，所以计时统计用这个
+uint64_t get_time_us();
+
 /// 让程序休眠指定毫秒（休眠期间让出 CPU 给其他任务）
 /// 在 VEX V5 的实时系统里，这很重要——
 /// 如果不休眠就会霸占 CPU，导致其他后台任务卡住
 void wait_ms(int ms);
+
+/// 休眠到指定的绝对时刻（get_time_ms() 的值）；时刻已过则立即返回
+/// 周期任务用它避免"sleep 固定时长"带来的累积漂移（见 hal/periodic_timer.h）
+void wait_until_ms(unsigned long deadline_ms);
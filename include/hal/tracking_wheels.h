@@ -11,7 +11,8 @@
 //  【垂直双轮布局】
 //    • 纵向轮（Forward）：朝前安装，测量前后位移
 //    • 横向轮（Lateral）：朝右安装，测量左右侧滑
-//    旋转角度由 IMU 提供，不需要从追踪轮推算。
+//    旋转角度由 IMU 提供；如果另外装了一个平行轮（PARALLEL_TRACKING_PORT），
+//    纵向轮和平行轮的距离差也能算出转角，用来修正 IMU 的漂移。
 //
 //  【为什么不用电机自带的编码器？】
 //    电机轮子打滑时，编码器以为走了 1 米，实际只走了 0.8 米——不准！
@@ -38,6 +39,12 @@ double tracking_get_forward_distance_m();
 /// 正数 = 向右，负数 = 向左
 double tracking_get_lateral_distance_m();
 
-/// 检查两个追踪轮旋转传感器是否都已连接
+/// 有没有配平行轮（PARALLEL_TRACKING_PORT >= 0）
+bool tracking_has_parallel_wheel();
+
+/// 获取平行轮累计滚过的距离（单位：米，正数 = 向前；没配平行轮返回 0）
+double tracking_get_parallel_distance_m();
+
+/// 检查追踪轮旋转传感器是否都已连接（配了平行轮的话也检查平行轮）
 /// 返回 true = 都连上了，false = 至少有一个没连上
 bool tracking_wheels_connected();
@@ -15,12 +15,20 @@
 //    • 大小       — 标签看起来有多大（像素）→ 越大说明离得越近
 //    • 角度       — 标签相对摄像头的旋转角度
 //
+//  【一次拍照 = 一帧（VisionFrame）】
+//    vision_snapshot() 把这次看到的所有标签、拍摄时刻、帧号写成完整的一帧，
+//    写好以后原子地换上去（hal/frame_buffer.h）。
+//    任何任务都可以用 vision_latest_frame() 借看最新的一帧：
+//    不加锁、不拷贝，看到的一定是同一次拍照的完整结果，不会看到写了一半的。
+//
 //  【图片坐标系】
 //    图片左上角是 (0,0)，x 向右增大，y 向下增大。
 //    摄像头装在机器人前方，摄像头偏移量在 config.h 里设定。
 //
 // ============================================================================
+#include "hal/frame_buffer.h"
 #include "hal/hal_log.h"
+#include <stdint.h>
 
 /// 每次拍照最多能返回的标签数量
 constexpr int VISION_MAX_TAGS = 8;
@@ -36,18 +44,31 @@ struct TagDetection {
     bool   valid;        ///< true = 有效检测，false = 无效/空的
 };
 
+/// 一次拍照的完整结果（发布以后不再改变）
+struct VisionFrame {
+    uint64_t     time_us;                 ///< 画面的拍摄时刻（get_time_us() 的时间轴，已经减掉了 VISION_CAPTURE_LATENCY_MS）
+    uint32_t     seq;                     ///< 第几帧（从 1 开始；0 = 还没拍过照）
+    int          count;                   ///< tags 里有几个标签（0 ~ VISION_MAX_TAGS）
+    TagDetection tags[VISION_MAX_TAGS];   ///< 这次拍到的 AprilTag（前 count 个有效）
+};
+
+/// 借看一帧（只读；离开作用域自动归还，别跨好几帧拿着不放）
+typedef FrameBuffer<VisionFrame>::View VisionFrameView;
+
 /// 初始化 AI 视觉传感器，启用 AprilTag 检测模式（开机时调用一次）
 void vision_init();
 
-/// "拍一张照"，返回这次拍到了几个 AprilTag 标签
-/// 拍照结果存在内部缓冲区里，用 vision_get_tag(i) 来取第 i 个
-/// @return 检测到的标签数量（0 ~ VISION_MAX_TAGS）
+/// "拍一张照"，把结果作为新的一帧发布出去，返回这次拍到了几个 AprilTag 标签
+/// 只能由一个任务调用（拍照的那个）
+/// @return 检测到的标签数量（0 ~ VISION_MAX_TAGS；所有缓冲都被借着、这一帧丢掉时返回 0）
 int vision_snapshot();
 
-/// 从最近一次拍照结果中取出第 index 个标签的信息
-/// @param index  从 0 开始的索引（必须 < vision_snapshot() 返回的数量）
-/// @return 标签信息结构体（使用前先检查 .valid 是否为 true）
-TagDetection vision_get_tag(int index);
+/// 借看最近一次发布的帧（任何任务都能调用，不会等拍照，不拷贝标签）
+/// 用 ->seq 判断是不是新的一帧（0 = 还没拍过照）
+VisionFrameView vision_latest_frame();
+
+/// 因为所有缓冲都被借着、没能发布而丢掉的拍照次数
+uint32_t vision_dropped_snapshots();
 
 /// 检查视觉传感器是否已连接并正常工作
 bool vision_is_connected();
@@ -0,0 +1,62 @@
+#pragma once
+// ============================================================================
+//  localization/gyro_bias.h — 静止检测 + 陀螺仪零漂估计（零速更新）
+// ============================================================================
+//
+//  【问题】
+//    陀螺仪有零漂：车一动不动，IMU 读数也会每秒慢慢变一点点。
+//    里程计把它当成真的转动积分进 θ，一场长自治下来航向就歪了。
+//
+//  【思路：停着的时候量一下】
+//    车真的停住时，"IMU 这一拍转了多少"就全是零漂。
+//    所以：先判断车是不是真停了，停了就用 IMU 的读数慢慢更新零漂估计，
+//    之后每一拍（不管动没动）都从 IMU 的转角里减掉 零漂 × dt。
+//
+//  【怎么判断"真的停了"？】全部满足、并且持续 STATIONARY_SETTLE_MS：
+//    • 追踪轮几乎没动（很精确，一圈 36000 格）
+//    • 驱动电机编码器也没动（有没有在原地打滑 / 被推）
+//    • 电机没在给电压（下一拍可能就要动了）
+//    • IMU 转得也很慢（平滑后的角速度比零漂大、比真转动小得多）
+//    用的都是里程计这一拍本来就读到的值，没有额外的传感器读取。
+//
+//  这个文件不依赖 VEX 硬件，电脑上的单元测试和性能测试可以直接用。
+//
+// ============================================================================
+#include "config.h"
+
+/// 判断静止用的这一拍的数据（都是增量 / 这一拍的值）
+struct StationaryInputs {
+    double wheel_forward_m;   ///< 纵向追踪轮这一拍走的距离
+    double wheel_lateral_m;   ///< 横向追踪轮这一拍走的距离
+    double motor_left_m;      ///< 左侧驱动电机这一拍走的距离
+    double motor_right_m;     ///< 右侧驱动电机这一拍走的距离
+    double command_volts;     ///< 左右电压命令里绝对值较大的那个
+};
+
+class GyroBiasEstimator {
+public:
+    GyroBiasEstimator();
+
+    /// 清掉零漂估计和静止计时（IMU 重新校准后；set_pose 不用清，IMU 还是那个 IMU）
+    void reset();
+
+    /// 喂一拍数据，返回减掉零漂后的 IMU 转角
+    /// @param imu_delta  IMU 这一拍的转角（弧度）
+    /// @param dt         真实经过的秒数
+    double correct(double imu_delta, const StationaryInputs& in, double dt);
+
+    /// 现在是不是判定为静止
+    bool stationary() const { return _still_s * 1000.0 >= STATIONARY_SETTLE_MS; }
+
+    /// 当前的零漂估计（弧度/秒）
+    double bias() const { return _bias; }
+
+    /// 累计用来估计零漂的秒数（0 = 还没停下来过）
+    double learned_s() const { return _learned_s; }
+
+private:
+    double _bias;
+    double _gyro_rate;   // 平滑后的 IMU 角速度（减过零漂），判断静止用
+    double _still_s;     // 连续满足静止条件多久了
+    double _learned_s;
+};
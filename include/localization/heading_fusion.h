@@ -0,0 +1,71 @@
+#pragma once
+// ============================================================================
+//  localization/heading_fusion.h — IMU + 轮子的互补滤波航向
+// ============================================================================
+//
+//  【为什么不只用 IMU？】
+//    IMU 短时间非常准（不怕打滑），但陀螺仪有零漂：静止不动读数也会慢慢变，
+//    一场 15 秒的自治下来能偏掉零点几度，走 3 米就是好几厘米。
+//    轮子算出来的角度（左右两边走的距离差 ÷ 间距）不会随时间漂，
+//    但打滑、原地转时轮子横着蹭地都会让它一下子错很多。
+//    两个的缺点正好互补，所以叫"互补滤波"：
+//      短时间的转动听 IMU（高频），长时间的趋势听轮子（低频）。
+//
+//  【算法】每一拍：
+//    参考角 ref += 这一拍轮子的转角（轮子靠不住的拍用 IMU 的转角代替）
+//    航向 θ    = θ + IMU 的转角                  ← 先按 IMU 走
+//    航向 θ   += (1 − α) × (ref − θ)            ← 再往轮子的角度拉一点点
+//    α 就是 IMU_FUSION_ALPHA（按真实 dt 缩放，晚了一拍就多拉一点）。
+//
+//  【轮子什么时候靠不住？】
+//    • 和 IMU 的转角差太多（HEADING_SLIP_RATE_RADPS）→ 打滑了
+//    • 用驱动电机时转得太快（HEADING_WHEEL_MAX_RATE_RADPS）→ 轮子在横着蹭地
+//      （平行追踪轮不会蹭地，不受这一条限制）
+//    这些拍里 ref 跟着 IMU 走，所以打滑的那一下不会被"拉"进航向里。
+//
+//  【IMU 掉线】
+//    IMU 线松了（installed() == false）的这几拍，直接用轮子的转角；
+//    重新插上后 IMU 读数从 0 开始，里程计先把"上一次读数"对齐到新的值，
+//    所以航向不会跳一下。两个都没有的时候航向保持不动。
+//    拔插得太快、installed() 没来得及报掉线时，读数会一拍之内跳回 0 附近
+//    （比 IMU 能测的最快转速 IMU_MAX_RATE_RADPS 还快），里程计也当成这一拍掉线处理。
+//
+//  这个文件不依赖 VEX 硬件，电脑上的单元测试和性能测试可以直接用。
+//
+// ============================================================================
+
+/// 航向融合统计
+struct HeadingFusionStats {
+    unsigned long wheel_ticks;     ///< 用了轮子角度的拍数
+    unsigned long slip_ticks;      ///< 轮子和 IMU 对不上（打滑 / 蹭地）的拍数
+    unsigned long dropout_ticks;   ///< IMU 掉线、只靠轮子（或什么都没有）的拍数
+};
+
+class HeadingFusion {
+public:
+    /// @param alpha            每 nominal_dt 秒信任 IMU 的比例（IMU_FUSION_ALPHA）
+    /// @param nominal_dt       alpha 对应的周期（秒）
+    /// @param wheels_scrub     true = 轮子角度来自驱动电机（转得快时不用）
+    HeadingFusion(double alpha, double nominal_dt, bool wheels_scrub);
+
+    /// 航向和参考角一起归零（set_pose 时）
+    void reset();
+
+    /// 融合一拍，返回这一拍的航向增量（弧度）
+    /// @param imu_delta    IMU 这一拍的转角（imu_ok = false 时忽略）
+    /// @param wheel_delta  轮子这一拍的转角（wheel_ok = false 时忽略）
+    /// @param dt           真实经过的秒数
+    double update(double imu_delta, bool imu_ok, double wheel_delta, bool wheel_ok, double dt);
+
+    /// 从 reset() 以来融合后的累计转角
+    double heading() const { return _heading; }
+
+    const HeadingFusionStats& stats() const { return _stats; }
+
+private:
+    double _gain_per_s;   // (1 − α) / nominal_dt
+    bool   _scrub;
+    double _heading;
+    double _reference;
+    HeadingFusionStats _stats;
+};
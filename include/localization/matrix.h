@@ -0,0 +1,129 @@
+#pragma once
+// ============================================================================
+//  localization/matrix.h — 固定大小的小矩阵（卡尔曼滤波用，全部在栈上）
+// ============================================================================
+//
+//  【为什么不用 Eigen 之类的库？】
+//    滤波器里最大的矩阵也就 3×3，用不着一个大库。
+//    这里的矩阵大小是模板参数（编译期就知道），数据就是一个 double 数组：
+//    • 不分配堆内存（new / malloc 都没有），100 Hz 调用也不会产生碎片
+//    • 每次运算的次数固定（3×3 乘法就是 27 次乘加），耗时可以预估
+//    • 维度写错（3×2 乘 3×3）在编译时就报错，不会跑起来才出问题
+//
+//  【怎么用？】
+//    Matrix<3, 3> F = Matrix<3, 3>::identity();
+//    F(0, 2) = -0.5;
+//    Matrix<3, 3> P2 = F * P * F.transpose() + Q;
+//
+// ============================================================================
+#include <cmath>
+
+template <int R, int C>
+struct Matrix {
+    double m[R][C];
+
+    /// 全零矩阵
+    static Matrix zero() {
+        Matrix out;
+        for (int i = 0; i < R; ++i)
+            for (int j = 0; j < C; ++j) out.m[i][j] = 0.0;
+        return out;
+    }
+
+    /// 单位矩阵（只对方阵有意义）
+    static Matrix identity() {
+        Matrix out = zero();
+        for (int i = 0; i < R && i < C; ++i) out.m[i][i] = 1.0;
+        return out;
+    }
+
+    double&       operator()(int r, int c) { return m[r][c]; }
+    const double& operator()(int r, int c) const { return m[r][c]; }
+
+    Matrix<C, R> transpose() const {
+        Matrix<C, R> out;
+        for (int i = 0; i < R; ++i)
+            for (int j = 0; j < C; ++j) out.m[j][i] = m[i][j];
+        return out;
+    }
+
+    Matrix operator+(const Matrix& b) const {
+        Matrix out;
+        for (int i = 0; i < R; ++i)
+            for (int j = 0; j < C; ++j) out.m[i][j] = m[i][j] + b.m[i][j];
+        return out;
+    }
+
+    Matrix operator-(const Matrix& b) const {
+        Matrix out;
+        for (int i = 0; i < R; ++i)
+            for (int j = 0; j < C; ++j) out.m[i][j] = m[i][j] - b.m[i][j];
+        return out;
+    }
+
+    Matrix operator*(double s) const {
+        Matrix out;
+        for (int i = 0; i < R; ++i)
+            for (int j = 0; j < C; ++j) out.m[i][j] = m[i][j] * s;
+        return out;
+    }
+
+    template <int K>
+    Matrix<R, K> operator*(const Matrix<C, K>& b) const {
+        Matrix<R, K> out;
+        for (int i = 0; i < R; ++i) {
+            for (int j = 0; j < K; ++j) {
+                double sum = 0.0;
+                for (int k = 0; k < C; ++k) sum += m[i][k] * b.m[k][j];
+                out.m[i][j] = sum;
+            }
+        }
+        return out;
+    }
+
+    /// 对称化：(A + Aᵀ) / 2。协方差矩阵反复运算后会有微小的不对称，定期修一下
+    Matrix symmetrized() const {
+        Matrix out;
+        for (int i = 0; i < R; ++i)
+            for (int j = 0; j < C; ++j) out.m[i][j] = 0.5 * (m[i][j] + m[j][i]);
+        return out;
+    }
+};
+
+/// 求逆（高斯-约旦消元 + 部分选主元）
+/// @return false = 矩阵（几乎）奇异，out 不变
+template <int N>
+bool matrix_invert(const Matrix<N, N>& a, Matrix<N, N>* out) {
+    Matrix<N, N> work = a;
+    Matrix<N, N> inv  = Matrix<N, N>::identity();
+    for (int col = 0; col < N; ++col) {
+        // 选这一列绝对值最大的一行当主元，数值更稳
+        int pivot = col;
+        for (int r = col + 1; r < N; ++r) {
+            if (fabs(work.m[r][col]) > fabs(work.m[pivot][col])) pivot = r;
+        }
+        if (fabs(work.m[pivot][col]) < 1e-12) return false;
+        if (pivot != col) {
+            for (int k = 0; k < N; ++k) {
+                double t = work.m[col][k]; work.m[col][k] = work.m[pivot][k]; work.m[pivot][k] = t;
+                t = inv.m[col][k]; inv.m[col][k] = inv.m[pivot][k]; inv.m[pivot][k] = t;
+            }
+        }
+        double d = work.m[col][col];
+        for (int k = 0; k < N; ++k) {
+            work.m[col][k] /= d;
+            inv.m[col][k]  /= d;
+        }
+        for (int r = 0; r < N; ++r) {
+            if (r == col) continue;
+            double f = work.m[r][col];
+            if (f == 0.0) continue;
+            for (int k = 0; k < N; ++k) {
+                work.m[r][k] -= f * work.m[col][k];
+                inv.m[r][k]  -= f * inv.m[col][k];
+            }
+        }
+    }
+    *out = inv;
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+// ============================================================================
+//  localization/multi_tag.h — 多个 AprilTag 一起解位姿（加权最小二乘）
+// ============================================================================
+//
+//  【以前怎么做？】
+//    每个标签单独反推一个位置（航向借用里程计的），然后只留置信度最高的那个，
+//    同一帧里其它标签的信息全扔了。单个标签的距离误差有好几厘米，
+//    而且航向错一点，反推的位置就沿着圆弧偏过去。
+//
+//  【联合求解】
+//    找一个位姿 (x, y, θ)，让"从这个位姿看过去应该看到的距离和方位"
+//    和所有标签实际测到的最接近：
+//      最小化  Σ 置信度ᵢ × [ (距离误差ᵢ / σ_r)² + (方位误差ᵢ / σ_φ)² ]
+//             + 里程计先验（很弱，只防止解不出来的方向乱跑）
+//    σ 用和卡尔曼滤波一样的测量噪声（EKF_RANGE_SIGMA_*、EKF_BEARING_SIGMA_RAD），
+//    测量模型也是同一个（vision_predict_tag）。
+//
+//  【高斯-牛顿法】
+//    从里程计的位姿出发，每一步把测量模型在当前位姿附近线性化：
+//      (Jᵀ W J + 先验) · Δ = Jᵀ W r + 先验拉回来的量
+//    解出 3×3 方程得到修正量 Δ，加上去，再来一次。
+//    迭代次数固定（VISION_MULTI_TAG_ITERATIONS），矩阵全是栈上的 3×3，
+//    每一帧的计算量只和标签个数成正比，没有 new。
+//
+//  【结果靠不靠谱？】
+//    解完以后看残差：如果标签之间互相矛盾（有一个是误检），
+//    残差的均方根会很大，ok = false，调用者退回单标签。
+//    协方差 (JᵀWJ)⁻¹ 也一起给出来，可以看出解在哪个方向上不确定。
+//
+//  这个文件不依赖 VEX 硬件，电脑上的单元测试和性能测试可以直接用。
+//
+// ============================================================================
+#include "localization/vision_geometry.h"
+
+/// 联合求解的结果
+struct MultiTagSolution {
+    Pose   pose;         ///< 解出来的位姿（ok = false 时是最后一次迭代的值，不要用）
+    double sigma_xy;     ///< 位置的不确定度（米，协方差 x、y 对角线的均方根）
+    double sigma_theta;  ///< 航向的不确定度（弧度）
+    double rms;          ///< 残差均方根（以测量标准差为单位，1 左右正常）
+    int    tags_used;    ///< 用了几个标签
+    bool   ok;           ///< 标签够数、方程可解、残差合理
+};
+
+/// 用多个标签一起解机器人位姿
+/// @param tags     这一帧的标签测量（置信度为 0 的跳过；其余按置信度加权，
+///                 单独不够 VISION_MIN_CONFIDENCE 的远处标签也能帮上忙）
+/// @param count    tags 的条数
+/// @param initial  起点和先验（里程计当前位姿）
+MultiTagSolution multi_tag_solve(const TagMeasurement* tags, int count, const Pose& initial);
@@ -27,6 +27,21 @@
 //    后台线程以 100Hz（每秒 100 次）自动更新位姿。
 //    运动控制器通过 get_pose() 读取最新位姿——不需要手动调用更新！
 //
+//  【读位姿不加锁】
+//    每次更新完，里程计把"位姿 + 序号 + 时间戳"整份发布出去（hal/seqlock.h），
+//    get_pose() 只是拷一份最新的快照：读者不会等写者，写者也不会等读者。
+//
+//  【速度】
+//    每次更新的增量 ÷ 真实 dt，低通滤波后和位姿放在同一份快照里发布
+//    （get_pose_snapshot().velocity / .accel）。控制器拿来做速度前馈、
+//    判断"是不是真的停稳了"，不用自己对位姿求差分，也不用再读一次传感器。
+//
+//  【卡尔曼滤波】
+//    里程计内部用一个 EKF（localization/pose_ekf.h）推进位姿，同时记录不确定度，
+//    视觉看到标签时调用 odometry_ekf_update() 融合。
+//    选了粒子滤波（VISION_FUSION_PARTICLE）时，粒子也在这里跟着里程计走，
+//    视觉调用 odometry_particle_update() 把粒子滤波的估计设为当前位姿。
+//
 // ============================================================================
 
 /// 机器人位姿：在场地上的位置 + 朝向
@@ -36,7 +51,42 @@ struct Pose {
     double theta;  ///< 航向角（弧度，逆时针为正）
 };
 
-/// 启动里程计后台任务（100 Hz）
+/// 机器人速度（或加速度），机器人坐标系：前方 / 左方 / 逆时针
+struct Twist {
+    double forward;  ///< 前进方向（米/秒）
+    double lateral;  ///< 向左（米/秒）
+    double omega;    ///< 旋转（弧度/秒，逆时针为正）
+};
+
+#include <stdint.h>
+#include "hal/sensor_frame.h"
+
+struct TagMeasurement;  // localization/vision_geometry.h
+
+/// 一次发布的位姿快照：位姿 + 速度 + 它是第几次发布 + 什么时候算出来的
+struct PoseSnapshot {
+    Pose     pose;
+    Twist    velocity;  ///< 滤波后的速度（localization/twist_estimator.h）
+    Twist    accel;     ///< 滤波后的加速度（单位再除一次秒；ODOM_ESTIMATE_ACCEL = false 时为 0）
+    uint32_t seq;       ///< 发布序号（每次更新或设置位姿 +1，单调递增）
+    uint32_t reserved;  ///< 保留（凑齐 8 字节对齐）
+    uint64_t time_us;   ///< 这个位姿对应的时刻（get_time_us()，微秒）
+};
+
+/// 里程计最近一次读到的传感器原始累计值（给日志和黑匣子用）
+/// 和位姿在同一份快照里发布：一起读出来的一定是同一拍的
+struct OdomRawInputs {
+    double   forward_m;        ///< 纵向追踪轮累计距离（米）
+    double   lateral_m;        ///< 横向追踪轮累计距离（米）
+    double   imu_rad;          ///< IMU 累计旋转（弧度）
+    double   dt_s;             ///< 这次更新距上一次更新实际经过的时间（秒）
+    double   left_command_v;   ///< 那一拍的左侧电压命令（伏）
+    double   right_command_v;  ///< 那一拍的右侧电压命令（伏）
+    uint32_t frame_seq;        ///< 用的是第几帧传感器读数（SensorFrame::seq；还没更新过为 0）
+    uint32_t reserved;         ///< 保留（凑齐 8 字节对齐）
+};
+
+/// 启动里程计后台任务（100 Hz，按绝对截止时间唤醒，见 hal/periodic_timer.h）
 /// 在 pre_auton() 中 IMU 校准完成后调用一次
 void odometry_start_task();
 
@@ -44,11 +94,29 @@ void odometry_start_task();
 void odometry_stop_task();
 
 /// 执行一次里程计更新（由后台任务自动调用，也可手动调用用于测试）
-void odometry_update();
+/// @param dt  距上一次更新实际经过的秒数（由 PeriodicTimer 测量，不是假设的 10 ms）
+void odometry_update(double dt);
+
+/// 用一帧已经采集好的传感器读数更新里程计（odometry_update() 先采集再调它）
+/// @param frame  这一拍的读数（hal/sensor_frame.h）；位姿的时间戳用 frame.time_us
+/// @param dt     距上一次更新实际经过的秒数
+void odometry_update_from(const SensorFrame& frame, double dt);
 
-/// 获取当前位姿（线程安全——有锁保护）
+/// 获取当前位姿（线程安全，无锁——拷贝最新发布的快照，不会等里程计）
 Pose get_pose();
 
+/// 获取当前位姿快照（带速度、序号和时间戳；序号没变说明位姿还没更新过）
+PoseSnapshot get_pose_snapshot();
+
+/// 获取当前速度（机器人坐标系，无锁；等于 get_pose_snapshot().velocity）
+Twist get_velocity();
+
+/// 获取最近一次更新时读到的传感器原始值（不会重新读传感器）
+/// @param snapshot  输出：和这些原始值同一次发布的位姿快照（可以为 nullptr）。
+///                  位姿和读数要配对时用它，不要分开调 get_pose() 和 sensor_frame_latest()——
+///                  传感器帧比位姿先发布，分开读可能拿到新一帧的读数配上一拍的位姿
+OdomRawInputs odometry_get_raw_inputs(PoseSnapshot* snapshot);
+
 /// 手动设置位姿（比如在自治开始时设定起始位置）
 /// 会同时重置编码器和 IMU
 void set_pose(const Pose& new_pose);
@@ -57,3 +125,38 @@ void set_pose(const Pose& new_pose);
 /// 用于视觉校正——只是轻轻"推一下"位置，不打断编码器的正常计数
 /// ⚠ 不要用这个函数来手动设定起始位姿！用 set_pose() 代替
 void set_pose_no_reset(const Pose& new_pose);
+
+/// 查询过去某个时刻的位姿（在里程计历史里插值，见 localization/pose_history.h）
+/// @param time_us  get_time_us() 时刻
+/// @return false = 太久以前（超出历史范围）或还没有历史
+bool odometry_pose_at(uint64_t time_us, Pose* out);
+
+/// 在过去某个时刻施加位姿修正，并把之后的里程计增量重放到现在
+/// 用于有延迟的传感器（摄像头）：在拍照时刻修正，而不是在结果出来的时刻
+/// @return false = 时刻超出历史范围，没有修正
+bool odometry_correct_at(uint64_t time_us, const Pose& corrected);
+
+/// 在过去某个时刻把位姿挪动 offset（dx, dy, dθ），并重放到现在
+/// 视觉修正用：修正量是拿拍照时刻的位姿算出来的，原样加回那个时刻
+/// @return false = 时刻超出历史范围，没有修正
+bool odometry_shift_at(uint64_t time_us, const Pose& offset);
+
+/// 用一个标签测量（距离 + 方位）更新里程计里的卡尔曼滤波，并发布新位姿
+/// @return false = 和预测差太多被门限拒绝（或测量不可用），位姿没变
+bool odometry_ekf_update(const TagMeasurement& meas);
+
+/// 停稳时估计出来的陀螺仪零漂（弧度/秒，已经在里程计里减掉了）
+/// @param stationary  输出：现在是不是判定为静止（可以为 nullptr）
+double odometry_get_gyro_bias(bool* stationary);
+
+/// 当前位姿的标准差（米, 米, 弧度）—— 卡尔曼滤波协方差对角线的平方根
+void odometry_get_uncertainty(double* sigma_x, double* sigma_y, double* sigma_theta);
+
+/// 分配粒子滤波的内存并把粒子撒在当前位姿周围（只调用一次，vision_localizer_init 里）
+/// 之后每次里程计更新都会推进粒子，set_pose() 会重新撒粒子
+/// @return false = 已经初始化过或内存不够
+bool odometry_particle_filter_init(int particle_count);
+
+/// 用这一帧看到的所有标签更新粒子滤波，并把它的估计设为当前位姿
+/// @return false = 粒子滤波没初始化或没有标签，位姿没变
+bool odometry_particle_update(const TagMeasurement* tags, int count);
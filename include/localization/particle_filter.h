@@ -0,0 +1,108 @@
+#pragma once
+// ============================================================================
+//  localization/particle_filter.h — 粒子滤波定位（蒙特卡洛定位，MCL）
+// ============================================================================
+//
+//  【为什么还要一个粒子滤波？】
+//    卡尔曼滤波只记一个"最可能的位置 + 一个椭圆"。平时很好用，
+//    可是比赛里被对手撞了一下，车一下子挪了 30 cm、编码器却没看见：
+//    标签读数和预测差太多 → 被门限当成误检全部拒绝 → 一直回不来。
+//
+//    粒子滤波同时养着几百个"猜测"（粒子），每个都是一个可能的 (x, y, θ)：
+//    • 预测：每个粒子都按里程计走一步，再各自加一点随机误差
+//    • 更新：看到标签时，和标签读数对得上的粒子权重高，对不上的低
+//    • 重采样：按权重"优胜劣汰"，权重高的复制几份，低的淘汰
+//    • 恢复：最近的读数整体都对不上（被撞了），就往估计位置周围撒一些新粒子，
+//      真实位置附近的新粒子很快就会胜出
+//
+//  【内存布局：数组的结构（SoA）】
+//    不是 "粒子[i].x, 粒子[i].y ..."，而是 x[]、y[]、θ[] 各一个连续数组。
+//    循环里每次都对同一个数组的相邻元素做同样的运算，编译器能用
+//    NEON 一次算 4 个 float（这也是用 float 而不是 double 的原因：
+//    V5 的 NEON 只支持单精度）。
+//    所有数组在 init() 时一次性从一整块内存里切出来，之后再也不分配。
+//
+//  【每次调用的开销】（n = 粒子数）
+//    predict      O(n)，无分支，可向量化（随机数先查表填好）
+//    update_tag   O(n)，无分支、无三角函数，可向量化
+//    finish_update O(n)，系统重采样（只用一个随机数）
+//    用 make bench 看看 10 ms 里能放下多少粒子。
+//
+//  这个文件不依赖 VEX 硬件，电脑上的单元测试和性能测试可以直接用。
+//
+// ============================================================================
+#include "localization/odometry.h"
+#include "localization/pose_history.h"
+#include "localization/vision_geometry.h"
+#include <stdint.h>
+
+/// 粒子滤波统计
+struct ParticleFilterStats {
+    unsigned long updates;    ///< 融合过的标签帧数（finish_update 次数）
+    unsigned long resamples;  ///< 重采样次数
+    unsigned long injected;   ///< 累计撒下的恢复粒子数
+    double        ess;        ///< 最近一次的有效粒子数（越接近 n 越健康）
+    double        w_slow;     ///< 长期平均似然
+    double        w_fast;     ///< 短期平均似然（明显低于长期 = 可能被撞了）
+};
+
+class ParticleFilter {
+public:
+    ParticleFilter();
+    ~ParticleFilter();
+
+    /// 分配粒子内存（整个程序只调用一次；之后不再分配）
+    /// @return false = 已经分配过，或 count 不合法
+    bool init(int count, uint32_t seed = 12345);
+
+    /// 粒子数（还没 init 时为 0）
+    int count() const { return _n; }
+
+    /// 把所有粒子撒在 pose 周围（PF_INIT_SIGMA_*），权重相等
+    void reset(const Pose& pose);
+
+    /// 预测：每个粒子按里程计增量走一步，再加各自的随机误差
+    void predict(const OdomDelta& delta);
+
+    /// 累加一个标签测量的对数似然（同一帧的多个标签依次调用）
+    void update_tag(const TagMeasurement& meas);
+
+    /// 一帧标签都加完后调用：更新权重、判断要不要重采样 / 撒恢复粒子
+    /// @return true = 这次做了重采样
+    bool finish_update();
+
+    /// 加权平均位姿
+    Pose estimate() const;
+
+    const ParticleFilterStats& stats() const { return _stats; }
+
+    /// 只读访问（测试用）
+    const float* x() const { return _x; }
+    const float* y() const { return _y; }
+    const float* theta() const { return _th; }
+
+private:
+    ParticleFilter(const ParticleFilter&);             // 不可拷贝（持有内存）
+    ParticleFilter& operator=(const ParticleFilter&);
+
+    uint32_t next_random();
+    float    uniform();
+    float    gaussian();
+    void     fill_noise(float* out);
+    void     compute_weights(float* w, double* sum_w, double* sum_w2) const;
+    void     resample(int inject, double sum_w);
+    void     scatter(int from, const Pose& center, double sigma_xy, double sigma_theta);
+
+    int      _n;
+    float*   _arena;                  // 一整块内存，下面的数组都指向它
+    float*   _x;  float* _y;  float* _th;  float* _c;  float* _s;   // 粒子（cos/sin 跟着 θ）
+    float*   _x2; float* _y2; float* _th2; float* _c2; float* _s2;  // 重采样的目标，做完交换
+    float*   _logw;                   // 对数权重（累积，重采样后清零）
+    float*   _ll;                     // 这一帧的对数似然
+    float*   _w;                      // 临时：归一化后的权重
+    float*   _noise0; float* _noise1; float* _noise2;  // 预测用的随机数
+    float*   _normal_table;           // 预先算好的标准正态随机数
+    int      _frame_tags;             // 这一帧加了几个标签
+    uint32_t _rng;
+    ParticleFilterStats _stats;
+};
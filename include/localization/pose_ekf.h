@@ -0,0 +1,80 @@
+#pragma once
+// ============================================================================
+//  localization/pose_ekf.h — 扩展卡尔曼滤波（EKF）：里程计 + IMU + AprilTag
+// ============================================================================
+//
+//  【和原来的互补滤波有什么不同？】
+//    互补滤波每次都用固定的比例 α 去拉位置："视觉说在这，我就往那边挪 40%"。
+//    它不知道自己现在有多不确定：刚重置完（很准）和跑了 30 秒（可能偏了 10 cm）
+//    用的是同一个 α；而且它只修正 x/y，从来不修正航向。
+//
+//    卡尔曼滤波多记了一样东西——协方差 P（"我对自己的位置有多没把握"）：
+//    • 预测（每次里程计更新）：走得越多、转得越多，P 越大
+//    • 更新（每次看到标签）：按 P 和测量噪声的比例决定信谁多一点，P 变小
+//    • 测量量是"距离 + 方位角"，所以方位角能顺便把航向也修正了
+//
+//  【状态】
+//    x = [x, y, θ]（米, 米, 弧度），P 是 3×3 协方差。
+//
+//  【门限（gating）】
+//    测量和预测差得太多（马氏距离² > EKF_GATE_CHI2）→ 认为是误检，拒绝。
+//    马氏距离把 P 也考虑进去了：越不确定，能接受的偏差越大。
+//
+//  【被撞偏以后怎么找回来？】
+//    被撞了一下里程计看不见，P 还很小，之后每个标签都"差太多"被拒绝——
+//    只靠门限的话滤波器再也回不来。所以连续 EKF_RECOVERY_GATED_TAGS 个标签
+//    都被拒绝（中间没有一个被接受）时，不再当它们是误检：
+//    把 P 放大 EKF_RECOVERY_SIGMA_*，同一个标签重新过一次门限，
+//    之后的标签按放大后的 P 很快把位姿拉回来。偶尔一个误检凑不够这么多个。
+//
+//  全部是固定大小的小矩阵（localization/matrix.h），不分配堆内存。
+//  这个文件不依赖 VEX 硬件，电脑上的单元测试和性能测试可以直接用。
+//
+// ============================================================================
+#include "localization/matrix.h"
+#include "localization/odometry.h"
+#include "localization/pose_history.h"
+#include "localization/vision_geometry.h"
+
+/// 一次标签更新的结果
+enum EkfUpdateResult {
+    EKF_UPDATE_ACCEPTED = 0,  ///< 已融合
+    EKF_UPDATE_GATED,         ///< 偏差超过门限，被拒绝
+    EKF_UPDATE_INVALID        ///< 测量本身不能用（距离太近 / 矩阵奇异）
+};
+
+/// 滤波器统计
+struct EkfStats {
+    unsigned long predicts;  ///< 预测次数
+    unsigned long accepted;  ///< 融合成功的标签测量
+    unsigned long gated;     ///< 被门限拒绝的标签测量
+    unsigned long recoveries;///< 连续被拒绝太多、放大协方差的次数
+    double        last_nis;  ///< 最近一次测量的马氏距离²（NIS）
+};
+
+class PoseEkf {
+public:
+    PoseEkf();
+
+    /// 重新开始：位姿 = pose，不确定度 = 配置里的初始值
+    void reset(const Pose& pose);
+
+    /// 直接改位姿（外部修正），协方差保持不变
+    void set_pose(const Pose& pose);
+
+    const Pose&          pose() const { return _pose; }
+    const Matrix<3, 3>&  covariance() const { return _P; }
+    const EkfStats&      stats() const { return _stats; }
+
+    /// 预测：用一步里程计增量推进位姿，并把这一步的噪声加进协方差
+    void predict(const OdomDelta& delta);
+
+    /// 更新：融合一个标签的距离 + 方位角测量
+    EkfUpdateResult update_tag(const TagMeasurement& meas);
+
+private:
+    Pose         _pose;
+    Matrix<3, 3> _P;
+    EkfStats     _stats;
+    int          _gated_run;   // 连续被门限拒绝的标签数（接受一个就清零）
+};
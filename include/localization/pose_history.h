@@ -0,0 +1,96 @@
+#pragma once
+// ============================================================================
+//  localization/pose_history.h — 带时间戳的位姿历史（"刚才我在哪？"）
+// ============================================================================
+//
+//  【为什么需要它？】
+//    摄像头拍照 → 识别标签 → 算出位置，等结果出来时已经过去了几十毫秒，
+//    机器人早就往前开了一段。如果把"几十毫秒前的位置"直接和"现在的位置"
+//    融合，就会把机器人往回拽。
+//    正确的做法是：在拍照的那个时刻比较、修正，再把之后走过的路"重放"一遍。
+//
+//  【存了什么？】
+//    里程计每次更新存一条：时间戳 + 更新后的位姿 + 这一步的增量（机器人坐标系）。
+//    固定大小的环形缓冲区（POSE_HISTORY_CAPACITY 条），满了覆盖最旧的，不分配内存。
+//
+//  【两个操作】
+//    pose_at(t)         二分查找 t 前后两条记录，线性插值  → O(log n)
+//    correct_at(t, p)   把 t 时刻的位姿改成 p，然后用之后每一步的增量
+//                       重新积分一遍，得到修正后的"现在"                → O(n)
+//    shift_at(t, Δ)     同上，只是给的是修正量 Δ 而不是修正后的位姿      → O(n)
+//
+//        t0    t1    t2    t3    t4  (现在)
+//        ●─────●─────●─────●─────●
+//                    ↑ 在 t2 修正
+//                    ◆─────◆─────◆   t3、t4 用原来的增量重新推算
+//
+//  这个文件不依赖 VEX 硬件，电脑上的单元测试可以直接用。
+//
+// ============================================================================
+#include "config.h"
+#include "localization/odometry.h"
+#include <stdint.h>
+
+/// 一次里程计更新的增量（机器人坐标系，已经补偿过旋转引起的假位移）
+struct OdomDelta {
+    double forward;  ///< 向前走了多远（米）
+    double lateral;  ///< 向侧面滑了多远（米）
+    double dtheta;   ///< 转了多少（弧度）
+};
+
+/// 历史里的一条记录
+struct PoseHistoryEntry {
+    uint64_t  time_us;  ///< 这次更新的时刻（get_time_us()）
+    Pose      pose;     ///< 更新后的位姿
+    OdomDelta delta;    ///< 这次更新的增量
+};
+
+/// 把一步增量积分到位姿上（按 ODOM_INTEGRATOR 选的方法，里程计和重放共用）
+Pose pose_integrate(const Pose& start, const OdomDelta& delta);
+
+/// 指定积分方法（ODOM_INTEGRATOR_MIDPOINT / _ARC / _RK2；性能测试用来比较）
+Pose pose_integrate_with(int integrator, const Pose& start, const OdomDelta& delta);
+
+class PoseHistory {
+public:
+    PoseHistory();
+
+    /// 清空（set_pose 重置里程计时调用）
+    void clear();
+
+    /// 追加一条记录（时间必须不早于上一条）；满了覆盖最旧的
+    void push(uint64_t time_us, const Pose& pose, const OdomDelta& delta);
+
+    /// 当前记录条数
+    int size() const { return _count; }
+
+    /// 第 i 条记录（0 = 最旧）
+    const PoseHistoryEntry& at(int i) const;
+
+    /// 查询 t 时刻的位姿（前后两条记录之间线性插值）
+    /// t 晚于最新一条时返回最新位姿
+    /// @return false = 历史为空，或 t 早于最旧的一条（已经被覆盖了）
+    bool pose_at(uint64_t time_us, Pose* out) const;
+
+    /// 把 t 时刻的位姿改成 corrected，并用之后的增量重新推算到现在
+    /// 修正施加在 t 之前（含）最近的那一条记录上（误差不超过一个周期）
+    /// @param newest  输出：修正后的最新位姿（可以为 nullptr）
+    /// @return false = t 不在历史范围内，什么都没改
+    bool correct_at(uint64_t time_us, const Pose& corrected, Pose* newest);
+
+    /// 把 t 时刻的位姿挪动 offset（dx, dy, dθ），并用之后的增量重新推算到现在
+    /// 和 correct_at 的区别：t 落在两条记录之间时，修正量照样对（不会把
+    /// t 之前那一小段路程也"修正"掉）——调用者手里只有 t 时刻插值出来的位姿时用它
+    /// @return false = t 不在历史范围内，什么都没改
+    bool shift_at(uint64_t time_us, const Pose& offset, Pose* newest);
+
+private:
+    /// 时间不晚于 t 的最后一条记录的序号；没有返回 -1（二分查找）
+    int find_index(uint64_t time_us) const;
+
+    PoseHistoryEntry& entry(int i) { return _entries[(_oldest + i) % POSE_HISTORY_CAPACITY]; }
+
+    PoseHistoryEntry _entries[POSE_HISTORY_CAPACITY];
+    int              _oldest;  // 最旧一条在数组里的位置
+    int              _count;
+};
@@ -0,0 +1,48 @@
+#pragma once
+// ============================================================================
+//  localization/twist_estimator.h — 从里程计增量估计速度和加速度
+// ============================================================================
+//
+//  【为什么里程计要顺便算速度？】
+//    里程计每 10 ms 都算出"这一步走了多远、转了多少"，除以真实 dt 就是速度。
+//    以前这些增量用完就扔了，运动控制想知道"我现在多快"只能自己对位姿求差分——
+//    而位姿会被视觉修正突然拽一下，差分出来就是一个假的大速度。
+//    用增量算不会有这个问题：视觉修正只改位姿，不改"这一步走了多远"。
+//
+//  【滤波】
+//    追踪轮编码器一格在 10 ms 里就是好几 cm/s 的跳动，所以用一阶低通：
+//      v ← v + α (v_raw − v)，   α = dt / (τ + dt)
+//    用真实 dt 算 α：这一拍晚了，新读数的分量也相应大一点。
+//    加速度是滤波后速度的差分，噪声更大，用更长的时间常数再滤一次。
+//
+//  【坐标系】
+//    速度在机器人坐标系里（前方 / 左方 / 逆时针），和 OdomDelta 一样，
+//    不随场地坐标系的修正跳变；控制器要的正好是"车自己往前多快"。
+//
+//  这个文件不依赖 VEX 硬件，电脑上的单元测试可以直接用。
+//
+// ============================================================================
+#include "localization/odometry.h"
+#include "localization/pose_history.h"
+
+class TwistEstimator {
+public:
+    TwistEstimator();
+
+    /// 清零（set_pose 重置里程计时调用：编码器归零那一拍的增量不是真的运动）
+    void reset();
+
+    /// 用一次里程计更新的增量和真实 dt 更新速度（dt <= 0 时忽略）
+    void update(const OdomDelta& delta, double dt);
+
+    /// 滤波后的速度（米/秒、弧度/秒）
+    const Twist& velocity() const { return _velocity; }
+
+    /// 滤波后的加速度（米/秒²、弧度/秒²；ODOM_ESTIMATE_ACCEL = false 时恒为 0）
+    const Twist& accel() const { return _accel; }
+
+private:
+    Twist _velocity;
+    Twist _accel;
+    bool  _primed;   // 第一拍没有"上一次速度"，不算加速度
+};
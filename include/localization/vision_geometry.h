@@ -0,0 +1,103 @@
+#pragma once
+// ============================================================================
+//  localization/vision_geometry.h — 视觉定位的几何计算（赛场标签地图 + 公式）
+// ============================================================================
+//
+//  【为什么单独放一个文件？】
+//    这里全是纯数学：标签在哪、从像素算距离和方位、从距离和方位反推位置、
+//    互补滤波怎么混合……不碰摄像头、不碰里程计。
+//    视觉定位（vision_localizer.cpp）、卡尔曼滤波（pose_ekf.cpp）、
+//    以及电脑上的单元测试和性能测试都用同一套公式。
+//
+//  【方位角的约定】
+//    bearing = 标签相对摄像头正前方的角度，图片中心 = 0，偏右为正。
+//    赛场方位 = 机器人航向 + VISION_CAMERA_ANGLE + bearing
+//
+// ============================================================================
+#include "localization/matrix.h"
+#include "localization/odometry.h"
+
+/// 赛场上一个 AprilTag 标签的已知信息
+struct FieldTag {
+    int    id;      ///< 标签 ID（必须和实际贴的标签上的数字一致）
+    double x;       ///< 在赛场上的 X 坐标（米）
+    double y;       ///< 在赛场上的 Y 坐标（米）
+    double z;       ///< 离地面的高度（米）—— 用来修正距离估算
+    double facing;  ///< 标签朝向（弧度）—— 标签表面法线的方向
+};
+
+/// 对一个标签的一次测量（给卡尔曼滤波用）
+struct TagMeasurement {
+    int    id;          ///< 标签 ID
+    double tag_x;       ///< 标签在赛场上的 X 坐标（米）
+    double tag_y;       ///< 标签在赛场上的 Y 坐标（米）
+    double range;       ///< 摄像头到标签的距离（米）
+    double bearing;     ///< 标签相对摄像头正前方的方位角（弧度）
+    double confidence;  ///< 置信度 [0, 1]
+};
+
+/// 赛场标签地图
+extern const FieldTag FIELD_TAGS[];
+/// 地图里的标签数
+extern const int      NUM_FIELD_TAGS;
+
+/// 查找标签 ID 对应的赛场已知位置。找不到返回 nullptr
+const FieldTag* find_field_tag(int id);
+
+/// 用"小孔成像模型"从标签像素大小估算距离；标签太小返回 -1
+double vision_estimate_distance(double pixel_size);
+
+/// 从标签在图片里的水平位置估算方位角（图片中心 = 0，偏右为正）
+double vision_estimate_bearing(double center_x);
+
+/// 置信度 [0, 1]：距离越近、标签越大越可信
+double vision_compute_confidence(double distance, double pixel_size);
+
+/// 摄像头在赛场上的位置（机器人中心 + 旋转后的安装偏移）
+void vision_camera_position(const Pose& robot, double* cam_x, double* cam_y);
+
+/// 测量模型：机器人在 robot 时，应该看到标签在多远、什么方位
+/// 卡尔曼滤波和多标签联合求解用的是同一个模型
+/// @param H  不为 nullptr 时顺便算雅可比 ∂(距离, 方位)/∂(x, y, θ)
+/// @return false = 摄像头和标签几乎重合，算不了
+bool vision_predict_tag(const Pose& robot, double tag_x, double tag_y,
+                        double* range, double* bearing, Matrix<2, 3>* H);
+
+/// 把拍照时刻的测量"搬"到现在：机器人在 then 拍的照，现在已经走到 now 了，
+/// 同一个标签从 now 看过去应该是什么距离和方位
+///   先用 then 把测量变成标签在里程计坐标系里的点，再从 now 看这个点。
+///   then 和 now 都是里程计位姿，只用到两者之间的相对运动（短时间内很准），
+///   里程计本身偏了多少不影响——那正是测量要去修正的东西
+/// 卡尔曼滤波和粒子滤波只会"在现在"融合测量，所以先搬过来再交给它们
+/// @return 搬过来的测量（id、标签坐标、置信度不变；算不了时原样返回）
+TagMeasurement vision_carry_forward(const TagMeasurement& meas, const Pose& then, const Pose& now);
+
+/// 从一个标签的距离和方位反推机器人中心的位置（航向用 robot_theta）
+void vision_robot_from_tag(double tag_x, double tag_y, double range, double bearing,
+                           double robot_theta, double* x, double* y);
+
+/// 从一个标签估计机器人航向（不需要知道机器人在哪）
+///   斜着看的角度 |a| = acos(宽 / 高)（标签宽度被压扁，高度不变）
+///   航向 = 标签朝向 + π + a − 方位角 − 摄像头安装角
+///   a 的正负号从宽高比看不出来，取离 near_theta（里程计航向）近的那个
+/// @param facing      标签朝向（FieldTag::facing）
+/// @param width_px    标签在图片里的宽度
+/// @param height_px   标签在图片里的高度
+/// @param bearing     方位角（vision_estimate_bearing）
+/// @param near_theta  里程计的航向（选正负号、结果也展开到它附近）
+/// @param heading     输出：估计的航向
+/// @param sigma       输出：估计的标准差（弧度；正对着标签时很大）
+/// @return false = 标签太小算不了
+bool vision_heading_from_tag(double facing, double width_px, double height_px, double bearing,
+                             double near_theta, double* heading, double* sigma);
+
+/// 航向置信度 [0, 1]：1 / (1 + (σ / VISION_HEADING_SIGMA_REF)²)
+double vision_heading_confidence(double sigma);
+
+/// 有上限的航向修正：往 heading 拉 α × 置信度，每次最多 VISION_HEADING_MAX_STEP_RAD，
+/// 差超过 VISION_HEADING_MAX_ERROR_RAD 就不改。x、y 不变
+Pose vision_blend_heading(const Pose& current, double heading, double heading_confidence);
+
+/// 互补滤波：新位置 = (1-α) × 当前 + α × 视觉，α = 基础 α × 置信度（有上限）
+/// 航向不变（这个方法不修正航向）
+Pose vision_blend_pose(const Pose& current, double est_x, double est_y, double confidence);
@@ -16,51 +16,85 @@
 //    4. 从标签在图片中的水平位置 → 估算方位角
 //    5. 已知标签位置 + 距离 + 方位角 → 算出机器人的位置
 //    6. 把结果和里程计的位置加权融合（不是直接替换，而是慢慢修正）
+//       也可以用卡尔曼滤波或粒子滤波，见 config.h 的 VISION_FUSION_MODE
 //
 //  【为什么不只用里程计？】
 //    里程计有"累积误差"——走得越远，偏差越大。
 //    视觉定位提供"绝对位置"——直接告诉你你在哪，不会累积偏差！
 //    两者结合：里程计提供高频平滑更新，视觉提供低频绝对校正。
 //
+//  【两个任务流水线】
+//    拍照任务按传感器的帧率拍（vision_snapshot()，会阻塞一会儿），
+//    估算任务只拿最新的一帧来算，算不过来的老帧直接跳过。
+//    拍照不再被计算拖慢，计算也不用等拍照。
+//
 //  【局限性】
 //    • 需要能看到至少一个标签（被挡住就没法定位）
 //    • 更新速度受摄像头帧率限制（约 15-30 fps）
+//    • 结果出来时画面已经是几十毫秒前的了：按拍摄时刻的位姿算、再补到现在
+//      （VISION_CAPTURE_LATENCY_MS），全速行驶时修正也不会把车往回拽
 //    • 距离太远（>2米）精度会下降（标签在图片里太小了）
 //
 // ============================================================================
-#include "localization/odometry.h"
-
-/// 赛场上一个 AprilTag 标签的已知信息
-struct FieldTag {
-    int    id;      ///< 标签 ID（必须和实际贴的标签上的数字一致）
-    double x;       ///< 在赛场上的 X 坐标（米）
-    double y;       ///< 在赛场上的 Y 坐标（米）
-    double z;       ///< 离地面的高度（米）—— 用来修正距离估算
-    double facing;  ///< 标签朝向（弧度）—— 标签表面法线的方向
-};
+#include "hal/vision.h"
+#include "telemetry/loop_stats.h"
+#include "localization/vision_geometry.h"
 
 /// 一次视觉定位的结果
 struct VisionEstimate {
     double x;           ///< 估算出的机器人 X 坐标（米）
     double y;           ///< 估算出的机器人 Y 坐标（米）
-    double heading;     ///< 估算出的航向（弧度，目前直接用里程计的）
-    double confidence;  ///< 置信度 [0, 1]（基于距离和标签大小，越大越可信）
+    double heading;     ///< 估算出的航向（弧度；heading_confidence = 0 时就是里程计的）
+    double heading_sigma;       ///< 航向估计的标准差（弧度）
+    double heading_confidence;  ///< 航向置信度 [0, 1]（0 = 这一帧估不出航向）
+    double confidence;  ///< 置信度 [0, 1]（基于距离和标签大小，越大越可信；多标签时合起来算）
+    int    tags_used;   ///< 位置是几个标签算出来的（1 = 单标签，≥ 2 = 多标签联合求解）
     bool   valid;       ///< false = 没有可用的检测结果
+    TagMeasurement tags[VISION_MAX_TAGS];  ///< 这次看到的每个已知标签（给卡尔曼滤波用）
+    int            tag_count;              ///< tags 里的有效条数
+    uint64_t       capture_time_us;        ///< 画面的拍摄时刻（0 = 历史里查不到，按"现在"算的）
+    Pose           capture_pose;           ///< 拍摄时刻的里程计位姿（上面的结果都是相对它算的）
+};
+
+/// 视觉流水线的计数（拍照任务 → 估算任务）
+struct VisionPipelineStats {
+    uint32_t     captured;    ///< 发布了多少帧（= 最新一帧的帧号）
+    uint32_t     processed;   ///< 估算了多少帧
+    uint32_t     stale;       ///< 没估算就被更新的帧顶掉的，加上太老（VISION_MAX_FRAME_AGE_MS）丢掉的
+    uint32_t     no_buffer;   ///< 拍了但没缓冲可写、根本没发布的（vision_dropped_snapshots()）
+    LogHistogram age_us;      ///< 估算完成时这一帧有多老（拍摄时刻 → 结果出来，微秒）
 };
 
 /// 初始化视觉定位器（在 vision_init() 之后调用）
 void vision_localizer_init();
 
-/// 拍照 + 处理所有检测到的标签，返回最佳的位置估算
-/// 内部会自动调用 vision_snapshot()
-/// @return 位置估算结果（使用前检查 .valid）
+/// 估算阶段：借看最新发布的一帧，没处理过就处理所有检测到的标签，返回最佳的位置估算
+/// 标签够 VISION_MULTI_TAG_MIN_TAGS 个时所有标签一起解（localization/multi_tag.h），
+/// 否则（或者标签互相矛盾时）用置信度最高的单个标签
+/// 用拍摄时刻（不是现在）的里程计位姿来算；不拍照，拍照是 vision_snapshot() 的事
+/// 中间漏掉的帧只计数不补算——只有最新的一帧有用
+/// @return 位置估算结果（没有新帧、帧太老、没看到标签时 .valid = false）
+VisionEstimate vision_localizer_estimate_latest();
+
+/// 拍一张照再估算（vision_snapshot() + vision_localizer_estimate_latest()）
+/// 拍照和估算在同一个任务里时用；比赛程序用两个任务分开跑（见 main.cpp）
 VisionEstimate vision_localizer_update();
 
 /// 把视觉定位结果融合到里程计中
-/// 使用"互补滤波器"：新位置 = (1-α) × 里程计 + α × 视觉
+/// 使用"互补滤波器"：新位置 = (1-α) × 里程计 + α × 视觉；
+/// 估出了航向时再做一次有上限的航向修正（每帧最多 VISION_HEADING_MAX_STEP_RAD）
+/// 多标签联合解的置信度是几个标签合起来的，α 自然就更大
+/// 修正量在拍摄时刻算，再用之后的里程计增量带到现在（odometry_shift_at）；
+/// 卡尔曼滤波 / 粒子滤波模式下先把测量搬到现在（vision_carry_forward）
 /// 这样不会因为一次不准的视觉读数就让位置跳来跳去
-/// @param estimate  来自 vision_localizer_update() 的结果
+/// @param estimate  来自 vision_localizer_estimate_latest() 的结果
 void vision_correct_odometry(const VisionEstimate& estimate);
 
 /// Get the number of tags detected in the last update.
 int vision_localizer_tag_count();
+
+/// 流水线计数（给屏幕和日志看；读的时候估算任务可能正在加一，差一两次无所谓）
+VisionPipelineStats vision_localizer_stats();
+
+/// 把流水线计数写进日志（INFO 级别，一行）
+void vision_localizer_log_stats();
@@ -0,0 +1,106 @@
+#pragma once
+// ============================================================================
+//  telemetry/block_stream.h — 按大块攒数据、整块写 SD 卡的字节流缓冲
+// ============================================================================
+//
+//  【为什么要攒成大块？】
+//    SD 卡按"扇区"（512 字节）读写。每次只写 40 字节，卡里面其实也要
+//    读-改-写一整个扇区，又慢又伤卡。把数据在内存里攒满一个大块
+//    （比如 4096 字节 = 8 个扇区）再一次写进去，效率高得多。
+//
+//  【两个角色】
+//    生产者（100 Hz 的日志任务）：append() 把记录字节拷进"正在填的块"，
+//        填满了就把块标记为"待写"，接着填下一个空闲块。
+//    消费者（低优先级写卡任务）：acquire() 拿到最早的待写块，写完 release()。
+//
+//    记录可以跨块（前半截在块 A 结尾，后半截在块 B 开头），
+//    因为文件本身就是一条连续的字节流，块只是"写入粒度"。
+//
+//  【满了怎么办？】
+//    如果写卡跟不上、所有块都在等待写入，append() 返回 false，
+//    这条记录直接丢弃（调用者计数）。生产者永远不会被 SD 卡拖慢。
+//
+// ============================================================================
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+template <int BLOCK_BYTES, int NUM_BLOCKS>
+class BlockStream {
+    static_assert(NUM_BLOCKS >= 2, "BlockStream needs at least two blocks");
+
+public:
+    BlockStream() : _fill_index(0), _fill_pos(0), _write_index(0) {
+        for (int i = 0; i < NUM_BLOCKS; ++i) {
+            _state[i].store(BLOCK_FREE, std::memory_order_relaxed);
+            _length[i] = 0;
+        }
+    }
+
+    /// 生产者：追加 len 字节（len 不能超过 BLOCK_BYTES）
+    /// 要么整条写进去，要么一个字节都不写
+    /// @return false = 没有空闲块，数据被丢弃
+    bool append(const uint8_t* data, int len) {
+        if (len <= 0 || len > BLOCK_BYTES) return false;
+        if (_state[_fill_index].load(std::memory_order_acquire) != BLOCK_FREE) return false;
+
+        int room = BLOCK_BYTES - _fill_pos;
+        if (len > room) {
+            // 放不下 → 需要下一个块，先确认它是空闲的
+            int next = (_fill_index + 1) % NUM_BLOCKS;
+            if (_state[next].load(std::memory_order_acquire) != BLOCK_FREE) return false;
+        }
+
+        int first = (len < room) ? len : room;
+        memcpy(&_blocks[_fill_index][_fill_pos], data, first);
+        _fill_pos += first;
+        if (_fill_pos == BLOCK_BYTES) {
+            seal_current();
+        }
+        if (first < len) {
+            memcpy(&_blocks[_fill_index][0], data + first, len - first);
+            _fill_pos = len - first;
+        }
+        return true;
+    }
+
+    /// 生产者：把当前没填满的块也交给写卡任务（比如比赛结束前刷盘）
+    void seal() {
+        if (_fill_pos > 0) seal_current();
+    }
+
+    /// 消费者：取最早的待写块
+    /// @param len  输出：块里有效数据的字节数
+    /// @return 块数据指针；没有待写块时返回 nullptr
+    const uint8_t* acquire(int* len) {
+        if (_state[_write_index].load(std::memory_order_acquire) != BLOCK_READY) return nullptr;
+        *len = _length[_write_index];
+        return _blocks[_write_index];
+    }
+
+    /// 消费者：这个块写完了，还给生产者
+    void release() {
+        _state[_write_index].store(BLOCK_FREE, std::memory_order_release);
+        _write_index = (_write_index + 1) % NUM_BLOCKS;
+    }
+
+    static int block_bytes() { return BLOCK_BYTES; }
+
+private:
+    enum { BLOCK_FREE = 0, BLOCK_READY = 1 };
+
+    void seal_current() {
+        _length[_fill_index] = _fill_pos;
+        _state[_fill_index].store(BLOCK_READY, std::memory_order_release);
+        _fill_index = (_fill_index + 1) % NUM_BLOCKS;
+        _fill_pos = 0;
+    }
+
+    uint8_t          _blocks[NUM_BLOCKS][BLOCK_BYTES];
+    int              _length[NUM_BLOCKS];   // 每个待写块的有效字节数
+    std::atomic<int> _state[NUM_BLOCKS];    // BLOCK_FREE / BLOCK_READY
+
+    int _fill_index;   // 生产者正在填的块
+    int _fill_pos;     // 生产者在这个块里写到哪了
+    int _write_index;  // 消费者下一个要写的块
+};
@@ -0,0 +1,82 @@
+#pragma once
+// ============================================================================
+//  telemetry/byte_order.h — 固定小端序的读写辅助函数（二进制文件格式共用）
+// ============================================================================
+//
+//  【为什么要一个字节一个字节地拼？】
+//    直接 memcpy 整个结构体也行，但编译器可能在字段之间塞"填充字节"，
+//    不同平台（机器人 ARM / 电脑 x86）的结构体布局也可能不同。
+//    手动按固定顺序、固定字节序写入，保证两边读出来完全一样。
+//
+// ============================================================================
+#include <stdint.h>
+#include <string.h>
+
+static inline void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void put_f32(uint8_t* p, float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));  // 取出 float 的原始 32 位
+    put_u32(p, bits);
+}
+
+static inline uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline float get_f32(const uint8_t* p) {
+    uint32_t bits = get_u32(p);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// ---- 变长整数（varint）----
+// 每个字节存 7 位，最高位 = 1 表示"后面还有"。小数字只要 1 字节：
+//   0..127 → 1 字节   128..16383 → 2 字节   …   最大 5 字节
+static inline int put_varint(uint8_t* p, uint32_t v) {
+    int n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+/// @return 读了几个字节；0 = 数据不完整或格式错误
+static inline int get_varint(const uint8_t* p, int len, uint32_t* v) {
+    uint32_t result = 0;
+    for (int i = 0; i < len && i < 5; ++i) {
+        result |= (uint32_t)(p[i] & 0x7F) << (7 * i);
+        if ((p[i] & 0x80) == 0) {
+            *v = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// ---- zigzag：把有符号数"折叠"成无符号数，让 -1 也只占 1 字节 ----
+//   0 → 0   -1 → 1   1 → 2   -2 → 3   2 → 4 …
+static inline uint32_t zigzag_encode(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t zigzag_decode(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
@@ -0,0 +1,232 @@
+#pragma once
+// ============================================================================
+//  telemetry/channel_log.h — 遥测通道表 + 差分编码（写日志只记"变了多少"）
+// ============================================================================
+//
+//  【以前的问题】
+//    想多记一个信号，要改记录结构体、改编码函数、改解码函数、改 CSV 表头……
+//    而且每条记录固定 40 字节，机器人停着不动也照样每周期写 40 字节。
+//
+//  【通道表：每个信号只声明一次】
+//    const ChannelDef<OdomRecord> ODOM_CHANNELS[] = {
+//        // 名字   单位    结构体字段           分辨率   每几帧采一次
+//        { "x",   "m",   &OdomRecord::x,       1e-4f,  1 },
+//        ...
+//    };
+//    编码器（模板）按这张表自动从结构体里取值；
+//    表本身也会写进文件头（"schema"），电脑端解码器读文件头就知道
+//    有哪些通道、叫什么、单位、类型是什么——解码器不需要跟着改。
+//
+//    注意：通道表是编译期就定好的常量，但 schema 字节不是编译期生成的——
+//    打开日志文件时 channel_schema_encode 把表序列化一次（运行时），
+//    之后每帧都不再碰它。
+//
+//  【通道类型】
+//    CHANNEL_F32：float 字段，按分辨率量化（有损，误差 ≤ 半个分辨率）
+//    CHANNEL_I32：int32_t 字段（计数器、状态码……），原样差分，不量化、没有误差，
+//                 声明时不写分辨率：{ "state", "", &Rec::state, 1 }
+//    其他整数类型（uint8_t、bool……）先在记录结构体里存成 int32_t。
+//
+//  【差分 + 变长整数编码】
+//    ① 量化：值 ÷ 分辨率 → 整数（x = 1.23456 m，分辨率 0.1 mm → 12346）
+//    ② 差分：只记和上一帧的差（机器人慢慢动时差值很小，停下时为 0）
+//    ③ zigzag + varint：小差值只占 1 字节（见 telemetry/byte_order.h）
+//    ④ 变化掩码：差值为 0 的通道一个字节都不写
+//
+//    一帧的格式：
+//      varint  (时间差 << 1) | 关键帧标记      关键帧时是绝对时间
+//      varint  变化掩码（第 i 位 = 通道 i 这一帧有数据）
+//      varint  × 掩码里 1 的个数：zigzag(差值)
+//
+//    关键帧：所有通道都从 0 开始算差值（= 完整数值）。文件第一帧、
+//    每隔 N 帧、以及有帧被丢弃之后都写关键帧，解码可以从这里重新同步。
+//
+//  【每帧开销】
+//    每个通道只有一次乘除 + 几次整数运算，没有任何 printf 格式化，
+//    多加一个通道只多几条指令。
+//
+// ============================================================================
+#include "telemetry/byte_order.h"
+#include <cmath>
+#include <stdint.h>
+#include <string.h>
+
+/// 通道数上限（变化掩码是 32 位）
+constexpr int CHANNEL_MAX       = 32;
+/// 通道名最长字符数（含结尾 '\0'）
+constexpr int CHANNEL_NAME_MAX  = 16;
+/// 单位最长字符数（含结尾 '\0'）
+constexpr int CHANNEL_UNIT_MAX  = 8;
+
+/// 通道的值类型（写进 schema，每个通道 1 字节）
+enum ChannelType : uint8_t {
+    CHANNEL_F32 = 0,   ///< float，按分辨率量化
+    CHANNEL_I32 = 1,   ///< int32_t，原样记录
+};
+
+/// 一个通道的声明（机器人端，编译期常量表）
+/// 字段类型决定通道类型：float 字段要写分辨率，int32_t 字段不写
+template <typename Record>
+struct ChannelDef {
+    const char*      name;       ///< 通道名（写进 CSV 表头）
+    const char*      unit;       ///< 单位
+    ChannelType      type;       ///< 值类型
+    float Record::*  field;      ///< float 通道：从记录结构体的哪个字段取值
+    int32_t Record::*int_field;  ///< int32 通道：从记录结构体的哪个字段取值
+    float            quantum;    ///< 分辨率（量化步长；int32 通道固定为 1）
+    uint8_t          rate_div;   ///< 每几帧采一次（1 = 每帧）
+
+    constexpr ChannelDef(const char* name, const char* unit, float Record::*field,
+                         float quantum, uint8_t rate_div)
+        : name(name), unit(unit), type(CHANNEL_F32), field(field), int_field(nullptr),
+          quantum(quantum), rate_div(rate_div) {}
+
+    constexpr ChannelDef(const char* name, const char* unit, int32_t Record::*int_field,
+                         uint8_t rate_div)
+        : name(name), unit(unit), type(CHANNEL_I32), field(nullptr), int_field(int_field),
+          quantum(1.0f), rate_div(rate_div) {}
+};
+
+/// 一个通道的描述（电脑端，从文件头里读出来）
+struct ChannelInfo {
+    char        name[CHANNEL_NAME_MAX];
+    char        unit[CHANNEL_UNIT_MAX];
+    ChannelType type;
+    float       quantum;
+    uint8_t     rate_div;
+};
+
+/// schema 的最大长度：1 字节通道数 + 每个通道（类型 1 + 采样分频 1 + 分辨率 4 + 名字 + 单位）
+constexpr int channel_schema_max_bytes(int channels) {
+    return 1 + channels * (1 + 1 + 4 + CHANNEL_NAME_MAX + CHANNEL_UNIT_MAX);
+}
+
+/// 把值量化成整数；NaN / 超范围时返回 fallback（保持上一个值）
+static inline int32_t channel_quantize(float value, float quantum, int32_t fallback) {
+    double q = (double)value / quantum;
+    if (!(q > -2.0e9 && q < 2.0e9)) return fallback;
+    return (int32_t)lround(q);
+}
+
+/// 把通道表写成 schema 字节（运行时调用，打开日志文件时写一次）
+/// 每个通道：类型(1) 采样分频(1) 分辨率(4, float) 名字('\0' 结尾) 单位('\0' 结尾)
+/// @return 写入的字节数；-1 = 名字太长或缓冲区不够
+template <typename Record, int N>
+int channel_schema_encode(const ChannelDef<Record> (&defs)[N], uint8_t* out, int size) {
+    static_assert(N >= 1 && N <= CHANNEL_MAX, "channel table must have 1..32 entries");
+    if (size < 1) return -1;
+    int n = 0;
+    out[n++] = (uint8_t)N;
+    for (int i = 0; i < N; ++i) {
+        int name_len = (int)strlen(defs[i].name) + 1;
+        int unit_len = (int)strlen(defs[i].unit) + 1;
+        if (name_len > CHANNEL_NAME_MAX || unit_len > CHANNEL_UNIT_MAX) return -1;
+        if (n + 6 + name_len + unit_len > size) return -1;
+        out[n++] = defs[i].type;
+        out[n++] = defs[i].rate_div;
+        put_f32(out + n, defs[i].quantum);
+        n += 4;
+        memcpy(out + n, defs[i].name, name_len);
+        n += name_len;
+        memcpy(out + n, defs[i].unit, unit_len);
+        n += unit_len;
+    }
+    return n;
+}
+
+/// 从 schema 字节解析通道表
+/// @return 通道数；-1 = 格式错误
+int channel_schema_decode(const uint8_t* in, int len, ChannelInfo* out, int max_channels);
+
+// ============================================================================
+//  编码器（机器人端）
+// ============================================================================
+template <typename Record, int N>
+class ChannelFrameEncoder {
+    static_assert(N >= 1 && N <= CHANNEL_MAX, "channel table must have 1..32 entries");
+
+public:
+    /// 一帧最多多少字节：时间 5 + 掩码 5 + 每个通道 5
+    static constexpr int MAX_FRAME_BYTES = 5 + 5 + 5 * N;
+
+    /// @param keyframe_interval  每隔几帧写一个关键帧
+    ChannelFrameEncoder(const ChannelDef<Record> (&defs)[N], int keyframe_interval)
+        : _defs(defs), _keyframe_interval(keyframe_interval) {
+        reset();
+    }
+
+    /// 回到初始状态（下一帧是关键帧）
+    void reset() {
+        for (int i = 0; i < N; ++i) _prev[i] = 0;
+        _prev_time        = 0;
+        _tick             = 0;
+        _frames_since_key = _keyframe_interval;
+    }
+
+    /// 下一帧强制写关键帧（上一帧没写进去、被丢弃时调用）
+    void force_keyframe() { _frames_since_key = _keyframe_interval; }
+
+    /// 编码一帧
+    /// @param out  至少 MAX_FRAME_BYTES 字节
+    /// @return 这一帧的字节数
+    int encode(uint32_t time_ms, const Record& rec, uint8_t* out) {
+        bool key = _frames_since_key >= _keyframe_interval;
+        uint32_t mask = 0;
+        int32_t deltas[N];
+        for (int i = 0; i < N; ++i) {
+            bool sampled = key || _defs[i].rate_div <= 1 || _tick % _defs[i].rate_div == 0;
+            if (!sampled) continue;
+            int32_t q    = _defs[i].type == CHANNEL_I32
+                               ? rec.*(_defs[i].int_field)
+                               : channel_quantize(rec.*(_defs[i].field), _defs[i].quantum, _prev[i]);
+            int32_t base = key ? 0 : _prev[i];
+            // 用无符号减法：就算溢出也是"绕一圈"，解码端加回去结果一样
+            deltas[i] = (int32_t)((uint32_t)q - (uint32_t)base);
+            _prev[i]  = q;
+            if (key || deltas[i] != 0) mask |= 1u << i;
+        }
+
+        uint32_t t = key ? time_ms : time_ms - _prev_time;
+        int n = put_varint(out, (t << 1) | (key ? 1u : 0u));
+        n += put_varint(out + n, mask);
+        for (int i = 0; i < N; ++i) {
+            if (mask & (1u << i)) n += put_varint(out + n, zigzag_encode(deltas[i]));
+        }
+
+        _prev_time = time_ms;
+        _tick++;
+        _frames_since_key = key ? 1 : _frames_since_key + 1;
+        return n;
+    }
+
+private:
+    const ChannelDef<Record> (&_defs)[N];
+    int      _keyframe_interval;
+    int32_t  _prev[N];           // 每个通道上一次的量化值
+    uint32_t _prev_time;
+    uint32_t _tick;
+    int      _frames_since_key;
+};
+
+// ============================================================================
+//  解码器（电脑端，只依赖文件里的 schema）
+// ============================================================================
+class ChannelFrameDecoder {
+public:
+    ChannelFrameDecoder(const ChannelInfo* channels, int count);
+
+    /// 解码一帧
+    /// @param values  输出：每个通道的当前值（count 个；int32 通道也是整数值的 double，没有误差）
+    /// @return 读了几个字节；0 = 数据不完整；-1 = 格式错误
+    int decode(const uint8_t* in, int len, uint32_t* time_ms, double* values);
+
+    /// 是否已经读到过关键帧（之前的帧没有参考值，数值无意义）
+    bool synced() const { return _synced; }
+
+private:
+    const ChannelInfo* _channels;
+    int      _count;
+    int32_t  _prev[CHANNEL_MAX];
+    uint32_t _time;
+    bool     _synced;
+};
@@ -0,0 +1,56 @@
+#pragma once
+// ============================================================================
+//  telemetry/flight_recorder.h — 飞行记录仪（"黑匣子"）
+// ============================================================================
+//
+//  【这个文件干什么？】
+//    飞机上的黑匣子一直在记录最近一段时间的所有数据，平时不往外写，
+//    出事了才把它拿出来看。这里也一样：
+//    • 每个控制周期（100 Hz）把一条完整的里程计记录放进内存环形缓冲区，
+//      只保留最近 FLIGHT_RECORDER_SAMPLES 条（默认 5 秒）——只是一次 40 字节拷贝
+//    • 平时不写 SD 卡，零 SD 开销
+//    • 出问题时（drive_to_pose 超时、视觉修正被拒绝、车手按手柄 X 键）
+//      调用 flight_recorder_trigger()，后台任务再多录 FLIGHT_RECORDER_POST_TRIGGER_MS，
+//      然后把整段数据写进 /usd/flight_NNN.bin
+//
+//  【文件格式】
+//    和二进制里程计日志完全一样（telemetry/odom_record.h），
+//    所以同一个工具就能转成 CSV：./build/odom_bin2csv flight_000.bin
+//
+// ============================================================================
+#include "telemetry/odom_record.h"
+#include <stdio.h>
+
+/// 黑匣子统计
+struct FlightRecorderStats {
+    unsigned long recorded;  ///< 总共记录过的条数
+    unsigned long skipped;   ///< 正在拷贝快照时跳过的条数
+    int           dumps;     ///< 已经写出的文件数
+    int           ignored_triggers;  ///< 冷却期内 / 超过次数上限被忽略的触发
+};
+
+/// 记录一条数据（日志任务每个控制周期调用一次，开销只有一次拷贝）
+void flight_recorder_record(const OdomRecord& rec);
+
+/// 请求把黑匣子写到 SD 卡（任何任务都能调用，不阻塞）
+/// @param reason  触发原因（必须是字符串常量，会写进日志）
+/// @return true = 已安排写出；false = 冷却中/已有待写请求/次数用完，被忽略
+bool flight_recorder_trigger(const char* reason);
+
+/// 按时间顺序（最旧 → 最新）拷贝当前缓冲区里的记录
+/// @return 拷贝的条数（最多 max_records）
+int flight_recorder_snapshot(OdomRecord* out, int max_records);
+
+/// 立即把当前缓冲区写进一个已打开的文件（阻塞，会写 SD 卡，后台任务内部使用）
+/// 写完会关闭文件
+/// @return 写出的记录条数
+int flight_recorder_dump_to(FILE* f);
+
+/// 检查一次有没有到时间该写出的触发，有就写出（后台任务每次循环调用一次）
+void flight_recorder_poll();
+
+/// 启动后台写出任务（pre_auton 调用一次）
+void flight_recorder_start();
+
+/// 读取统计
+FlightRecorderStats flight_recorder_get_stats();
@@ -0,0 +1,134 @@
+#pragma once
+// ============================================================================
+//  telemetry/loop_stats.h — 每个循环任务的耗时 / 唤醒延迟统计
+// ============================================================================
+//
+//  【为什么需要它？】
+//    里程计说自己是 100 Hz：每次算完 sleep(10ms)。但是——
+//    • 一次计算到底花了多久？（执行时间）
+//    • sleep(10ms) 之后真的 10ms 就醒了吗？视觉任务忙的时候会不会晚醒？（唤醒延迟）
+//    不测量就不知道。这个文件给每个循环记两张直方图。
+//
+//  【对数直方图】
+//    时间按 2 的幂分桶：0~1 µs、2~3、4~7、8~15、……、2^k ~ 2^(k+1)-1。
+//    24 个桶就能覆盖 0 ~ 16 秒，每次记录只是"找桶 + 加一"，没有浮点、没有分配。
+//    代价是百分位数只精确到"在哪个桶"（误差不超过 2 倍），对找问题足够了。
+//
+//  【怎么用？】
+//    static LoopStats odom_loop_stats("odom", LOOP_INTERVAL_MS);
+//    PeriodicTimer period(LOOP_INTERVAL_MS, &odom_loop_stats);
+//    while (true) {
+//        double dt = period.wait();
+//        ScopedLoopTimer timer(odom_loop_stats);  // 进入作用域 = 开始计时
+//        odometry_update(dt);
+//    }                                          // 离开作用域 = 记录耗时
+//    统计对象在构造时自动登记，loop_stats_log_report() 会把所有循环写进日志。
+//
+//  【线程安全】
+//    每个 LoopStats 只被自己的任务写；别的任务读的时候可能读到
+//    "正在加一"的计数，差一两次，作为诊断数据可以接受。
+//
+// ============================================================================
+#include <stdint.h>
+
+/// 直方图桶数：桶 k 覆盖 [2^k, 2^(k+1)-1] µs（桶 0 是 0~1 µs）
+constexpr int LOOP_HIST_BUCKETS = 24;
+
+/// 以 2 为底的对数直方图（单位：微秒）
+class LogHistogram {
+public:
+    LogHistogram();
+
+    /// 清空
+    void reset();
+
+    /// 记录一个时长（微秒）
+    void record(uint32_t us);
+
+    /// 已记录的次数
+    uint32_t count() const { return _count; }
+
+    /// 见过的最大值（精确值，不是桶边界）
+    uint32_t max() const { return _max; }
+
+    /// 百分位数（p = 0.5 表示中位数，0.99 表示 P99）
+    /// 返回所在桶的上界（不超过 max()）；没有数据时返回 0
+    uint32_t percentile(double p) const;
+
+    /// 某个时长落在哪个桶
+    static int bucket_of(uint32_t us);
+
+    /// 第 k 个桶的计数
+    uint32_t bucket(int k) const { return _buckets[k]; }
+
+private:
+    uint32_t _buckets[LOOP_HIST_BUCKETS];
+    uint32_t _count;
+    uint32_t _max;
+};
+
+/// 一个周期性循环的统计：执行时间 + 唤醒延迟
+class LoopStats {
+public:
+    /// @param name       循环名字（字符串常量，会出现在日志和屏幕上）
+    /// @param period_ms  循环每次 sleep 的毫秒数（用来算"应该什么时候醒"）
+    LoopStats(const char* name, int period_ms);
+
+    /// 每次循环开始时调用：记录"比预定时间晚醒了多久"
+    void begin();
+
+    /// 每次循环的工作做完、sleep 之前调用：记录执行时间
+    void end();
+
+    /// 循环要重新开始（比如新的一次 drive_to_pose）：
+    /// 下一次 begin() 不算唤醒延迟，因为中间并没有按周期 sleep
+    void restart() { _sleeping = false; }
+
+    /// 下一次应该在哪个时刻（微秒）醒来——按绝对截止时间睡觉时调用
+    /// （见 hal/periodic_timer.h）；不调用时按 end() + 一个周期算
+    void expect_wake_at(uint64_t due_us) { _due_us = due_us; _sleeping = true; }
+
+    /// 清空两张直方图
+    void reset();
+
+    const char*         name() const { return _name; }
+    const LogHistogram& exec_us() const { return _exec; }
+    const LogHistogram& late_us() const { return _late; }
+
+private:
+    const char*  _name;
+    uint32_t     _period_us;
+    uint64_t     _begin_us;    // 本次循环开始的时刻
+    uint64_t     _sleep_us;    // 上次进入 sleep 的时刻
+    uint64_t     _due_us;      // 预定醒来的时刻
+    bool         _sleeping;    // _due_us 是否有效
+    LogHistogram _exec;        // 执行时间
+    LogHistogram _late;        // 唤醒延迟（实际醒来 - 预定醒来）
+};
+
+/// 作用域计时器：构造时 begin()，析构时 end()
+/// 循环体里提前 break / return 也不会漏记
+class ScopedLoopTimer {
+public:
+    explicit ScopedLoopTimer(LoopStats& stats) : _stats(stats) { _stats.begin(); }
+    ~ScopedLoopTimer() { _stats.end(); }
+
+private:
+    LoopStats& _stats;
+    ScopedLoopTimer(const ScopedLoopTimer&);             // 禁止拷贝
+    ScopedLoopTimer& operator=(const ScopedLoopTimer&);
+};
+
+/// 已登记的循环个数 / 第 i 个循环
+int        loop_stats_count();
+LoopStats* loop_stats_get(int i);
+
+/// 按名字找已登记的循环（找不到返回 nullptr）
+LoopStats* loop_stats_find(const char* name);
+
+/// 把一个循环的统计格式化成一行（给屏幕和日志用）
+/// 例："odom n=1200 exec p50=63 p99=127 max=180us late p99=1023 max=1530us"
+void loop_stats_format(const LoopStats& stats, char* out, int out_size);
+
+/// 把所有已登记循环的统计写进日志（INFO 级别，每个循环一行）
+void loop_stats_log_report();
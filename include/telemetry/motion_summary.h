@@ -0,0 +1,78 @@
+#pragma once
+// ============================================================================
+//  telemetry/motion_summary.h — 每条运动命令一条统计摘要
+// ============================================================================
+//
+//  【为什么？】
+//    翻 10 Hz 的日志，最后要看的其实是几个数：这次走了多久、多久到位、
+//    最大误差多少、航向最多偏了多少、有没有超时。
+//    与其把几百行原始数据写进 SD 卡再在电脑上算，不如在机器人上边跑边统计，
+//    每条 drive_to_pose / turn_to_heading 结束时只写一行摘要。
+//
+//  【怎么用？】（在运动函数里）
+//    MotionSummary summary;
+//    summary.begin(MOTION_DRIVE, DRIVE_SETTLE_M);
+//    while (...) {
+//        ...
+//        summary.sample(dist, heading_error, left_v, right_v);
+//    }
+//    summary.finish(timed_out);   // 写一行日志，并保存为"最近一次摘要"
+//
+//  【日志里长这样】
+//    drive#3 1230ms settle=980 to=0 err max=.512 avg=.201 sd=.150 end=.012 hdg=4.1 in=2
+//      settle = 最后一次进入容差范围的时刻（从命令开始算，毫秒；超时为 -1）
+//      in     = 进入容差范围的次数（>1 说明在目标附近来回晃）
+//
+// ============================================================================
+#include "telemetry/running_stats.h"
+
+/// 运动命令种类
+enum MotionKind {
+    MOTION_DRIVE = 0,  ///< drive_to_pose（误差单位：米）
+    MOTION_TURN  = 1,  ///< turn_to_heading（误差单位：弧度）
+};
+
+/// 一条命令结束后的摘要
+struct MotionSummaryRecord {
+    MotionKind    kind;
+    int           index;            ///< 这是第几条同类命令（从 1 开始）
+    unsigned long start_ms;         ///< 开始时间
+    unsigned long duration_ms;      ///< 总耗时
+    long          settle_ms;        ///< 最后一次进入容差的时刻（相对开始）；没到位为 -1
+    bool          timed_out;        ///< 是否超时退出
+    int           tolerance_entries;///< 进入容差范围的次数
+    double        final_error;      ///< 最后一次采样的误差
+    double        peak_heading_rad; ///< 最大航向误差（绝对值）
+    double        peak_volts;       ///< 最大电机电压（绝对值）
+    RunningStats  error;            ///< 误差（绝对值）的统计
+};
+
+class MotionSummary {
+public:
+    MotionSummary();
+
+    /// 命令开始
+    /// @param tolerance  到位容差（和误差同单位），用来统计"进入容差范围"
+    void begin(MotionKind kind, double tolerance);
+
+    /// 每个控制周期采样一次
+    void sample(double error, double heading_error, double left_volts, double right_volts);
+
+    /// 命令结束：写一行日志并保存为最近一次摘要
+    void finish(bool timed_out);
+
+    /// 当前（或刚结束）命令的摘要
+    const MotionSummaryRecord& record() const { return _rec; }
+
+private:
+    MotionSummaryRecord _rec;
+    double              _tolerance;
+    bool                _in_tolerance;
+    unsigned long       _last_entry_ms;
+};
+
+/// 把一条摘要格式化成一行文字（就是写进日志的那一行）
+void motion_summary_format(const MotionSummaryRecord& rec, char* out, int out_size);
+
+/// 最近一次结束的运动命令摘要（还没有时 index 为 0）
+MotionSummaryRecord motion_summary_last();
@@ -0,0 +1,50 @@
+#pragma once
+// ============================================================================
+//  telemetry/odom_logger.h — 100 Hz 二进制里程计日志（写到 SD 卡）
+// ============================================================================
+//
+//  【怎么用？】
+//    1. pre_auton() 里调用 odom_logger_start()：
+//       在 SD 卡上新建 /usd/odom_000.bin（编号自动递增，不覆盖旧文件），
+//       并启动低优先级的写卡任务。
+//    2. 自治路线里每换一个目标点就调用 odom_logger_set_target()，
+//       这样日志里的"目标误差"才有意义。
+//    3. 日志任务每个控制周期调用一次：
+//         OdomRecord rec = odom_logger_capture();
+//         odom_logger_push(rec);
+//    4. 比赛后把 .bin 文件拷到电脑上：
+//         make tools && ./build/odom_bin2csv odom_000.bin > odom.csv
+//
+//  【开销】
+//    每条记录只是按通道表做一次差分编码（几十条整数指令，没有 snprintf、没有开关文件），
+//    机器人停着时一帧只有 2 字节，跑起来通常十几字节（以前固定 40 字节）。
+//    真正写 SD 卡的是后台任务，每攒满 4 KB 写一次。
+//
+// ============================================================================
+#include "telemetry/odom_record.h"
+#include "localization/odometry.h"
+
+/// 日志统计
+struct OdomLoggerStats {
+    unsigned long records;         ///< 成功写进缓冲区的记录数
+    unsigned long dropped;         ///< 缓冲区满了被丢弃的记录数
+    unsigned long blocks_written;  ///< 已经写进 SD 卡的块数
+};
+
+/// 打开新日志文件、写文件头并启动后台写卡任务（pre_auton 调用一次）
+void odom_logger_start();
+
+/// 设置当前运动目标（用于计算记录里的 target_error）
+void odom_logger_set_target(const Pose& target);
+
+/// 采集一条记录：当前位姿 + 目标误差 + 电机电压 + 传感器原始值
+OdomRecord odom_logger_capture();
+
+/// 把记录差分编码后放进块缓冲区（不阻塞，满了丢弃，下一帧自动写关键帧）
+void odom_logger_push(const OdomRecord& rec);
+
+/// 把还没写满的块也交给写卡任务（比如自治结束时调用，防止最后一秒数据丢失）
+void odom_logger_flush();
+
+/// 读取统计
+OdomLoggerStats odom_logger_get_stats();
@@ -0,0 +1,99 @@
+#pragma once
+// ============================================================================
+//  telemetry/odom_record.h — 二进制里程计记录格式（机器人和电脑共用）
+// ============================================================================
+//
+//  【为什么不用 CSV？】
+//    CSV 每一行都要用 snprintf 把 5 个小数变成文字，再开关一次文件，
+//    既费 CPU 又费 SD 卡带宽，所以以前只敢 10 Hz 记录。
+//    二进制格式直接把数字的"原始字节"存下来，不用格式化，
+//    可以在 100 Hz 下记录全部数据。
+//    比赛后用电脑上的 tools/odom_bin2csv 把它转回 CSV 再用 Excel 打开。
+//
+//  【两种文件格式】（文件头的版本号区分，解码工具两种都认识）
+//
+//    v1 固定长度记录（黑匣子 /usd/flight_NNN.bin 用）
+//    ┌──────────────┬──────────┬──────────┬─────┐
+//    │ 文件头 16 字节 │ 记录 0   │ 记录 1   │ ... │
+//    └──────────────┴──────────┴──────────┴─────┘
+//    文件头：魔数 "VXOD" + 版本号 1 + 单条记录长度 + 保留字节
+//    记录  ：每条 40 字节，全部按小端序（little-endian），float 为 IEEE-754 单精度
+//
+//    v2 差分编码帧（连续日志 /usd/odom_NNN.bin 用）
+//    ┌──────────────┬──────────┬────────┬────────┬─────┐
+//    │ 文件头 16 字节 │ schema   │ 帧 0   │ 帧 1   │ ... │
+//    └──────────────┴──────────┴────────┴────────┴─────┘
+//    文件头：魔数 "VXOD" + 版本号 2 + schema 长度 + 保留字节
+//    schema：通道表（名字、单位、类型、分辨率、采样分频），帧：变长（见 telemetry/channel_log.h）
+//
+//  【加一个新信号要改哪里？】
+//    ① OdomRecord 里加字段   ② ODOM_CHANNELS 表里加一行（odom_record.cpp）
+//    编码、文件头、电脑端解码和 CSV 表头都会自动跟着变。
+//
+//  这个文件不依赖任何 VEX 硬件，电脑上的解码工具也直接用它。
+//
+// ============================================================================
+#include "telemetry/channel_log.h"
+#include <stdint.h>
+
+/// 文件头魔数："VXOD"（用来识别"这确实是里程计日志文件"）
+constexpr uint32_t ODOM_LOG_MAGIC       = 0x444F5856;  // 'V' 'X' 'O' 'D'（小端序）
+/// 固定长度记录格式的版本号
+constexpr uint16_t ODOM_LOG_VERSION     = 1;
+/// 差分编码帧格式的版本号
+constexpr uint16_t ODOM_LOG_VERSION_DELTA = 2;
+/// 文件头长度（字节）
+constexpr int      ODOM_LOG_HEADER_SIZE = 16;
+/// 单条记录长度（字节）
+constexpr int      ODOM_RECORD_SIZE     = 40;
+
+/// 一条里程计记录（一个控制周期的完整快照）
+struct OdomRecord {
+    uint32_t time_ms;       ///< 系统时间（毫秒）
+    float    x;             ///< 位姿 X（米）
+    float    y;             ///< 位姿 Y（米）
+    float    theta;         ///< 航向（弧度）
+    float    target_error;  ///< 到当前目标点的距离（米）
+    float    left_volts;    ///< 左侧电机电压命令（伏）
+    float    right_volts;   ///< 右侧电机电压命令（伏）
+    float    forward_m;     ///< 纵向追踪轮原始累计距离（米）
+    float    lateral_m;     ///< 横向追踪轮原始累计距离（米）
+    float    imu_rad;       ///< IMU 原始累计旋转（弧度）
+};
+
+/// 差分编码日志里的通道数
+constexpr int ODOM_CHANNEL_COUNT = 9;
+
+/// 差分编码日志的通道表（时间戳单独编码，不在表里）
+extern const ChannelDef<OdomRecord> ODOM_CHANNELS[ODOM_CHANNEL_COUNT];
+
+/// 差分编码器
+typedef ChannelFrameEncoder<OdomRecord, ODOM_CHANNEL_COUNT> OdomFrameEncoder;
+
+/// v2 文件头 + schema 最多多少字节
+constexpr int ODOM_LOG_DELTA_HEADER_MAX = ODOM_LOG_HEADER_SIZE + channel_schema_max_bytes(ODOM_CHANNEL_COUNT);
+
+/// 写入 v1 文件头（out 至少 ODOM_LOG_HEADER_SIZE 字节）
+void odom_log_encode_header(uint8_t* out);
+
+/// 写入 v2 文件头 + schema（out 至少 ODOM_LOG_DELTA_HEADER_MAX 字节）
+/// @return 写入的字节数
+int odom_log_encode_delta_header(uint8_t* out);
+
+/// 解析文件头（前 ODOM_LOG_HEADER_SIZE 字节）
+/// @param version  输出：格式版本
+/// @param size     输出：v1 = 单条记录长度；v2 = 紧跟在文件头后面的 schema 长度
+/// @return false = 魔数不对（不是里程计日志文件）
+bool odom_log_decode_header(const uint8_t* in, uint16_t* version, uint16_t* size);
+
+/// 把一条记录编码成 ODOM_RECORD_SIZE 字节
+void odom_record_encode(const OdomRecord& rec, uint8_t* out);
+
+/// 从 ODOM_RECORD_SIZE 字节解码出一条记录
+void odom_record_decode(const uint8_t* in, OdomRecord* rec);
+
+/// CSV 表头（不含换行）
+extern const char* const ODOM_CSV_HEADER;
+
+/// 把一条记录格式化成一行 CSV（不含换行），返回写入的字符数
+int odom_record_to_csv(const OdomRecord& rec, char* buf, int buf_size);
@@ -0,0 +1,46 @@
+#pragma once
+// ============================================================================
+//  telemetry/running_stats.h — 流式统计：边来数据边算最小/最大/平均/方差
+// ============================================================================
+//
+//  【为什么不把数据存下来再算？】
+//    一次 drive_to_pose 可能跑 400 个周期。存下来要内存，事后算还要再遍历一遍。
+//    流式统计每来一个数只更新几个变量，内存固定、每次 O(1)。
+//
+//  【Welford 算法】
+//    直接用"平方和 / n - 平均数²"算方差，在数值很接近时会因为
+//    两个大数相减丢失精度（甚至算出负数）。Welford 的递推公式
+//    每一步只加"和当前平均数的差"，结果稳定：
+//        delta = x - mean
+//        mean += delta / n
+//        m2   += delta × (x - mean)        方差 = m2 / (n - 1)
+//
+// ============================================================================
+
+class RunningStats {
+public:
+    RunningStats() { reset(); }
+
+    /// 清空
+    void reset();
+
+    /// 加入一个数
+    void add(double x);
+
+    int    count() const { return _n; }
+    double min() const { return _min; }    ///< 没有数据时为 0
+    double max() const { return _max; }    ///< 没有数据时为 0
+    double mean() const { return _mean; }  ///< 没有数据时为 0
+
+    /// 样本方差（除以 n-1）；少于 2 个数据时为 0
+    double variance() const;
+
+    /// 标准差 = √方差
+    double stddev() const;
+
+private:
+    int    _n;
+    double _min, _max;
+    double _mean;
+    double _m2;  // 和平均数之差的平方和
+};
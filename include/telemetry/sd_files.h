@@ -0,0 +1,17 @@
+#pragma once
+// ============================================================================
+//  telemetry/sd_files.h — SD 卡上"自动编号"的新文件
+// ============================================================================
+//
+//  日志文件不能每次开机都覆盖上一场的（那样上一场的数据就没了），
+//  所以按 odom_000.bin、odom_001.bin……的顺序找第一个还不存在的编号。
+//
+// ============================================================================
+#include <stdio.h>
+
+/// 按 printf 格式（必须含一个 %03d 之类的整数占位符）找第一个还不存在的文件名，
+/// 以 "wb" 打开它
+/// @param name_fmt   例如 "/usd/odom_%03d.bin"
+/// @param name       输出：实际打开的文件名
+/// @return 打开的文件；SD 卡不可用或编号用完时返回 nullptr
+FILE* sd_open_numbered_file(const char* name_fmt, char* name, int name_size);
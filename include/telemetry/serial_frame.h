@@ -0,0 +1,99 @@
+#pragma once
+// ============================================================================
+//  telemetry/serial_frame.h — 串口遥测的分帧协议（机器人和电脑共用）
+// ============================================================================
+//
+//  【问题】
+//    串口只是一串连续的字节，没有"一条消息从哪开始、到哪结束"的概念；
+//    线缆一抖还可能丢字节、错字节。要在上面传二进制数据，需要：
+//    ① 分帧：接收方能找到每一帧的边界，丢了字节也能从下一帧重新同步
+//    ② 校验：能发现被改坏的帧并扔掉
+//
+//  【一帧的结构】
+//    原始内容： [通道号 1][序号 1][数据 0~64][CRC16 2（小端）]
+//    再做 COBS 编码（把所有 0x00 字节换掉），最后加一个 0x00 作为帧尾。
+//
+//  【COBS 是什么？】
+//    Consistent Overhead Byte Stuffing：把数据里的 0 全部去掉，
+//    换成"到下一个 0 还有几个字节"的计数。编码后数据里不会再出现 0，
+//    所以 0x00 可以放心当作帧分隔符。每 254 字节只多 1 字节开销。
+//
+//  【CRC16 是什么？】
+//    一种校验和（这里用 CRC-16/CCITT-FALSE）。发送方根据内容算出 2 字节，
+//    接收方再算一遍，对不上就说明传坏了。
+//
+//  【序号有什么用？】
+//    每个通道每发一帧序号 +1（到 255 回到 0）。接收方看到序号跳了，
+//    就知道中间丢了几帧。
+//
+// ============================================================================
+#include <stdint.h>
+
+/// 单帧数据最多多少字节（不含通道号、序号、CRC）
+constexpr int SERIAL_FRAME_MAX_PAYLOAD = 64;
+/// 编码后一帧最多多少字节（含 COBS 开销和帧尾 0x00）
+constexpr int SERIAL_FRAME_MAX_ENCODED = SERIAL_FRAME_MAX_PAYLOAD + 4 + 2 + 1;
+
+/// 遥测通道（编号会出现在数据流里，只能追加）
+enum TelemetryChannel {
+    TELEM_CH_ODOM = 1,   ///< 一条 OdomRecord（40 字节，见 telemetry/odom_record.h）
+    TELEM_CH_LOOP = 2,   ///< 里程计循环计时（TelemLoopSample，20 字节）
+    TELEM_CH_COUNT
+};
+
+/// TELEM_CH_LOOP 通道的数据
+struct TelemLoopSample {
+    uint32_t time_ms;       ///< 系统时间（毫秒）
+    uint32_t exec_p99_us;   ///< 里程计执行时间 P99
+    uint32_t exec_max_us;   ///< 里程计执行时间最大值
+    uint32_t late_p99_us;   ///< 里程计晚醒时间 P99
+    uint32_t late_max_us;   ///< 里程计晚醒时间最大值
+};
+constexpr int TELEM_LOOP_SAMPLE_SIZE = 20;
+
+void telem_loop_encode(const TelemLoopSample& s, uint8_t* out);
+void telem_loop_decode(const uint8_t* in, TelemLoopSample* s);
+
+/// CRC-16/CCITT-FALSE（初值 0xFFFF，多项式 0x1021）
+uint16_t crc16_ccitt(const uint8_t* data, int len);
+
+/// COBS 编码，返回编码后的长度（不含帧尾 0x00）
+/// out 至少要有 len + len/254 + 1 字节
+int cobs_encode(const uint8_t* in, int len, uint8_t* out);
+
+/// COBS 解码，返回解码后的长度；数据不合法返回 -1
+int cobs_decode(const uint8_t* in, int len, uint8_t* out);
+
+/// 把一帧编码好（含帧尾 0x00），返回总字节数；payload 太长返回 0
+int serial_frame_encode(uint8_t channel, uint8_t seq,
+                        const uint8_t* payload, int len, uint8_t* out);
+
+/// 流式解帧器：一个字节一个字节喂进去，凑够一帧就告诉你
+class SerialFrameDecoder {
+public:
+    enum Result { NONE, FRAME, BAD_FRAME };
+
+    SerialFrameDecoder();
+
+    /// 喂一个字节
+    /// @return FRAME = 刚收完一个好帧（用下面的访问函数读取）；
+    ///         BAD_FRAME = 刚收完一个坏帧（CRC 错 / 太长 / COBS 不合法），已丢弃
+    Result feed(uint8_t byte);
+
+    uint8_t        channel() const { return _frame[0]; }
+    uint8_t        seq() const { return _frame[1]; }
+    const uint8_t* payload() const { return _frame + 2; }
+    int            payload_len() const { return _frame_len - 4; }
+
+    unsigned long good_frames() const { return _good; }
+    unsigned long bad_frames() const { return _bad; }
+
+private:
+    uint8_t       _buf[SERIAL_FRAME_MAX_ENCODED];  // 正在收的（编码后的）字节
+    int           _len;
+    bool          _overflow;                       // 这一帧太长，等帧尾后丢弃
+    uint8_t       _frame[SERIAL_FRAME_MAX_ENCODED];  // 解码后的上一个好帧
+    int           _frame_len;
+    unsigned long _good;
+    unsigned long _bad;
+};
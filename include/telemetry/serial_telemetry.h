@@ -0,0 +1,61 @@
+#pragma once
+// ============================================================================
+//  telemetry/serial_telemetry.h — 通过 USB 串口实时发送遥测数据
+// ============================================================================
+//
+//  【干什么用？】
+//    以前想看实时位姿只能盯着 Brain 屏幕，或者比赛后拔 SD 卡。
+//    现在用 USB 线把 Brain 连到电脑，机器人边跑边把数据发过来：
+//        make tools
+//        ./build/telemetry_rx /dev/ttyACM1 live.csv --stats
+//    （Brain 的"用户串口"通常是第二个 ttyACM 设备；Windows 上是 COMx）
+//
+//  【限速】
+//    每个通道有自己的最短发送间隔（config.h 的 SERIAL_TELEM_*_INTERVAL_MS），
+//    调用得再频繁，也只按这个频率发；多出来的调用直接返回 false（很便宜）。
+//
+//  【不会卡住调用者】
+//    send 只是编码一帧并放进无锁队列；真正往串口写字节的是低优先级后台任务。
+//    队列满了（比如电脑没在读、串口堵住了）就丢弃这一帧，序号照样 +1，
+//    所以电脑那边能从序号跳变看出丢了多少。
+//
+//  【注意】
+//    数据走的是标准输出（stdout，也就是 USB 用户串口）。
+//    开启遥测后不要再用 printf 往 stdout 打印文字，否则会混进二进制数据流
+//    （接收端能扔掉坏帧，但会计入错误数）。
+//
+// ============================================================================
+#include "telemetry/serial_frame.h"
+#include "telemetry/odom_record.h"
+
+/// 遥测统计
+struct SerialTelemetryStats {
+    unsigned long sent;          ///< 放进发送队列的帧数
+    unsigned long rate_limited;  ///< 因为限速没发的次数
+    unsigned long dropped;       ///< 队列满了丢弃的帧数
+};
+
+/// 队列里的一帧（已经编码好，可以直接写串口）
+struct SerialTxFrame {
+    int     len;
+    uint8_t bytes[SERIAL_FRAME_MAX_ENCODED];
+};
+
+/// 按通道限速后发送一帧（任何任务都能调用，不阻塞）
+/// @return true = 已放进发送队列；false = 限速/队列满/通道号不对
+bool serial_telemetry_send(uint8_t channel, const uint8_t* payload, int len);
+
+/// 发送一条里程计记录（TELEM_CH_ODOM）
+bool serial_telemetry_send_odom(const OdomRecord& rec);
+
+/// 发送里程计循环计时（TELEM_CH_LOOP，数据来自 telemetry/loop_stats.h 里的 "odom"）
+bool serial_telemetry_send_loop_stats();
+
+/// 后台任务从这里取要写串口的帧
+bool serial_telemetry_pop(SerialTxFrame& out);
+
+/// 启动后台串口发送任务（pre_auton 调用一次）
+void serial_telemetry_start();
+
+/// 读取统计
+SerialTelemetryStats serial_telemetry_get_stats();
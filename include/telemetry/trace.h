@@ -0,0 +1,84 @@
+#pragma once
+// ============================================================================
+//  telemetry/trace.h — 时间线采集（记录每段关键代码什么时候开始、跑了多久）
+// ============================================================================
+//
+//  【怎么用？】
+//    1. 在要测的函数开头放一个 TraceScope：
+//         void odometry_update(double dt) {
+//             TraceScope trace(TRACE_ODOMETRY_UPDATE);
+//             ...
+//         }
+//       离开函数时自动记一条事件（开始时间 + 持续时间）。
+//    2. trace_capture_start() 开始采集（自治开始时），
+//       缓冲区满了自动停止，不会覆盖前面的数据。
+//    3. 机器人上：trace_save_to_sd() 写 /usd/trace_NNN.bin，
+//         电脑上 ./build/trace2json trace_000.bin trace.json
+//       电脑仿真：trace_save_chrome_json("build/trace.json") 直接写 JSON。
+//    4. 把 JSON 拖进 https://ui.perfetto.dev 查看。
+//
+//  【开销】
+//    没在采集时：TraceScope 只检查一个标记。
+//    采集时：两次读微秒计时器 + 一次原子加法 + 填 12 字节。
+//    config.h 里 TRACE_ENABLED = false 时编译器会把它整个删掉。
+//
+//  【多任务】
+//    多个任务可以同时记录：每条事件先用原子加法"占一个格子"再填写，
+//    不需要锁。缓冲区满了以后的事件丢弃并计数。
+//
+// ============================================================================
+#include "telemetry/trace_event.h"
+#include "config.h"
+#include "hal/time.h"
+#include <stdio.h>
+
+/// 开始一次新的采集（清空缓冲区）
+void trace_capture_start();
+
+/// 停止采集（已记录的事件保留，可以保存）
+void trace_capture_stop();
+
+/// 是否正在采集
+bool trace_capture_active();
+
+/// 记录一条事件（一般用 TraceScope，不直接调用）
+void trace_record(TraceId id, uint32_t start_us, uint32_t dur_us);
+
+/// 已采集的事件（只在 trace_capture_stop() 之后读）
+/// @param count  输出：事件个数
+const TraceEvent* trace_events(int* count);
+
+/// 缓冲区满了被丢弃的事件数
+unsigned long trace_dropped();
+
+/// 把已采集的事件按二进制格式写进一个已打开的文件（写完会关闭文件）
+/// @return 写出的事件个数
+int trace_save_binary(FILE* f);
+
+/// 停止采集并写到 SD 卡上新的 /usd/trace_NNN.bin
+void trace_save_to_sd();
+
+/// 停止采集并直接写成 Chrome trace JSON（电脑仿真用）
+/// @return false = 文件打不开
+bool trace_save_chrome_json(const char* path);
+
+/// 作用域计时：构造时记下开始时间，析构时记录一条事件
+class TraceScope {
+public:
+    explicit TraceScope(TraceId id) : _id(id), _active(TRACE_ENABLED && trace_capture_active()) {
+        if (_active) _start_us = (uint32_t)get_time_us();
+    }
+    ~TraceScope() {
+        if (_active) {
+            uint32_t now = (uint32_t)get_time_us();
+            trace_record(_id, _start_us, now - _start_us);
+        }
+    }
+
+private:
+    TraceId  _id;
+    bool     _active;
+    uint32_t _start_us;
+    TraceScope(const TraceScope&);             // 禁止拷贝
+    TraceScope& operator=(const TraceScope&);
+};
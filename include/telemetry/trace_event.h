@@ -0,0 +1,77 @@
+#pragma once
+// ============================================================================
+//  telemetry/trace_event.h — 时间线事件格式 + Chrome Trace JSON 导出（机器人和电脑共用）
+// ============================================================================
+//
+//  【干什么用？】
+//    loop_stats 告诉你"里程计有时候晚醒 3 毫秒"，但不告诉你"是谁占了 CPU"。
+//    把每次 odometry_update、vision_localizer_update、PID 计算、SD 卡写入的
+//    开始时间和持续时间记下来，画到一条时间线上，一眼就能看到任务之间怎么交错。
+//
+//  【怎么看？】
+//    导出成 Chrome trace-event JSON，用浏览器打开 https://ui.perfetto.dev
+//    （或 Chrome 的 chrome://tracing），把文件拖进去即可。
+//    每个后台任务是一行（"线程"），每个事件是一个色块。
+//
+//  【二进制文件结构（/usd/trace_NNN.bin）】
+//    ┌──────────────┬──────────┬──────────┬─────┐
+//    │ 文件头 16 字节 │ 事件 0   │ 事件 1   │ ... │
+//    └──────────────┴──────────┴──────────┴─────┘
+//    文件头：魔数 "VXTR" + 版本号 + 单个事件长度 + 事件个数 + 保留
+//    事件  ：开始时间(µs, 4) + 持续时间(µs, 4) + 事件编号(1) + 保留(3)，小端序
+//    比赛后用 tools/trace2json 转成 JSON。
+//
+//  这个文件不依赖任何 VEX 硬件，电脑上的转换工具也直接用它。
+//
+// ============================================================================
+#include <stdint.h>
+#include <stdio.h>
+
+/// 文件头魔数："VXTR"
+constexpr uint32_t TRACE_FILE_MAGIC       = 0x52545856;  // 'V' 'X' 'T' 'R'（小端序）
+/// 当前格式版本
+constexpr uint16_t TRACE_FILE_VERSION     = 1;
+/// 文件头长度（字节）
+constexpr int      TRACE_FILE_HEADER_SIZE = 16;
+/// 单个事件长度（字节）
+constexpr int      TRACE_EVENT_SIZE       = 12;
+
+/// 被记录的代码段（只能在末尾追加，编号会写进文件）
+enum TraceId {
+    TRACE_ODOMETRY_UPDATE = 0,  ///< odometry_update()
+    TRACE_VISION_UPDATE,        ///< 视觉估算（vision_localizer_estimate_latest()）
+    TRACE_PID_CALCULATE,        ///< PIDController::calculate()
+    TRACE_SD_WRITE_LOG,         ///< 文字日志写 SD 卡
+    TRACE_SD_WRITE_ODOM,        ///< 二进制里程计日志写 SD 卡
+    TRACE_SD_WRITE_FLIGHT,      ///< 黑匣子写 SD 卡
+    TRACE_VISION_SNAPSHOT,      ///< vision_snapshot()（拍照任务）
+    TRACE_ID_COUNT
+};
+
+/// 一个"持续事件"：从 start_us 开始，持续 dur_us
+struct TraceEvent {
+    uint32_t start_us;  ///< 开始时间（开机后微秒数，约 71 分钟回绕一次）
+    uint32_t dur_us;    ///< 持续时间（微秒）
+    uint8_t  id;        ///< TraceId
+};
+
+/// 事件名（如 "odometry_update"）；未知编号返回 "unknown"
+const char* trace_event_name(int id);
+
+/// 事件所在的任务名（时间线上的一行，如 "odometry task"）
+const char* trace_event_track(int id);
+
+/// 写入文件头（out 至少 TRACE_FILE_HEADER_SIZE 字节）
+void trace_file_encode_header(uint8_t* out, uint32_t event_count);
+
+/// 解析文件头
+/// @return false = 魔数不对或事件长度不认识
+bool trace_file_decode_header(const uint8_t* in, uint16_t* version, uint32_t* event_count);
+
+/// 把一个事件编码成 TRACE_EVENT_SIZE 字节 / 反过来
+void trace_event_encode(const TraceEvent& ev, uint8_t* out);
+void trace_event_decode(const uint8_t* in, TraceEvent* ev);
+
+/// 把一组事件写成 Chrome trace-event JSON（"ph":"X" 完整事件 + 线程名元数据）
+/// @return 写出的事件个数
+int trace_write_chrome_json(FILE* out, const TraceEvent* events, int count);
@@ -13,6 +13,7 @@
 // ============================================================================
 #include "control/pid.h"
 #include "hal/time.h"
+#include "telemetry/trace.h"
 
 // ---- 构造函数 ----
 // 初始化所有成员变量。增强功能默认关闭（值为 0）
@@ -24,6 +25,8 @@ PIDController::PIDController(double kp, double ki, double kd)
 
 // ---- 核心：计算一次 PID 输出 ----
 double PIDController::calculate(double setpoint, double pv) {
+    TraceScope trace(TRACE_PID_CALCULATE);
+
     // 第一步：算出时间间隔 dt（从上次调用到现在过了多久）
     double now = get_time_sec();
     double dt  = now - _last_time;
@@ -1,34 +1,66 @@
 // ============================================================================
-//  hal/hal_log.cpp — 日志系统的实现
+//  hal/hal_log.cpp — 日志系统的实现（生产者这一侧）
 // ============================================================================
 //
 //  日志就像机器人的"日记"。它把运行过程中的重要事件写到
 //  SD 卡上的文件里（Brain 上插的那张 microSD 卡）。
 //  比赛后拔出 SD 卡，就能在电脑上看到完整的运行记录。
 //
-//  这个文件包含两种日志：
-//  1. 文字日志 (hal_log.txt)  —— 记录事件，像"IMU校准完成"
-//  2. CSV 数据 (odom_log.csv) —— 记录位姿数据，可以用 Excel 画轨迹图
+//  【两个角色】
+//    生产者（本文件）：任何任务调用 hal_log()，消息被复制进环形缓冲区，
+//                      耗时只有几微秒，永远不会等 SD 卡。
+//    消费者（hal_log_writer.cpp）：低优先级后台任务，把缓冲区里的消息
+//                      写进一直打开着的 SD 卡文件，并负责屏幕显示。
+//
+//  本文件不直接碰硬件，所以电脑上的单元测试也能直接编译它。
 //
 // ============================================================================
 #include "hal/hal_log.h"
+#include "hal/ring_buffer.h"
+#include "hal/time.h"
 #include "config.h"
-#include "vex.h"
-#include <fstream>    // 文件读写
+#include <atomic>
 #include <cstring>
+#include <stdarg.h>
+#include <stdio.h>
+
+// ---- 环形缓冲区 + 统计计数 ----
+static RingBuffer<LogEntry, LOG_RING_CAPACITY> log_ring;
+static std::atomic<unsigned long> log_enqueued(0);
+static std::atomic<unsigned long> log_dropped(0);
+static std::atomic<unsigned long> log_drained(0);
 
-using namespace vex;
+// ---- 把一条填好的日志放进环形缓冲区 ----
+// 满了就丢弃并计数——绝不等待
+static void enqueue(const LogEntry& entry) {
+    if (log_ring.try_push(entry)) {
+        log_enqueued.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        log_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-// Brain 对象在 main.cpp 里定义，这里用 extern 声明"借用"它
-extern brain Brain;
+// ---- printf 风格日志（核心，不分配堆内存）----
+void hal_log_printf(int level, bool to_screen, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    hal_log_vprintf(level, to_screen, fmt, args);
+    va_end(args);
+}
 
-// SD 卡上的日志文件路径（/usd/ 是 VEX Brain 上 SD 卡的挂载路径）
-#define HAL_LOG_FILE  "/usd/hal_log.txt"   // 文字日志
-#define ODOM_CSV_FILE "/usd/odom_log.csv"  // CSV 数据日志
+void hal_log_vprintf(int level, bool to_screen, const char* fmt, va_list args) {
+    // 宏已经在编译期过滤过了，这里再检查一次是给直接调用的地方兜底
+    if (level > LOG_VERBOSITY) return;
 
-// 标记：CSV 文件的表头是否已经写过了
-// 第一次写数据时先写一行表头（time_ms,x,y,theta,error），之后就不再重复写了
-static bool odom_csv_header_written = false;
+    // 日志条目在栈上，vsnprintf 直接写进它的固定大小数组（自动截断）
+    LogEntry entry;
+    entry.time_ms   = get_time_ms();
+    entry.level     = level;
+    // 严重错误和警告一定显示在 Brain 屏幕上（方便现场发现问题）
+    entry.to_screen = to_screen || level <= LOG_WARN;
+    vsnprintf(entry.text, LOG_LINE_MAX, fmt, args);
+    enqueue(entry);
+}
 
 // ---- 简便版日志函数 ----
 // 不指定级别时默认按 INFO 级别记录
@@ -36,62 +68,37 @@ void hal_log(const std::string& message, bool printToScreen) {
     hal_log_level(LOG_INFO, message, printToScreen);
 }
 
-// ---- 带级别的日志函数（核心） ----
+// ---- 带级别的日志函数（旧接口，std::string 版本） ----
 void hal_log_level(int level, const std::string& message, bool printToScreen) {
     // 第一步：级别过滤
     // 如果消息级别 > config.h 里设定的 LOG_VERBOSITY，就直接忽略
     // 比如 LOG_VERBOSITY=2(INFO)，那 DEBUG(3) 消息就不会被记录
     if (level > LOG_VERBOSITY) return;
 
-    // 第二步：根据级别加前缀，方便在日志文件里快速筛选
-    const char* prefix = "";
-    switch (level) {
-        case LOG_ERROR: prefix = "ERR "; break;  // 严重错误
-        case LOG_WARN:  prefix = "WRN "; break;  // 警告
-        case LOG_INFO:  prefix = "INF "; break;  // 信息
-        case LOG_DEBUG: prefix = "DBG "; break;  // 调试
-    }
-
-    // 第三步：获取系统时间戳（毫秒），比如 [12345] 表示开机第 12.345 秒
-    unsigned long ms = (unsigned long)vex::timer::system();
-    char timebuf[32];
-    snprintf(timebuf, sizeof(timebuf), "%lu", ms);
-
-    // 第四步：拼接最终的日志条目，格式: [时间戳] 级别 消息
-    std::string log_entry = std::string("[") + timebuf + "] " + prefix + message + "\n";
-
-    // 第五步：追加写入 SD 卡上的日志文件
-    // std::ios::app 表示"追加模式"——每次都写在文件末尾，不覆盖之前的内容
-    std::ofstream log_file(HAL_LOG_FILE, std::ios::app);
-    if (log_file.is_open()) {
-        log_file << log_entry;
-        log_file.close();
-    }
+    // 第二步：在栈上填好一条日志（时间戳 + 级别 + 截断后的消息）
+    LogEntry entry;
+    entry.time_ms   = get_time_ms();
+    entry.level     = level;
+    // 严重错误和警告一定显示在 Brain 屏幕上（方便现场发现问题）
+    entry.to_screen = printToScreen || level <= LOG_WARN;
+    strncpy(entry.text, message.c_str(), LOG_LINE_MAX - 1);
+    entry.text[LOG_LINE_MAX - 1] = '\0';
 
-    // 第六步：严重错误和警告一定显示在 Brain 屏幕上（方便现场发现问题）
-    if (printToScreen || level <= LOG_WARN) {
-        Brain.Screen.print("%s", log_entry.c_str());
-        Brain.Screen.newLine();
-    }
+    // 第三步：放进环形缓冲区
+    enqueue(entry);
 }
 
-// ---- CSV 位姿数据日志 ----
-// 每次调用往 SD 卡上的 CSV 文件追加一行数据
-// CSV = Comma-Separated Values（用逗号隔开的数值），Excel 可以直接打开
-void hal_log_odom_csv(unsigned long time_ms, double x, double y, double theta, double error) {
-    std::ofstream csv(ODOM_CSV_FILE, std::ios::app);
-    if (!csv.is_open()) return;  // SD 卡没插好？打开失败就算了
-
-    // 第一次调用时写入表头行
-    if (!odom_csv_header_written) {
-        csv << "time_ms,x,y,theta,error\n";
-        odom_csv_header_written = true;
-    }
+// ---- 后台写日志任务从这里取数据 ----
+bool hal_log_pop(LogEntry& out) {
+    if (!log_ring.try_pop(out)) return false;
+    log_drained.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
 
-    // 写入一行数据，%.4f 表示保留 4 位小数
-    char buf[128];
-    snprintf(buf, sizeof(buf), "%lu,%.4f,%.4f,%.4f,%.4f\n",
-             time_ms, x, y, theta, error);
-    csv << buf;
-    csv.close();
+LogStats hal_log_get_stats() {
+    LogStats stats;
+    stats.enqueued = log_enqueued.load(std::memory_order_relaxed);
+    stats.dropped  = log_dropped.load(std::memory_order_relaxed);
+    stats.drained  = log_drained.load(std::memory_order_relaxed);
+    return stats;
 }
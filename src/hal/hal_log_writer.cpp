@@ -0,0 +1,107 @@
+// ============================================================================
+//  hal/hal_log_writer.cpp — 日志系统的 SD 卡写入端（消费者这一侧）
+// ============================================================================
+//
+//  这个文件包含文字日志 (hal_log.txt) 真正碰 SD 卡的代码：
+//  后台任务把环形缓冲区里的消息写进去。
+//  （位姿数据日志见 telemetry/odom_logger.cpp，用的是二进制格式）
+//
+//  【为什么文件一直开着？】
+//    SD 卡每次打开/关闭文件都要好几毫秒。以前每条日志都开关一次，
+//    调用 hal_log() 的任务就被卡住好几毫秒。现在文件只打开一次，
+//    后台任务每 LOG_WRITER_INTERVAL_MS 把攒下的消息一起写进去再 flush。
+//
+// ============================================================================
+#include "hal/hal_log.h"
+#include "config.h"
+#include "hal/screen.h"
+#include "telemetry/trace.h"
+#include "vex.h"
+#include <stdio.h>
+
+using namespace vex;
+
+// SD 卡上的日志文件路径（/usd/ 是 VEX Brain 上 SD 卡的挂载路径）
+#define HAL_LOG_FILE  "/usd/hal_log.txt"   // 文字日志
+
+// 文件打不开（比如没插 SD 卡）时，每隔多久重试一次
+static constexpr int LOG_REOPEN_INTERVAL_MS = 1000;
+
+static FILE*      log_file        = nullptr;  // 一直保持打开的日志文件
+static vex::task* log_writer_task = nullptr;
+static unsigned long last_open_attempt_ms = 0;
+static unsigned long reported_dropped     = 0;  // 已经在文件里报告过的丢弃数
+
+// 根据级别加前缀，方便在日志文件里快速筛选
+static const char* level_prefix(int level) {
+    switch (level) {
+        case LOG_ERROR: return "ERR ";  // 严重错误
+        case LOG_WARN:  return "WRN ";  // 警告
+        case LOG_INFO:  return "INF ";  // 信息
+        case LOG_DEBUG: return "DBG ";  // 调试
+    }
+    return "";
+}
+
+// 文件没打开就（限频地）尝试打开
+static void ensure_log_file_open() {
+    if (log_file != nullptr) return;
+    unsigned long now = (unsigned long)vex::timer::system();
+    if (last_open_attempt_ms != 0 && now - last_open_attempt_ms < LOG_REOPEN_INTERVAL_MS) return;
+    last_open_attempt_ms = now;
+    // "a" = 追加模式——每次都写在文件末尾，不覆盖之前的内容
+    log_file = fopen(HAL_LOG_FILE, "a");
+}
+
+// 把缓冲区里所有的日志写出去，返回写了几条
+static int drain_log_ring() {
+    ensure_log_file_open();
+
+    int written = 0;
+    LogEntry entry;
+    char line[LOG_LINE_MAX + 32];
+    while (hal_log_pop(entry)) {
+        // 格式: [时间戳] 级别 消息
+        snprintf(line, sizeof(line), "[%lu] %s%s\n",
+                 entry.time_ms, level_prefix(entry.level), entry.text);
+        if (log_file != nullptr) fputs(line, log_file);
+        if (entry.to_screen) {
+            // 屏幕只显示级别 + 消息（最后两行，见 hal/screen.h）
+            snprintf(line, sizeof(line), "%s%s", level_prefix(entry.level), entry.text);
+            screen_show_message(line);
+        }
+        written++;
+    }
+
+    // 有消息被丢弃了？在文件里补一条说明，方便事后知道日志不完整
+    LogStats stats = hal_log_get_stats();
+    if (stats.dropped != reported_dropped && log_file != nullptr) {
+        fprintf(log_file, "[%lu] WRN log ring full: %lu message(s) dropped\n",
+                (unsigned long)vex::timer::system(), stats.dropped - reported_dropped);
+        reported_dropped = stats.dropped;
+        written++;
+    }
+
+    // 一批写完再 flush 一次（而不是每条都 flush）
+    if (written > 0 && log_file != nullptr) {
+        TraceScope trace(TRACE_SD_WRITE_LOG);
+        fflush(log_file);
+    }
+    return written;
+}
+
+// ---- 后台写日志任务 ----
+static int log_writer_task_fn() {
+    while (true) {
+        drain_log_ring();
+        vex::task::sleep(LOG_WRITER_INTERVAL_MS);
+    }
+    return 0;
+}
+
+void hal_log_start_writer() {
+    if (log_writer_task != nullptr) return;
+    ensure_log_file_open();
+    // 低优先级：只在里程计、视觉、运动控制都让出 CPU 时才写 SD 卡
+    log_writer_task = new vex::task(log_writer_task_fn, vex::task::taskPrioritylow);
+}
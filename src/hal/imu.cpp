@@ -29,11 +29,17 @@ double get_imu_rotation_rad() {
     return DrivetrainInertial.rotation(vex::rotationUnits::deg) * M_PI / 180.0;
 }
 
+// ---- IMU 能不能用 ----
+// 线松了再插上，IMU 会自己重新校准一遍，这段时间的读数也不能用
+bool imu_connected() {
+    return DrivetrainInertial.installed() && !DrivetrainInertial.isCalibrating();
+}
+
 // ---- 重置 IMU ----
 void reset_imu() {
     DrivetrainInertial.resetRotation();  // 累计旋转归零
     DrivetrainInertial.resetHeading();   // 当前航向归零
-    hal_log("IMU reset");
+    LOG_SCREENF("IMU reset");
 }
 
 // ---- 校准 IMU ----
@@ -41,7 +47,7 @@ void reset_imu() {
 // 如果 3 秒内没校准完（可能传感器没插好），就超时退出并打印警告。
 void calibrate_imu() {
     DrivetrainInertial.calibrate();       // 启动校准
-    hal_log("IMU calibration started");
+    LOG_SCREENF("IMU calibration started");
 
     // 每 50 毫秒检查一次校准是否完成，最多等 3 秒
     int elapsed = 0;
@@ -52,8 +58,8 @@ void calibrate_imu() {
 
     if (elapsed >= 3000) {
         // 超时了！可能传感器没连好
-        hal_log("IMU calibration TIMEOUT — sensor may not be connected");
+        LOG_ERRORF("IMU calibration TIMEOUT — sensor may not be connected");
     } else {
-        hal_log("IMU calibration finished");
+        LOG_SCREENF("IMU calibration finished");
     }
 }
@@ -42,11 +42,17 @@ extern vex::motor RightRear;
 static vex::motor* left_motors[]  = { &LeftFront,  &LeftMid,  &LeftRear  };
 static vex::motor* right_motors[] = { &RightFront, &RightMid, &RightRear };
 
+// 最近一次的电压命令（给日志用，省得再去读电机）
+static double last_left_voltage  = 0.0;
+static double last_right_voltage = 0.0;
+
 // ---- 设定电机电压 ----
 void set_drive_motors(double left_voltage, double right_voltage) {
     // 先限幅，防止超过 ±12V
     left_voltage  = clamp_voltage(left_voltage);
     right_voltage = clamp_voltage(right_voltage);
+    last_left_voltage  = left_voltage;
+    last_right_voltage = right_voltage;
 
     // 给同侧 3 个电机设定相同电压
     // 注意：VEX API 的 spin() 接受的单位是毫伏 (mV)，所以要乘以 1000
@@ -59,6 +65,8 @@ void set_drive_motors(double left_voltage, double right_voltage) {
 
 // ---- 刹停所有电机 ----
 void stop_drive_motors() {
+    last_left_voltage  = 0.0;
+    last_right_voltage = 0.0;
     for (int i = 0; i < MOTORS_PER_SIDE; ++i) {
         // brakeType::brake = 主动刹车（电机反向阻力），比 coast（惯性滑行）停得更快
         left_motors[i]->stop(vex::brakeType::brake);
@@ -66,9 +74,13 @@ void stop_drive_motors() {
     }
 }
 
+// ---- 最近一次的电压命令 ----
+double get_left_drive_command()  { return last_left_voltage; }
+double get_right_drive_command() { return last_right_voltage; }
+
 // ---- 读取电机编码器 ----
-// 这两个函数目前没被里程计使用（里程计用追踪轮代替了），
-// 但保留着以备将来需要。
+// 里程计用它们算"轮子的转角"来修正 IMU 航向（没装平行轮时，见 heading_fusion.h）。
+// 电机位置由 VEXos 每 10 ms 自动刷新，读它只是拷一个缓存值。
 double get_left_encoder_ticks() {
     return LeftMid.position(vex::rotationUnits::raw);
 }
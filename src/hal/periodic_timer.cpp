@@ -0,0 +1,54 @@
+// ============================================================================
+//  hal/periodic_timer.cpp — 绝对截止时间周期定时器的实现
+// ============================================================================
+//
+//  截止时间用毫秒（VEX 的 sleep 精度就是 1 ms），
+//  真实 dt 和平均周期用微秒时钟测量。
+//  只用到 hal/time.h 的函数，所以电脑上的单元测试也能直接编译它。
+//
+// ============================================================================
+#include "hal/periodic_timer.h"
+#include "hal/time.h"
+
+PeriodicTimer::PeriodicTimer(int period_ms, LoopStats* stats)
+    : _period_ms(period_ms), _stats(stats), _started(false), _deadline_ms(0),
+      _start_us(0), _last_wake_us(0), _ticks(0), _overruns(0),
+      _last_dt(period_ms / 1000.0) {}
+
+void PeriodicTimer::start() {
+    _started      = true;
+    _deadline_ms  = get_time_ms() + _period_ms;
+    _start_us     = get_time_us();
+    _last_wake_us = _start_us;
+    _ticks        = 0;
+    _overruns     = 0;
+    _last_dt      = _period_ms / 1000.0;
+}
+
+double PeriodicTimer::wait() {
+    if (!_started) start();
+
+    if (_stats != nullptr) _stats->expect_wake_at((uint64_t)_deadline_ms * 1000u);
+
+    // 有符号差值：时钟回绕时也能比较先后
+    long remaining = (long)(_deadline_ms - get_time_ms());
+    if (remaining > 0) {
+        wait_until_ms(_deadline_ms);
+    } else if (remaining < 0) {
+        _overruns++;
+        // 落后超过一整个周期：放弃错过的周期，从现在重新对齐
+        if (-remaining >= _period_ms) _deadline_ms = get_time_ms();
+    }
+    _deadline_ms += _period_ms;
+
+    uint64_t now = get_time_us();
+    _last_dt      = (now - _last_wake_us) / 1.0e6;
+    _last_wake_us = now;
+    _ticks++;
+    return _last_dt;
+}
+
+double PeriodicTimer::measured_period_ms() const {
+    if (_ticks == 0) return _period_ms;
+    return (_last_wake_us - _start_us) / 1000.0 / _ticks;
+}
@@ -0,0 +1,63 @@
+// ============================================================================
+//  hal/screen.cpp — Brain 屏幕显示的实现
+// ============================================================================
+//
+//  屏幕任务、日志写入任务都会改屏幕内容，所以缓存用一把锁保护。
+//  锁里只做内存拷贝和（flush 时）少量画字，持有时间很短。
+//
+// ============================================================================
+#include "hal/screen.h"
+#include "vex.h"
+#include <stdarg.h>
+#include <string.h>
+
+using namespace vex;
+
+// Brain 对象在 main.cpp 里定义，这里用 extern 声明"借用"它
+extern brain Brain;
+
+static ScreenCache screen_cache;
+static vex::mutex  screen_mutex;
+static bool        screen_first_flush = true;
+
+// 真正往屏幕上画字
+static void draw_on_brain(int row, int col, const char* text) {
+    Brain.Screen.setCursor(row, col);
+    Brain.Screen.print("%s", text);
+}
+
+void screen_printf_row(int row, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    screen_mutex.lock();
+    screen_cache.vset_row(row, fmt, args);
+    screen_mutex.unlock();
+    va_end(args);
+}
+
+void screen_show_message(const char* text) {
+    screen_mutex.lock();
+    // 上一条消息上移一行，新消息放在最后一行
+    screen_cache.set_row(SCREEN_MESSAGE_ROW, "%s", screen_cache.pending_row(SCREEN_MESSAGE_ROW + 1));
+    screen_cache.set_row(SCREEN_MESSAGE_ROW + 1, "%s", text);
+    screen_mutex.unlock();
+}
+
+void screen_flush() {
+    screen_mutex.lock();
+    if (screen_first_flush) {
+        // 开机时屏幕上可能还有 pre_auton 打印的字，第一次整屏擦掉重画
+        Brain.Screen.clearScreen();
+        screen_cache.mark_cleared();
+        screen_first_flush = false;
+    }
+    screen_cache.flush(draw_on_brain);
+    screen_mutex.unlock();
+}
+
+ScreenCacheStats screen_get_stats() {
+    screen_mutex.lock();
+    ScreenCacheStats stats = screen_cache.stats();
+    screen_mutex.unlock();
+    return stats;
+}
@@ -0,0 +1,75 @@
+// ============================================================================
+//  hal/screen_cache.cpp — 屏幕缓存的实现（纯逻辑，电脑上也能测试）
+// ============================================================================
+#include "hal/screen_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+ScreenCache::ScreenCache() {
+    for (int r = 0; r < SCREEN_ROWS; ++r) {
+        _pending[r][0] = '\0';
+        _drawn[r][0]   = '\0';
+    }
+    _stats.flushes     = 0;
+    _stats.rows_drawn  = 0;
+    _stats.chars_drawn = 0;
+}
+
+void ScreenCache::set_row(int row, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vset_row(row, fmt, args);
+    va_end(args);
+}
+
+void ScreenCache::vset_row(int row, const char* fmt, va_list args) {
+    if (row < 1 || row > SCREEN_ROWS) return;
+    vsnprintf(_pending[row - 1], SCREEN_COLS + 1, fmt, args);
+}
+
+void ScreenCache::clear_row(int row) {
+    if (row < 1 || row > SCREEN_ROWS) return;
+    _pending[row - 1][0] = '\0';
+}
+
+void ScreenCache::mark_cleared() {
+    for (int r = 0; r < SCREEN_ROWS; ++r) _drawn[r][0] = '\0';
+}
+
+const char* ScreenCache::pending_row(int row) const {
+    if (row < 1 || row > SCREEN_ROWS) return "";
+    return _pending[row - 1];
+}
+
+int ScreenCache::flush(ScreenDrawFn draw) {
+    _stats.flushes++;
+    int rows = 0;
+    char tail[SCREEN_COLS + 1];
+
+    for (int r = 0; r < SCREEN_ROWS; ++r) {
+        const char* want = _pending[r];
+        const char* have = _drawn[r];
+
+        // 找第一个不同的字符
+        int col = 0;
+        while (want[col] != '\0' && want[col] == have[col]) col++;
+        int want_len = (int)strlen(want);
+        int have_len = (int)strlen(have);
+        if (col == want_len && col == have_len) continue;  // 这一行没变
+
+        // 从 col 开始画新文字；新文字比旧的短，就用空格盖住旧的尾巴
+        int end = (want_len > have_len) ? want_len : have_len;
+        int n = 0;
+        for (int c = col; c < end; ++c) {
+            tail[n++] = (c < want_len) ? want[c] : ' ';
+        }
+        tail[n] = '\0';
+        draw(r + 1, col + 1, tail);
+
+        memcpy(_drawn[r], want, want_len + 1);
+        rows++;
+        _stats.rows_drawn++;
+        _stats.chars_drawn += n;
+    }
+    return rows;
+}
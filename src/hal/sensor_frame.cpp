@@ -0,0 +1,67 @@
+// ============================================================================
+//  hal/sensor_frame.cpp — 每拍一次的传感器采集
+// ============================================================================
+#include "hal/sensor_frame.h"
+#include "config.h"
+#include "hal/imu.h"
+#include "hal/motors.h"
+#include "hal/seqlock.h"
+#include "hal/time.h"
+#include "hal/tracking_wheels.h"
+#include <atomic>
+#include <cmath>
+
+static SeqLock<SensorFrame> latest_frame;
+static uint32_t             frame_seq = 0;   // 只有采集者改
+
+// 上一次查到的连接状态（只有采集者改）和还有几拍才再查（0 = 这一拍就查）
+static bool             status_imu_ok      = false;
+static bool             status_tracking_ok = false;
+static std::atomic<int> status_countdown(0);
+
+SensorFrame sensor_frame_acquire() {
+    SensorFrame f;
+    // 时间戳取在读传感器之前：读数是"这一刻之后马上"读到的
+    f.time_us  = get_time_us();
+    f.seq      = ++frame_seq;
+    f.reserved = 0;
+
+    // 连接状态每 SENSOR_STATUS_POLL_TICKS 拍才查一次（每次都是好几趟设备调用）
+    if (status_countdown.load() <= 0) {
+        status_tracking_ok = tracking_wheels_connected();
+        status_imu_ok      = imu_connected();
+        status_countdown.store(SENSOR_STATUS_POLL_TICKS);
+    }
+    status_countdown.fetch_sub(1);
+
+    f.forward_m    = tracking_get_forward_distance_m();
+    f.lateral_m    = tracking_get_lateral_distance_m();
+    f.has_parallel = tracking_has_parallel_wheel();
+    f.parallel_m   = f.has_parallel ? tracking_get_parallel_distance_m() : 0.0;
+    f.tracking_ok  = status_tracking_ok;
+
+    f.imu_ok           = status_imu_ok;
+    f.imu_rotation_rad = f.imu_ok ? get_imu_rotation_rad() : 0.0;
+    if (!std::isfinite(f.imu_rotation_rad)) {
+        f.imu_ok           = false;
+        f.imu_rotation_rad = 0.0;
+    }
+
+    // 驱动电机位置由 VEXos 缓存，电压命令是 HAL 记下来的值，都不花时间
+    f.left_ticks      = get_left_encoder_ticks();
+    f.right_ticks     = get_right_encoder_ticks();
+    f.left_command_v  = get_left_drive_command();
+    f.right_command_v = get_right_drive_command();
+    f.pad             = false;
+
+    latest_frame.write(f);
+    return f;
+}
+
+SensorFrame sensor_frame_latest() {
+    return latest_frame.read();
+}
+
+void sensor_frame_refresh_status() {
+    status_countdown.store(0);
+}
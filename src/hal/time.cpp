@@ -22,6 +22,11 @@ unsigned long get_time_ms() {
     return (unsigned long)vex::timer::system();
 }
 
+// timer::systemHighResolution() 返回开机到现在的微秒数（64 位，不会溢出）
+uint64_t get_time_us() {
+    return vex::timer::systemHighResolution();
+}
+
 // 让当前任务休眠 ms 毫秒
 // VEX V5 是一个实时操作系统 (RTOS)，可以同时跑多个任务。
 // sleep 会暂停当前任务，把 CPU 让给其他任务（比如里程计后台线程）。
@@ -29,3 +34,8 @@ unsigned long get_time_ms() {
 void wait_ms(int ms) {
     vex::task::sleep(ms);
 }
+
+// 睡到绝对时刻：由 RTOS 按系统时钟唤醒，不受"调用之前花了多久"影响
+void wait_until_ms(unsigned long deadline_ms) {
+    vex::this_thread::sleep_until((uint32_t)deadline_ms);
+}
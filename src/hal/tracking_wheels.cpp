@@ -24,17 +24,26 @@
 extern vex::rotation ForwardTrackingSensor;
 extern vex::rotation LateralTrackingSensor;
 
+// 平行轮是可选的：配了端口才在 init 时创建
+static vex::rotation* parallel_sensor = nullptr;
+
 // ---- 初始化 ----
 void tracking_wheels_init() {
     ForwardTrackingSensor.resetPosition();  // 纵向传感器读数归零
     LateralTrackingSensor.resetPosition();  // 横向传感器读数归零
-    hal_log("Tracking wheels initialized (perpendicular layout)");
+    if (PARALLEL_TRACKING_PORT >= 0 && parallel_sensor == nullptr) {
+        parallel_sensor = new vex::rotation(PARALLEL_TRACKING_PORT, PARALLEL_TRACKING_REVERSED);
+        parallel_sensor->resetPosition();
+    }
+    LOG_SCREENF("Tracking wheels initialized (perpendicular layout%s)",
+                parallel_sensor != nullptr ? " + parallel wheel" : "");
 }
 
 // ---- 重置读数 ----
 void tracking_wheels_reset() {
     ForwardTrackingSensor.resetPosition();
     LateralTrackingSensor.resetPosition();
+    if (parallel_sensor != nullptr) parallel_sensor->resetPosition();
 }
 
 // ---- 纵向追踪轮距离（米） ----
@@ -53,8 +62,20 @@ double tracking_get_lateral_distance_m() {
     return (degrees / 360.0) * TRACKING_WHEEL_CIRCUMFERENCE;
 }
 
+// ---- 平行轮距离（米） ----
+bool tracking_has_parallel_wheel() {
+    return parallel_sensor != nullptr;
+}
+
+double tracking_get_parallel_distance_m() {
+    if (parallel_sensor == nullptr) return 0.0;
+    double degrees = parallel_sensor->position(vex::rotationUnits::deg);
+    return (degrees / 360.0) * TRACKING_WHEEL_CIRCUMFERENCE;
+}
+
 // ---- 检查传感器连接状态 ----
-// 两个都连好了才返回 true
+// 都连好了才返回 true（配了平行轮的话平行轮也算）
 bool tracking_wheels_connected() {
-    return ForwardTrackingSensor.installed() && LateralTrackingSensor.installed();
+    return ForwardTrackingSensor.installed() && LateralTrackingSensor.installed() &&
+           (parallel_sensor == nullptr || parallel_sensor->installed());
 }
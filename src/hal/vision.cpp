@@ -4,8 +4,9 @@
 //
 //  【工作流程】
 //    1. vision_init()     → 开机时初始化，打开 AprilTag 检测模式
-//    2. vision_snapshot()  → "拍一张照"，传感器分析画面找 AprilTag
-//    3. vision_get_tag(i)  → 取出第 i 个检测到的标签的信息
+//    2. vision_snapshot()  → "拍一张照"，传感器分析画面找 AprilTag，
+//                            连同拍摄时刻、帧号写成一帧发布出去
+//    3. vision_latest_frame() → 借看最新的一帧（哪个任务都行，不加锁、不拷贝）
 //
 //  【AprilTag 是什么？】
 //    一种黑白方块图案（像超级简化的二维码），被贴在赛场墙壁上。
@@ -16,38 +17,54 @@
 // ============================================================================
 #include "hal/vision.h"
 #include "config.h"
+#include "hal/time.h"
+#include "telemetry/trace.h"
 #include "vex.h"
 
 // 视觉传感器对象在 main.cpp 里创建，这里用 extern "借用"
 extern vex::aivision VisionSensor;
 
-// ---- 内部缓冲区 ----
-// 每次拍照的结果存在这里，上层通过 vision_get_tag() 来取
-static TagDetection tag_buffer[VISION_MAX_TAGS];  // 最多存 8 个标签
-static int          tag_count = 0;                 // 上次拍到了几个标签
+// ---- 帧缓冲 ----
+// 拍照的结果写进一块空闲缓冲，写完整了才换上去，读者借看的那块不会被改
+static FrameBuffer<VisionFrame> frames;
+static uint32_t                 frame_seq = 0;   // 只有拍照的任务改
 
 // ---- 初始化 ----
 void vision_init() {
     // 打开物体检测功能（包括 AprilTag 检测）
     VisionSensor.objectDetection(true);
-    hal_log("Vision sensor initialized (AprilTag mode)");
+    LOG_SCREENF("Vision sensor initialized (AprilTag mode)");
 }
 
 // ---- 拍照并检测标签 ----
 int vision_snapshot() {
-    tag_count = 0;  // 清空上次的计数
+    TraceScope trace(TRACE_VISION_SNAPSHOT);
+
+    // 先拿一块空闲缓冲；都被借着（读者拿着老帧不还）就丢掉这一帧，不等
+    VisionFrame* f = frames.begin_write();
+    if (f == nullptr) {
+        LOG_DEBUGF("Vision: no free frame buffer, snapshot dropped (%u so far)", (unsigned)frames.dropped());
+        return 0;
+    }
+
+    // 时间戳取在拍照之前：画面是传感器在这之前拍好的，再往前推一个拍照延迟
+    uint64_t now_us = get_time_us();
+    uint64_t latency_us = (uint64_t)VISION_CAPTURE_LATENCY_MS * 1000;
+    f->time_us = (now_us > latency_us) ? now_us - latency_us : 0;
+    f->seq     = ++frame_seq;
+    f->count   = 0;
 
     // 让传感器拍一张照，检测所有类型的物体
     VisionSensor.takeSnapshot(vex::aivision::ALL_AIOBJS);
     int raw_count = VisionSensor.objectCount;  // 传感器看到了几个物体
 
     // 遍历所有检测到的物体，只保留 AprilTag 类型的
-    for (int i = 0; i < raw_count && tag_count < VISION_MAX_TAGS; ++i) {
+    for (int i = 0; i < raw_count && f->count < VISION_MAX_TAGS; ++i) {
         auto& obj = VisionSensor.objects[i];
 
         // 过滤：只要 AprilTag，忽略其他物体（比如彩色方块等）
         if (obj.type == vex::aivision::kAiVisAprilTag) {
-            TagDetection& t = tag_buffer[tag_count];
+            TagDetection& t = f->tags[f->count];
             t.id       = obj.id;        // 标签 ID
             t.center_x = obj.centerX;   // 图片中的水平位置
             t.center_y = obj.centerY;   // 图片中的垂直位置
@@ -55,33 +72,28 @@ int vision_snapshot() {
             t.height   = obj.height;    // 标签在图片里的高度
             t.angle    = obj.angle;     // 标签旋转角度
             t.valid    = true;          // 标记为有效
-            tag_count++;
+            f->count++;
         }
     }
 
-    // 如果看到了标签，记一条日志
-    if (tag_count > 0) {
-        hal_log("Vision: " + to_str(tag_count) + " AprilTag(s) detected");
+    // 整帧写完才换上去：读者看到的要么是上一帧，要么是这一帧
+    int count = f->count;
+    frames.publish();
+
+    // 如果看到了标签，记一条日志（每帧都有，所以是 DEBUG 级别）
+    if (count > 0) {
+        LOG_DEBUGF("Vision: %d AprilTag(s) detected", count);
     }
-    return tag_count;
+    return count;
 }
 
-// ---- 取出一个标签的检测结果 ----
-TagDetection vision_get_tag(int index) {
-    // 索引合法就返回缓冲区里的结果
-    if (index >= 0 && index < tag_count) {
-        return tag_buffer[index];
-    }
-    // 索引不合法就返回一个"无效"的空结构体
-    TagDetection empty;
-    empty.valid    = false;
-    empty.id       = -1;
-    empty.center_x = 0;
-    empty.center_y = 0;
-    empty.width    = 0;
-    empty.height   = 0;
-    empty.angle    = 0;
-    return empty;
+// ---- 借看最新的一帧 ----
+VisionFrameView vision_latest_frame() {
+    return frames.latest();
+}
+
+uint32_t vision_dropped_snapshots() {
+    return frames.dropped();
 }
 
 // ---- 检查传感器连接状态 ----
@@ -0,0 +1,42 @@
+// ============================================================================
+//  localization/gyro_bias.cpp — 静止检测 + 零漂估计的实现
+// ============================================================================
+#include "localization/gyro_bias.h"
+#include <algorithm>
+#include <cmath>
+
+GyroBiasEstimator::GyroBiasEstimator() {
+    reset();
+}
+
+void GyroBiasEstimator::reset() {
+    _bias      = 0.0;
+    _gyro_rate = 0.0;
+    _still_s   = 0.0;
+    _learned_s = 0.0;
+}
+
+double GyroBiasEstimator::correct(double imu_delta, const StationaryInputs& in, double dt) {
+    if (dt <= 0.0) return imu_delta;
+
+    // 这一拍像不像静止？（速度 = 这一拍的距离 ÷ dt）
+    double wheel_v = std::max(std::abs(in.wheel_forward_m), std::abs(in.wheel_lateral_m)) / dt;
+    double motor_v = std::max(std::abs(in.motor_left_m), std::abs(in.motor_right_m)) / dt;
+    _gyro_rate += dt / (STATIONARY_GYRO_TAU_S + dt) * (imu_delta / dt - _bias - _gyro_rate);
+    bool   still   = wheel_v < STATIONARY_MAX_WHEEL_MPS &&
+                     motor_v < STATIONARY_MAX_MOTOR_MPS &&
+                     std::abs(in.command_volts) < STATIONARY_MAX_VOLTS &&
+                     std::abs(_gyro_rate) < STATIONARY_MAX_GYRO_RADPS;
+    _still_s = still ? _still_s + dt : 0.0;
+
+    // 停稳了：这一拍 IMU 的读数全是零漂
+    // 先按累计时间求平均（头几拍就能用），攒够 GYRO_BIAS_TAU_S 以后变成滑动平均
+    if (stationary()) {
+        _learned_s += dt;
+        double k = dt / std::min(_learned_s, GYRO_BIAS_TAU_S);
+        _bias += k * (imu_delta / dt - _bias);
+        if (_bias >  GYRO_BIAS_MAX_RADPS) _bias =  GYRO_BIAS_MAX_RADPS;
+        if (_bias < -GYRO_BIAS_MAX_RADPS) _bias = -GYRO_BIAS_MAX_RADPS;
+    }
+    return imu_delta - _bias * dt;
+}
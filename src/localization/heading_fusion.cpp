@@ -0,0 +1,52 @@
+// ============================================================================
+//  localization/heading_fusion.cpp — 互补滤波航向的实现
+// ============================================================================
+#include "localization/heading_fusion.h"
+#include "config.h"
+#include <cmath>
+
+HeadingFusion::HeadingFusion(double alpha, double nominal_dt, bool wheels_scrub)
+    : _gain_per_s((1.0 - alpha) / nominal_dt), _scrub(wheels_scrub) {
+    reset();
+}
+
+void HeadingFusion::reset() {
+    _heading   = 0.0;
+    _reference = 0.0;
+    _stats.wheel_ticks   = 0;
+    _stats.slip_ticks    = 0;
+    _stats.dropout_ticks = 0;
+}
+
+double HeadingFusion::update(double imu_delta, bool imu_ok, double wheel_delta, bool wheel_ok, double dt) {
+    double before = _heading;
+
+    if (!imu_ok) {
+        // IMU 掉线：轮子的转角直接当航向增量（没有轮子就不动）
+        double step = wheel_ok ? wheel_delta : 0.0;
+        _heading   += step;
+        _reference += step;
+        _stats.dropout_ticks++;
+        return _heading - before;
+    }
+
+    // 这一拍轮子靠得住吗？
+    bool use_wheels = wheel_ok && dt > 0.0 &&
+                      std::abs(wheel_delta - imu_delta) <= HEADING_SLIP_RATE_RADPS * dt &&
+                      !(_scrub && std::abs(imu_delta) > HEADING_WHEEL_MAX_RATE_RADPS * dt);
+    if (use_wheels) {
+        _reference += wheel_delta;
+        _stats.wheel_ticks++;
+    } else {
+        _reference += imu_delta;   // 跟着 IMU 走，打滑的这一下不会被拉进来
+        if (wheel_ok) _stats.slip_ticks++;
+    }
+
+    // 先按 IMU 走，再往参考角拉一点
+    double k = _gain_per_s * dt;
+    if (k > 1.0) k = 1.0;
+    if (k < 0.0) k = 0.0;
+    _heading += imu_delta;
+    _heading += k * (_reference - _heading);
+    return _heading - before;
+}
@@ -0,0 +1,87 @@
+// ============================================================================
+//  localization/multi_tag.cpp — 多标签联合求解的实现
+// ============================================================================
+#include "localization/multi_tag.h"
+#include "config.h"
+#include <cmath>
+
+// 角度差归到 (−π, π]
+static double wrap_heading(double a) {
+    return atan2(sin(a), cos(a));
+}
+
+// 在位姿 p 处把所有标签线性化，累加正规方程 A·Δ = b（先验也算进去）
+// 顺便累加残差平方和（以标准差为单位，不乘置信度）
+static void accumulate(const TagMeasurement* tags, int count, const Pose& prior, const Pose& p,
+                       Matrix<3, 3>* A, Matrix<3, 1>* b, double* chi2) {
+    const double wxy = 1.0 / (VISION_MULTI_TAG_PRIOR_SIGMA_XY * VISION_MULTI_TAG_PRIOR_SIGMA_XY);
+    const double wt  = 1.0 / (VISION_MULTI_TAG_PRIOR_SIGMA_THETA * VISION_MULTI_TAG_PRIOR_SIGMA_THETA);
+    *A = Matrix<3, 3>::zero();
+    (*A)(0, 0) = wxy;
+    (*A)(1, 1) = wxy;
+    (*A)(2, 2) = wt;
+    (*b)(0, 0) = wxy * (prior.x - p.x);
+    (*b)(1, 0) = wxy * (prior.y - p.y);
+    (*b)(2, 0) = wt * wrap_heading(prior.theta - p.theta);
+    *chi2 = 0.0;
+
+    for (int i = 0; i < count; ++i) {
+        const TagMeasurement& m = tags[i];
+        if (m.confidence <= 0.0) continue;
+        double r, phi;
+        Matrix<2, 3> H;
+        if (!vision_predict_tag(p, m.tag_x, m.tag_y, &r, &phi, &H)) continue;
+
+        double sr = EKF_RANGE_SIGMA_MIN_M + EKF_RANGE_SIGMA_PER_M * m.range;
+        double res[2] = { (m.range - r) / sr, wrap_heading(m.bearing - phi) / EKF_BEARING_SIGMA_RAD };
+        double inv_sigma[2] = { 1.0 / sr, 1.0 / EKF_BEARING_SIGMA_RAD };
+        *chi2 += res[0] * res[0] + res[1] * res[1];
+
+        // 每一行先除以 σ（白化），再乘 √置信度：权重 = 置信度 / σ²
+        double sw = sqrt(m.confidence);
+        for (int k = 0; k < 2; ++k) {
+            double row[3];
+            for (int j = 0; j < 3; ++j) row[j] = H(k, j) * inv_sigma[k] * sw;
+            for (int j = 0; j < 3; ++j) {
+                for (int c = 0; c < 3; ++c) (*A)(j, c) += row[j] * row[c];
+                (*b)(j, 0) += row[j] * res[k] * sw;
+            }
+        }
+    }
+}
+
+MultiTagSolution multi_tag_solve(const TagMeasurement* tags, int count, const Pose& initial) {
+    MultiTagSolution out;
+    out.pose        = initial;
+    out.sigma_xy    = 0.0;
+    out.sigma_theta = 0.0;
+    out.rms         = 0.0;
+    out.tags_used   = 0;
+    out.ok          = false;
+
+    for (int i = 0; i < count; ++i) {
+        if (tags[i].confidence > 0.0) out.tags_used++;
+    }
+    if (out.tags_used < VISION_MULTI_TAG_MIN_TAGS) return out;
+
+    Matrix<3, 3> A, A_inv;
+    Matrix<3, 1> b;
+    double chi2 = 0.0;
+    for (int iter = 0; iter < VISION_MULTI_TAG_ITERATIONS; ++iter) {
+        accumulate(tags, count, initial, out.pose, &A, &b, &chi2);
+        if (!matrix_invert(A, &A_inv)) return out;
+        Matrix<3, 1> step = A_inv * b;
+        out.pose.x     += step(0, 0);
+        out.pose.y     += step(1, 0);
+        out.pose.theta += step(2, 0);   // 不回绕：和里程计的航向保持连续
+    }
+
+    // 最后在解出来的位姿上再算一遍：残差和协方差都以最终结果为准
+    accumulate(tags, count, initial, out.pose, &A, &b, &chi2);
+    if (!matrix_invert(A, &A_inv)) return out;
+    out.sigma_xy    = sqrt(0.5 * (A_inv(0, 0) + A_inv(1, 1)));
+    out.sigma_theta = sqrt(A_inv(2, 2));
+    out.rms         = sqrt(chi2 / (2.0 * out.tags_used));
+    out.ok          = out.rms <= VISION_MULTI_TAG_MAX_RMS;
+    return out;
+}
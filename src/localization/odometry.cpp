@@ -6,7 +6,7 @@
 //
 //    与平行双轮不同，垂直双轮可以同时测量前后和左右两个方向的位移：
 //
-//    第 1 步：读取传感器
+//    第 1 步：读取传感器（这一拍的 SensorFrame，见 hal/sensor_frame.h）
 //      • 纵向轮 → 这次前后走了多远（Δforward）
 //      • 横向轮 → 这次左右滑了多远（Δlateral）
 //      • IMU    → 这次转了多少角度（Δθ）
@@ -18,39 +18,89 @@
 //        Δlateral_corrected = Δlateral - LATERAL_WHEEL_OFFSET × Δθ
 //
 //    第 3 步：转换到全局坐标
-//      用中点近似法，把机器人坐标系的位移转到场地坐标系：
-//        x += Δforward × cos(θ+Δθ/2) - Δlateral × sin(θ+Δθ/2)
-//        y += Δforward × sin(θ+Δθ/2) + Δlateral × cos(θ+Δθ/2)
+//      按中点朝向，把机器人坐标系的位移转到场地坐标系：
+//        x += k × (Δforward × cos(θ+Δθ/2) - Δlateral × sin(θ+Δθ/2))
+//        y += k × (Δforward × sin(θ+Δθ/2) + Δlateral × cos(θ+Δθ/2))
 //        θ += Δθ
+//      默认用圆弧法：k = sin(Δθ/2) / (Δθ/2)（弦长 ÷ 弧长），转弯时也是精确的；
+//      k = 1 就是中点近似法（ODOM_INTEGRATOR 可选，见 pose_history.cpp）
 //
 //    以 100Hz（每秒 100 次）在后台线程中不断重复以上 3 步。
 //
+//    第 1 步里的 Δθ 不直接用 IMU：IMU 和轮子算出来的转角先做互补滤波
+//    （heading_fusion.cpp），修正 IMU 的零漂；IMU 掉线时用轮子顶上。
+//    车停稳的时候还会顺便量一下陀螺仪零漂（gyro_bias.cpp），之后每一拍都减掉。
+//
+//    第 3 步由卡尔曼滤波（pose_ekf.cpp）的"预测"完成：位姿用同一个公式推进，
+//    顺便把这一步的不确定度累加进协方差。视觉标签的"更新"也改的是同一份状态。
+//
 // ============================================================================
 #include "localization/odometry.h"
+#include "localization/gyro_bias.h"
+#include "localization/heading_fusion.h"
+#include "localization/particle_filter.h"
+#include "localization/pose_ekf.h"
+#include "localization/pose_history.h"
+#include "localization/twist_estimator.h"
 #include "config.h"
 #include "hal/motors.h"
 #include "hal/imu.h"
 #include "hal/hal_log.h"
+#include "hal/periodic_timer.h"
+#include "hal/sensor_frame.h"
+#include "hal/seqlock.h"
+#include "hal/time.h"
 #include "hal/tracking_wheels.h"
+#include "telemetry/loop_stats.h"
+#include "telemetry/trace.h"
 #include "vex.h"
+#include <algorithm>
 #include <cmath>
 
-// ---- 线程安全的位姿变量 ----
-static vex::mutex pose_mutex;
-static Pose current_pose = {0.0, 0.0, 0.0};
+// ---- 位姿：写者私有的工作副本 + 发布给读者的快照 ----
+// 写位姿的有三个地方（里程计任务、set_pose、视觉修正的 set_pose_no_reset），
+// 它们之间用 pose_writer_mutex 排队；读者只读发布出来的快照，从不加锁。
+struct OdomPublished {
+    PoseSnapshot  snapshot;
+    OdomRawInputs raw;
+};
+
+static vex::mutex               pose_writer_mutex;
+static Pose                     current_pose = {0.0, 0.0, 0.0};
+static uint32_t                 publish_seq  = 0;
+static SeqLock<OdomPublished>   published;
+static PoseHistory              history;       // 最近 ~1.3 秒的（时间, 位姿, 增量），也归写者管
+static PoseEkf                  ekf;           // 位姿 + 协方差；current_pose 始终等于 ekf.pose()
+static ParticleFilter           particles;     // 只有选了粒子滤波才会 init（否则 count() == 0，什么都不做）
+static TwistEstimator           twist;         // 速度 / 加速度（只看增量，视觉修正不影响）
+static HeadingFusion            heading(IMU_FUSION_ALPHA, LOOP_INTERVAL_MS / 1000.0,
+                                        PARALLEL_TRACKING_PORT < 0);  // 驱动电机会蹭地
+static GyroBiasEstimator        gyro_bias;     // 停稳时估计的零漂；set_pose 不清（还是同一个 IMU）
 
 // ---- 上一次的传感器读数（用于计算增量）----
 static double prev_forward_dist  = 0.0;   // 上一次纵向轮累计距离
 static double prev_lateral_dist  = 0.0;   // 上一次横向轮累计距离
 static double prev_imu_rotation  = 0.0;   // 上一次 IMU 累计旋转量
+static double prev_wheel_rotation = 0.0;  // 上一次轮子算出来的累计转角
+static double prev_left_m        = 0.0;   // 上一次左侧驱动电机累计距离
+static double prev_right_m       = 0.0;   // 上一次右侧驱动电机累计距离
+static bool   prev_imu_ok        = true;  // 上一次 IMU 能不能用（从掉线恢复时要重新对齐）
+static double last_update_dt     = 0.0;   // 上一次更新的真实 dt（秒）
+static double   last_left_command_v  = 0.0;   // 上一次更新那一帧的电压命令（发布给日志用）
+static double   last_right_command_v = 0.0;
+static uint32_t last_sensor_seq      = 0;     // 上一次更新用的是第几帧
 
 // ---- 后台任务 ----
 static vex::task* odom_task_ptr = nullptr;
+static LoopStats  odom_loop_stats("odom", LOOP_INTERVAL_MS);
 
 static int odometry_task_fn() {
+    // 睡到绝对截止时间：周期稳定在 10 ms，不会因为计算时间和调度延迟越跑越慢
+    PeriodicTimer period(LOOP_INTERVAL_MS, &odom_loop_stats);
     while (true) {
-        odometry_update();
-        vex::task::sleep(LOOP_INTERVAL_MS);
+        double dt = period.wait();
+        ScopedLoopTimer timer(odom_loop_stats);
+        odometry_update(dt);
     }
     return 0;
 }
@@ -58,7 +108,7 @@ static int odometry_task_fn() {
 void odometry_start_task() {
     if (odom_task_ptr == nullptr) {
         odom_task_ptr = new vex::task(odometry_task_fn);
-        hal_log("Odometry task started (100 Hz, perpendicular tracking wheels)");
+        LOG_SCREENF("Odometry task started (100 Hz, perpendicular tracking wheels)");
     }
 }
 
@@ -67,24 +117,101 @@ void odometry_stop_task() {
         odom_task_ptr->stop();
         delete odom_task_ptr;
         odom_task_ptr = nullptr;
-        hal_log("Odometry task stopped");
+        LOG_SCREENF("Odometry task stopped");
     }
 }
 
+// ---- 发布一份快照（调用者必须拿着 pose_writer_mutex）----
+// prev_* 正好就是这次更新读到的传感器累计值，一起发布给日志用
+static void publish_locked(uint64_t time_us) {
+    OdomPublished out;
+    out.snapshot.pose     = current_pose;
+    out.snapshot.velocity = twist.velocity();
+    out.snapshot.accel    = twist.accel();
+    out.snapshot.seq      = ++publish_seq;
+    out.snapshot.reserved = 0;
+    out.snapshot.time_us  = time_us;
+    out.raw.forward_m     = prev_forward_dist;
+    out.raw.lateral_m     = prev_lateral_dist;
+    out.raw.imu_rad       = prev_imu_rotation;
+    out.raw.dt_s          = last_update_dt;
+    out.raw.left_command_v  = last_left_command_v;
+    out.raw.right_command_v = last_right_command_v;
+    out.raw.frame_seq       = last_sensor_seq;
+    out.raw.reserved        = 0;
+    published.write(out);
+}
+
+// ---- 轮子算出来的累计转角（弧度）----
+//   平行轮：纵向轮和平行轮走的距离差 ÷ 两轮的侧向间距（不打滑）
+//   没有平行轮：右侧和左侧驱动电机走的距离差 ÷ 轮距
+static double frame_wheel_rotation(const SensorFrame& frame, double left_m, double right_m) {
+    if (frame.has_parallel) {
+        return (frame.forward_m - frame.parallel_m) / (FORWARD_WHEEL_OFFSET - PARALLEL_WHEEL_OFFSET);
+    }
+    return (right_m - left_m) / WHEEL_TRACK;
+}
+
 // ---- 核心：一次里程计更新 ----
-void odometry_update() {
-    // 第 1 步：读取传感器当前累计值，然后算出增量
-    double fwd_dist = tracking_get_forward_distance_m();
-    double lat_dist = tracking_get_lateral_distance_m();
+void odometry_update(double dt) {
+    // 第 1 步：这一拍所有传感器只读一次（读传感器比较慢，放在锁外面）
+    odometry_update_from(sensor_frame_acquire(), dt);
+}
+
+void odometry_update_from(const SensorFrame& frame, double dt) {
+    TraceScope trace(TRACE_ODOMETRY_UPDATE);
+
+    double fwd_dist = frame.forward_m;
+    double lat_dist = frame.lateral_m;
+    bool   imu_ok   = frame.imu_ok;
+    double imu_rotation = imu_ok ? frame.imu_rotation_rad : prev_imu_rotation;
+    // 航向融合和静止检测都要用驱动电机走的距离
+    double m_per_tick = WHEEL_CIRCUMFERENCE / TICKS_PER_REV;
+    double left_m  = frame.left_ticks * m_per_tick;
+    double right_m = frame.right_ticks * m_per_tick;
+    double wheel_rotation = frame_wheel_rotation(frame, left_m, right_m);
+
+    // 从这里开始改写者私有的状态，和 set_pose() 排队
+    pose_writer_mutex.lock();
+
+    // 算出增量
     double d_forward = fwd_dist - prev_forward_dist;   // 纵向轮这一步走了多远
     double d_lateral = lat_dist - prev_lateral_dist;    // 横向轮这一步滑了多远
-    prev_forward_dist = fwd_dist;
-    prev_lateral_dist = lat_dist;
+    double d_imu = imu_rotation - prev_imu_rotation;    // IMU 这一步转了多少
+    double d_wheel = wheel_rotation - prev_wheel_rotation;  // 轮子说这一步转了多少
+    prev_forward_dist   = fwd_dist;
+    prev_lateral_dist   = lat_dist;
+    prev_imu_rotation   = imu_rotation;
+    prev_wheel_rotation = wheel_rotation;
+
+    // IMU 刚从掉线恢复：读数是从新的零点开始的，这一拍的差值不算，只对齐
+    // 拔插太快、installed() 没来得及变 false 时，只能从读数看出来：
+    // 一拍里变得比 IMU 能测的还快（IMU_MAX_RATE_RADPS），而且落回了 0 附近
+    double max_step = IMU_MAX_RATE_RADPS * dt;
+    bool imu_jumped = imu_ok && prev_imu_ok &&
+                      std::abs(d_imu) > max_step && std::abs(imu_rotation) <= max_step;
+    bool imu_usable = imu_ok && prev_imu_ok && !imu_jumped;
+    if (imu_ok && (!prev_imu_ok || imu_jumped)) gyro_bias.reset();   // 重新插上会重新校准，零漂也要重新量
+    prev_imu_ok = imu_ok;
 
-    // 从 IMU 读取旋转角度增量
-    double imu_rotation = get_imu_rotation_rad();
-    double dtheta = imu_rotation - prev_imu_rotation;
-    prev_imu_rotation = imu_rotation;
+    // 静止检测 + 减掉零漂（IMU 不能用的拍不参与）
+    if (imu_usable) {
+        StationaryInputs still;
+        still.wheel_forward_m = d_forward;
+        still.wheel_lateral_m = d_lateral;
+        still.motor_left_m    = left_m - prev_left_m;
+        still.motor_right_m   = right_m - prev_right_m;
+        still.command_volts   = std::max(std::abs(frame.left_command_v),
+                                         std::abs(frame.right_command_v));
+        d_imu = gyro_bias.correct(d_imu, still, dt);
+    }
+    prev_left_m  = left_m;
+    prev_right_m = right_m;
+
+    // 互补滤波：短时间听 IMU，长时间听轮子；IMU 不能用时只用轮子
+    // 轮子的角度来自平行追踪轮时，追踪轮掉线就不能用（驱动电机编码器没有掉线一说）
+    bool wheel_ok = !frame.has_parallel || frame.tracking_ok;
+    double dtheta = heading.update(d_imu, imu_usable, d_wheel, wheel_ok, dt);
 
     // 第 2 步：补偿旋转引起的假位移
     //   当机器人转动 Δθ 时，偏移旋转中心的轮子会画弧线，
@@ -92,31 +219,59 @@ void odometry_update() {
     double d_fwd_corrected = d_forward - FORWARD_WHEEL_OFFSET * dtheta;
     double d_lat_corrected = d_lateral - LATERAL_WHEEL_OFFSET * dtheta;
 
-    // 第 3 步：从机器人坐标系转换到场地全局坐标系
-    pose_mutex.lock();
-    double mid_theta = current_pose.theta + dtheta / 2.0;
-    //   纵向位移沿机器人前方，横向位移沿机器人右方
-    //   注意：场地坐标系 y 轴朝左，所以横向向右为负 y
-    current_pose.x     += d_fwd_corrected * cos(mid_theta) - d_lat_corrected * sin(mid_theta);
-    current_pose.y     += d_fwd_corrected * sin(mid_theta) + d_lat_corrected * cos(mid_theta);
-    current_pose.theta += dtheta;
-    pose_mutex.unlock();
+    // 第 3 步：从机器人坐标系转换到场地全局坐标系（EKF 预测，ODOM_INTEGRATOR 选的积分方法）
+    OdomDelta delta = { d_fwd_corrected, d_lat_corrected, dtheta };
+    ekf.predict(delta);
+    particles.predict(delta);
+    twist.update(delta, dt);
+    current_pose   = ekf.pose();
+    last_update_dt = dt;
+    last_left_command_v  = frame.left_command_v;
+    last_right_command_v = frame.right_command_v;
+    last_sensor_seq      = frame.seq;
+
+    // 第 4 步：记进历史（以后可以在这个时刻施加修正），再整份发布
+    //   时间用采集时刻：位姿对应的是传感器读数的那一瞬间，不是算完的时候
+    history.push(frame.time_us, current_pose, delta);
+    publish_locked(frame.time_us);
+    pose_writer_mutex.unlock();
 }
 
 Pose get_pose() {
-    pose_mutex.lock();
-    Pose copy = current_pose;
-    pose_mutex.unlock();
-    return copy;
+    return published.read().snapshot.pose;
+}
+
+PoseSnapshot get_pose_snapshot() {
+    return published.read().snapshot;
+}
+
+Twist get_velocity() {
+    return published.read().snapshot.velocity;
+}
+
+OdomRawInputs odometry_get_raw_inputs(PoseSnapshot* snapshot) {
+    OdomPublished p = published.read();   // 一次拷贝：位姿和原始值一定是同一拍的
+    if (snapshot != nullptr) *snapshot = p.snapshot;
+    return p.raw;
 }
 
 void set_pose(const Pose& new_pose) {
-    pose_mutex.lock();
+    pose_writer_mutex.lock();
     current_pose       = new_pose;
-    prev_forward_dist  = 0;
-    prev_lateral_dist  = 0;
-    prev_imu_rotation  = 0.0;
-    pose_mutex.unlock();
+    ekf.reset(new_pose);
+    particles.reset(new_pose);
+    twist.reset();
+    heading.reset();
+    prev_forward_dist   = 0;
+    prev_lateral_dist   = 0;
+    prev_imu_rotation   = 0.0;
+    prev_wheel_rotation = 0.0;
+    prev_left_m         = 0.0;
+    prev_right_m        = 0.0;
+    prev_imu_ok         = true;   // IMU 也刚归零，和 prev_imu_rotation 对得上
+    history.clear();  // 坐标系重新开始，旧历史没有意义了
+    publish_locked(get_time_us());
+    pose_writer_mutex.unlock();
 
     reset_encoders();
     reset_imu();
@@ -124,7 +279,101 @@ void set_pose(const Pose& new_pose) {
 }
 
 void set_pose_no_reset(const Pose& new_pose) {
-    pose_mutex.lock();
+    pose_writer_mutex.lock();
     current_pose = new_pose;
-    pose_mutex.unlock();
+    ekf.set_pose(new_pose);
+    // 最新一条历史也跟着改，之后的重放从这里接着走
+    uint64_t now_us = get_time_us();
+    history.correct_at(now_us, new_pose, nullptr);
+    publish_locked(now_us);
+    pose_writer_mutex.unlock();
+}
+
+bool odometry_pose_at(uint64_t time_us, Pose* out) {
+    pose_writer_mutex.lock();
+    bool ok = history.pose_at(time_us, out);
+    pose_writer_mutex.unlock();
+    return ok;
+}
+
+bool odometry_correct_at(uint64_t time_us, const Pose& corrected) {
+    pose_writer_mutex.lock();
+    Pose newest;
+    bool ok = history.correct_at(time_us, corrected, &newest);
+    if (ok) {
+        current_pose = newest;
+        ekf.set_pose(newest);
+        publish_locked(get_time_us());
+    }
+    pose_writer_mutex.unlock();
+    return ok;
+}
+
+bool odometry_shift_at(uint64_t time_us, const Pose& offset) {
+    pose_writer_mutex.lock();
+    Pose newest;
+    bool ok = history.shift_at(time_us, offset, &newest);
+    if (ok) {
+        current_pose = newest;
+        ekf.set_pose(newest);
+        publish_locked(get_time_us());
+    }
+    pose_writer_mutex.unlock();
+    return ok;
+}
+
+bool odometry_ekf_update(const TagMeasurement& meas) {
+    pose_writer_mutex.lock();
+    bool accepted = ekf.update_tag(meas) == EKF_UPDATE_ACCEPTED;
+    if (accepted) {
+        current_pose = ekf.pose();
+        uint64_t now_us = get_time_us();
+        history.correct_at(now_us, current_pose, nullptr);
+        publish_locked(now_us);
+    }
+    pose_writer_mutex.unlock();
+    return accepted;
+}
+
+double odometry_get_gyro_bias(bool* stationary) {
+    pose_writer_mutex.lock();
+    double bias = gyro_bias.bias();
+    if (stationary != nullptr) *stationary = gyro_bias.stationary();
+    pose_writer_mutex.unlock();
+    return bias;
+}
+
+void odometry_get_uncertainty(double* sigma_x, double* sigma_y, double* sigma_theta) {
+    pose_writer_mutex.lock();
+    Matrix<3, 3> P = ekf.covariance();
+    pose_writer_mutex.unlock();
+    *sigma_x     = sqrt(P(0, 0));
+    *sigma_y     = sqrt(P(1, 1));
+    *sigma_theta = sqrt(P(2, 2));
+}
+
+bool odometry_particle_filter_init(int particle_count) {
+    pose_writer_mutex.lock();
+    bool ok = particles.init(particle_count);
+    if (ok) particles.reset(current_pose);
+    pose_writer_mutex.unlock();
+    if (ok) LOG_INFOF("Particle filter: %d particles", particle_count);
+    return ok;
+}
+
+bool odometry_particle_update(const TagMeasurement* tags, int count) {
+    if (count <= 0) return false;
+    pose_writer_mutex.lock();
+    bool ok = particles.count() > 0;
+    if (ok) {
+        for (int i = 0; i < count; ++i) particles.update_tag(tags[i]);
+        particles.finish_update();
+        current_pose = particles.estimate();
+        ekf.set_pose(current_pose);
+        uint64_t now_us = get_time_us();
+        history.correct_at(now_us, current_pose, nullptr);
+        publish_locked(now_us);
+    }
+    pose_writer_mutex.unlock();
+    return ok;
 }
@@ -0,0 +1,318 @@
+// ============================================================================
+//  localization/particle_filter.cpp — 粒子滤波的实现
+// ============================================================================
+//
+//  【预测：不用 sin/cos 的转向】
+//    每个粒子除了 θ，还存着 cos θ 和 sin θ。每一步只转一个很小的角度 d
+//    （100 Hz 下一般不到 0.05 弧度），用泰勒展开就够准了：
+//      cos(d/2) ≈ 1 − h²/2，sin(d/2) ≈ h − h³/6   （h = d/2）
+//    先转半步得到中点朝向，按中点公式走一步，再转半步。
+//    这里故意不跟 ODOM_INTEGRATOR 走：圆弧法只比中点公式多乘一个弦长系数
+//    sin(h)/h ≈ 1 − h²/6，一步最多差万分之几，比每个粒子加的运动噪声小得多。
+//    最后用一步牛顿迭代把 (cos, sin) 的长度拉回 1，误差不会越积越多。
+//
+//  【更新：不用 atan2 的方位误差】
+//    测量方位（赛场坐标）的单位向量 u = R(θ + 摄像头角 + 方位) = R(θ)·(ca, sa)，
+//    粒子看标签的方向是 d = 标签 − 摄像头。
+//    cos(方位误差) = u·d / |d|，方位似然用 κ·(cos 误差 − 1)（κ = 1/σ²）。
+//    误差小时它就等于 −误差²/(2σ²)，和高斯一样；误差大时不会无限变小。
+//    每个粒子的对数似然再和 PF_LOGLIK_FLOOR 取大：一次误检最多扣这么多分，
+//    不会把所有粒子一次杀光。
+//
+//  【系统重采样】
+//    把权重排成一条长度为 W 的线段，放 n 把间隔 W/n 的"梳子齿"，
+//    起点只随机一次。每个齿落在哪个粒子上就复制哪个——O(n)，
+//    权重高的粒子被复制的次数正比于权重，方差比每次独立抽签小。
+//
+//  【什么时候撒恢复粒子】（Thrun 的 Augmented MCL）
+//    w_slow / w_fast = 似然的长期 / 短期平均。被撞了之后所有粒子都对不上，
+//    w_fast 掉得比 w_slow 快。w_fast 低于 w_slow 的 PF_INJECT_BELOW 倍时，
+//    按 1 − w_fast/(PF_INJECT_BELOW·w_slow) 的比例在估计位置周围撒新粒子。
+//
+// ============================================================================
+#include "localization/particle_filter.h"
+#include "config.h"
+#include <cmath>
+#include <new>
+
+static const int PF_NORMAL_TABLE_SIZE = 4096;  // 必须是 2 的幂
+static const int PF_ARENA_ARRAYS      = 16;    // 每个粒子占几个 float
+
+ParticleFilter::ParticleFilter()
+    : _n(0), _arena(nullptr),
+      _x(nullptr), _y(nullptr), _th(nullptr), _c(nullptr), _s(nullptr),
+      _x2(nullptr), _y2(nullptr), _th2(nullptr), _c2(nullptr), _s2(nullptr),
+      _logw(nullptr), _ll(nullptr), _w(nullptr),
+      _noise0(nullptr), _noise1(nullptr), _noise2(nullptr), _normal_table(nullptr),
+      _frame_tags(0), _rng(12345) {
+    _stats.updates   = 0;
+    _stats.resamples = 0;
+    _stats.injected  = 0;
+    _stats.ess       = 0.0;
+    _stats.w_slow    = 0.0;
+    _stats.w_fast    = 0.0;
+}
+
+ParticleFilter::~ParticleFilter() {
+    delete[] _arena;
+}
+
+bool ParticleFilter::init(int count, uint32_t seed) {
+    if (_arena != nullptr || count <= 0) return false;
+    _arena = new (std::nothrow) float[(size_t)count * PF_ARENA_ARRAYS + PF_NORMAL_TABLE_SIZE];
+    if (_arena == nullptr) return false;
+    _n = count;
+
+    float* p = _arena;
+    float** arrays[PF_ARENA_ARRAYS] = {
+        &_x, &_y, &_th, &_c, &_s, &_x2, &_y2, &_th2, &_c2, &_s2,
+        &_logw, &_ll, &_w, &_noise0, &_noise1, &_noise2
+    };
+    for (int k = 0; k < PF_ARENA_ARRAYS; ++k) {
+        *arrays[k] = p;
+        p += count;
+    }
+    _normal_table = p;
+
+    // 正态随机数表：Box-Muller，只在这里算一次
+    _rng = seed ? seed : 1;
+    for (int i = 0; i < PF_NORMAL_TABLE_SIZE; i += 2) {
+        double u1 = (next_random() >> 8) * (1.0 / 16777216.0) + 1e-9;
+        double u2 = (next_random() >> 8) * (1.0 / 16777216.0);
+        double r  = sqrt(-2.0 * log(u1));
+        _normal_table[i]     = (float)(r * cos(2.0 * M_PI * u2));
+        _normal_table[i + 1] = (float)(r * sin(2.0 * M_PI * u2));
+    }
+
+    Pose origin = {0.0, 0.0, 0.0};
+    reset(origin);
+    return true;
+}
+
+// ---- xorshift32：几条指令一个随机数 ----
+uint32_t ParticleFilter::next_random() {
+    uint32_t v = _rng;
+    v ^= v << 13;
+    v ^= v >> 17;
+    v ^= v << 5;
+    _rng = v;
+    return v;
+}
+
+float ParticleFilter::uniform() {
+    return (next_random() >> 8) * (1.0f / 16777216.0f);
+}
+
+float ParticleFilter::gaussian() {
+    return _normal_table[next_random() & (PF_NORMAL_TABLE_SIZE - 1)];
+}
+
+void ParticleFilter::fill_noise(float* out) {
+    for (int i = 0; i < _n; ++i) out[i] = gaussian();
+}
+
+// 从第 from 个粒子到最后，撒在 center 周围
+void ParticleFilter::scatter(int from, const Pose& center, double sigma_xy, double sigma_theta) {
+    for (int i = from; i < _n; ++i) {
+        double th = center.theta + sigma_theta * gaussian();
+        _x[i]  = (float)(center.x + sigma_xy * gaussian());
+        _y[i]  = (float)(center.y + sigma_xy * gaussian());
+        _th[i] = (float)th;
+        _c[i]  = (float)cos(th);
+        _s[i]  = (float)sin(th);
+    }
+}
+
+void ParticleFilter::reset(const Pose& pose) {
+    if (_n == 0) return;
+    scatter(0, pose, PF_INIT_SIGMA_XY, PF_INIT_SIGMA_THETA);
+    for (int i = 0; i < _n; ++i) {
+        _logw[i] = 0.0f;
+        _ll[i]   = 0.0f;
+    }
+    _frame_tags   = 0;
+    _stats.w_slow = 0.0;
+    _stats.w_fast = 0.0;
+    _stats.ess    = _n;
+}
+
+void ParticleFilter::predict(const OdomDelta& delta) {
+    if (_n == 0) return;
+    fill_noise(_noise0);
+    fill_noise(_noise1);
+    fill_noise(_noise2);
+
+    const float f  = (float)delta.forward;
+    const float l  = (float)delta.lateral;
+    const float d  = (float)delta.dtheta;
+    const float sf = (float)(PF_ODOM_NOISE_BASE_M  + PF_ODOM_NOISE_PER_M  * fabs(delta.forward));
+    const float sl = (float)(PF_ODOM_NOISE_BASE_M  + PF_ODOM_NOISE_PER_M  * fabs(delta.lateral));
+    const float st = (float)(PF_IMU_NOISE_BASE_RAD + PF_IMU_NOISE_PER_RAD * fabs(delta.dtheta));
+
+    float* __restrict x  = _x;
+    float* __restrict y  = _y;
+    float* __restrict th = _th;
+    float* __restrict c  = _c;
+    float* __restrict s  = _s;
+    const float* __restrict n0 = _noise0;
+    const float* __restrict n1 = _noise1;
+    const float* __restrict n2 = _noise2;
+
+    for (int i = 0; i < _n; ++i) {
+        float fi = f + sf * n0[i];
+        float li = l + sl * n1[i];
+        float di = d + st * n2[i];
+        float h  = 0.5f * di;
+        float ch = 1.0f - 0.5f * h * h;
+        float sh = h - h * h * h * (1.0f / 6.0f);
+        float cm = c[i] * ch - s[i] * sh;   // 中点朝向（故意用中点公式，见文件头）
+        float sm = s[i] * ch + c[i] * sh;
+        x[i] += fi * cm - li * sm;
+        y[i] += fi * sm + li * cm;
+        float c2 = cm * ch - sm * sh;       // 再转半步
+        float s2 = sm * ch + cm * sh;
+        float k  = 1.5f - 0.5f * (c2 * c2 + s2 * s2);  // 长度拉回 1
+        c[i]  = c2 * k;
+        s[i]  = s2 * k;
+        th[i] += di;
+    }
+}
+
+void ParticleFilter::update_tag(const TagMeasurement& meas) {
+    if (_n == 0) return;
+    // 传感器本身的噪声和卡尔曼滤波用同一组参数
+    const double sr = EKF_RANGE_SIGMA_MIN_M + EKF_RANGE_SIGMA_PER_M * meas.range;
+    const float  half_inv_var_r = (float)(0.5 / (sr * sr));
+    const float  kappa = (float)(1.0 / (EKF_BEARING_SIGMA_RAD * EKF_BEARING_SIGMA_RAD));
+    const float  ca = (float)cos(VISION_CAMERA_ANGLE + meas.bearing);
+    const float  sa = (float)sin(VISION_CAMERA_ANGLE + meas.bearing);
+    const float  tx = (float)meas.tag_x, ty = (float)meas.tag_y;
+    const float  range = (float)meas.range;
+    const float  ox = (float)VISION_CAMERA_OFFSET_X, oy = (float)VISION_CAMERA_OFFSET_Y;
+    const float  floor_ll = (float)PF_LOGLIK_FLOOR;
+
+    const float* __restrict x = _x;
+    const float* __restrict y = _y;
+    const float* __restrict c = _c;
+    const float* __restrict s = _s;
+    float* __restrict ll = _ll;
+
+    for (int i = 0; i < _n; ++i) {
+        float cx = x[i] + ox * c[i] - oy * s[i];
+        float cy = y[i] + ox * s[i] + oy * c[i];
+        float dx = tx - cx;
+        float dy = ty - cy;
+        float r  = sqrtf(dx * dx + dy * dy) + 1e-6f;
+        float dr = r - range;
+        float ux = c[i] * ca - s[i] * sa;   // 测量方位的单位向量（赛场坐标）
+        float uy = s[i] * ca + c[i] * sa;
+        float cos_err = (ux * dx + uy * dy) / r;
+        float l = -half_inv_var_r * dr * dr + kappa * (cos_err - 1.0f);
+        ll[i] += (l > floor_ll) ? l : floor_ll;
+    }
+    _frame_tags++;
+}
+
+// 归一化权重（最大的 = 1），顺便算和与平方和
+void ParticleFilter::compute_weights(float* w, double* sum_w, double* sum_w2) const {
+    float max_lw = _logw[0];
+    for (int i = 1; i < _n; ++i) max_lw = (_logw[i] > max_lw) ? _logw[i] : max_lw;
+    double s1 = 0.0, s2 = 0.0;
+    for (int i = 0; i < _n; ++i) {
+        w[i] = expf(_logw[i] - max_lw);
+        s1 += w[i];
+        s2 += (double)w[i] * w[i];
+    }
+    *sum_w  = s1;
+    *sum_w2 = s2;
+}
+
+bool ParticleFilter::finish_update() {
+    if (_n == 0 || _frame_tags == 0) return false;
+
+    // 这一帧的平均似然（按原来的权重加权；多个标签取几何平均，和标签数无关）
+    double sum_w, sum_w2;
+    compute_weights(_w, &sum_w, &sum_w2);
+    double avg = 0.0;
+    float inv_tags = 1.0f / _frame_tags;
+    for (int i = 0; i < _n; ++i) {
+        avg += _w[i] * expf(_ll[i] * inv_tags);
+        _logw[i] += _ll[i];
+        _ll[i] = 0.0f;
+    }
+    avg /= sum_w;
+    _frame_tags = 0;
+
+    if (_stats.w_slow == 0.0) {
+        _stats.w_slow = avg;
+        _stats.w_fast = avg;
+    } else {
+        _stats.w_slow += PF_ALPHA_SLOW * (avg - _stats.w_slow);
+        _stats.w_fast += PF_ALPHA_FAST * (avg - _stats.w_fast);
+    }
+    _stats.updates++;
+
+    compute_weights(_w, &sum_w, &sum_w2);
+    _stats.ess = sum_w * sum_w / sum_w2;
+
+    // 短期似然掉到长期的 PF_INJECT_BELOW 以下才撒（平时的起伏不算被撞）
+    double inject_ratio = 1.0 - _stats.w_fast / (PF_INJECT_BELOW * _stats.w_slow);
+    if (inject_ratio > PF_MAX_INJECT_FRACTION) inject_ratio = PF_MAX_INJECT_FRACTION;
+    int inject = (inject_ratio > 0.0) ? (int)(inject_ratio * _n) : 0;
+
+    if (inject == 0 && _stats.ess >= PF_RESAMPLE_ESS_RATIO * _n) return false;
+    resample(inject, sum_w);
+    return true;
+}
+
+// _w / sum_w 是 compute_weights() 刚算好的
+void ParticleFilter::resample(int inject, double sum_w) {
+    Pose center = estimate();   // 恢复粒子撒在重采样前的估计周围
+
+    int    keep = _n - inject;
+    double step = sum_w / keep;
+    double target = uniform() * step;
+    double cum = _w[0];
+    int    j = 0;
+    for (int i = 0; i < keep; ++i) {
+        while (cum < target && j < _n - 1) {
+            ++j;
+            cum += _w[j];
+        }
+        _x2[i] = _x[j];  _y2[i] = _y[j];  _th2[i] = _th[j];
+        _c2[i] = _c[j];  _s2[i] = _s[j];
+        target += step;
+    }
+
+    float* t;
+    t = _x;  _x  = _x2;  _x2  = t;
+    t = _y;  _y  = _y2;  _y2  = t;
+    t = _th; _th = _th2; _th2 = t;
+    t = _c;  _c  = _c2;  _c2  = t;
+    t = _s;  _s  = _s2;  _s2  = t;
+
+    scatter(keep, center, PF_RECOVERY_SIGMA_XY, PF_RECOVERY_SIGMA_THETA);
+    for (int i = 0; i < _n; ++i) _logw[i] = 0.0f;
+
+    _stats.resamples++;
+    _stats.injected += inject;
+}
+
+Pose ParticleFilter::estimate() const {
+    Pose out = {0.0, 0.0, 0.0};
+    if (_n == 0) return out;
+    float max_lw = _logw[0];
+    for (int i = 1; i < _n; ++i) max_lw = (_logw[i] > max_lw) ? _logw[i] : max_lw;
+    double sw = 0.0, sx = 0.0, sy = 0.0, sth = 0.0;
+    for (int i = 0; i < _n; ++i) {
+        double w = expf(_logw[i] - max_lw);
+        sw  += w;
+        sx  += w * _x[i];
+        sy  += w * _y[i];
+        sth += w * _th[i];   // θ 没有取模（和里程计一样连续累加），直接平均
+    }
+    out.x     = sx / sw;
+    out.y     = sy / sw;
+    out.theta = sth / sw;
+    return out;
+}
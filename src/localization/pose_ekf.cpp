@@ -0,0 +1,143 @@
+// ============================================================================
+//  localization/pose_ekf.cpp — 扩展卡尔曼滤波的实现
+// ============================================================================
+//
+//  【预测】（位姿用 pose_integrate 推进；雅可比按中点公式算，
+//    圆弧法只比它多乘一个接近 1 的弦长系数，对协方差的影响可以忽略）
+//    mid = θ + Δθ/2
+//    x' = x + f·cos(mid) − l·sin(mid)
+//    y' = y + f·sin(mid) + l·cos(mid)
+//    θ' = θ + Δθ
+//
+//    F = ∂x'/∂x = | 1 0 a |     a = −f·sin(mid) − l·cos(mid)
+//                 | 0 1 b |     b =  f·cos(mid) − l·sin(mid)
+//                 | 0 0 1 |
+//    G = ∂x'/∂(f, l, Δθ)，里程计噪声 Σ 经过 G 变成状态噪声 Q = G Σ Gᵀ
+//    P' = F P Fᵀ + Q
+//
+//  【测量模型】（vision_geometry.cpp 的 vision_predict_tag，多标签求解也用它）
+//    摄像头位置  cam = 机器人 + R(θ)·(OX, OY)
+//    预测距离    r = |tag − cam|
+//    预测方位    φ = atan2(tag − cam) − θ − 摄像头安装角
+//    H = ∂(r, φ)/∂(x, y, θ)，2×3
+//
+//  【更新】
+//    S = H P Hᵀ + R          （预测测量的不确定度）
+//    K = P Hᵀ S⁻¹            （卡尔曼增益：信测量多少）
+//    x ← x + K·(z − h(x))
+//    P ← (I − KH) P (I − KH)ᵀ + K R Kᵀ   （Joseph 形式，数值上保持正定）
+//
+//  【恢复】连续 EKF_RECOVERY_GATED_TAGS 个标签被拒绝 → P 的对角线加上恢复方差，
+//    同一个测量按新的 P 重新算一遍（见 pose_ekf.h）
+//
+// ============================================================================
+#include "localization/pose_ekf.h"
+#include "config.h"
+#include <cmath>
+
+static double wrap_angle(double a) {
+    return atan2(sin(a), cos(a));
+}
+
+PoseEkf::PoseEkf() {
+    Pose origin = {0.0, 0.0, 0.0};
+    reset(origin);
+}
+
+void PoseEkf::reset(const Pose& pose) {
+    _pose = pose;
+    _P = Matrix<3, 3>::zero();
+    _P(0, 0) = EKF_INIT_SIGMA_XY * EKF_INIT_SIGMA_XY;
+    _P(1, 1) = EKF_INIT_SIGMA_XY * EKF_INIT_SIGMA_XY;
+    _P(2, 2) = EKF_INIT_SIGMA_THETA * EKF_INIT_SIGMA_THETA;
+    _stats.predicts = 0;
+    _stats.accepted = 0;
+    _stats.gated    = 0;
+    _stats.recoveries = 0;
+    _stats.last_nis = 0.0;
+    _gated_run      = 0;
+}
+
+void PoseEkf::set_pose(const Pose& pose) {
+    _pose = pose;
+}
+
+void PoseEkf::predict(const OdomDelta& delta) {
+    double mid = _pose.theta + delta.dtheta / 2.0;
+    double c = cos(mid), s = sin(mid);
+    double a = -delta.forward * s - delta.lateral * c;
+    double b =  delta.forward * c - delta.lateral * s;
+
+    Matrix<3, 3> F = Matrix<3, 3>::identity();
+    F(0, 2) = a;
+    F(1, 2) = b;
+
+    // 噪声输入 (f, l, Δθ) 对状态的影响；Δθ 只经过 mid 用了一半
+    Matrix<3, 3> G = Matrix<3, 3>::zero();
+    G(0, 0) = c;  G(0, 1) = -s;  G(0, 2) = a / 2.0;
+    G(1, 0) = s;  G(1, 1) =  c;  G(1, 2) = b / 2.0;
+    G(2, 2) = 1.0;
+
+    // 噪声随走过的距离和转过的角度增长，再加一点底噪（静止时也会慢慢变得不确定）
+    double sf = EKF_ODOM_NOISE_BASE_M   + EKF_ODOM_NOISE_PER_M   * fabs(delta.forward);
+    double sl = EKF_ODOM_NOISE_BASE_M   + EKF_ODOM_NOISE_PER_M   * fabs(delta.lateral);
+    double st = EKF_IMU_NOISE_BASE_RAD  + EKF_IMU_NOISE_PER_RAD  * fabs(delta.dtheta);
+    Matrix<3, 3> sigma = Matrix<3, 3>::zero();
+    sigma(0, 0) = sf * sf;
+    sigma(1, 1) = sl * sl;
+    sigma(2, 2) = st * st;
+
+    _P = (F * _P * F.transpose() + G * sigma * G.transpose()).symmetrized();
+    _pose = pose_integrate(_pose, delta);
+    _stats.predicts++;
+}
+
+EkfUpdateResult PoseEkf::update_tag(const TagMeasurement& meas) {
+    double r, phi;
+    Matrix<2, 3> H;
+    if (!vision_predict_tag(_pose, meas.tag_x, meas.tag_y, &r, &phi, &H)) return EKF_UPDATE_INVALID;
+
+    // 测量噪声：距离误差和距离成正比（远处的标签像素少），方位误差固定
+    double sr = EKF_RANGE_SIGMA_MIN_M + EKF_RANGE_SIGMA_PER_M * meas.range;
+    Matrix<2, 2> Rm = Matrix<2, 2>::zero();
+    Rm(0, 0) = sr * sr;
+    Rm(1, 1) = EKF_BEARING_SIGMA_RAD * EKF_BEARING_SIGMA_RAD;
+
+    Matrix<3, 2> Ht = H.transpose();
+    Matrix<2, 1> y;
+    y(0, 0) = meas.range - r;
+    y(1, 0) = wrap_angle(meas.bearing - phi);
+
+    Matrix<2, 2> S, S_inv;
+    while (true) {
+        S = H * _P * Ht + Rm;
+        if (!matrix_invert(S, &S_inv)) return EKF_UPDATE_INVALID;
+
+        // 马氏距离² = yᵀ S⁻¹ y，服从 2 自由度卡方分布
+        double nis = (y.transpose() * S_inv * y)(0, 0);
+        _stats.last_nis = nis;
+        if (nis <= EKF_GATE_CHI2) break;
+
+        _stats.gated++;
+        if (++_gated_run < EKF_RECOVERY_GATED_TAGS) return EKF_UPDATE_GATED;
+
+        // 连续被拒绝太多：是自己错了，放大不确定度，这个测量重新过一次门限
+        _P(0, 0) += EKF_RECOVERY_SIGMA_XY * EKF_RECOVERY_SIGMA_XY;
+        _P(1, 1) += EKF_RECOVERY_SIGMA_XY * EKF_RECOVERY_SIGMA_XY;
+        _P(2, 2) += EKF_RECOVERY_SIGMA_THETA * EKF_RECOVERY_SIGMA_THETA;
+        _gated_run = 0;
+        _stats.recoveries++;
+    }
+    _gated_run = 0;
+
+    Matrix<3, 2> K  = _P * Ht * S_inv;
+    Matrix<3, 1> dx_state = K * y;
+    _pose.x    += dx_state(0, 0);
+    _pose.y    += dx_state(1, 0);
+    _pose.theta += dx_state(2, 0);
+
+    Matrix<3, 3> I_KH = Matrix<3, 3>::identity() - K * H;
+    _P = (I_KH * _P * I_KH.transpose() + K * Rm * K.transpose()).symmetrized();
+    _stats.accepted++;
+    return EKF_UPDATE_ACCEPTED;
+}
@@ -0,0 +1,125 @@
+// ============================================================================
+//  localization/pose_history.cpp — 位姿历史的实现
+// ============================================================================
+#include "localization/pose_history.h"
+#include <cmath>
+
+// ---- 三种积分方法 ----
+//   纵向位移沿机器人前方，横向位移沿机器人右方
+//   注意：场地坐标系 y 轴朝左，所以横向向右为负 y
+//
+//   中点法：整步的位移都按中点朝向 θ + Δθ/2 摆放
+//   圆弧法：这一步里速度（机器人坐标系）不变 → 走的是一段圆弧。
+//           圆弧的弦也指向中点朝向，只是比弧长短：弦长 = 弧长 × sin(h)/h，h = Δθ/2
+//           所以只比中点法多乘一个系数；h 很小时用泰勒展开，避免 0/0
+//   RK2  ：起点朝向和终点朝向各放一半位移（Heun 法 / 梯形法）
+
+// 位移 (f, l) 按朝向 theta 转到场地坐标，乘 scale 后加到 p 上
+static void add_rotated(Pose* p, double f, double l, double theta, double scale) {
+    double c = cos(theta), s = sin(theta);
+    p->x += scale * (f * c - l * s);
+    p->y += scale * (f * s + l * c);
+}
+
+Pose pose_integrate_with(int integrator, const Pose& start, const OdomDelta& delta) {
+    Pose p = start;
+    double mid_theta = start.theta + delta.dtheta / 2.0;
+    if (integrator == ODOM_INTEGRATOR_ARC) {
+        double h = delta.dtheta / 2.0;
+        double chord = (fabs(h) < 1e-4) ? 1.0 - h * h / 6.0 : sin(h) / h;
+        add_rotated(&p, delta.forward, delta.lateral, mid_theta, chord);
+    } else if (integrator == ODOM_INTEGRATOR_RK2) {
+        add_rotated(&p, delta.forward, delta.lateral, start.theta, 0.5);
+        add_rotated(&p, delta.forward, delta.lateral, start.theta + delta.dtheta, 0.5);
+    } else {
+        add_rotated(&p, delta.forward, delta.lateral, mid_theta, 1.0);
+    }
+    p.theta = start.theta + delta.dtheta;
+    return p;
+}
+
+Pose pose_integrate(const Pose& start, const OdomDelta& delta) {
+    return pose_integrate_with(ODOM_INTEGRATOR, start, delta);
+}
+
+PoseHistory::PoseHistory() {
+    clear();
+}
+
+void PoseHistory::clear() {
+    _oldest = 0;
+    _count  = 0;
+}
+
+void PoseHistory::push(uint64_t time_us, const Pose& pose, const OdomDelta& delta) {
+    int slot;
+    if (_count < POSE_HISTORY_CAPACITY) {
+        slot = (_oldest + _count) % POSE_HISTORY_CAPACITY;
+        _count++;
+    } else {
+        slot = _oldest;  // 满了：覆盖最旧的
+        _oldest = (_oldest + 1) % POSE_HISTORY_CAPACITY;
+    }
+    _entries[slot].time_us = time_us;
+    _entries[slot].pose    = pose;
+    _entries[slot].delta   = delta;
+}
+
+const PoseHistoryEntry& PoseHistory::at(int i) const {
+    return _entries[(_oldest + i) % POSE_HISTORY_CAPACITY];
+}
+
+int PoseHistory::find_index(uint64_t time_us) const {
+    // 在 [lo, hi) 里找第一条"时间 > t"的记录，它前面那条就是答案
+    int lo = 0, hi = _count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (at(mid).time_us <= time_us) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo - 1;
+}
+
+bool PoseHistory::pose_at(uint64_t time_us, Pose* out) const {
+    int i = find_index(time_us);
+    if (i < 0) return false;
+    if (i == _count - 1) {
+        *out = at(i).pose;
+        return true;
+    }
+
+    // 在第 i 和 i+1 条之间按时间线性插值
+    const PoseHistoryEntry& a = at(i);
+    const PoseHistoryEntry& b = at(i + 1);
+    double f = (double)(time_us - a.time_us) / (double)(b.time_us - a.time_us);
+    out->x     = a.pose.x     + f * (b.pose.x     - a.pose.x);
+    out->y     = a.pose.y     + f * (b.pose.y     - a.pose.y);
+    out->theta = a.pose.theta + f * (b.pose.theta - a.pose.theta);  // 累计角度，不会跳变
+    return true;
+}
+
+bool PoseHistory::correct_at(uint64_t time_us, const Pose& corrected, Pose* newest) {
+    int i = find_index(time_us);
+    if (i < 0) return false;
+
+    entry(i).pose = corrected;
+    for (int j = i + 1; j < _count; ++j) {
+        entry(j).pose = pose_integrate(entry(j - 1).pose, entry(j).delta);
+    }
+    if (newest != nullptr) *newest = at(_count - 1).pose;
+    return true;
+}
+
+bool PoseHistory::shift_at(uint64_t time_us, const Pose& offset, Pose* newest) {
+    int i = find_index(time_us);
+    if (i < 0) return false;
+
+    Pose shifted = at(i).pose;
+    shifted.x     += offset.x;
+    shifted.y     += offset.y;
+    shifted.theta += offset.theta;
+    return correct_at(at(i).time_us, shifted, newest);
+}
@@ -0,0 +1,46 @@
+// ============================================================================
+//  localization/twist_estimator.cpp — 速度 / 加速度估计的实现
+// ============================================================================
+#include "localization/twist_estimator.h"
+#include "config.h"
+
+static const Twist ZERO_TWIST = {0.0, 0.0, 0.0};
+
+// 一阶低通：value 朝 target 走 alpha 那么多
+static void low_pass(Twist* value, const Twist& target, double alpha) {
+    value->forward += alpha * (target.forward - value->forward);
+    value->lateral += alpha * (target.lateral - value->lateral);
+    value->omega   += alpha * (target.omega   - value->omega);
+}
+
+TwistEstimator::TwistEstimator() {
+    reset();
+}
+
+void TwistEstimator::reset() {
+    _velocity = ZERO_TWIST;
+    _accel    = ZERO_TWIST;
+    _primed   = false;
+}
+
+void TwistEstimator::update(const OdomDelta& delta, double dt) {
+    if (dt <= 0.0) return;
+
+    Twist raw = { delta.forward / dt, delta.lateral / dt, delta.dtheta / dt };
+    Twist prev = _velocity;
+    if (_primed) {
+        low_pass(&_velocity, raw, dt / (ODOM_VELOCITY_FILTER_TAU_S + dt));
+    } else {
+        _velocity = raw;   // 第一拍直接用，不从 0 慢慢爬上来
+    }
+
+    if (ODOM_ESTIMATE_ACCEL && _primed) {
+        Twist raw_accel = {
+            (_velocity.forward - prev.forward) / dt,
+            (_velocity.lateral - prev.lateral) / dt,
+            (_velocity.omega   - prev.omega)   / dt,
+        };
+        low_pass(&_accel, raw_accel, dt / (ODOM_ACCEL_FILTER_TAU_S + dt));
+    }
+    _primed = true;
+}
@@ -0,0 +1,204 @@
+// ============================================================================
+//  localization/vision_geometry.cpp — 视觉定位的几何计算
+// ============================================================================
+#include "localization/vision_geometry.h"
+#include "config.h"
+#include <cmath>
+
+// ============================================================================
+//  赛场标签地图 —— 每个标签在赛场上的已知位置
+// ============================================================================
+//
+//  ⚠ 根据你的具体赛场布局修改这里！
+//  每个标签需要：ID、X坐标、Y坐标、离地高度、朝向角度
+//
+//  VEX V5 赛场尺寸：3.6576m × 3.6576m（12英尺 × 12英尺）
+//  标签通常贴在赛场四周的围墙上。
+//
+//  facing（朝向）= 标签表面法线方向（标签面朝哪个方向）
+//    例如：贴在左墙上的标签面朝右 → facing = 0（+x 方向）
+//
+//  赛场俯视图：
+//  ┌───────────────────────────────────┐
+//  │             +y 墙壁               │  ← 标签面朝 -y (3π/2)
+//  │ Tag3                         Tag4 │
+//  │                                   │
+//  │ +x墙壁                      -x墙壁│
+//  │ Tag1                         Tag2 │
+//  │ (面朝+x)                 (面朝-x) │
+//  │                                   │
+//  │ Tag5                         Tag6 │
+//  │             -y 墙壁               │  ← 标签面朝 +y (π/2)
+//  └───────────────────────────────────┘
+//     原点(0,0) = 左下角
+//
+const FieldTag FIELD_TAGS[] = {
+    // ID,  X坐标(m), Y坐标(m), 高度(m), 朝向(弧度)
+    {  1,    0.0,      1.22,     0.15,   0.0         },  // 左墙下方
+    {  2,    3.6576,   1.22,     0.15,   M_PI        },  // 右墙下方
+    {  3,    0.0,      2.44,     0.15,   0.0         },  // 左墙上方
+    {  4,    3.6576,   2.44,     0.15,   M_PI        },  // 右墙上方
+    {  5,    0.91,     0.0,      0.15,   M_PI / 2    },  // 下墙左侧
+    {  6,    2.74,     0.0,      0.15,   M_PI / 2    },  // 下墙右侧
+    {  7,    0.91,     3.6576,   0.15,   3*M_PI / 2  },  // 上墙左侧
+    {  8,    2.74,     3.6576,   0.15,   3*M_PI / 2  },  // 上墙右侧
+};
+const int NUM_FIELD_TAGS = sizeof(FIELD_TAGS) / sizeof(FIELD_TAGS[0]);
+
+const FieldTag* find_field_tag(int id) {
+    for (int i = 0; i < NUM_FIELD_TAGS; ++i) {
+        if (FIELD_TAGS[i].id == id) return &FIELD_TAGS[i];
+    }
+    return nullptr;
+}
+
+/// 原理：真实大小 × 焦距 / 像素大小
+/// 就像你用手指比划——远处的东西在指间显得更小
+double vision_estimate_distance(double pixel_size) {
+    if (pixel_size < MIN_TAG_PIXELS) return -1.0;  // 标签太小，不可信
+    return (APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH) / pixel_size;
+}
+
+/// 图片中心 = 正前方（方位角=0）
+/// 偏右 = 正角度，偏左 = 负角度
+double vision_estimate_bearing(double center_x) {
+    double pixel_offset = center_x - (VISION_IMAGE_WIDTH / 2.0);
+    return atan2(pixel_offset, VISION_FOCAL_LENGTH);
+}
+
+double vision_compute_confidence(double distance, double pixel_size) {
+    if (distance <= 0 || distance > MAX_VISION_RANGE) return 0.0;
+
+    // 距离因子：越近越好（线性递减）
+    double dist_conf = 1.0 - (distance / MAX_VISION_RANGE);
+    if (dist_conf < 0) dist_conf = 0;
+
+    // 大小因子：图片里标签越大越好
+    // 100 像素大约对应近距离，设为满分 1.0
+    double size_conf = pixel_size / 100.0;
+    if (size_conf > 1.0) size_conf = 1.0;
+
+    // 两个因子相乘 → 只有距离近且标签够大时，置信度才高
+    return dist_conf * size_conf;
+}
+
+void vision_camera_position(const Pose& robot, double* cam_x, double* cam_y) {
+    double c = cos(robot.theta), s = sin(robot.theta);
+    *cam_x = robot.x + VISION_CAMERA_OFFSET_X * c - VISION_CAMERA_OFFSET_Y * s;
+    *cam_y = robot.y + VISION_CAMERA_OFFSET_X * s + VISION_CAMERA_OFFSET_Y * c;
+}
+
+bool vision_predict_tag(const Pose& robot, double tag_x, double tag_y,
+                        double* range, double* bearing, Matrix<2, 3>* H) {
+    double ct = cos(robot.theta), st = sin(robot.theta);
+    double cam_x, cam_y;
+    vision_camera_position(robot, &cam_x, &cam_y);
+
+    double dx = tag_x - cam_x;
+    double dy = tag_y - cam_y;
+    double r2 = dx * dx + dy * dy;
+    if (r2 < 1e-6) return false;
+    double r = sqrt(r2);
+    double phi = atan2(dy, dx) - robot.theta - VISION_CAMERA_ANGLE;
+    *range   = r;
+    *bearing = atan2(sin(phi), cos(phi));
+    if (H == nullptr) return true;
+
+    // 摄像头位置对 θ 的导数
+    double cx_t = -VISION_CAMERA_OFFSET_X * st - VISION_CAMERA_OFFSET_Y * ct;
+    double cy_t =  VISION_CAMERA_OFFSET_X * ct - VISION_CAMERA_OFFSET_Y * st;
+
+    (*H)(0, 0) = -dx / r;
+    (*H)(0, 1) = -dy / r;
+    (*H)(0, 2) = (-dx * cx_t - dy * cy_t) / r;
+    (*H)(1, 0) =  dy / r2;
+    (*H)(1, 1) = -dx / r2;
+    (*H)(1, 2) = (-dx * cy_t + dy * cx_t) / r2 - 1.0;
+    return true;
+}
+
+void vision_robot_from_tag(double tag_x, double tag_y, double range, double bearing,
+                           double robot_theta, double* x, double* y) {
+    // 赛场方位 = 机器人当前航向 + 摄像头安装角度 + 摄像头看到的角度
+    double bearing_field = robot_theta + VISION_CAMERA_ANGLE + bearing;
+
+    // 已知标签在 (tag_x, tag_y)，摄像头在距标签 range 的方向上，
+    // 再减去摄像头相对机器人中心的偏移量
+    *x = tag_x - range * cos(bearing_field)
+         - VISION_CAMERA_OFFSET_X * cos(robot_theta)
+         + VISION_CAMERA_OFFSET_Y * sin(robot_theta);
+    *y = tag_y - range * sin(bearing_field)
+         - VISION_CAMERA_OFFSET_X * sin(robot_theta)
+         - VISION_CAMERA_OFFSET_Y * cos(robot_theta);
+}
+
+TagMeasurement vision_carry_forward(const TagMeasurement& meas, const Pose& then, const Pose& now) {
+    // 拍照时看到的标签在里程计坐标系里的位置（和 vision_predict_tag 同一套方位约定）
+    double cam_x, cam_y;
+    vision_camera_position(then, &cam_x, &cam_y);
+    double dir = then.theta + VISION_CAMERA_ANGLE + meas.bearing;
+    double seen_x = cam_x + meas.range * cos(dir);
+    double seen_y = cam_y + meas.range * sin(dir);
+
+    TagMeasurement out = meas;
+    if (!vision_predict_tag(now, seen_x, seen_y, &out.range, &out.bearing, nullptr)) return meas;
+    return out;
+}
+
+bool vision_heading_from_tag(double facing, double width_px, double height_px, double bearing,
+                             double near_theta, double* heading, double* sigma) {
+    if (height_px < MIN_TAG_PIXELS) return false;
+
+    // 宽高比 → 斜看的角度。噪声可能让宽度比高度还大一点，当成正对着
+    double ratio = width_px / height_px;
+    if (ratio > 1.0) ratio = 1.0;
+    double a = acos(ratio);
+
+    // 两种正负号各算一个航向，选离里程计近的
+    double base = facing + M_PI - bearing - VISION_CAMERA_ANGLE;
+    double plus  = near_theta + atan2(sin(base + a - near_theta), cos(base + a - near_theta));
+    double minus = near_theta + atan2(sin(base - a - near_theta), cos(base - a - near_theta));
+    *heading = (fabs(plus - near_theta) <= fabs(minus - near_theta)) ? plus : minus;
+
+    // 误差传播：宽高比的误差 σ_r，acos 的斜率是 1/sin(a)；
+    // 正对着（a ≈ 0）时 acos 在 1 附近像 √(2(1−r))，用这个上限
+    double sigma_ratio = VISION_TAG_PIXEL_SIGMA * sqrt(1.0 + ratio * ratio) / height_px;
+    double sin_a = sin(a);
+    double sigma_a = sqrt(2.0 * sigma_ratio);
+    if (sin_a > 0.0 && sigma_ratio / sin_a < sigma_a) sigma_a = sigma_ratio / sin_a;
+    *sigma = sqrt(sigma_a * sigma_a + EKF_BEARING_SIGMA_RAD * EKF_BEARING_SIGMA_RAD);
+    return true;
+}
+
+double vision_heading_confidence(double sigma) {
+    double k = sigma / VISION_HEADING_SIGMA_REF;
+    return 1.0 / (1.0 + k * k);
+}
+
+Pose vision_blend_heading(const Pose& current, double heading, double heading_confidence) {
+    Pose out = current;
+    double err = atan2(sin(heading - current.theta), cos(heading - current.theta));
+    if (fabs(err) > VISION_HEADING_MAX_ERROR_RAD) return out;   // 差太多，不信
+
+    double step = VISION_HEADING_CORRECTION_ALPHA * heading_confidence * err;
+    if (step >  VISION_HEADING_MAX_STEP_RAD) step =  VISION_HEADING_MAX_STEP_RAD;
+    if (step < -VISION_HEADING_MAX_STEP_RAD) step = -VISION_HEADING_MAX_STEP_RAD;
+    out.theta = current.theta + step;
+    return out;
+}
+
+Pose vision_blend_pose(const Pose& current, double est_x, double est_y, double confidence) {
+    // 互补滤波器：α 越大，越信任视觉；越小，越信任里程计
+    // 实际 α = 基础 α × 置信度（置信度越高，修正力度越大）
+    double alpha = VISION_CORRECTION_ALPHA * confidence;
+
+    // α 不能太大，防止一次异常的视觉读数导致位置大幅跳跃
+    if (alpha > VISION_MAX_CORRECTION_ALPHA) alpha = VISION_MAX_CORRECTION_ALPHA;
+
+    // 加权融合：新位置 = (1-α) × 里程计 + α × 视觉
+    Pose corrected;
+    corrected.x     = (1.0 - alpha) * current.x + alpha * est_x;
+    corrected.y     = (1.0 - alpha) * current.y + alpha * est_y;
+    corrected.theta = current.theta;  // 航向角不用视觉修正（IMU 更可靠）
+    return corrected;
+}
@@ -25,232 +25,339 @@
 //      越近的标签、在图片里越大的标签，结果越可信。
 //      太远或太小的标签会被丢弃（不可信）。
 //
-//  如果同时看到多个标签，取置信度最高的那个。
+//  如果同时看到多个标签：所有标签的距离和方位一起做加权最小二乘，
+//  同时解出 x、y、θ（multi_tag.cpp）。解不出来或者标签互相矛盾时，
+//  才退回"取置信度最高的那个"。
 //
 //  【视觉 → 里程计融合】
 //    不是直接替换里程计的位置（那样会跳来跳去），而是慢慢修正：
 //    新位置 = (1 - α) × 里程计位置 + α × 视觉位置
 //    α 越大修正越猛，越小修正越柔和。这叫"互补滤波器"。
 //
+//    VISION_FUSION_MODE = VISION_FUSION_EKF 时，看到的每个标签都作为一次
+//    "距离 + 方位"测量交给里程计里的卡尔曼滤波，由它按不确定度决定修正多少；
+//    VISION_FUSION_PARTICLE 时交给粒子滤波，被撞偏以后也能找回来。
+//
+//  【航向】
+//    以前航向永远用里程计的，IMU 的漂移没人管，自治时间越长偏得越多。
+//    现在每一帧也估一个航向：多个标签时用联合求解的 θ；
+//    单个标签时用它在图片里被压扁的程度（宽 / 高）+ 标签朝向 + 方位角。
+//    两种都带自己的标准差，选更准的那个，换算成航向置信度。
+//    互补滤波模式下按置信度、有上限地拉航向。卡尔曼滤波和粒子滤波本来就用方位角
+//    修正航向，不需要这一步。
+//
+//  【延迟补偿】
+//    拍照 → 识别 → 算完，结果出来时画面已经是几十毫秒前的了，全速（1.5 m/s）
+//    开的时候车早就又走了好几厘米。拿这个结果和"现在"的位姿比，
+//    就会把车往回拽——以前只好在慢的时候才敢信视觉。
+//    现在：
+//      ① 每一帧都带着拍摄时刻（VisionFrame::time_us）
+//      ② 从里程计历史里查出那个时刻的位姿，所有计算都相对它
+//      ③ 互补滤波：修正量（视觉 − 当时的位姿）加回那个时刻，
+//         再用之后的里程计增量重放到现在（odometry_shift_at）
+//         卡尔曼滤波 / 粒子滤波：把每个测量"搬"到现在的位姿（vision_carry_forward），
+//         用的也是这段时间里程计走过的相对运动
+//    历史里查不到（刚 set_pose 过）时退回老办法：按现在的位姿算。
+//
+//  公式本身都在 vision_geometry.cpp 里，这个文件只负责调摄像头和调度。
+//
 // ============================================================================
 #include "localization/vision_localizer.h"
+#include "localization/multi_tag.h"
+#include "localization/odometry.h"
 #include "config.h"
-#include "hal/vision.h"
 #include "hal/hal_log.h"
+#include "hal/time.h"
+#include "telemetry/flight_recorder.h"
+#include "telemetry/trace.h"
 #include <cmath>
 
-// ============================================================================
-//  赛场标签地图 —— 每个标签在赛场上的已知位置
-// ============================================================================
-//
-//  ⚠ 根据你的具体赛场布局修改这里！
-//  每个标签需要：ID、X坐标、Y坐标、离地高度、朝向角度
-//
-//  VEX V5 赛场尺寸：3.6576m × 3.6576m（12英尺 × 12英尺）
-//  标签通常贴在赛场四周的围墙上。
-//
-//  facing（朝向）= 标签表面法线方向（标签面朝哪个方向）
-//    例如：贴在左墙上的标签面朝右 → facing = 0（+x 方向）
-//
-//  赛场俯视图：
-//  ┌───────────────────────────────────┐
-//  │             +y 墙壁               │  ← 标签面朝 -y (3π/2)
-//  │ Tag3                         Tag4 │
-//  │                                   │
-//  │ +x墙壁                      -x墙壁│
-//  │ Tag1                         Tag2 │
-//  │ (面朝+x)                 (面朝-x) │
-//  │                                   │
-//  │ Tag5                         Tag6 │
-//  │             -y 墙壁               │  ← 标签面朝 +y (π/2)
-//  └───────────────────────────────────┘
-//     原点(0,0) = 左下角
-//
-static const FieldTag FIELD_TAGS[] = {
-    // ID,  X坐标(m), Y坐标(m), 高度(m), 朝向(弧度)
-    {  1,    0.0,      1.22,     0.15,   0.0         },  // 左墙下方
-    {  2,    3.6576,   1.22,     0.15,   M_PI        },  // 右墙下方
-    {  3,    0.0,      2.44,     0.15,   0.0         },  // 左墙上方
-    {  4,    3.6576,   2.44,     0.15,   M_PI        },  // 右墙上方
-    {  5,    0.91,     0.0,      0.15,   M_PI / 2    },  // 下墙左侧
-    {  6,    2.74,     0.0,      0.15,   M_PI / 2    },  // 下墙右侧
-    {  7,    0.91,     3.6576,   0.15,   3*M_PI / 2  },  // 上墙左侧
-    {  8,    2.74,     3.6576,   0.15,   3*M_PI / 2  },  // 上墙右侧
-};
-static constexpr int NUM_FIELD_TAGS = sizeof(FIELD_TAGS) / sizeof(FIELD_TAGS[0]);
-
 // 记录上一次拍到了几个标签
-static int last_tag_count = 0;
-
-// ============================================================================
-//  辅助函数
-// ============================================================================
-
-/// 查找标签 ID 对应的赛场已知位置。找不到返回 nullptr
-static const FieldTag* find_field_tag(int id) {
-    for (int i = 0; i < NUM_FIELD_TAGS; ++i) {
-        if (FIELD_TAGS[i].id == id) return &FIELD_TAGS[i];
-    }
-    return nullptr;
-}
+static int      last_tag_count = 0;
+static uint32_t last_frame_seq = 0;   // 处理过的最后一帧（同一帧不处理两遍）
 
-/// 用"小孔成像模型"估算标签距离
-/// 原理：真实大小 × 焦距 / 像素大小
-/// 就像你用手指比划——远处的东西在指间显得更小
-static double estimate_distance(double pixel_size) {
-    if (pixel_size < MIN_TAG_PIXELS) return -1.0;  // 标签太小，不可信
-    return (APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH) / pixel_size;
-}
-
-/// 估算标签的方位角（标签在图片中偏左还是偏右）
-/// 图片中心 = 正前方（方位角=0）
-/// 偏右 = 正角度，偏左 = 负角度
-static double estimate_bearing(double center_x) {
-    double pixel_offset = center_x - (VISION_IMAGE_WIDTH / 2.0);
-    return atan2(pixel_offset, VISION_FOCAL_LENGTH);
-}
-
-/// 计算置信度（0~1，越大越可信）
-/// 距离越近 + 标签在图片里越大 → 越可信
-static double compute_confidence(double distance, double pixel_size) {
-    if (distance <= 0 || distance > MAX_VISION_RANGE) return 0.0;
-
-    // 距离因子：越近越好（线性递减）
-    double dist_conf = 1.0 - (distance / MAX_VISION_RANGE);
-    if (dist_conf < 0) dist_conf = 0;
-
-    // 大小因子：图片里标签越大越好
-    // 100 像素大约对应近距离，设为满分 1.0
-    double size_conf = pixel_size / 100.0;
-    if (size_conf > 1.0) size_conf = 1.0;
-
-    // 两个因子相乘 → 只有距离近且标签够大时，置信度才高
-    return dist_conf * size_conf;
-}
+// 流水线计数（只有估算任务写）
+static uint32_t     frames_processed = 0;
+static uint32_t     frames_stale     = 0;
+static LogHistogram frame_age_us;
 
 // ============================================================================
-//  公开接口
+//  估算一帧
 // ============================================================================
 
-void vision_localizer_init() {
-    last_tag_count = 0;
-    hal_log("Vision localizer initialized with " + to_str(NUM_FIELD_TAGS) + " field tags");
+// "什么都没有"的结果
+static void clear_estimate(VisionEstimate& e) {
+    e.valid = false;
+    e.confidence = 0.0;
+    e.x = 0;
+    e.y = 0;
+    e.heading = 0;
+    e.heading_sigma = 0;
+    e.heading_confidence = 0;
+    e.tags_used = 0;
+    e.tag_count = 0;
+    e.capture_time_us = 0;
+    e.capture_pose = { 0.0, 0.0, 0.0 };
 }
 
-// ---- 拍照 + 处理标签 → 返回最佳位置估算 ----
-VisionEstimate vision_localizer_update() {
-    // 先准备一个"无效"的结果（如果什么都没看到就返回这个）
-    VisionEstimate best_estimate;
-    best_estimate.valid = false;
-    best_estimate.confidence = 0.0;
-    best_estimate.x = 0;
-    best_estimate.y = 0;
-    best_estimate.heading = 0;
-
-    // 拍一张照
-    int count = vision_snapshot();
+// 处理一帧里所有检测到的标签，结果写进 best_estimate（调用前已经 clear_estimate 过）
+static void estimate_frame(const VisionFrame& frame, VisionEstimate& best_estimate) {
+    int count = frame.count;
     last_tag_count = count;
 
-    if (count == 0) return best_estimate;  // 什么都没看到
+    if (count == 0) return;  // 什么都没看到
+
+    // 拍照那一刻的里程计位姿（需要它的航向从"摄像头视角"转换到"赛场视角"）
+    // 查不到就用现在的，capture_time_us 留 0，修正时也按现在处理
+    uint64_t capture_us = frame.time_us;
+    Pose current;
+    if (!odometry_pose_at(capture_us, &current)) {
+        current    = get_pose();
+        capture_us = 0;
+    }
+    best_estimate.capture_time_us = capture_us;
+    best_estimate.capture_pose    = current;
 
-    // 获取里程计的当前航向（需要它来从"摄像头视角"转换到"赛场视角"）
-    Pose current = get_pose();
+    // 单标签航向：几个标签各估一个，按方差倒数加权（相对里程计航向的偏差求平均）
+    double aspect_info = 0.0, aspect_sum = 0.0;
 
     // 逐个处理检测到的标签
     for (int i = 0; i < count; ++i) {
-        TagDetection tag = vision_get_tag(i);
+        const TagDetection& tag = frame.tags[i];
         if (!tag.valid) continue;
 
         // 查找这个标签在赛场上的已知位置
         const FieldTag* field_tag = find_field_tag(tag.id);
         if (field_tag == nullptr) {
-            hal_log("Vision: unknown tag ID " + to_str(tag.id) + ", skipped");
+            LOG_DEBUGF("Vision: unknown tag ID %d, skipped", tag.id);
             continue;  // 不认识的标签，跳过
         }
 
         // 第 1 步：从标签像素大小估算距离
         double pixel_size = (tag.width > tag.height) ? tag.width : tag.height;
-        double distance = estimate_distance(pixel_size);
+        double distance = vision_estimate_distance(pixel_size);
         if (distance < 0) continue;  // 标签太远/太小，不可信
 
         // 第 2 步：估算方位角（摄像头视角）
-        double bearing_camera = estimate_bearing(tag.center_x);
-
-        // 第 3 步：把摄像头视角的方位角转换成赛场视角
-        // 赛场方位 = 机器人当前航向 + 摄像头安装角度 + 摄像头看到的角度
-        double bearing_field = current.theta + VISION_CAMERA_ANGLE + bearing_camera;
-
-        // 第 4 步：从标签位置反推机器人位置
-        // 逻辑：已知标签在 (tag_x, tag_y)，机器人在距标签 distance 的方向上
-        // 还要减去摄像头相对机器人中心的偏移量
-        double est_x = field_tag->x - distance * cos(bearing_field)
-                      - VISION_CAMERA_OFFSET_X * cos(current.theta)
-                      + VISION_CAMERA_OFFSET_Y * sin(current.theta);
-        double est_y = field_tag->y - distance * sin(bearing_field)
-                      - VISION_CAMERA_OFFSET_X * sin(current.theta)
-                      - VISION_CAMERA_OFFSET_Y * cos(current.theta);
+        double bearing_camera = vision_estimate_bearing(tag.center_x);
+
+        // 第 3 步：从标签位置 + 距离 + 方位反推机器人位置（航向用里程计的）
+        double est_x, est_y;
+        vision_robot_from_tag(field_tag->x, field_tag->y, distance, bearing_camera,
+                              current.theta, &est_x, &est_y);
+
+        // 第 4 步：计算置信度
+        double conf = vision_compute_confidence(distance, pixel_size);
+
+        // 第 5 步：从宽高比估航向（标签在图片里歪了就不用）
+        double tag_heading, tag_sigma;
+        if (conf > 0.0 && fabs(tag.angle) <= VISION_TAG_MAX_ROLL_DEG &&
+            vision_heading_from_tag(field_tag->facing, tag.width, tag.height, bearing_camera,
+                                    current.theta, &tag_heading, &tag_sigma)) {
+            aspect_info += 1.0 / (tag_sigma * tag_sigma);
+            aspect_sum  += (tag_heading - current.theta) / (tag_sigma * tag_sigma);
+        }
 
-        // 第 5 步：计算置信度
-        double conf = compute_confidence(distance, pixel_size);
+        // 原始测量也留下来（卡尔曼滤波直接用距离和方位，不用反推的位置）
+        TagMeasurement& m = best_estimate.tags[best_estimate.tag_count++];
+        m.id         = tag.id;
+        m.tag_x      = field_tag->x;
+        m.tag_y      = field_tag->y;
+        m.range      = distance;
+        m.bearing    = bearing_camera;
+        m.confidence = conf;
 
         // 保留置信度最高的估算结果
         if (conf > best_estimate.confidence) {
             best_estimate.x          = est_x;
             best_estimate.y          = est_y;
-            best_estimate.heading    = current.theta;  // 航向仍用里程计的（更准）
             best_estimate.confidence = conf;
+            best_estimate.tags_used  = 1;
             best_estimate.valid      = true;
         }
     }
 
+    if (aspect_info > 0.0) {
+        best_estimate.heading       = current.theta + aspect_sum / aspect_info;
+        best_estimate.heading_sigma = 1.0 / sqrt(aspect_info);
+    }
+
+    // 看到好几个可信标签：一起解 x、y、θ，比只用最好的一个准得多
+    if (best_estimate.tag_count >= VISION_MULTI_TAG_MIN_TAGS) {
+        MultiTagSolution sol = multi_tag_solve(best_estimate.tags, best_estimate.tag_count, current);
+        if (sol.ok) {
+            // 合起来的置信度：1 − 每个标签"都不可信"的概率
+            double all_wrong = 1.0;
+            for (int i = 0; i < best_estimate.tag_count; ++i) {
+                double c = best_estimate.tags[i].confidence;
+                if (c > 0.0) all_wrong *= 1.0 - c;
+            }
+            best_estimate.x          = sol.pose.x;
+            best_estimate.y          = sol.pose.y;
+            best_estimate.confidence = 1.0 - all_wrong;
+            best_estimate.tags_used  = sol.tags_used;
+            if (aspect_info == 0.0 || sol.sigma_theta < best_estimate.heading_sigma) {
+                best_estimate.heading       = sol.pose.theta;
+                best_estimate.heading_sigma = sol.sigma_theta;
+            }
+        } else if (sol.tags_used >= VISION_MULTI_TAG_MIN_TAGS) {
+            LOG_DEBUGF("Vision multi-tag: %d tags disagree (rms %.1f), using best single tag",
+                       sol.tags_used, sol.rms);
+        }
+    }
+
+    if (best_estimate.heading_sigma > 0.0) {
+        best_estimate.heading_confidence = vision_heading_confidence(best_estimate.heading_sigma);
+    } else {
+        best_estimate.heading = current.theta;   // 估不出航向，沿用里程计的
+    }
+
     if (best_estimate.valid) {
-        hal_log("Vision est: (" + to_str(best_estimate.x) + ", "
-                + to_str(best_estimate.y) + ") conf="
-                + to_str(best_estimate.confidence));
+        LOG_DEBUGF("Vision est: (%.3f, %.3f) conf=%.2f tags=%d heading %.3f (conf %.2f)",
+                   best_estimate.x, best_estimate.y, best_estimate.confidence, best_estimate.tags_used,
+                   best_estimate.heading, best_estimate.heading_confidence);
+    }
+}
+
+// ============================================================================
+//  公开接口
+// ============================================================================
+
+void vision_localizer_init() {
+    last_tag_count   = 0;
+    last_frame_seq   = 0;
+    frames_processed = 0;
+    frames_stale     = 0;
+    frame_age_us.reset();
+    if (VISION_FUSION_MODE == VISION_FUSION_PARTICLE) {
+        odometry_particle_filter_init(PF_PARTICLE_COUNT);  // 粒子内存只在这里分配一次
+    }
+    LOG_SCREENF("Vision localizer initialized with %d field tags", NUM_FIELD_TAGS);
+}
+
+// ---- 借看最新的一帧 → 返回最佳位置估算 ----
+VisionEstimate vision_localizer_estimate_latest() {
+    VisionEstimate best_estimate;
+    clear_estimate(best_estimate);
+
+    // 借看最新的一帧（标签不拷贝，直接在帧里读；函数返回时自动归还）
+    VisionFrameView frame = vision_latest_frame();
+    if (frame->seq == last_frame_seq) return best_estimate;  // 还是上次那一帧
+
+    // 中间漏掉的帧不补算：它们比这一帧老，算出来也只会被这一帧盖掉
+    if (frame->seq > last_frame_seq + 1) {
+        frames_stale += frame->seq - last_frame_seq - 1;
+    }
+    last_frame_seq = frame->seq;
+
+    // 太老的帧也不算（估算任务被挤住了）：延迟有上限，宁可等下一帧
+    uint64_t age_us = get_time_us() - frame->time_us;
+    if (age_us > (uint64_t)VISION_MAX_FRAME_AGE_MS * 1000) {
+        frames_stale++;
+        LOG_DEBUGF("Vision: frame %u is %lu ms old, skipped", (unsigned)frame->seq,
+                   (unsigned long)(age_us / 1000));
+        return best_estimate;
     }
 
+    {
+        TraceScope trace(TRACE_VISION_UPDATE);
+        estimate_frame(*frame, best_estimate);
+    }
+    frames_processed++;
+    frame_age_us.record((uint32_t)(get_time_us() - frame->time_us));
     return best_estimate;
 }
 
+// ---- 拍照 + 估算（单任务用法）----
+VisionEstimate vision_localizer_update() {
+    vision_snapshot();
+    return vision_localizer_estimate_latest();
+}
+
 // ---- 把视觉结果融合到里程计中 ----
 void vision_correct_odometry(const VisionEstimate& estimate) {
     // 无效或置信度太低→不修正
     if (!estimate.valid) return;
     if (estimate.confidence < VISION_MIN_CONFIDENCE) return;
 
-    Pose current = get_pose();
+    // 拍照以后车走到哪了（历史里查不到时 capture_pose 就是当时的"现在"）
+    Pose now = get_pose();
+
+    if (VISION_FUSION_MODE != VISION_FUSION_BLEND) {
+        // 滤波器只能在"现在"融合：先把所有测量搬到现在的位姿。
+        // 一次性搬完再更新——前一个标签的修正会同时挪动 then 和 now，相对运动不变
+        TagMeasurement usable[VISION_MAX_TAGS];
+        int n = 0;
+        for (int i = 0; i < estimate.tag_count; ++i) {
+            if (estimate.tags[i].confidence < VISION_MIN_CONFIDENCE) continue;
+            usable[n++] = vision_carry_forward(estimate.tags[i], estimate.capture_pose, now);
+        }
 
-    // 互补滤波器：α 越大，越信任视觉；越小，越信任里程计
-    // 实际 α = 基础 α × 置信度（置信度越高，修正力度越大）
-    double alpha = VISION_CORRECTION_ALPHA * estimate.confidence;
+        if (VISION_FUSION_MODE == VISION_FUSION_PARTICLE) {
+            odometry_particle_update(usable, n);
+            return;
+        }
 
-    // α 不能太大，防止一次异常的视觉读数导致位置大幅跳跃
-    if (alpha > VISION_MAX_CORRECTION_ALPHA) alpha = VISION_MAX_CORRECTION_ALPHA;
+        for (int i = 0; i < n; ++i) {
+            const TagMeasurement& m = usable[i];
+            if (!odometry_ekf_update(m)) {
+                // 和预测差太多 → 拒绝（可能是误检或传感器异常）
+                LOG_INFOF("Vision tag %d REJECTED by EKF gate", m.id);
+                flight_recorder_trigger("vision correction rejected");
+            }
+        }
+        return;
+    }
 
-    // 加权融合：新位置 = (1-α) × 里程计 + α × 视觉
-    Pose corrected;
-    corrected.x     = (1.0 - alpha) * current.x     + alpha * estimate.x;
-    corrected.y     = (1.0 - alpha) * current.y     + alpha * estimate.y;
-    corrected.theta = current.theta;  // 航向角不用视觉修正（IMU 更可靠）
+    // 修正量在拍照时刻算：视觉结果和当时的位姿比
+    const Pose& then = estimate.capture_pose;
+    Pose corrected = vision_blend_pose(then, estimate.x, estimate.y, estimate.confidence);
+    if (estimate.heading_confidence > 0.0) {
+        corrected = vision_blend_heading(corrected, estimate.heading, estimate.heading_confidence);
+    }
 
     // 异常值检测：如果修正量太大（超过安全阈值），说明可能是误检
     // 直接拒绝这次修正，防止机器人"瞬移"
-    double dx = corrected.x - current.x;
-    double dy = corrected.y - current.y;
+    double dx = corrected.x - then.x;
+    double dy = corrected.y - then.y;
     double correction_dist = sqrt(dx * dx + dy * dy);
 
     if (correction_dist < VISION_MAX_CORRECTION_M) {
-        // 修正量合理 → 应用（用 set_pose_no_reset 轻轻微调，不打断编码器）
-        set_pose_no_reset(corrected);
-        hal_log("Vision correction applied: dx=" + to_str(dx)
-                + " dy=" + to_str(dy) + " alpha=" + to_str(alpha));
+        // 修正量合理 → 加回拍照时刻，之后走过的路重放一遍。
+        // 历史里查不到（或者刚好被挤出去了）→ 直接加到现在的位姿上
+        // （用 set_pose_no_reset 轻轻微调，不打断编码器）
+        Pose offset = { dx, dy, corrected.theta - then.theta };
+        if (estimate.capture_time_us == 0 || !odometry_shift_at(estimate.capture_time_us, offset)) {
+            Pose shifted = { now.x + offset.x, now.y + offset.y, now.theta + offset.theta };
+            set_pose_no_reset(shifted);
+        }
+        LOG_DEBUGF("Vision correction applied: dx=%.4f dy=%.4f", dx, dy);
     } else {
         // 修正量太大 → 拒绝（可能是误检或传感器异常）
-        hal_log("Vision correction REJECTED: dist=" + to_str(correction_dist)
-                + " > max=" + to_str(VISION_MAX_CORRECTION_M));
+        LOG_INFOF("Vision correction REJECTED: dist=%.3f > max=%.3f",
+                  correction_dist, VISION_MAX_CORRECTION_M);
+        flight_recorder_trigger("vision correction rejected");
     }
 }
 
 int vision_localizer_tag_count() {
     return last_tag_count;
 }
+
+VisionPipelineStats vision_localizer_stats() {
+    VisionPipelineStats st;
+    st.captured  = vision_latest_frame()->seq;
+    st.processed = frames_processed;
+    st.stale     = frames_stale;
+    st.no_buffer = vision_dropped_snapshots();
+    st.age_us    = frame_age_us;
+    return st;
+}
+
+void vision_localizer_log_stats() {
+    VisionPipelineStats st = vision_localizer_stats();
+    LOG_INFOF("vision pipeline: captured %lu processed %lu stale %lu no-buffer %lu age p50=%lu p99=%lu max=%lu us",
+              (unsigned long)st.captured, (unsigned long)st.processed, (unsigned long)st.stale,
+              (unsigned long)st.no_buffer, (unsigned long)st.age_us.percentile(0.5),
+              (unsigned long)st.age_us.percentile(0.99), (unsigned long)st.age_us.max());
+}
@@ -24,8 +24,11 @@
 //    它们在后台默默干活，互不干扰。
 //    1. 里程计 — 100 Hz 持续计算位置（追踪轮 + IMU 融合）
 //    2. 屏幕   — 20 Hz 在 Brain 屏幕上显示调试信息
-//    3. 视觉   — 20 Hz 用 AprilTag 修正位置
-//    4. 日志   — 10 Hz 把位置数据记到 SD 卡（CSV 格式）
+//    3. 视觉   — 两个任务：拍照（约 30 Hz，跟传感器帧率）+ 估算（有新帧就用 AprilTag 修正位置）
+//    4. 日志   — 100 Hz 把位置数据记到 SD 卡（二进制格式，见 telemetry/odom_logger.h）
+//    5. 写日志 — 低优先级，把日志缓冲区写进 SD 卡（hal_log_start_writer）
+//    6. 黑匣子 — 低优先级，出问题时把最近 5 秒数据写进 SD 卡（telemetry/flight_recorder.h）
+//    7. 遥测   — 低优先级，通过 USB 串口实时发送位姿（telemetry/serial_telemetry.h）
 //
 // ============================================================================
 
@@ -36,12 +39,20 @@
 #include "hal/motors.h"
 #include "hal/hal_log.h"
 #include "hal/time.h"
+#include "hal/periodic_timer.h"
+#include "hal/screen.h"
+#include "hal/sensor_frame.h"
 #include "hal/vision.h"
 #include "hal/tracking_wheels.h"
 #include "localization/odometry.h"
 #include "localization/vision_localizer.h"
 #include "motion/drive_to_pose.h"
 #include "motion/turn_to_heading.h"
+#include "telemetry/odom_logger.h"
+#include "telemetry/flight_recorder.h"
+#include "telemetry/loop_stats.h"
+#include "telemetry/trace.h"
+#include "telemetry/serial_telemetry.h"
 
 using namespace vex;
 
@@ -77,36 +88,68 @@ motor  RightFront = motor(RIGHT_FRONT_MOTOR_PORT, ratio6_1, false);
 motor  RightMid   = motor(RIGHT_MID_MOTOR_PORT,   ratio6_1, false);
 motor  RightRear  = motor(RIGHT_REAR_MOTOR_PORT,  ratio6_1, false);
 
+// ── 各后台任务的循环计时统计（见 telemetry/loop_stats.h）──
+static LoopStats screen_loop_stats("screen", SCREEN_UPDATE_INTERVAL_MS);
+static LoopStats vision_capture_stats("vis_cap", VISION_CAPTURE_INTERVAL_MS);
+static LoopStats vision_loop_stats("vision", VISION_ESTIMATE_POLL_MS);
+static LoopStats logger_loop_stats("logger", LOOP_INTERVAL_MS);
+
 // ============================================================================
 //  后台任务 ①: Brain 屏幕调试显示
 // ============================================================================
 //  在 Brain 的屏幕上实时显示当前位置、朝向、传感器状态，
 //  方便你在比赛前调试。
+//  第 9、10 行是里程计的计时：执行时间和"比预定晚醒了多久"，
+//  晚醒很多说明 100 Hz 被别的任务挤掉了。每 5 秒还会把所有循环的统计写进日志。
+//
+//  这里不再每次 clearScreen() 整屏重画：screen_printf_row() 只是把文字
+//  格式化进缓存，screen_flush() 只重画真正变了的字（见 hal/screen.h）。
+//  这个任务以低优先级运行，省下的 CPU 留给控制任务。
 // ============================================================================
 static int screen_task_fn() {
+    unsigned long last_report_ms = get_time_ms();
+    screen_printf_row(1, "=== 6M Tracking Odom ===");
     while (true) {
+        screen_loop_stats.begin();
         Pose p = get_pose();  // 读取当前位姿
         double heading_deg = p.theta * 180.0 / M_PI;  // 弧度 → 角度
 
-        Brain.Screen.clearScreen();
-        Brain.Screen.setCursor(1, 1);
-        Brain.Screen.print("=== 6M Tracking Odom ===");
-
-        Brain.Screen.setCursor(2, 1);
-        Brain.Screen.print("X: %.3f m", p.x);          // X 坐标（米）
-        Brain.Screen.setCursor(3, 1);
-        Brain.Screen.print("Y: %.3f m", p.y);          // Y 坐标（米）
-        Brain.Screen.setCursor(4, 1);
-        Brain.Screen.print("Heading: %.1f deg", heading_deg);  // 朝向（度）
+        screen_printf_row(2, "X: %.3f m", p.x);                 // X 坐标（米）
+        screen_printf_row(3, "Y: %.3f m", p.y);                 // Y 坐标（米）
+        screen_printf_row(4, "Heading: %.1f deg", heading_deg); // 朝向（度）
+
+        // 传感器状态用里程计这一拍采集的帧，不再自己去问硬件
+        SensorFrame frame = sensor_frame_latest();
+        screen_printf_row(6, "Enc: %s  IMU: %s",
+            frame.tracking_ok ? "OK" : "NC",                    // 追踪轮是否连接
+            frame.imu_ok ? "OK" : "NC");                        // IMU 是否连接
+        screen_printf_row(7, "Vision tags: %d", vision_localizer_tag_count());  // 检测到几个 AprilTag
+        VisionPipelineStats vis = vision_localizer_stats();                     // 拍了 / 算了 / 丢了几帧
+        screen_printf_row(8, "Vis cap %lu proc %lu drop %lu",
+            (unsigned long)vis.captured, (unsigned long)vis.processed,
+            (unsigned long)(vis.stale + vis.no_buffer));
+
+        // 里程计循环计时：P99 执行时间 / P99 晚醒时间（微秒）
+        const LoopStats* odom_stats = loop_stats_find("odom");
+        if (odom_stats != nullptr) {
+            screen_printf_row(9, "odom exec p99 %lu max %lu us",
+                (unsigned long)odom_stats->exec_us().percentile(0.99),
+                (unsigned long)odom_stats->exec_us().max());
+            screen_printf_row(10, "odom late p99 %lu max %lu us",
+                (unsigned long)odom_stats->late_us().percentile(0.99),
+                (unsigned long)odom_stats->late_us().max());
+        }
 
-        Brain.Screen.setCursor(6, 1);
-        Brain.Screen.print("Enc: TrackingWheels  IMU: %s",
-            DrivetrainInertial.installed() ? "OK" : "NC");  // IMU 是否连接
+        screen_flush();  // 只画变了的字
+        serial_telemetry_send_loop_stats();  // 内部限速到 1 秒一次
 
-        Brain.Screen.setCursor(7, 1);
-        int tags = vision_localizer_tag_count();
-        Brain.Screen.print("Vision tags: %d", tags);  // 检测到几个 AprilTag
+        if (get_time_ms() - last_report_ms >= LOOP_STATS_REPORT_INTERVAL_MS) {
+            loop_stats_log_report();
+            vision_localizer_log_stats();
+            last_report_ms = get_time_ms();
+        }
 
+        screen_loop_stats.end();
         vex::task::sleep(SCREEN_UPDATE_INTERVAL_MS);  // 等 50ms（20Hz）
     }
     return 0;
@@ -117,40 +160,65 @@ static int screen_task_fn() {
 // ============================================================================
 //  用 AI 视觉传感器识别 AprilTag，算出绝对坐标，修正里程计的漂移。
 //  就像手机 GPS 替你纠正方向一样。
+//
+//  以前一个任务里"拍照 → 计算 → 修正 → 睡 50 ms"串着跑，实际不到 20 Hz，
+//  而且会阻塞的 takeSnapshot 和计算挤在一起。现在拆成流水线：
+//    拍照任务：按传感器帧率拍，拍完发布成一帧（hal/vision.h，不等任何人）
+//    估算任务：每 5 ms 看一眼，有新帧就算、就修正；来不及算的老帧直接跳过
+//  屏幕第 8 行和日志里有"拍了多少 / 算了多少 / 丢了多少 / 帧龄"。
 // ============================================================================
+static int vision_capture_task_fn() {
+    PeriodicTimer period(VISION_CAPTURE_INTERVAL_MS, &vision_capture_stats);
+    while (true) {
+        period.wait();
+        ScopedLoopTimer timer(vision_capture_stats);
+        vision_snapshot();  // 拍照 + 发布一帧
+    }
+    return 0;
+}
+
 static int vision_task_fn() {
+    PeriodicTimer period(VISION_ESTIMATE_POLL_MS, &vision_loop_stats);
     while (true) {
-        VisionEstimate est = vision_localizer_update();  // 拍照 + 计算位置
+        period.wait();
+        ScopedLoopTimer timer(vision_loop_stats);
+        VisionEstimate est = vision_localizer_estimate_latest();  // 有新帧才计算位置
         if (est.valid) {
             vision_correct_odometry(est);  // 有效就修正里程计
         }
-        vex::task::sleep(VISION_UPDATE_INTERVAL_MS);  // 等 50ms（20Hz）
     }
     return 0;
 }
 
 // ============================================================================
-//  后台任务 ③: CSV 位姿日志 (10 Hz)
+//  后台任务 ③: 二进制位姿日志 (100 Hz)
 // ============================================================================
-//  每 100ms 把当前位置和到目标的距离记录到 SD 卡的 CSV 文件。
-//  比赛后拔出 SD 卡，用 Excel 打开就能画轨迹图！
+//  每个控制周期把位置、到目标的距离、电机电压和传感器原始值
+//  记录成一条二进制记录，差分编码后（通常十几字节）攒满 4 KB 再写 SD 卡。
+//  比赛后用 tools/odom_bin2csv 转成 CSV，用 Excel 打开就能画轨迹图！
+//  同一条记录也放进黑匣子（telemetry/flight_recorder.h），出问题时才写卡。
 // ============================================================================
 static Pose auton_target = {0, 0, 0};  // 当前自治目标点（日志用）
 
-static int csv_logger_task_fn() {
+static int odom_logger_task_fn() {
+    // 10ms = 100Hz，和里程计同频；按绝对截止时间唤醒，记录间隔不漂移
+    PeriodicTimer period(LOOP_INTERVAL_MS, &logger_loop_stats);
     while (true) {
-        Pose p = get_pose();
-        // 计算到当前目标的距离（用于记录跟踪误差）
-        double dx = auton_target.x - p.x;
-        double dy = auton_target.y - p.y;
-        double error_dist = sqrt(dx * dx + dy * dy);
-        // 写入一行 CSV：时间戳, x, y, theta, 误差
-        hal_log_odom_csv(get_time_ms(), p.x, p.y, p.theta, error_dist);
-        vex::task::sleep(100);  // 100ms = 10Hz
+        period.wait();
+        ScopedLoopTimer timer(logger_loop_stats);
+        OdomRecord rec = odom_logger_capture();
+        odom_logger_push(rec);
+        flight_recorder_record(rec);
+        serial_telemetry_send_odom(rec);  // 内部限速到 50 Hz
     }
     return 0;
 }
 
+// 车手觉得"刚才不对劲"时按手柄 X 键，把最近 5 秒存下来
+static void on_button_x_pressed() {
+    flight_recorder_trigger("driver request (button X)");
+}
+
 // ============================================================================
 //  pre_auton() — 开机初始化（比赛开始前运行）
 // ============================================================================
@@ -164,7 +232,9 @@ void pre_auton() {
     Brain.Screen.setCursor(1, 1);
     Brain.Screen.print("Initializing...");
 
-    hal_log("=== Pre-Auton Init ===");
+    // 0. 先启动后台写日志任务，后面所有初始化日志才能写进 SD 卡
+    hal_log_start_writer();
+    LOG_SCREENF("=== Pre-Auton Init ===");
 
     // 1. 校准惯性传感器（需要 ~2 秒，这段时间机器人不能动！）
     calibrate_imu();
@@ -172,7 +242,7 @@ void pre_auton() {
     // 2. 初始化追踪轮（把编码器归零，准备开始测量）
     tracking_wheels_init();
     if (!tracking_wheels_connected()) {
-        hal_log_level(LOG_WARN, "Tracking wheels NOT detected!");
+        LOG_WARNF("Tracking wheels NOT detected!");
         // 警告：追踪轮没检测到！检查线缆连接
     }
 
@@ -186,13 +256,17 @@ void pre_auton() {
 
     // 5. 启动后台任务（它们会在后台默默运行，直到关机）
     odometry_start_task();                    // 里程计（100Hz）
-    vex::task screenTask(screen_task_fn);     // 屏幕显示（20Hz）
-    vex::task visionTask(vision_task_fn);     // 视觉定位（20Hz）
-    vex::task csvTask(csv_logger_task_fn);    // CSV 日志（10Hz）
-
-    Brain.Screen.setCursor(2, 1);
-    Brain.Screen.print("Ready!");
-    hal_log("Pre-auton complete");
+    vex::task screenTask(screen_task_fn, vex::task::taskPrioritylow);  // 屏幕显示（20Hz，低优先级）
+    vex::task visionCaptureTask(vision_capture_task_fn);  // 视觉拍照（约 30Hz）
+    vex::task visionTask(vision_task_fn);     // 视觉估算（有新帧就算）
+    odom_logger_start();                      // 打开二进制日志文件
+    vex::task logTask(odom_logger_task_fn);   // 位姿日志（100Hz）
+    flight_recorder_start();                  // 黑匣子写出任务（平时空闲）
+    serial_telemetry_start();                 // USB 串口实时遥测
+    Controller1.ButtonX.pressed(on_button_x_pressed);
+
+    screen_show_message("Ready!");  // 屏幕任务已经接管了屏幕，通过缓存显示
+    LOG_SCREENF("Pre-auton complete");
 }
 
 // ============================================================================
@@ -207,12 +281,14 @@ void pre_auton() {
 //  下面是示例路线——请根据你的比赛策略修改！
 // ============================================================================
 void autonomous() {
-    hal_log("=== Autonomous Start ===");
+    LOG_SCREENF("=== Autonomous Start ===");
+    trace_capture_start();  // 记录整段自治的任务时间线（见 telemetry/trace.h）
 
     // ─── 示例路线 (请替换为你的比赛策略！) ─────────────────────────────
 
     // 第 1 步：前进到 (0.5, 0) 米
     auton_target = {0.5, 0.0, 0.0};
+    odom_logger_set_target(auton_target);
     drive_to_pose(auton_target);
 
     // 第 2 步：原地左转 90°
@@ -220,6 +296,7 @@ void autonomous() {
 
     // 第 3 步：前进到 (0.5, 0.5) 米，朝向 90°
     auton_target = {0.5, 0.5, M_PI / 2.0};
+    odom_logger_set_target(auton_target);
     drive_to_pose(auton_target);
 
     // 第 4 步：原地转回 0°
@@ -227,9 +304,12 @@ void autonomous() {
 
     // 第 5 步：回到原点
     auton_target = {0.0, 0.0, 0.0};
+    odom_logger_set_target(auton_target);
     drive_to_pose(auton_target);
 
-    hal_log("=== Autonomous End ===");
+    odom_logger_flush();  // 把最后不满一块的日志也写进 SD 卡
+    trace_save_to_sd();   // 时间线写进 /usd/trace_NNN.bin，电脑上用 tools/trace2json 转换
+    LOG_SCREENF("=== Autonomous End ===");
 }
 
 // ============================================================================
@@ -243,7 +323,7 @@ void autonomous() {
 //    推相反方向 → 快速旋转
 // ============================================================================
 void usercontrol() {
-    hal_log("=== Driver Control Start ===");
+    LOG_SCREENF("=== Driver Control Start ===");
 
     while (true) {
         // 读取摇杆位置（-100 到 +100 的百分比）
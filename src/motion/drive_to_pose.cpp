@@ -17,7 +17,8 @@
 //    Boomerang 就是让机器人自动计算这条弧线！
 //
 //  【退出条件】
-//    ① 距离目标 < DRIVE_SETTLE_M 持续 DRIVE_SETTLE_TIME_MS → 成功到达
+//    ① 距离目标 < DRIVE_SETTLE_M 且速度 < DRIVE_SETTLE_SPEED_MPS，
+//       持续 DRIVE_SETTLE_TIME_MS → 成功到达
 //    ② 运行时间 > DRIVE_TIMEOUT_MS → 超时退出（防止卡死）
 //
 // ============================================================================
@@ -25,10 +26,17 @@
 #include "config.h"
 #include "control/pid.h"
 #include "hal/motors.h"
+#include "hal/periodic_timer.h"
 #include "hal/time.h"
 #include "localization/odometry.h"
+#include "telemetry/flight_recorder.h"
+#include "telemetry/loop_stats.h"
+#include "telemetry/motion_summary.h"
 #include <cmath>
 
+// 控制循环计时统计（见 telemetry/loop_stats.h）
+static LoopStats drive_loop_stats("drive", LOOP_INTERVAL_MS);
+
 void drive_to_pose(const Pose& target_pose, bool reverse) {
     // 创建角度 PID 控制器（用来修正航向偏差）
     PIDController angular_pid(TURN_KP, TURN_KI, TURN_KD);
@@ -41,14 +49,30 @@ void drive_to_pose(const Pose& target_pose, bool reverse) {
     unsigned long settle_start = 0;   // 开始"到位计时"的时刻
     bool settling = false;            // 是否正在到位计时中
     double prev_cmd_v = 0.0;          // 上一次的速度命令（用于加速度限幅）
+    bool timed_out = false;
+    double dt = LOOP_INTERVAL_MS / 1000.0;  // 上一个周期实际经过的秒数
+
+    // 整条命令的统计摘要：结束时只写一行日志（见 telemetry/motion_summary.h）
+    MotionSummary summary;
+    summary.begin(MOTION_DRIVE, DRIVE_SETTLE_M);
 
     // ---- 主控制循环 ----
+    drive_loop_stats.restart();  // 上一次命令结束到现在不算"晚醒"
+    PeriodicTimer period(LOOP_INTERVAL_MS, &drive_loop_stats);
     while (true) {
-        // 超时检测
-        if (get_time_ms() - start_time > DRIVE_TIMEOUT_MS) break;
+        drive_loop_stats.begin();
+
+        // 超时检测（超时说明出了问题 → 让黑匣子把最近几秒存下来）
+        if (get_time_ms() - start_time > DRIVE_TIMEOUT_MS) {
+            flight_recorder_trigger("drive_to_pose timeout");
+            timed_out = true;
+            break;
+        }
 
-        // 读取当前位姿
-        Pose cur = get_pose();
+        // 读取当前位姿和速度（同一份快照，不用自己对位姿求差分）
+        PoseSnapshot snap = get_pose_snapshot();
+        Pose cur = snap.pose;
+        double speed = hypot(snap.velocity.forward, snap.velocity.lateral);
 
         // 计算到目标的距离
         double dx = target_pose.x - cur.x;
@@ -56,8 +80,9 @@ void drive_to_pose(const Pose& target_pose, bool reverse) {
         double dist = sqrt(dx * dx + dy * dy);  // 勾股定理
 
         // ── 到位检测 ──
-        // 如果距离目标足够近，开始计时；如果持续够久，就认为到达了
-        if (dist < DRIVE_SETTLE_M) {
+        // 如果距离目标足够近、而且已经慢下来了，开始计时；如果持续够久，就认为到达了
+        // （只看距离的话，高速冲过目标的那一瞬间也会开始计时）
+        if (dist < DRIVE_SETTLE_M && speed < DRIVE_SETTLE_SPEED_MPS) {
             if (!settling) {
                 settling = true;
                 settle_start = get_time_ms();
@@ -97,7 +122,8 @@ void drive_to_pose(const Pose& target_pose, bool reverse) {
         if (reverse) raw_v = -raw_v;  // 倒车速度取负
 
         // 加速度限幅：防止突然加速或减速（保护机构 + 防止轮子打滑）
-        double max_dv = MAX_ACCELERATION * (LOOP_INTERVAL_MS / 1000.0);
+        // 用真实 dt：这一周期被调度晚了，允许的速度变化也相应大一点
+        double max_dv = MAX_ACCELERATION * dt;
         if (raw_v - prev_cmd_v >  max_dv) raw_v = prev_cmd_v + max_dv;
         if (prev_cmd_v - raw_v >  max_dv) raw_v = prev_cmd_v - max_dv;
         prev_cmd_v = raw_v;
@@ -114,9 +140,12 @@ void drive_to_pose(const Pose& target_pose, bool reverse) {
         double left_v  = raw_v - omega * WHEEL_TRACK / 2.0;
         double right_v = raw_v + omega * WHEEL_TRACK / 2.0;
         set_drive_motors(left_v, right_v);
+        summary.sample(dist, heading_error, left_v, right_v);
 
-        wait_ms(LOOP_INTERVAL_MS);  // 等待一个控制周期
+        drive_loop_stats.end();
+        dt = period.wait();  // 睡到下一个控制周期的截止时间
     }
 
     stop_drive_motors();  // 循环结束，刹停
+    summary.finish(timed_out);
 }
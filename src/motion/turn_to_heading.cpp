@@ -8,7 +8,7 @@
 //    1. 计算"我现在朝哪" 和 "我要朝哪" 之间的差值（航向误差）
 //    2. 用 PID 控制器决定转弯力度
 //    3. 差速驱动：左边往后转、右边往前转（或反过来）→ 原地旋转
-//    4. 持续足够时间误差很小 → 认为到位
+//    4. 误差很小、角速度也很小，持续足够时间 → 认为到位
 //
 //    关键技巧：航向误差归一化
 //      角度是"循环"的——350° 和 10° 之间，差值应该是 20°，不是 -340°。
@@ -20,8 +20,12 @@
 #include "config.h"
 #include "control/pid.h"
 #include "hal/motors.h"
+#include "hal/periodic_timer.h"
 #include "hal/time.h"
 #include "localization/odometry.h"
+#include "telemetry/flight_recorder.h"
+#include "telemetry/loop_stats.h"
+#include "telemetry/motion_summary.h"
 #include <cmath>
 
 // 模块级 PID 控制器 —— 用 static 让它只在这个文件可见
@@ -35,6 +39,9 @@ double turn_to_heading_pid_calculate(double error) {
     return turn_pid.calculate(0.0, -error);
 }
 
+// 控制循环计时统计（见 telemetry/loop_stats.h）
+static LoopStats turn_loop_stats("turn", LOOP_INTERVAL_MS);
+
 void turn_to_heading(double target_heading_rad) {
     // 每次新的转弯任务开始时重置 PID（清除积分和上次误差）
     turn_pid.reset();
@@ -45,15 +52,29 @@ void turn_to_heading(double target_heading_rad) {
     unsigned long settle_start = 0;   // 开始"到位计时"的时刻
     bool settling = false;            // 是否正在到位计时
     unsigned long start_time = get_time_ms();
+    bool timed_out = false;
+
+    // 整条命令的统计摘要：结束时只写一行日志（见 telemetry/motion_summary.h）
+    MotionSummary summary;
+    summary.begin(MOTION_TURN, TURN_SETTLE_RAD);
 
     // ---- 主控制循环 ----
+    turn_loop_stats.restart();  // 上一次命令结束到现在不算"晚醒"
+    PeriodicTimer period(LOOP_INTERVAL_MS, &turn_loop_stats);
     while (true) {
+        turn_loop_stats.begin();
+
         // 超时保护：不管什么原因没转到位，到时间就强制退出
         unsigned long elapsed = get_time_ms() - start_time;
-        if (elapsed > TURN_TIMEOUT_MS) break;
+        if (elapsed > TURN_TIMEOUT_MS) {
+            flight_recorder_trigger("turn_to_heading timeout");
+            timed_out = true;
+            break;
+        }
 
-        // 读取当前位姿（其中 theta 是当前朝向）
-        Pose current = get_pose();
+        // 读取当前位姿（其中 theta 是当前朝向）和角速度
+        PoseSnapshot snap = get_pose_snapshot();
+        Pose current = snap.pose;
 
         // 计算航向误差并归一化到 [-π, π]
         // ← 这个公式确保机器人永远走"近路"而不是绕大圈
@@ -61,8 +82,8 @@ void turn_to_heading(double target_heading_rad) {
         error = atan2(sin(error), cos(error));  // 归一化！
 
         // ── 到位检测 ──
-        // 误差绝对值小于阈值？开始计时。持续够久？认为到位！
-        if (std::abs(error) < TURN_SETTLE_RAD) {
+        // 误差绝对值小于阈值、而且没在快速转动？开始计时。持续够久？认为到位！
+        if (std::abs(error) < TURN_SETTLE_RAD && std::abs(snap.velocity.omega) < TURN_SETTLE_OMEGA_RADPS) {
             if (!settling) {
                 settling = true;
                 settle_start = get_time_ms();
@@ -84,9 +105,12 @@ void turn_to_heading(double target_heading_rad) {
         double left_v  = -omega * WHEEL_TRACK / 2.0;
         double right_v =  omega * WHEEL_TRACK / 2.0;
         set_drive_motors(left_v, right_v);
+        summary.sample(error, error, left_v, right_v);  // 转弯时误差就是航向误差
 
-        wait_ms(LOOP_INTERVAL_MS);  // 等一个控制周期
+        turn_loop_stats.end();
+        period.wait();  // 睡到下一个控制周期的截止时间（PID 自己按时间戳算 dt）
     }
 
     stop_drive_motors();  // 刹停
+    summary.finish(timed_out);
 }
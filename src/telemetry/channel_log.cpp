@@ -0,0 +1,76 @@
+// ============================================================================
+//  telemetry/channel_log.cpp — schema 解析和差分帧解码（电脑端工具、单元测试用）
+// ============================================================================
+//
+//  编码器是模板，全部在头文件里；这里只有不依赖具体记录结构体的解码部分。
+//
+// ============================================================================
+#include "telemetry/channel_log.h"
+
+int channel_schema_decode(const uint8_t* in, int len, ChannelInfo* out, int max_channels) {
+    if (len < 1) return -1;
+    int count = in[0];
+    if (count < 1 || count > CHANNEL_MAX || count > max_channels) return -1;
+
+    int pos = 1;
+    for (int i = 0; i < count; ++i) {
+        if (pos + 6 > len) return -1;
+        if (in[pos] != CHANNEL_F32 && in[pos] != CHANNEL_I32) return -1;  // 不认识的类型
+        out[i].type     = (ChannelType)in[pos];
+        out[i].rate_div = in[pos + 1];
+        out[i].quantum  = get_f32(in + pos + 2);
+        pos += 6;
+        if (!(out[i].quantum > 0.0f)) return -1;
+        if (out[i].type == CHANNEL_I32 && out[i].quantum != 1.0f) return -1;
+
+        // 名字和单位都是以 '\0' 结尾的字符串
+        char* fields[2]     = { out[i].name, out[i].unit };
+        const int limits[2] = { CHANNEL_NAME_MAX, CHANNEL_UNIT_MAX };
+        for (int f = 0; f < 2; ++f) {
+            int n = 0;
+            while (pos + n < len && n < limits[f] && in[pos + n] != 0) n++;
+            if (pos + n >= len || n >= limits[f]) return -1;
+            memcpy(fields[f], in + pos, n);
+            fields[f][n] = '\0';
+            pos += n + 1;
+        }
+    }
+    return count;
+}
+
+ChannelFrameDecoder::ChannelFrameDecoder(const ChannelInfo* channels, int count)
+    : _channels(channels), _count(count), _time(0), _synced(false) {
+    for (int i = 0; i < CHANNEL_MAX; ++i) _prev[i] = 0;
+}
+
+int ChannelFrameDecoder::decode(const uint8_t* in, int len, uint32_t* time_ms, double* values) {
+    uint32_t head, mask;
+    int pos = get_varint(in, len, &head);
+    if (pos == 0) return 0;
+    int n = get_varint(in + pos, len - pos, &mask);
+    if (n == 0) return 0;
+    pos += n;
+    if (_count < 32 && (mask >> _count) != 0) return -1;  // 掩码里有不存在的通道
+
+    bool key = (head & 1u) != 0;
+    int32_t next[CHANNEL_MAX];
+    for (int i = 0; i < _count; ++i) {
+        next[i] = key ? 0 : _prev[i];
+        if ((mask & (1u << i)) == 0) continue;
+        uint32_t zz;
+        n = get_varint(in + pos, len - pos, &zz);
+        if (n == 0) return 0;
+        pos += n;
+        next[i] = (int32_t)((uint32_t)next[i] + (uint32_t)zigzag_decode(zz));
+    }
+
+    // 整帧读完才更新状态（数据不完整时下次从同一帧重新开始）
+    _time = key ? (head >> 1) : _time + (head >> 1);
+    if (key) _synced = true;
+    for (int i = 0; i < _count; ++i) {
+        _prev[i]  = next[i];
+        values[i] = (double)next[i] * _channels[i].quantum;
+    }
+    *time_ms = _time;
+    return pos;
+}
@@ -0,0 +1,141 @@
+// ============================================================================
+//  telemetry/flight_recorder.cpp — 飞行记录仪（黑匣子）的实现
+// ============================================================================
+//
+//  【环形缓冲区】
+//    recorder_ring 是一个固定大小的数组，写指针一圈一圈地转：
+//    写满以后新数据覆盖最旧的数据，所以永远保留"最近 N 条"。
+//    只有日志任务会写它，所以不需要锁。
+//
+//  【写出流程】
+//    trigger() → 只设置一个"待写"标记 + 记下时间（几条指令）
+//    后台任务看到标记 → 再等 POST_TRIGGER 毫秒（把出事后的数据也录进来）
+//    → 暂停记录、把环形缓冲区拷到快照数组（几十微秒）→ 恢复记录
+//    → 慢慢把快照写进 SD 卡
+//
+// ============================================================================
+#include "telemetry/flight_recorder.h"
+#include "telemetry/sd_files.h"
+#include "telemetry/trace.h"
+#include "config.h"
+#include "hal/hal_log.h"
+#include "hal/time.h"
+#include "vex.h"
+#include <atomic>
+#include <stdio.h>
+
+static OdomRecord recorder_ring[FLIGHT_RECORDER_SAMPLES];
+static OdomRecord recorder_snapshot[FLIGHT_RECORDER_SAMPLES];  // 写出时的快照
+static int        ring_next  = 0;   // 下一条写到哪
+static int        ring_count = 0;   // 当前有几条有效数据
+
+static std::atomic<bool> frozen(false);  // true = 正在拷贝快照，暂停记录
+static unsigned long     recorded_count = 0;
+static unsigned long     skipped_count  = 0;
+
+// ---- 触发状态 ----
+static std::atomic<bool>        dump_pending(false);
+static std::atomic<const char*> dump_reason(nullptr);
+static unsigned long            trigger_time_ms   = 0;
+static unsigned long            last_dump_time_ms = 0;
+static int                      dump_count        = 0;
+static int                      ignored_count     = 0;
+
+static vex::task* dump_task_ptr = nullptr;
+
+// ---- 记录（每个控制周期一次）----
+void flight_recorder_record(const OdomRecord& rec) {
+    if (frozen.load(std::memory_order_acquire)) {
+        skipped_count++;
+        return;
+    }
+    recorder_ring[ring_next] = rec;
+    ring_next = (ring_next + 1) % FLIGHT_RECORDER_SAMPLES;
+    if (ring_count < FLIGHT_RECORDER_SAMPLES) ring_count++;
+    recorded_count++;
+}
+
+// ---- 按时间顺序拷贝 ----
+int flight_recorder_snapshot(OdomRecord* out, int max_records) {
+    frozen.store(true, std::memory_order_release);
+    int n = (ring_count < max_records) ? ring_count : max_records;
+    // 最旧的一条在 ring_next - ring_count 处；只拷最新的 n 条
+    int start = (ring_next - n + FLIGHT_RECORDER_SAMPLES) % FLIGHT_RECORDER_SAMPLES;
+    for (int i = 0; i < n; ++i) {
+        out[i] = recorder_ring[(start + i) % FLIGHT_RECORDER_SAMPLES];
+    }
+    frozen.store(false, std::memory_order_release);
+    return n;
+}
+
+// ---- 触发 ----
+bool flight_recorder_trigger(const char* reason) {
+    unsigned long now = get_time_ms();
+    bool cooling = dump_count > 0 && now - last_dump_time_ms < FLIGHT_RECORDER_COOLDOWN_MS;
+    if (cooling || dump_count >= FLIGHT_RECORDER_MAX_DUMPS || dump_pending.load()) {
+        ignored_count++;
+        return false;
+    }
+    dump_reason.store(reason);
+    trigger_time_ms = now;
+    dump_pending.store(true, std::memory_order_release);
+    return true;
+}
+
+// ---- 写成文件 ----
+int flight_recorder_dump_to(FILE* f) {
+    TraceScope trace(TRACE_SD_WRITE_FLIGHT);
+    int n = flight_recorder_snapshot(recorder_snapshot, FLIGHT_RECORDER_SAMPLES);
+
+    uint8_t bytes[ODOM_RECORD_SIZE];
+    odom_log_encode_header(bytes);  // 文件头 16 字节 < 40 字节，借用同一个缓冲区
+    fwrite(bytes, 1, ODOM_LOG_HEADER_SIZE, f);
+    for (int i = 0; i < n; ++i) {
+        odom_record_encode(recorder_snapshot[i], bytes);
+        fwrite(bytes, 1, ODOM_RECORD_SIZE, f);
+    }
+    fclose(f);
+    return n;
+}
+
+// ---- 后台写出 ----
+void flight_recorder_poll() {
+    if (!dump_pending.load(std::memory_order_acquire)) return;
+    if (get_time_ms() - trigger_time_ms < FLIGHT_RECORDER_POST_TRIGGER_MS) return;
+
+    char path[32];
+    const char* reason = dump_reason.load();
+    FILE* f = sd_open_numbered_file("/usd/flight_%03d.bin", path, sizeof(path));
+    if (f != nullptr) {
+        int n = flight_recorder_dump_to(f);
+        LOG_WARNF("Flight recorder: %d samples -> %s (%s)", n, path, reason);
+    } else {
+        LOG_WARNF("Flight recorder: cannot open file on SD card (%s)", reason);
+    }
+    dump_count++;
+    last_dump_time_ms = get_time_ms();
+    dump_pending.store(false, std::memory_order_release);
+}
+
+static int flight_recorder_task_fn() {
+    while (true) {
+        flight_recorder_poll();
+        vex::task::sleep(FLIGHT_RECORDER_POLL_MS);
+    }
+    return 0;
+}
+
+void flight_recorder_start() {
+    if (dump_task_ptr == nullptr) {
+        dump_task_ptr = new vex::task(flight_recorder_task_fn, vex::task::taskPrioritylow);
+    }
+}
+
+FlightRecorderStats flight_recorder_get_stats() {
+    FlightRecorderStats stats;
+    stats.recorded         = recorded_count;
+    stats.skipped          = skipped_count;
+    stats.dumps            = dump_count;
+    stats.ignored_triggers = ignored_count;
+    return stats;
+}
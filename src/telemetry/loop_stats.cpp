@@ -0,0 +1,139 @@
+// ============================================================================
+//  telemetry/loop_stats.cpp — 循环计时统计的实现
+// ============================================================================
+//
+//  只用 get_time_us() 和整数运算，电脑上的单元测试可以直接编译。
+//
+// ============================================================================
+#include "telemetry/loop_stats.h"
+#include "config.h"
+#include "hal/hal_log.h"
+#include "hal/time.h"
+#include <stdio.h>
+#include <string.h>
+
+// ---- 全局登记表 ----
+// 普通数组 + 整数，程序启动时就已经清零，
+// 所以别的文件里的静态 LoopStats 在构造时登记也是安全的
+static LoopStats* loop_registry[LOOP_STATS_MAX_LOOPS];
+static int        loop_registry_count = 0;
+
+// ============================================================================
+//  LogHistogram
+// ============================================================================
+
+LogHistogram::LogHistogram() {
+    reset();
+}
+
+void LogHistogram::reset() {
+    for (int i = 0; i < LOOP_HIST_BUCKETS; ++i) _buckets[i] = 0;
+    _count = 0;
+    _max   = 0;
+}
+
+int LogHistogram::bucket_of(uint32_t us) {
+    // floor(log2(us))：数一数右移几次才变成 1
+    int k = 0;
+    while (us > 1) {
+        us >>= 1;
+        k++;
+    }
+    return (k < LOOP_HIST_BUCKETS) ? k : LOOP_HIST_BUCKETS - 1;
+}
+
+void LogHistogram::record(uint32_t us) {
+    _buckets[bucket_of(us)]++;
+    _count++;
+    if (us > _max) _max = us;
+}
+
+uint32_t LogHistogram::percentile(double p) const {
+    if (_count == 0) return 0;
+
+    // 第 ceil(p × count) 个样本落在哪个桶
+    uint32_t rank = (uint32_t)(p * _count);
+    if (rank < p * _count) rank++;
+    if (rank < 1) rank = 1;
+
+    uint32_t seen = 0;
+    for (int k = 0; k < LOOP_HIST_BUCKETS; ++k) {
+        seen += _buckets[k];
+        if (seen >= rank) {
+            uint32_t upper = (k == LOOP_HIST_BUCKETS - 1) ? _max : (2u << k) - 1;
+            return (upper < _max) ? upper : _max;
+        }
+    }
+    return _max;
+}
+
+// ============================================================================
+//  LoopStats
+// ============================================================================
+
+LoopStats::LoopStats(const char* name, int period_ms)
+    : _name(name), _period_us((uint32_t)period_ms * 1000u),
+      _begin_us(0), _sleep_us(0), _due_us(0), _sleeping(false) {
+    if (loop_registry_count < LOOP_STATS_MAX_LOOPS) {
+        loop_registry[loop_registry_count++] = this;
+    }
+}
+
+void LoopStats::begin() {
+    _begin_us = get_time_us();
+    if (_sleeping) {
+        // 应该在预定时刻醒来；早醒（理论上不会）按 0 算
+        _late.record(_begin_us > _due_us ? (uint32_t)(_begin_us - _due_us) : 0);
+    }
+}
+
+void LoopStats::end() {
+    _sleep_us = get_time_us();
+    _exec.record((uint32_t)(_sleep_us - _begin_us));
+    _due_us   = _sleep_us + _period_us;  // 默认：sleep 一个周期
+    _sleeping = true;
+}
+
+void LoopStats::reset() {
+    _exec.reset();
+    _late.reset();
+    _sleeping = false;
+}
+
+// ============================================================================
+//  登记表 + 报告
+// ============================================================================
+
+int loop_stats_count() {
+    return loop_registry_count;
+}
+
+LoopStats* loop_stats_get(int i) {
+    if (i < 0 || i >= loop_registry_count) return nullptr;
+    return loop_registry[i];
+}
+
+LoopStats* loop_stats_find(const char* name) {
+    for (int i = 0; i < loop_registry_count; ++i) {
+        if (strcmp(loop_registry[i]->name(), name) == 0) return loop_registry[i];
+    }
+    return nullptr;
+}
+
+void loop_stats_format(const LoopStats& stats, char* out, int out_size) {
+    const LogHistogram& exec = stats.exec_us();
+    const LogHistogram& late = stats.late_us();
+    snprintf(out, out_size, "%s n=%lu exec p50=%lu p99=%lu max=%luus late p99=%lu max=%luus",
+             stats.name(), (unsigned long)exec.count(),
+             (unsigned long)exec.percentile(0.50), (unsigned long)exec.percentile(0.99),
+             (unsigned long)exec.max(),
+             (unsigned long)late.percentile(0.99), (unsigned long)late.max());
+}
+
+void loop_stats_log_report() {
+    char line[LOG_LINE_MAX];
+    for (int i = 0; i < loop_registry_count; ++i) {
+        loop_stats_format(*loop_registry[i], line, sizeof(line));
+        LOG_INFOF("%s", line);
+    }
+}
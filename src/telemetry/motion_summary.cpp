@@ -0,0 +1,93 @@
+// ============================================================================
+//  telemetry/motion_summary.cpp — 运动命令摘要的实现
+// ============================================================================
+#include "telemetry/motion_summary.h"
+#include "config.h"
+#include "hal/hal_log.h"
+#include "hal/time.h"
+#include <cmath>
+#include <stdio.h>
+
+// 每种命令各自编号：drive#1、drive#2……turn#1……
+static int                 command_counts[2] = { 0, 0 };
+static MotionSummaryRecord last_summary;
+static bool                has_last_summary = false;
+
+MotionSummary::MotionSummary()
+    : _tolerance(0.0), _in_tolerance(false), _last_entry_ms(0) {
+    _rec.kind              = MOTION_DRIVE;
+    _rec.index             = 0;
+    _rec.start_ms          = 0;
+    _rec.duration_ms       = 0;
+    _rec.settle_ms         = -1;
+    _rec.timed_out         = false;
+    _rec.tolerance_entries = 0;
+    _rec.final_error       = 0.0;
+    _rec.peak_heading_rad  = 0.0;
+    _rec.peak_volts        = 0.0;
+}
+
+void MotionSummary::begin(MotionKind kind, double tolerance) {
+    _rec = MotionSummaryRecord();
+    _rec.kind      = kind;
+    _rec.index     = ++command_counts[kind];
+    _rec.start_ms  = get_time_ms();
+    _rec.settle_ms = -1;
+    _rec.error.reset();
+    _tolerance     = tolerance;
+    _in_tolerance  = false;
+    _last_entry_ms = 0;
+}
+
+void MotionSummary::sample(double error, double heading_error,
+                           double left_volts, double right_volts) {
+    double abs_error = fabs(error);
+    _rec.error.add(abs_error);
+    _rec.final_error = abs_error;
+
+    if (fabs(heading_error) > _rec.peak_heading_rad) _rec.peak_heading_rad = fabs(heading_error);
+    if (fabs(left_volts)  > _rec.peak_volts) _rec.peak_volts = fabs(left_volts);
+    if (fabs(right_volts) > _rec.peak_volts) _rec.peak_volts = fabs(right_volts);
+
+    // 从容差外进入容差内 → 记一次，并记下时刻
+    bool inside = abs_error < _tolerance;
+    if (inside && !_in_tolerance) {
+        _rec.tolerance_entries++;
+        _last_entry_ms = get_time_ms();
+    }
+    _in_tolerance = inside;
+}
+
+void MotionSummary::finish(bool timed_out) {
+    _rec.duration_ms = get_time_ms() - _rec.start_ms;
+    _rec.timed_out   = timed_out;
+    _rec.settle_ms   = (!timed_out && _rec.tolerance_entries > 0)
+                           ? (long)(_last_entry_ms - _rec.start_ms) : -1;
+
+    char line[LOG_LINE_MAX];
+    motion_summary_format(_rec, line, sizeof(line));
+    LOG_INFOF("%s", line);
+
+    last_summary     = _rec;
+    has_last_summary = true;
+}
+
+void motion_summary_format(const MotionSummaryRecord& rec, char* out, int out_size) {
+    // 直线误差是米（3 位小数 = 毫米），转弯误差是弧度，统一显示成度更直观
+    bool turn = rec.kind == MOTION_TURN;
+    double scale = turn ? 180.0 / M_PI : 1.0;
+    snprintf(out, out_size,
+             "%s#%d %lums settle=%ld to=%d err max=%.3f avg=%.3f sd=%.3f end=%.3f hdg=%.1f in=%d",
+             turn ? "turn" : "drive", rec.index, rec.duration_ms, rec.settle_ms,
+             rec.timed_out ? 1 : 0,
+             rec.error.max() * scale, rec.error.mean() * scale, rec.error.stddev() * scale,
+             rec.final_error * scale, rec.peak_heading_rad * 180.0 / M_PI, rec.tolerance_entries);
+}
+
+MotionSummaryRecord motion_summary_last() {
+    if (!has_last_summary) {
+        MotionSummary empty;
+        return empty.record();
+    }
+    return last_summary;
+}
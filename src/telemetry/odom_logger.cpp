@@ -0,0 +1,135 @@
+// ============================================================================
+//  telemetry/odom_logger.cpp — 二进制里程计日志的实现
+// ============================================================================
+//
+//  【数据流】
+//    日志任务 (100 Hz)                     写卡任务 (低优先级)
+//    odom_logger_capture()                    │
+//          ↓ 差分编码（2~30 字节）            │
+//    odom_logger_push() ──→ BlockStream ──→ fwrite 4 KB + fflush
+//                           (4 × 4 KB)
+//
+//  SD 卡文件一直保持打开，只有攒满一整块才写一次。
+//
+// ============================================================================
+#include "telemetry/odom_logger.h"
+#include "telemetry/block_stream.h"
+#include "telemetry/sd_files.h"
+#include "telemetry/trace.h"
+#include "config.h"
+#include "hal/hal_log.h"
+#include "hal/time.h"
+#include "vex.h"
+#include <atomic>
+#include <cmath>
+#include <stdio.h>
+
+static BlockStream<ODOM_LOG_BLOCK_BYTES, ODOM_LOG_NUM_BLOCKS> odom_stream;
+static OdomFrameEncoder odom_encoder(ODOM_CHANNELS, ODOM_LOG_KEYFRAME_INTERVAL);
+static FILE*      odom_file        = nullptr;
+static vex::task* odom_writer_task = nullptr;
+
+static Pose target_pose = {0.0, 0.0, 0.0};
+
+static std::atomic<bool> flush_requested(false);
+static unsigned long     records_pushed  = 0;  // 只有生产者任务会改
+static unsigned long     records_dropped = 0;
+static std::atomic<unsigned long> blocks_written(0);
+
+// ---- 后台写卡任务 ----
+static int odom_writer_task_fn() {
+    while (true) {
+        int len = 0;
+        const uint8_t* block;
+        while ((block = odom_stream.acquire(&len)) != nullptr) {
+            {
+                TraceScope trace(TRACE_SD_WRITE_ODOM);
+                fwrite(block, 1, len, odom_file);
+                fflush(odom_file);
+            }
+            odom_stream.release();
+            blocks_written.fetch_add(1, std::memory_order_relaxed);
+        }
+        vex::task::sleep(ODOM_LOG_WRITER_INTERVAL_MS);
+    }
+    return 0;
+}
+
+void odom_logger_start() {
+    if (odom_writer_task != nullptr) return;
+
+    char name[32];
+    odom_file = sd_open_numbered_file("/usd/odom_%03d.bin", name, sizeof(name));
+    if (odom_file == nullptr) {
+        LOG_WARNF("Odom log: cannot open file on SD card, logging disabled");
+        return;
+    }
+
+    // 文件头 + 通道表作为字节流的开头，和记录一起按块写入
+    uint8_t header[ODOM_LOG_DELTA_HEADER_MAX];
+    odom_stream.append(header, odom_log_encode_delta_header(header));
+    odom_encoder.reset();
+
+    odom_writer_task = new vex::task(odom_writer_task_fn, vex::task::taskPrioritylow);
+    LOG_INFOF("Odom log: writing %s", name);
+}
+
+void odom_logger_set_target(const Pose& target) {
+    target_pose = target;
+}
+
+OdomRecord odom_logger_capture() {
+    // 位姿、传感器读数和电压从里程计的同一份发布里一次拷出来：一定是同一拍的，
+    // 也不用再读一次硬件（分开读 get_pose() 和 sensor_frame_latest() 会错开一拍：
+    // 传感器帧在位姿算完之前就发布了）
+    PoseSnapshot snap;
+    OdomRawInputs raw = odometry_get_raw_inputs(&snap);
+    const Pose& p = snap.pose;
+
+    double dx = target_pose.x - p.x;
+    double dy = target_pose.y - p.y;
+
+    OdomRecord rec;
+    rec.time_ms      = (uint32_t)get_time_ms();
+    rec.x            = (float)p.x;
+    rec.y            = (float)p.y;
+    rec.theta        = (float)p.theta;
+    rec.target_error = (float)sqrt(dx * dx + dy * dy);
+    rec.left_volts   = (float)raw.left_command_v;
+    rec.right_volts  = (float)raw.right_command_v;
+    rec.forward_m    = (float)raw.forward_m;
+    rec.lateral_m    = (float)raw.lateral_m;
+    rec.imu_rad      = (float)raw.imu_rad;
+    return rec;
+}
+
+void odom_logger_push(const OdomRecord& rec) {
+    if (odom_file == nullptr) return;  // 没有日志文件（没插 SD 卡）
+
+    uint8_t frame[OdomFrameEncoder::MAX_FRAME_BYTES];
+    int len = odom_encoder.encode(rec.time_ms, rec, frame);
+    if (odom_stream.append(frame, len)) {
+        records_pushed++;
+    } else {
+        // 这一帧没写进去，后面的差值就没有参考了 → 下一帧写完整数值
+        odom_encoder.force_keyframe();
+        records_dropped++;
+    }
+
+    // 刷盘请求由生产者自己执行，避免和 append() 同时改同一个块
+    if (flush_requested.exchange(false)) {
+        odom_stream.seal();
+    }
+}
+
+void odom_logger_flush() {
+    flush_requested.store(true);
+}
+
+OdomLoggerStats odom_logger_get_stats() {
+    OdomLoggerStats stats;
+    stats.records        = records_pushed;
+    stats.dropped        = records_dropped;
+    stats.blocks_written = blocks_written.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,90 @@
+// ============================================================================
+//  telemetry/odom_record.cpp — 二进制里程计记录的编码/解码
+// ============================================================================
+//
+//  字节序辅助函数见 telemetry/byte_order.h。
+//
+// ============================================================================
+#include "telemetry/odom_record.h"
+#include "telemetry/byte_order.h"
+#include <stdio.h>
+#include <string.h>
+
+// ---- 差分编码日志的通道表 ----
+// 分辨率决定精度和体积：位置 0.1 mm、角度 0.0001 rad（≈0.006°）、电压 1 mV
+const ChannelDef<OdomRecord> ODOM_CHANNELS[ODOM_CHANNEL_COUNT] = {
+    // 名字         单位    字段                          分辨率   采样分频
+    { "x",         "m",   &OdomRecord::x,              1e-4f,  1 },
+    { "y",         "m",   &OdomRecord::y,              1e-4f,  1 },
+    { "theta",     "rad", &OdomRecord::theta,          1e-4f,  1 },
+    { "error",     "m",   &OdomRecord::target_error,   1e-4f,  1 },
+    { "left_v",    "V",   &OdomRecord::left_volts,     1e-3f,  1 },
+    { "right_v",   "V",   &OdomRecord::right_volts,    1e-3f,  1 },
+    { "forward_m", "m",   &OdomRecord::forward_m,      1e-5f,  1 },
+    { "lateral_m", "m",   &OdomRecord::lateral_m,      1e-5f,  1 },
+    { "imu_rad",   "rad", &OdomRecord::imu_rad,        1e-5f,  1 },
+};
+
+// ---- 文件头 ----
+// 偏移: 0 魔数(4)  4 版本(2)  6 记录长度 / schema 长度(2)  8 保留(8)
+static void encode_header(uint8_t* out, uint16_t version, uint16_t size) {
+    memset(out, 0, ODOM_LOG_HEADER_SIZE);
+    put_u32(out + 0, ODOM_LOG_MAGIC);
+    put_u16(out + 4, version);
+    put_u16(out + 6, size);
+}
+
+void odom_log_encode_header(uint8_t* out) {
+    encode_header(out, ODOM_LOG_VERSION, (uint16_t)ODOM_RECORD_SIZE);
+}
+
+int odom_log_encode_delta_header(uint8_t* out) {
+    int schema_len = channel_schema_encode(ODOM_CHANNELS, out + ODOM_LOG_HEADER_SIZE,
+                                           ODOM_LOG_DELTA_HEADER_MAX - ODOM_LOG_HEADER_SIZE);
+    encode_header(out, ODOM_LOG_VERSION_DELTA, (uint16_t)schema_len);
+    return ODOM_LOG_HEADER_SIZE + schema_len;
+}
+
+bool odom_log_decode_header(const uint8_t* in, uint16_t* version, uint16_t* size) {
+    if (get_u32(in) != ODOM_LOG_MAGIC) return false;
+    *version = get_u16(in + 4);
+    *size    = get_u16(in + 6);
+    return true;
+}
+
+// ---- 记录 ----
+void odom_record_encode(const OdomRecord& rec, uint8_t* out) {
+    put_u32(out +  0, rec.time_ms);
+    put_f32(out +  4, rec.x);
+    put_f32(out +  8, rec.y);
+    put_f32(out + 12, rec.theta);
+    put_f32(out + 16, rec.target_error);
+    put_f32(out + 20, rec.left_volts);
+    put_f32(out + 24, rec.right_volts);
+    put_f32(out + 28, rec.forward_m);
+    put_f32(out + 32, rec.lateral_m);
+    put_f32(out + 36, rec.imu_rad);
+}
+
+void odom_record_decode(const uint8_t* in, OdomRecord* rec) {
+    rec->time_ms      = get_u32(in +  0);
+    rec->x            = get_f32(in +  4);
+    rec->y            = get_f32(in +  8);
+    rec->theta        = get_f32(in + 12);
+    rec->target_error = get_f32(in + 16);
+    rec->left_volts   = get_f32(in + 20);
+    rec->right_volts  = get_f32(in + 24);
+    rec->forward_m    = get_f32(in + 28);
+    rec->lateral_m    = get_f32(in + 32);
+    rec->imu_rad      = get_f32(in + 36);
+}
+
+// ---- CSV 输出（给电脑端解码工具用）----
+const char* const ODOM_CSV_HEADER =
+    "time_ms,x,y,theta,error,left_v,right_v,forward_m,lateral_m,imu_rad";
+
+int odom_record_to_csv(const OdomRecord& rec, char* buf, int buf_size) {
+    return snprintf(buf, buf_size, "%lu,%.4f,%.4f,%.4f,%.4f,%.3f,%.3f,%.5f,%.5f,%.5f",
+                    (unsigned long)rec.time_ms, rec.x, rec.y, rec.theta, rec.target_error,
+                    rec.left_volts, rec.right_volts, rec.forward_m, rec.lateral_m, rec.imu_rad);
+}
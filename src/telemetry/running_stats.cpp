@@ -0,0 +1,35 @@
+// ============================================================================
+//  telemetry/running_stats.cpp — Welford 流式统计的实现
+// ============================================================================
+#include "telemetry/running_stats.h"
+#include <cmath>
+
+void RunningStats::reset() {
+    _n    = 0;
+    _min  = 0.0;
+    _max  = 0.0;
+    _mean = 0.0;
+    _m2   = 0.0;
+}
+
+void RunningStats::add(double x) {
+    _n++;
+    if (_n == 1) {
+        _min = x;
+        _max = x;
+    } else {
+        if (x < _min) _min = x;
+        if (x > _max) _max = x;
+    }
+    double delta = x - _mean;
+    _mean += delta / _n;
+    _m2   += delta * (x - _mean);
+}
+
+double RunningStats::variance() const {
+    return (_n > 1) ? _m2 / (_n - 1) : 0.0;
+}
+
+double RunningStats::stddev() const {
+    return sqrt(variance());
+}
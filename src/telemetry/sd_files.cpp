@@ -0,0 +1,20 @@
+// ============================================================================
+//  telemetry/sd_files.cpp — 自动编号文件的实现
+// ============================================================================
+#include "telemetry/sd_files.h"
+
+// 最多尝试多少个编号（000 ~ 999）
+static constexpr int SD_MAX_NUMBERED_FILES = 1000;
+
+FILE* sd_open_numbered_file(const char* name_fmt, char* name, int name_size) {
+    for (int i = 0; i < SD_MAX_NUMBERED_FILES; ++i) {
+        snprintf(name, name_size, name_fmt, i);
+        FILE* existing = fopen(name, "rb");
+        if (existing != nullptr) {
+            fclose(existing);  // 这个编号已经有了，试下一个
+            continue;
+        }
+        return fopen(name, "wb");
+    }
+    return nullptr;
+}
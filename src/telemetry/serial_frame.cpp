@@ -0,0 +1,123 @@
+// ============================================================================
+//  telemetry/serial_frame.cpp — CRC16 + COBS 分帧的实现
+// ============================================================================
+#include "telemetry/serial_frame.h"
+#include "telemetry/byte_order.h"
+
+// ---- 循环计时通道 ----
+void telem_loop_encode(const TelemLoopSample& s, uint8_t* out) {
+    put_u32(out +  0, s.time_ms);
+    put_u32(out +  4, s.exec_p99_us);
+    put_u32(out +  8, s.exec_max_us);
+    put_u32(out + 12, s.late_p99_us);
+    put_u32(out + 16, s.late_max_us);
+}
+
+void telem_loop_decode(const uint8_t* in, TelemLoopSample* s) {
+    s->time_ms     = get_u32(in +  0);
+    s->exec_p99_us = get_u32(in +  4);
+    s->exec_max_us = get_u32(in +  8);
+    s->late_p99_us = get_u32(in + 12);
+    s->late_max_us = get_u32(in + 16);
+}
+
+// ---- CRC16 ----
+// 逐位计算：每个字节 8 次移位，不需要查找表（一帧只有几十字节）
+uint16_t crc16_ccitt(const uint8_t* data, int len) {
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < len; ++i) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// ---- COBS ----
+// 编码：每一段"非零字节"前面放一个计数 = 这段长度 + 1，
+// 计数指向下一个（被删掉的）0 的位置。一段最长 254 个字节。
+int cobs_encode(const uint8_t* in, int len, uint8_t* out) {
+    int code_pos = 0;   // 当前段的计数字节放在哪
+    int out_pos  = 1;
+    uint8_t code = 1;
+    for (int i = 0; i < len; ++i) {
+        if (in[i] == 0) {
+            out[code_pos] = code;
+            code_pos = out_pos++;
+            code = 1;
+        } else {
+            out[out_pos++] = in[i];
+            code++;
+            if (code == 0xFF) {   // 段满了，强制开始新的一段
+                out[code_pos] = code;
+                code_pos = out_pos++;
+                code = 1;
+            }
+        }
+    }
+    out[code_pos] = code;
+    return out_pos;
+}
+
+int cobs_decode(const uint8_t* in, int len, uint8_t* out) {
+    int in_pos  = 0;
+    int out_pos = 0;
+    while (in_pos < len) {
+        uint8_t code = in[in_pos++];
+        if (code == 0 || in_pos + code - 1 > len) return -1;  // 计数不合法
+        for (int i = 1; i < code; ++i) {
+            out[out_pos++] = in[in_pos++];
+        }
+        // 计数 < 0xFF 表示这一段后面原来有一个 0（最后一段除外）
+        if (code < 0xFF && in_pos < len) out[out_pos++] = 0;
+    }
+    return out_pos;
+}
+
+// ---- 整帧编码 ----
+int serial_frame_encode(uint8_t channel, uint8_t seq,
+                        const uint8_t* payload, int len, uint8_t* out) {
+    if (len < 0 || len > SERIAL_FRAME_MAX_PAYLOAD) return 0;
+
+    uint8_t raw[SERIAL_FRAME_MAX_PAYLOAD + 4];
+    raw[0] = channel;
+    raw[1] = seq;
+    for (int i = 0; i < len; ++i) raw[2 + i] = payload[i];
+    put_u16(raw + 2 + len, crc16_ccitt(raw, 2 + len));
+
+    int n = cobs_encode(raw, len + 4, out);
+    out[n++] = 0x00;  // 帧尾
+    return n;
+}
+
+// ---- 流式解帧 ----
+SerialFrameDecoder::SerialFrameDecoder()
+    : _len(0), _overflow(false), _frame_len(0), _good(0), _bad(0) {}
+
+SerialFrameDecoder::Result SerialFrameDecoder::feed(uint8_t byte) {
+    if (byte != 0x00) {
+        if (_len < SERIAL_FRAME_MAX_ENCODED) {
+            _buf[_len++] = byte;
+        } else {
+            _overflow = true;
+        }
+        return NONE;
+    }
+
+    // 收到帧尾 → 处理这一帧
+    int len = _len;
+    bool overflow = _overflow;
+    _len = 0;
+    _overflow = false;
+    if (len == 0) return NONE;  // 连续的 0（比如刚开始同步），忽略
+
+    int n = overflow ? -1 : cobs_decode(_buf, len, _frame);
+    if (n < 4 || get_u16(_frame + n - 2) != crc16_ccitt(_frame, n - 2)) {
+        _bad++;
+        return BAD_FRAME;
+    }
+    _frame_len = n;
+    _good++;
+    return FRAME;
+}
@@ -0,0 +1,115 @@
+// ============================================================================
+//  telemetry/serial_telemetry.cpp — 串口遥测的实现
+// ============================================================================
+//
+//  【数据流】
+//    日志任务 / 屏幕任务                          串口任务 (低优先级)
+//    serial_telemetry_send()                          │
+//       限速 → 编码一帧 ──→ RingBuffer (16 帧) ──→ fwrite(stdout) + fflush
+//
+// ============================================================================
+#include "telemetry/serial_telemetry.h"
+#include "telemetry/loop_stats.h"
+#include "hal/ring_buffer.h"
+#include "hal/time.h"
+#include "config.h"
+#include "vex.h"
+#include <atomic>
+#include <stdio.h>
+
+static RingBuffer<SerialTxFrame, SERIAL_TELEM_QUEUE_FRAMES> tx_ring;
+static vex::task* serial_task_ptr = nullptr;
+
+// ---- 每个通道的限速状态（下标 = 通道号）----
+// 每个通道只会被一个任务发送（odom ← 日志任务，loop ← 屏幕任务），所以不需要锁
+static const int channel_interval_ms[TELEM_CH_COUNT] = {
+    0,                               // 0：未使用
+    SERIAL_TELEM_ODOM_INTERVAL_MS,   // TELEM_CH_ODOM
+    SERIAL_TELEM_LOOP_INTERVAL_MS,   // TELEM_CH_LOOP
+};
+static unsigned long channel_last_ms[TELEM_CH_COUNT];
+static bool          channel_sent_once[TELEM_CH_COUNT];
+static uint8_t       channel_seq[TELEM_CH_COUNT];
+
+static std::atomic<unsigned long> sent_count(0);
+static std::atomic<unsigned long> rate_limited_count(0);
+static std::atomic<unsigned long> dropped_count(0);
+
+bool serial_telemetry_send(uint8_t channel, const uint8_t* payload, int len) {
+    if (channel == 0 || channel >= TELEM_CH_COUNT) return false;
+
+    // 限速：离上次发送还不够一个间隔就不发
+    unsigned long now = get_time_ms();
+    if (channel_sent_once[channel] &&
+        now - channel_last_ms[channel] < (unsigned long)channel_interval_ms[channel]) {
+        rate_limited_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    channel_last_ms[channel]   = now;
+    channel_sent_once[channel] = true;
+
+    SerialTxFrame frame;
+    frame.len = serial_frame_encode(channel, channel_seq[channel]++, payload, len, frame.bytes);
+    if (frame.len == 0) return false;  // 数据太长
+
+    if (!tx_ring.try_push(frame)) {
+        dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    sent_count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool serial_telemetry_send_odom(const OdomRecord& rec) {
+    uint8_t bytes[ODOM_RECORD_SIZE];
+    odom_record_encode(rec, bytes);
+    return serial_telemetry_send(TELEM_CH_ODOM, bytes, ODOM_RECORD_SIZE);
+}
+
+bool serial_telemetry_send_loop_stats() {
+    const LoopStats* odom = loop_stats_find("odom");
+    if (odom == nullptr) return false;
+
+    TelemLoopSample s;
+    s.time_ms     = (uint32_t)get_time_ms();
+    s.exec_p99_us = odom->exec_us().percentile(0.99);
+    s.exec_max_us = odom->exec_us().max();
+    s.late_p99_us = odom->late_us().percentile(0.99);
+    s.late_max_us = odom->late_us().max();
+
+    uint8_t bytes[TELEM_LOOP_SAMPLE_SIZE];
+    telem_loop_encode(s, bytes);
+    return serial_telemetry_send(TELEM_CH_LOOP, bytes, TELEM_LOOP_SAMPLE_SIZE);
+}
+
+bool serial_telemetry_pop(SerialTxFrame& out) {
+    return tx_ring.try_pop(out);
+}
+
+// ---- 后台串口发送任务 ----
+static int serial_task_fn() {
+    while (true) {
+        SerialTxFrame frame;
+        int written = 0;
+        while (serial_telemetry_pop(frame)) {
+            fwrite(frame.bytes, 1, frame.len, stdout);
+            written++;
+        }
+        if (written > 0) fflush(stdout);  // 一批写完再 flush 一次
+        vex::task::sleep(SERIAL_TELEM_WRITER_INTERVAL_MS);
+    }
+    return 0;
+}
+
+void serial_telemetry_start() {
+    if (!SERIAL_TELEM_ENABLED || serial_task_ptr != nullptr) return;
+    serial_task_ptr = new vex::task(serial_task_fn, vex::task::taskPrioritylow);
+}
+
+SerialTelemetryStats serial_telemetry_get_stats() {
+    SerialTelemetryStats stats;
+    stats.sent         = sent_count.load(std::memory_order_relaxed);
+    stats.rate_limited = rate_limited_count.load(std::memory_order_relaxed);
+    stats.dropped      = dropped_count.load(std::memory_order_relaxed);
+    return stats;
+}
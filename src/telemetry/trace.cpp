@@ -0,0 +1,117 @@
+// ============================================================================
+//  telemetry/trace.cpp — 时间线采集的实现
+// ============================================================================
+//
+//  【一次性采集】
+//    trace_buffer 是固定大小的数组，trace_next 是"下一个空格子"。
+//    记录时 fetch_add 占一个格子；格子编号超过容量就说明满了，
+//    这条丢弃并停止采集。不回绕——时间线要的是一段连续的记录，而不是"最近"的零碎片段。
+//
+//  【怎么知道一个格子填完了？】
+//    先占格子、再填内容，中间可能被别的任务打断。
+//    所以每个格子有一个 ready 标记，填完最后一个字段才置位；
+//    导出时跳过还没填完的格子。
+//
+// ============================================================================
+#include "telemetry/trace.h"
+#include "telemetry/sd_files.h"
+#include "hal/hal_log.h"
+#include <atomic>
+
+static TraceEvent              trace_buffer[TRACE_CAPACITY];
+static std::atomic<bool>       trace_ready[TRACE_CAPACITY];
+static TraceEvent              trace_export[TRACE_CAPACITY];  // 去掉没填完的格子后的连续副本
+static std::atomic<int>        trace_next(0);
+static std::atomic<bool>       trace_active(false);
+static std::atomic<unsigned long> trace_drop_count(0);
+
+void trace_capture_start() {
+    trace_active.store(false);
+    for (int i = 0; i < TRACE_CAPACITY; ++i) {
+        trace_ready[i].store(false, std::memory_order_relaxed);
+    }
+    trace_drop_count.store(0);
+    trace_next.store(0);
+    trace_active.store(true, std::memory_order_release);
+}
+
+void trace_capture_stop() {
+    trace_active.store(false, std::memory_order_release);
+}
+
+bool trace_capture_active() {
+    return trace_active.load(std::memory_order_acquire);
+}
+
+void trace_record(TraceId id, uint32_t start_us, uint32_t dur_us) {
+    if (!trace_active.load(std::memory_order_acquire)) return;
+
+    int slot = trace_next.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= TRACE_CAPACITY) {
+        trace_active.store(false, std::memory_order_release);  // 满了，自动停止
+        trace_drop_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent& ev = trace_buffer[slot];
+    ev.start_us = start_us;
+    ev.dur_us   = dur_us;
+    ev.id       = (uint8_t)id;
+    trace_ready[slot].store(true, std::memory_order_release);
+}
+
+const TraceEvent* trace_events(int* count) {
+    int used = trace_next.load(std::memory_order_acquire);
+    if (used > TRACE_CAPACITY) used = TRACE_CAPACITY;
+    int n = 0;
+    for (int i = 0; i < used; ++i) {
+        if (trace_ready[i].load(std::memory_order_acquire)) {
+            trace_export[n++] = trace_buffer[i];
+        }
+    }
+    *count = n;
+    return trace_export;
+}
+
+unsigned long trace_dropped() {
+    return trace_drop_count.load(std::memory_order_relaxed);
+}
+
+int trace_save_binary(FILE* f) {
+    int n = 0;
+    const TraceEvent* events = trace_events(&n);
+
+    uint8_t header[TRACE_FILE_HEADER_SIZE];
+    trace_file_encode_header(header, (uint32_t)n);
+    fwrite(header, 1, TRACE_FILE_HEADER_SIZE, f);
+
+    uint8_t bytes[TRACE_EVENT_SIZE];
+    for (int i = 0; i < n; ++i) {
+        trace_event_encode(events[i], bytes);
+        fwrite(bytes, 1, TRACE_EVENT_SIZE, f);
+    }
+    fclose(f);
+    return n;
+}
+
+void trace_save_to_sd() {
+    trace_capture_stop();
+    char path[32];
+    FILE* f = sd_open_numbered_file("/usd/trace_%03d.bin", path, sizeof(path));
+    if (f == nullptr) {
+        LOG_WARNF("Trace: cannot open file on SD card");
+        return;
+    }
+    int n = trace_save_binary(f);
+    LOG_INFOF("Trace: %d events -> %s (%lu dropped)", n, path, trace_dropped());
+}
+
+bool trace_save_chrome_json(const char* path) {
+    trace_capture_stop();
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) return false;
+    int n = 0;
+    const TraceEvent* events = trace_events(&n);
+    trace_write_chrome_json(f, events, n);
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,100 @@
+// ============================================================================
+//  telemetry/trace_event.cpp — 时间线事件的编码/解码和 JSON 导出
+// ============================================================================
+#include "telemetry/trace_event.h"
+#include "telemetry/byte_order.h"
+#include <string.h>
+
+// ---- 事件名和所在任务（下标 = TraceId）----
+// 时间线上的 tid 就是任务在下面这张表里的序号 + 1
+static const char* const TRACE_NAMES[TRACE_ID_COUNT] = {
+    "odometry_update",
+    "vision_localizer_update",
+    "pid_calculate",
+    "sd_write_log",
+    "sd_write_odom",
+    "sd_write_flight",
+    "vision_snapshot",
+};
+
+static const char* const TRACE_TRACKS[] = {
+    "odometry task",
+    "vision task",
+    "motion (main)",
+    "log writer",
+    "odom log writer",
+    "flight recorder",
+    "vision capture task",
+};
+static const int TRACE_TRACK_COUNT = sizeof(TRACE_TRACKS) / sizeof(TRACE_TRACKS[0]);
+
+static const int TRACE_TRACK_OF[TRACE_ID_COUNT] = { 0, 1, 2, 3, 4, 5, 6 };
+
+const char* trace_event_name(int id) {
+    if (id < 0 || id >= TRACE_ID_COUNT) return "unknown";
+    return TRACE_NAMES[id];
+}
+
+const char* trace_event_track(int id) {
+    if (id < 0 || id >= TRACE_ID_COUNT) return "unknown";
+    return TRACE_TRACKS[TRACE_TRACK_OF[id]];
+}
+
+// ---- 文件头 ----
+// 偏移: 0 魔数(4)  4 版本(2)  6 事件长度(2)  8 事件个数(4)  12 保留(4)
+void trace_file_encode_header(uint8_t* out, uint32_t event_count) {
+    memset(out, 0, TRACE_FILE_HEADER_SIZE);
+    put_u32(out + 0, TRACE_FILE_MAGIC);
+    put_u16(out + 4, TRACE_FILE_VERSION);
+    put_u16(out + 6, (uint16_t)TRACE_EVENT_SIZE);
+    put_u32(out + 8, event_count);
+}
+
+bool trace_file_decode_header(const uint8_t* in, uint16_t* version, uint32_t* event_count) {
+    if (get_u32(in) != TRACE_FILE_MAGIC) return false;
+    if (get_u16(in + 6) != TRACE_EVENT_SIZE) return false;
+    *version     = get_u16(in + 4);
+    *event_count = get_u32(in + 8);
+    return true;
+}
+
+// ---- 事件 ----
+void trace_event_encode(const TraceEvent& ev, uint8_t* out) {
+    put_u32(out + 0, ev.start_us);
+    put_u32(out + 4, ev.dur_us);
+    out[8]  = ev.id;
+    out[9]  = 0;
+    out[10] = 0;
+    out[11] = 0;
+}
+
+void trace_event_decode(const uint8_t* in, TraceEvent* ev) {
+    ev->start_us = get_u32(in + 0);
+    ev->dur_us   = get_u32(in + 4);
+    ev->id       = in[8];
+}
+
+// ---- Chrome trace-event JSON ----
+// 格式见 Chrome 的 "Trace Event Format" 文档：
+//   "ph":"X" = 完整事件（带开始时间 ts 和持续时间 dur，单位微秒）
+//   "ph":"M" = 元数据，这里用来给每个 tid 起名字
+int trace_write_chrome_json(FILE* out, const TraceEvent* events, int count) {
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"V5 Brain\"}}");
+    for (int t = 0; t < TRACE_TRACK_COUNT; ++t) {
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                     "\"args\":{\"name\":\"%s\"}}", t + 1, TRACE_TRACKS[t]);
+    }
+    int written = 0;
+    for (int i = 0; i < count; ++i) {
+        const TraceEvent& ev = events[i];
+        int track = (ev.id < TRACE_ID_COUNT) ? TRACE_TRACK_OF[ev.id] : 0;
+        fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"robot\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,"
+                     "\"pid\":1,\"tid\":%d}",
+                trace_event_name(ev.id), (unsigned long)ev.start_us, (unsigned long)ev.dur_us,
+                track + 1);
+        written++;
+    }
+    fprintf(out, "\n]}\n");
+    return written;
+}
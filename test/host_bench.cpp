@@ -0,0 +1,950 @@
+// ============================================================================
+//  test/host_bench.cpp — 定位融合的性能测试（在电脑上运行，不需要机器人）
+// ============================================================================
+//
+//  【这个文件干什么？】
+//    比较几种"视觉 + 里程计"融合方法，到底哪个更准、各要花多少时间：
+//    • 互补滤波（原来的方法）：取置信度最高的标签反推位置，按固定比例 α 拉过去
+//    • 扩展卡尔曼滤波（localization/pose_ekf.h）：每个标签的距离 + 方位都融合
+//    • 粒子滤波（localization/particle_filter.h）：几百个猜测一起跟踪
+//    另外跑一遍"只用里程计"作为参考，看看不修正会飘多远。
+//    最后单独测粒子滤波：粒子数从小到大，看一个 10 ms 周期里放得下多少。
+//    还有一段 15 秒自治的航向漂移：只用 IMU vs IMU + 轮子互补滤波（heading_fusion.h），
+//    和一段 60 秒"走走停停"的长自治：停下来时估计陀螺仪零漂有没有用（gyro_bias.h）。
+//    然后比较三种里程计积分方法（中点 / 圆弧 / RK2）在 5~50 ms 周期下的误差和耗时，
+//    以及同一帧看到好几个标签时，联合求解（multi_tag.h）比只用最好的一个准多少，
+//    和一段 120 秒的长自治：视觉估航向（标签宽高比）能不能把 IMU 的漂移压住。
+//    最后让车全速来回冲、画面晚 60 ms 才到：按拍摄时刻修正（延迟补偿）有多大用。
+//
+//  【数据从哪来？】
+//    这是合成的回放数据，不是真车录的：
+//    ① 先生成一条真实轨迹（面朝左墙来回开、车头左右摆，像在球门前推挤），100 Hz
+//    ② 从真实轨迹算出"传感器读数"，再加上误差：
+//       • 追踪轮打滑（系统性少算 2%）+ 随机噪声
+//       • IMU 慢慢漂移（每分钟约 1.7°）+ 随机噪声
+//       • 每 50 ms 看一次标签：只看得到视野内、2.5 米以内的，
+//         距离和方位都带噪声，偶尔还有一次误检（距离错得离谱）
+//       • 第 30 秒被"撞"了一下：真车突然平移 + 转了一点，传感器完全没看见
+//    ③ 三种方法吃同一份数据，和真实轨迹比误差
+//
+//  【怎么运行？】
+//    make bench
+//
+// ============================================================================
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "config.h"
+#include "hal/vision.h"
+#include "localization/gyro_bias.h"
+#include "localization/heading_fusion.h"
+#include "localization/particle_filter.h"
+#include "localization/pose_ekf.h"
+#include "localization/pose_history.h"
+#include "localization/vision_geometry.h"
+
+#include "../src/localization/pose_history.cpp"
+#include "../src/localization/vision_geometry.cpp"
+#include "../src/localization/multi_tag.cpp"
+#include "../src/localization/pose_ekf.cpp"
+#include "../src/localization/particle_filter.cpp"
+#include "../src/localization/heading_fusion.cpp"
+#include "../src/localization/gyro_bias.cpp"
+
+// ---- 回放参数 ----
+static const double BENCH_DURATION_S    = 60.0;
+static const double BENCH_DT_S          = LOOP_INTERVAL_MS / 1000.0;
+static const int    BENCH_VISION_EVERY  = 50 / LOOP_INTERVAL_MS;   // 每 50 ms 一帧
+static const double BENCH_SLIP          = 0.02;     // 追踪轮系统性少算 2%
+static const double BENCH_WHEEL_NOISE_M = 0.0003;   // 每次更新的随机误差
+static const double BENCH_IMU_DRIFT     = 0.0005;   // 弧度/秒（约 0.03°/s）
+static const double BENCH_IMU_NOISE     = 0.0002;   // 每次更新的随机误差
+static const double BENCH_RANGE_NOISE   = 0.03;     // 距离误差（比例）
+static const double BENCH_BEARING_NOISE = 0.01;     // 方位误差（弧度）
+static const double BENCH_OUTLIER_RATE  = 0.02;     // 2% 的标签读数是误检
+static const double BENCH_CONVERGED_M   = 0.05;     // 位置误差小于 5 cm 算收敛
+static const double BENCH_SHOVE_AT_S    = 30.0;     // 第几秒被撞
+static const Pose   BENCH_SHOVE         = { 0.25, -0.20, 0.15 };  // 撞了多少（里程计看不见）
+static const double BENCH_RECOVERED_M   = 0.10;     // 被撞后误差回到 10 cm 以内算找回来
+static const double BENCH_BUDGET_US     = LOOP_INTERVAL_MS * 1000.0;  // 一个控制周期
+
+static std::mt19937 rng(12345);  // 固定种子：每次运行结果都一样
+
+static double gauss(double sigma) {
+    std::normal_distribution<double> d(0.0, sigma);
+    return d(rng);
+}
+
+static double uniform01() {
+    std::uniform_real_distribution<double> d(0.0, 1.0);
+    return d(rng);
+}
+
+static double wrap(double a) {
+    return atan2(sin(a), cos(a));
+}
+
+// ---- 一种融合方法的误差统计 ----
+struct BenchResult {
+    const char* name;
+    double      sum_pos_sq;
+    double      sum_theta_sq;
+    double      max_pos;
+    double      converged_s;   // 误差第一次 < 5 cm 的时刻（初始偏差被消掉）
+    int         within;        // 误差 < 5 cm 的样本数
+    double      recovered_s;   // 被撞后多久误差第一次回到 10 cm 以内（-1 = 没回来）
+    int         after_shove;   // 被撞以后的样本数
+    int         after_within;  // 其中误差 < 10 cm 的（回来了还能不能待住）
+    int         samples;
+    int         tag_updates;
+    int         tag_rejects;
+
+    void add(double t, const Pose& est, const Pose& truth) {
+        double e  = hypot(est.x - truth.x, est.y - truth.y);
+        double et = wrap(est.theta - truth.theta);
+        sum_pos_sq   += e * e;
+        sum_theta_sq += et * et;
+        if (e > max_pos) max_pos = e;
+        if (e < BENCH_CONVERGED_M) {
+            within++;
+            if (converged_s < 0) converged_s = t;
+        }
+        if (t > BENCH_SHOVE_AT_S && recovered_s < 0 && e < BENCH_RECOVERED_M) {
+            recovered_s = t - BENCH_SHOVE_AT_S;
+        }
+        if (t > BENCH_SHOVE_AT_S) {
+            after_shove++;
+            if (e < BENCH_RECOVERED_M) after_within++;
+        }
+        samples++;
+    }
+
+    void print() const {
+        printf("  %-22s pos RMS %6.1f mm  max %6.1f mm  heading RMS %5.2f deg  ",
+               name, 1000.0 * sqrt(sum_pos_sq / samples), 1000.0 * max_pos,
+               sqrt(sum_theta_sq / samples) * 180.0 / M_PI);
+        if (converged_s >= 0) printf("converged %5.2f s", converged_s);
+        else                  printf("not converged   ");
+        printf("  <5cm %3.0f%%", 100.0 * within / samples);
+        if (recovered_s >= 0) printf("  shove: back in %5.2f s", recovered_s);
+        else                  printf("  shove: lost           ");
+        printf("  after shove <10cm %3.0f%%", after_shove ? 100.0 * after_within / after_shove : 0.0);
+        printf("  tags %d/%d\n", tag_updates - tag_rejects, tag_updates);
+    }
+};
+
+// ============================================================================
+//  粒子数预算：一个控制周期里最坏情况（预测 + 两个标签 + 重采样）要多久
+// ============================================================================
+static void bench_particle_budget() {
+    static const int COUNTS[] = { 100, 250, 500, 1000, 2000, 4000, 8000, 16000 };
+    static const int CYCLES   = 200;
+    typedef std::chrono::steady_clock clock;
+
+    printf("\n[Particle budget: predict + 2 tags + resample in one %.0f ms cycle]\n",
+           BENCH_BUDGET_US / 1000.0);
+    printf("  particles   predict us   tags+resample us   worst cycle us   of budget\n");
+
+    Pose truth = { 1.0, 1.80, M_PI };
+    TagMeasurement tags[2];
+    for (int k = 0; k < 2; ++k) {
+        const FieldTag* t = find_field_tag(k == 0 ? 1 : 3);
+        double cx, cy;
+        vision_camera_position(truth, &cx, &cy);
+        tags[k].id         = t->id;
+        tags[k].tag_x      = t->x;
+        tags[k].tag_y      = t->y;
+        tags[k].range      = hypot(t->x - cx, t->y - cy);
+        tags[k].bearing    = wrap(atan2(t->y - cy, t->x - cx) - truth.theta - VISION_CAMERA_ANGLE);
+        tags[k].confidence = 1.0;
+    }
+    OdomDelta step = { 0.005, 0.0, 0.002 };
+
+    double per_particle_us = 0.0;
+    for (unsigned c = 0; c < sizeof(COUNTS) / sizeof(COUNTS[0]); ++c) {
+        ParticleFilter pf;
+        pf.init(COUNTS[c]);
+        pf.reset(truth);
+        double predict_us = 0, update_us = 0;
+        for (int k = 0; k < CYCLES; ++k) {
+            clock::time_point t0 = clock::now();
+            pf.predict(step);
+            clock::time_point t1 = clock::now();
+            pf.update_tag(tags[0]);
+            pf.update_tag(tags[1]);
+            pf.finish_update();
+            clock::time_point t2 = clock::now();
+            predict_us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            update_us  += std::chrono::duration<double, std::micro>(t2 - t1).count();
+        }
+        predict_us /= CYCLES;
+        update_us  /= CYCLES;
+        double worst = predict_us + update_us;
+        per_particle_us = worst / COUNTS[c];
+        printf("  %9d   %10.1f   %16.1f   %14.1f   %8.1f%%\n",
+               COUNTS[c], predict_us, update_us, worst, 100.0 * worst / BENCH_BUDGET_US);
+    }
+    printf("\n  ~%.0f particles fit in one %.0f ms cycle on this machine\n",
+           BENCH_BUDGET_US / per_particle_us, BENCH_BUDGET_US / 1000.0);
+    printf("  (the V5 brain is much slower: confirm on the robot with the odom loop stats)\n");
+}
+
+static BenchResult bench_result(const char* name) {
+    BenchResult r;
+    r.name         = name;
+    r.sum_pos_sq   = 0.0;
+    r.sum_theta_sq = 0.0;
+    r.max_pos      = 0.0;
+    r.converged_s  = -1.0;
+    r.within       = 0;
+    r.recovered_s  = -1.0;
+    r.after_shove  = 0;
+    r.after_within = 0;
+    r.samples      = 0;
+    r.tag_updates  = 0;
+    r.tag_rejects  = 0;
+    return r;
+}
+
+// ============================================================================
+//  航向漂移：15 秒自治（直行 + 快速原地转 + 慢弧线），第 8 秒 IMU 掉线 0.5 秒
+// ============================================================================
+//  IMU：零漂 0.0015 rad/s（约 5°/分钟）+ 比例误差 0.4% + 噪声
+//  驱动电机：原地快转时蹭地少算 3%，起步偶尔打滑，编码器按刻度取整
+//  平行轮：比例误差 0.3% + 噪声（不蹭地、不打滑）
+struct HeadingSegment { double seconds; double rate; };
+
+static void bench_heading_fusion() {
+    static const HeadingSegment SCRIPT[] = {
+        { 1.5, 0.0 }, { 0.63, 2.5 }, { 2.0, 0.0 }, { 1.2, -0.4 }, { 1.0, 0.0 },
+        { 0.94, -2.5 }, { 2.5, 0.0 }, { 0.63, 2.5 }, { 1.5, 0.3 }, { 1.6, 0.0 }, { 1.5, 0.0 },
+    };
+    const double IMU_BIAS = 0.0015, IMU_SCALE = 1.004, SCRUB = 0.97, PAR_SCALE = 0.997;
+    const double DROPOUT_FROM = 8.0, DROPOUT_TO = 8.5;
+    const double m_per_tick = WHEEL_CIRCUMFERENCE / TICKS_PER_REV;
+
+    HeadingFusion drive(IMU_FUSION_ALPHA, BENCH_DT_S, true);
+    HeadingFusion parallel(IMU_FUSION_ALPHA, BENCH_DT_S, false);
+    double truth = 0.0, imu_only = 0.0, drive_ticks_prev = 0.0;
+    double drive_wheel = 0.0;
+    double max_err[3] = { 0, 0, 0 }, max_step = 0.0;
+    double t = 0.0;
+    for (unsigned s = 0; s < sizeof(SCRIPT) / sizeof(SCRIPT[0]); ++s) {
+        int steps = (int)(SCRIPT[s].seconds / BENCH_DT_S + 0.5);
+        for (int k = 0; k < steps; ++k, t += BENCH_DT_S) {
+            double d_truth = SCRIPT[s].rate * BENCH_DT_S;
+            truth += d_truth;
+
+            double d_imu = d_truth * IMU_SCALE + IMU_BIAS * BENCH_DT_S + gauss(BENCH_IMU_NOISE);
+            bool imu_ok = t < DROPOUT_FROM || t >= DROPOUT_TO;
+
+            // 驱动电机：快转时蹭地；每段开头打滑一下；按编码器刻度取整
+            double d_drive = d_truth * (std::abs(SCRIPT[s].rate) > 1.0 ? SCRUB : 1.0);
+            if (k == 0) d_drive += gauss(0.01);
+            drive_wheel += d_drive;
+            double drive_ticks = floor(drive_wheel * WHEEL_TRACK / m_per_tick + 0.5);
+            double d_drive_q = (drive_ticks - drive_ticks_prev) * m_per_tick / WHEEL_TRACK;
+            drive_ticks_prev = drive_ticks;
+
+            double d_par = d_truth * PAR_SCALE + gauss(0.0001);
+
+            imu_only += imu_ok ? d_imu : 0.0;   // 只用 IMU 的话，掉线期间航向停住
+            double step = drive.update(d_imu, imu_ok, d_drive_q, true, BENCH_DT_S);
+            parallel.update(d_imu, imu_ok, d_par, true, BENCH_DT_S);
+            if (std::abs(step - d_truth) > max_step) max_step = std::abs(step - d_truth);
+
+            double e[3] = { imu_only - truth, drive.heading() - truth, parallel.heading() - truth };
+            for (int m = 0; m < 3; ++m) if (std::abs(e[m]) > max_err[m]) max_err[m] = std::abs(e[m]);
+        }
+    }
+
+    const double DEG = 180.0 / M_PI;
+    printf("\n[Heading drift over a %.0f s autonomous run, IMU dropout %.1f-%.1f s]\n",
+           t, DROPOUT_FROM, DROPOUT_TO);
+    printf("  IMU only                 final %6.2f deg  max %6.2f deg\n",
+           (imu_only - truth) * DEG, max_err[0] * DEG);
+    printf("  IMU + drive encoders     final %6.2f deg  max %6.2f deg  (wheel ticks %lu, slip %lu)\n",
+           (drive.heading() - truth) * DEG, max_err[1] * DEG,
+           drive.stats().wheel_ticks, drive.stats().slip_ticks);
+    printf("  IMU + parallel wheel     final %6.2f deg  max %6.2f deg\n",
+           (parallel.heading() - truth) * DEG, max_err[2] * DEG);
+    printf("  largest one-tick heading error with drive encoders: %.3f deg (no jump at dropout)\n",
+           max_step * DEG);
+}
+
+// ============================================================================
+//  长自治（60 秒）：停 1 秒 → 原地转 90° → 停 0.5 秒 → 开 2 秒，循环
+//  IMU 零漂 0.003 rad/s（约 10°/分钟，没预热好的 IMU），驱动电机快转时蹭地
+// ============================================================================
+static void bench_gyro_bias() {
+    typedef std::chrono::steady_clock clock;
+    const double IMU_BIAS = 0.003, SCRUB = 0.97;
+    const double CYCLE_S = 1.0 + 0.63 + 0.5 + 2.0;
+    const int    STEPS = (int)(60.0 / BENCH_DT_S);
+
+    GyroBiasEstimator bias;
+    HeadingFusion fused(IMU_FUSION_ALPHA, BENCH_DT_S, true);
+    HeadingFusion fused_bias(IMU_FUSION_ALPHA, BENCH_DT_S, true);
+    double truth = 0.0, imu_only = 0.0, imu_bias = 0.0;
+    double cost_us = 0.0;
+    int turn = 1;
+    for (int i = 0; i < STEPS; ++i) {
+        double phase = fmod(i * BENCH_DT_S, CYCLE_S);
+        bool   pause = phase < 1.0 || (phase >= 1.63 && phase < 2.13);
+        bool   turning = phase >= 1.0 && phase < 1.63;
+        if (phase < BENCH_DT_S) turn = -turn;          // 左右交替，免得比例误差一直往一边攒
+        double rate = turning ? turn * 2.5 : 0.0;
+        double speed = (!pause && !turning) ? 0.6 : 0.0;
+
+        double d_truth = rate * BENCH_DT_S;
+        truth += d_truth;
+        double d_imu = d_truth + IMU_BIAS * BENCH_DT_S + gauss(BENCH_IMU_NOISE);
+        double d_drive = d_truth * (turning ? SCRUB : 1.0);
+
+        StationaryInputs in;
+        in.wheel_forward_m = speed * BENCH_DT_S + (pause ? gauss(0.00001) : 0.0);
+        in.wheel_lateral_m = pause ? gauss(0.00001) : 0.0;
+        in.motor_left_m    = (speed - rate * WHEEL_TRACK / 2.0) * BENCH_DT_S;
+        in.motor_right_m   = (speed + rate * WHEEL_TRACK / 2.0) * BENCH_DT_S;
+        in.command_volts   = pause ? 0.0 : 8.0;
+
+        clock::time_point t0 = clock::now();
+        double d_corrected = bias.correct(d_imu, in, BENCH_DT_S);
+        cost_us += std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+
+        imu_only += d_imu;
+        imu_bias += d_corrected;
+        fused.update(d_imu, true, d_drive, true, BENCH_DT_S);
+        fused_bias.update(d_corrected, true, d_drive, true, BENCH_DT_S);
+    }
+
+    const double DEG = 180.0 / M_PI;
+    printf("\n[Heading after a 60 s stop-and-go routine, gyro bias %.1f deg/min]\n", IMU_BIAS * 60.0 * DEG);
+    printf("  IMU only                       final error %6.2f deg\n", (imu_only - truth) * DEG);
+    printf("  IMU - stationary bias          final error %6.2f deg  (bias %.2f deg/min, learned over %.1f s)\n",
+           (imu_bias - truth) * DEG, bias.bias() * 60.0 * DEG, bias.learned_s());
+    printf("  IMU + drive encoders           final error %6.2f deg\n", (fused.heading() - truth) * DEG);
+    printf("  IMU - bias + drive encoders    final error %6.2f deg\n", (fused_bias.heading() - truth) * DEG);
+    printf("  stationary detector + bias: %.0f ns per tick on this machine\n", 1000.0 * cost_us / STEPS);
+}
+
+// ============================================================================
+//  多标签联合求解：每一帧单独看，和"只用置信度最高的一个标签"比误差
+// ============================================================================
+//  场地里随机摆车，看得见 2 个以上标签的帧才算。里程计的位姿（求解的起点、
+//  也是单标签法借用的航向）带着 5 cm / 3° 的误差。
+static void bench_multi_tag() {
+    typedef std::chrono::steady_clock clock;
+    const int    FRAMES = 20000;
+    const double half_fov = atan2(VISION_IMAGE_WIDTH / 2.0, VISION_FOCAL_LENGTH);
+    double single_sq[4] = { 0 }, joint_sq[4] = { 0 }, theta_sq[4] = { 0 };
+    int    frames[4] = { 0 }, rejected[4] = { 0 };
+    int    outlier_frames = 0, outlier_caught = 0;
+    double solve_ns = 0;
+    int    solve_n  = 0;
+
+    for (int f = 0; f < FRAMES; ++f) {
+        Pose truth = { 0.4 + 2.85 * uniform01(), 0.4 + 2.85 * uniform01(), 2.0 * M_PI * uniform01() };
+        Pose odom  = { truth.x + gauss(0.05), truth.y + gauss(0.05), truth.theta + gauss(0.05) };
+        bool with_outlier = (f % 10 == 0);
+
+        TagMeasurement seen[VISION_MAX_TAGS];
+        int n = 0;
+        for (int k = 0; k < NUM_FIELD_TAGS && n < VISION_MAX_TAGS; ++k) {
+            double range, bearing;
+            if (!vision_predict_tag(truth, FIELD_TAGS[k].x, FIELD_TAGS[k].y, &range, &bearing, nullptr)) continue;
+            if (fabs(bearing) > half_fov || range > MAX_VISION_RANGE) continue;
+            TagMeasurement& m = seen[n++];
+            m.id      = FIELD_TAGS[k].id;
+            m.tag_x   = FIELD_TAGS[k].x;
+            m.tag_y   = FIELD_TAGS[k].y;
+            m.range   = range * (1.0 + gauss(BENCH_RANGE_NOISE));
+            m.bearing = bearing + gauss(BENCH_BEARING_NOISE);
+            m.confidence = vision_compute_confidence(m.range, APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH / m.range);
+        }
+        int usable = 0, best = -1;
+        for (int k = 0; k < n; ++k) {
+            if (seen[k].confidence <= 0.0) continue;
+            usable++;
+            if (best < 0 || seen[k].confidence > seen[best].confidence) best = k;
+        }
+        if (usable < 2 || seen[best].confidence < VISION_MIN_CONFIDENCE) continue;
+        if (with_outlier) {
+            seen[best == 0 ? 1 : 0].range += 0.5;   // 有一个标签是误检：距离差了 50 cm
+            outlier_frames++;
+        }
+
+        clock::time_point t0 = clock::now();
+        MultiTagSolution sol = multi_tag_solve(seen, n, odom);
+        solve_ns += std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        solve_n++;
+        if (with_outlier) {
+            if (!sol.ok) outlier_caught++;
+            continue;
+        }
+
+        int g = usable >= 5 ? 3 : usable - 2;   // 2 / 3 / 4 / 5+ 个
+        double sx, sy;
+        const TagMeasurement& m = seen[best];
+        vision_robot_from_tag(m.tag_x, m.tag_y, m.range, m.bearing, odom.theta, &sx, &sy);
+        double es = hypot(sx - truth.x, sy - truth.y);
+        single_sq[g] += es * es;
+        frames[g]++;
+        if (!sol.ok) {
+            rejected[g]++;
+            continue;
+        }
+        double ej = hypot(sol.pose.x - truth.x, sol.pose.y - truth.y);
+        double et = wrap(sol.pose.theta - truth.theta);
+        joint_sq[g] += ej * ej;
+        theta_sq[g] += et * et;
+    }
+
+    printf("\n[Multi-tag solve: per-frame error, odometry prior off by 5 cm / 3 deg]\n");
+    printf("  tags   frames   best single tag   joint solve   joint heading   rejected\n");
+    static const char* LABELS[] = { "2", "3", "4", "5+" };
+    for (int g = 0; g < 4; ++g) {
+        if (frames[g] == 0) continue;
+        int solved = frames[g] - rejected[g];
+        printf("  %-4s  %7d   %9.1f mm      %7.1f mm    %7.2f deg    %5.1f%%\n",
+               LABELS[g], frames[g], 1000.0 * sqrt(single_sq[g] / frames[g]),
+               solved ? 1000.0 * sqrt(joint_sq[g] / solved) : 0.0,
+               solved ? sqrt(theta_sq[g] / solved) * 180.0 / M_PI : 0.0,
+               100.0 * rejected[g] / frames[g]);
+    }
+    printf("  one tag off by 50 cm: %d of %d frames rejected (fall back to single tag)\n",
+           outlier_caught, outlier_frames);
+    printf("  cost per solve on this machine: %.0f ns (%d iterations)\n",
+           solve_n ? solve_ns / solve_n : 0.0, VISION_MULTI_TAG_ITERATIONS);
+}
+
+// ============================================================================
+//  视觉航向修正：120 秒长自治，IMU 每秒漂 0.003 弧度（一分钟约 10°）
+// ============================================================================
+//  轨迹和上面的回放一样（在左墙前来回开、车头左右摆），只是时间更长、漂移更大。
+//  每 50 ms 看一次标签：宽度按斜看的角度压扁，宽、高、方位都带噪声。
+//  比较：不修航向（互补滤波原来的样子）/ 有上限的航向修正 / 卡尔曼滤波（参考）
+struct AspectView { double facing, width, height, bearing; };
+
+// 几个标签的宽高比航向按方差倒数加权（和 vision_localizer.cpp 一样），正负号选离 near 近的
+static bool fuse_aspect_heading(const AspectView* views, int n, double near, double* heading, double* sigma) {
+    double info = 0.0, sum = 0.0;
+    for (int k = 0; k < n; ++k) {
+        double h, s;
+        if (!vision_heading_from_tag(views[k].facing, views[k].width, views[k].height, views[k].bearing, near, &h, &s)) continue;
+        info += 1.0 / (s * s);
+        sum  += (h - near) / (s * s);
+    }
+    if (info == 0.0) return false;
+    *heading = near + sum / info;
+    *sigma   = 1.0 / sqrt(info);
+    return true;
+}
+
+static void bench_vision_heading() {
+    const double DURATION_S = 120.0, GYRO_BIAS = 0.003;
+    const double half_fov = atan2(VISION_IMAGE_WIDTH / 2.0, VISION_FOCAL_LENGTH);
+    const int    steps = (int)(DURATION_S / BENCH_DT_S);
+
+    Pose truth = { 2.4, 1.83, M_PI };
+    Pose none = truth, bounded = truth;
+    static PoseEkf ekf;
+    ekf.reset(truth);
+    double sq[3] = { 0 };
+    int    heading_updates = 0;
+
+    printf("\n[Vision heading: %.0f s autonomous, gyro drifting %.3f rad/s]\n", DURATION_S, GYRO_BIAS);
+    printf("  heading error (deg)   t=30 s   t=60 s   t=90 s  t=120 s\n");
+    double at[3][4];
+    for (int i = 1; i <= steps; ++i) {
+        double t = i * BENCH_DT_S;
+        double v = 0.5 * sin(0.5 * t), omega = 0.15 * cos(0.35 * t);
+        OdomDelta true_delta = { v * BENCH_DT_S, 0.0, omega * BENCH_DT_S };
+        truth = pose_integrate(truth, true_delta);
+        OdomDelta measured = { true_delta.forward + gauss(BENCH_WHEEL_NOISE_M), gauss(BENCH_WHEEL_NOISE_M),
+                               true_delta.dtheta + GYRO_BIAS * BENCH_DT_S + gauss(BENCH_IMU_NOISE) };
+        none    = pose_integrate(none, measured);
+        bounded = pose_integrate(bounded, measured);
+        ekf.predict(measured);
+
+        if (i % BENCH_VISION_EVERY == 0) {
+            double best_conf = 0.0, bx = 0.0, by = 0.0;
+            int n_tags = 0, n_views = 0;
+            TagMeasurement seen[VISION_MAX_TAGS];
+            AspectView views[VISION_MAX_TAGS];
+            double cam_x, cam_y;
+            vision_camera_position(truth, &cam_x, &cam_y);
+            for (int k = 0; k < NUM_FIELD_TAGS && n_tags < VISION_MAX_TAGS; ++k) {
+                const FieldTag& tag = FIELD_TAGS[k];
+                double range, bearing;
+                if (!vision_predict_tag(truth, tag.x, tag.y, &range, &bearing, nullptr)) continue;
+                if (fabs(bearing) > half_fov || range > MAX_VISION_RANGE) continue;
+                // 斜看的角度：从标签指向摄像头的方向 和 标签朝向 的夹角
+                double view = wrap(atan2(cam_y - tag.y, cam_x - tag.x) - tag.facing);
+                double height = APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH / range;
+                double width  = height * cos(view) + gauss(VISION_TAG_PIXEL_SIGMA);
+                height += gauss(VISION_TAG_PIXEL_SIGMA);
+                bearing += gauss(BENCH_BEARING_NOISE);
+                double pixels = width > height ? width : height;
+                double dist = vision_estimate_distance(pixels);
+                if (dist < 0) continue;
+                double conf = vision_compute_confidence(dist, pixels);
+
+                TagMeasurement& m = seen[n_tags++];
+                m.id = tag.id; m.tag_x = tag.x; m.tag_y = tag.y;
+                m.range = dist; m.bearing = bearing; m.confidence = conf;
+
+                if (conf > 0.0) {
+                    AspectView& view_k = views[n_views++];
+                    view_k.facing = tag.facing; view_k.width = width; view_k.height = height; view_k.bearing = bearing;
+                }
+                if (conf > best_conf) {
+                    best_conf = conf;
+                    vision_robot_from_tag(tag.x, tag.y, dist, bearing, bounded.theta, &bx, &by);
+                }
+            }
+            // 有上限的航向修正（位置照常用互补滤波）
+            if (best_conf >= VISION_MIN_CONFIDENCE) {
+                Pose c = vision_blend_pose(bounded, bx, by, best_conf);
+                if (hypot(c.x - bounded.x, c.y - bounded.y) < VISION_MAX_CORRECTION_M) bounded = c;
+                double h, sigma;
+                if (fuse_aspect_heading(views, n_views, bounded.theta, &h, &sigma)) {
+                    heading_updates++;
+                    bounded = vision_blend_heading(bounded, h, vision_heading_confidence(sigma));
+                }
+            }
+            // 卡尔曼滤波：标签的距离 + 方位照常融合（方位角本身就在修航向）
+            for (int k = 0; k < n_tags; ++k) {
+                if (seen[k].confidence >= VISION_MIN_CONFIDENCE) ekf.update_tag(seen[k]);
+            }
+        }
+
+        const Pose* est[3] = { &none, &bounded, &ekf.pose() };
+        for (int e = 0; e < 3; ++e) {
+            double err = wrap(est[e]->theta - truth.theta);
+            sq[e] += err * err;
+            if (i % (int)(30.0 / BENCH_DT_S) == 0) at[e][i / (int)(30.0 / BENCH_DT_S) - 1] = err * 180.0 / M_PI;
+        }
+    }
+    static const char* NAMES[] = { "blend, no heading fix", "blend + bounded fix", "EKF (range+bearing)" };
+    for (int e = 0; e < 3; ++e) {
+        printf("  %-22s %7.2f  %7.2f  %7.2f  %7.2f   RMS %.2f deg\n", NAMES[e],
+               at[e][0], at[e][1], at[e][2], at[e][3], sqrt(sq[e] / steps) * 180.0 / M_PI);
+    }
+    printf("  frames with a tag heading: %d of %d\n", heading_updates, steps / BENCH_VISION_EVERY);
+}
+
+// ============================================================================
+//  视觉延迟：画面是 60 ms 前拍的，全速来回开时补偿和不补偿差多少
+// ============================================================================
+//  和主回放一样的传感器误差（打滑 2%、IMU 漂移、标签噪声，没有误检和碰撞），
+//  只是车开得快：面朝左墙前后冲，最高 0.5 / 1.5 m/s。
+//  不补偿：结果出来时直接和现在的位姿比（以前的做法）
+//  补偿  ：在拍摄时刻比、把修正量重放到现在（互补滤波，PoseHistory::shift_at），
+//          或者把测量搬到现在再交给卡尔曼滤波（vision_carry_forward）
+static const int LATENCY_STEPS = 6;   // 60 ms = 6 个周期
+
+struct LatencyRun {
+    Pose        pose;
+    PoseHistory hist;
+    PoseEkf     ekf;
+    double      sum_sq;
+    int         samples, updates, rejects;
+};
+
+static void bench_vision_latency_at(double v_max) {
+    const double DURATION_S = 60.0, SETTLE_S = 5.0;
+    const double half_fov = atan2(VISION_IMAGE_WIDTH / 2.0, VISION_FOCAL_LENGTH);
+    const int    steps = (int)(DURATION_S / BENCH_DT_S);
+    // 0 = 互补滤波不补偿，1 = 互补滤波补偿，2 = 卡尔曼不补偿，3 = 卡尔曼补偿
+    static LatencyRun runs[4];
+    static Pose truth_hist[LATENCY_STEPS + 1];
+
+    Pose truth = { 2.4, 1.83, M_PI };
+    for (int e = 0; e < 4; ++e) {
+        runs[e].pose = truth;
+        runs[e].hist.clear();
+        runs[e].ekf.reset(truth);
+        runs[e].sum_sq = 0.0;
+        runs[e].samples = runs[e].updates = runs[e].rejects = 0;
+    }
+
+    for (int i = 1; i <= steps; ++i) {
+        double t = i * BENCH_DT_S;
+        uint64_t now_us = (uint64_t)i * LOOP_INTERVAL_MS * 1000;
+        // 往前冲 2 米再退回来（速度越快来回越勤，距离总是 2 米），车头慢慢左右摆
+        double v = v_max * sin(v_max * t), omega = 0.15 * cos(0.35 * t);
+        OdomDelta true_delta = { v * BENCH_DT_S, 0.0, omega * BENCH_DT_S };
+        truth = pose_integrate(truth, true_delta);
+        truth_hist[i % (LATENCY_STEPS + 1)] = truth;
+        OdomDelta measured = { true_delta.forward * (1.0 - BENCH_SLIP) + gauss(BENCH_WHEEL_NOISE_M),
+                               gauss(BENCH_WHEEL_NOISE_M),
+                               true_delta.dtheta + BENCH_IMU_DRIFT * BENCH_DT_S + gauss(BENCH_IMU_NOISE) };
+        for (int e = 0; e < 4; ++e) {
+            LatencyRun& r = runs[e];
+            if (e < 2) {
+                r.pose = pose_integrate(r.pose, measured);
+            } else {
+                r.ekf.predict(measured);
+                r.pose = r.ekf.pose();
+            }
+            r.hist.push(now_us, r.pose, measured);
+        }
+
+        // 每 50 ms 拿到一帧结果，画面是 LATENCY_STEPS 个周期以前拍的
+        if (i % BENCH_VISION_EVERY == 0 && i > LATENCY_STEPS) {
+            const Pose& seen_from = truth_hist[(i - LATENCY_STEPS) % (LATENCY_STEPS + 1)];
+            uint64_t capture_us = now_us - LATENCY_STEPS * LOOP_INTERVAL_MS * 1000;
+            TagMeasurement seen[VISION_MAX_TAGS];
+            int n_seen = 0, best = -1;
+            for (int k = 0; k < NUM_FIELD_TAGS && n_seen < VISION_MAX_TAGS; ++k) {
+                const FieldTag& tag = FIELD_TAGS[k];
+                double range, bearing;
+                if (!vision_predict_tag(seen_from, tag.x, tag.y, &range, &bearing, nullptr)) continue;
+                if (fabs(bearing) > half_fov || range > MAX_VISION_RANGE) continue;
+                TagMeasurement& m = seen[n_seen];
+                m.id = tag.id; m.tag_x = tag.x; m.tag_y = tag.y;
+                m.range   = range * (1.0 + gauss(BENCH_RANGE_NOISE));
+                m.bearing = bearing + gauss(BENCH_BEARING_NOISE);
+                m.confidence = vision_compute_confidence(m.range, APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH / m.range);
+                if (best < 0 || m.confidence > seen[best].confidence) best = n_seen;
+                n_seen++;
+            }
+
+            for (int e = 0; e < 4; ++e) {
+                LatencyRun& r = runs[e];
+                bool compensate = (e % 2 == 1);
+                Pose then = r.pose;
+                if (compensate) r.hist.pose_at(capture_us, &then);
+
+                if (e < 2) {
+                    if (best < 0 || seen[best].confidence < VISION_MIN_CONFIDENCE) continue;
+                    const TagMeasurement& m = seen[best];
+                    double ex, ey;
+                    vision_robot_from_tag(m.tag_x, m.tag_y, m.range, m.bearing, then.theta, &ex, &ey);
+                    Pose c = vision_blend_pose(then, ex, ey, m.confidence);
+                    r.updates++;
+                    if (hypot(c.x - then.x, c.y - then.y) >= VISION_MAX_CORRECTION_M) {
+                        r.rejects++;
+                        continue;
+                    }
+                    Pose offset = { c.x - then.x, c.y - then.y, 0.0 };
+                    if (compensate) {
+                        r.hist.shift_at(capture_us, offset, &r.pose);
+                    } else {
+                        r.pose.x += offset.x;
+                        r.pose.y += offset.y;
+                        r.hist.correct_at(now_us, r.pose, nullptr);
+                    }
+                } else {
+                    Pose now = r.pose;
+                    for (int k = 0; k < n_seen; ++k) {
+                        if (seen[k].confidence < VISION_MIN_CONFIDENCE) continue;
+                        TagMeasurement m = compensate ? vision_carry_forward(seen[k], then, now) : seen[k];
+                        r.updates++;
+                        if (r.ekf.update_tag(m) != EKF_UPDATE_ACCEPTED) r.rejects++;
+                    }
+                    r.pose = r.ekf.pose();
+                    r.hist.correct_at(now_us, r.pose, nullptr);
+                }
+            }
+        }
+
+        if (t >= SETTLE_S) {
+            for (int e = 0; e < 4; ++e) {
+                double err = hypot(runs[e].pose.x - truth.x, runs[e].pose.y - truth.y);
+                runs[e].sum_sq += err * err;
+                runs[e].samples++;
+            }
+        }
+    }
+
+    static const char* NAMES[] = { "blend", "blend, compensated", "EKF", "EKF, compensated" };
+    for (int e = 0; e < 4; ++e) {
+        printf("  %.1f m/s  %-20s pos RMS %6.1f mm  tags %d/%d\n", v_max, NAMES[e],
+               1000.0 * sqrt(runs[e].sum_sq / runs[e].samples),
+               runs[e].updates - runs[e].rejects, runs[e].updates);
+    }
+}
+
+static void bench_vision_latency() {
+    printf("\n[Vision latency: frames %d ms old, 60 s back and forth toward the left wall]\n",
+           LATENCY_STEPS * LOOP_INTERVAL_MS);
+    bench_vision_latency_at(0.5);
+    bench_vision_latency_at(1.5);
+}
+
+// ============================================================================
+//  积分方法：5 / 10 / 20 / 50 ms 周期下，和真实轨迹比误差，再比每次调用的耗时
+// ============================================================================
+//  两条 4 秒的轨迹（传感器没有误差，只看积分方法本身）：
+//    圆弧    ：1.5 m/s、2.5 rad/s 一直不变（有精确解）
+//    变曲率  ：速度、角速度、侧滑都随时间变（用 10 µs 的步长算"真值"）
+struct IntegratorPath {
+    const char* name;
+    double (*forward)(double t);
+    double (*lateral)(double t);
+    double (*omega)(double t);
+};
+
+static double arc_v(double)     { return 1.5; }
+static double arc_l(double)     { return 0.0; }
+static double arc_w(double)     { return 2.5; }
+static double wavy_v(double t)  { return 1.2 + 0.3 * sin(1.3 * t); }
+static double wavy_l(double t)  { return 0.1 * cos(t); }
+static double wavy_w(double t)  { return 3.0 * sin(1.7 * t); }
+
+// 把 [t0, t1] 里的速度用细步长积分成一步增量（追踪轮和 IMU 看到的就是这个）
+static OdomDelta path_delta(const IntegratorPath& path, double t0, double t1, int sub) {
+    OdomDelta d = { 0.0, 0.0, 0.0 };
+    double h = (t1 - t0) / sub;
+    for (int i = 0; i < sub; ++i) {
+        double t = t0 + (i + 0.5) * h;
+        d.forward += path.forward(t) * h;
+        d.lateral += path.lateral(t) * h;
+        d.dtheta  += path.omega(t) * h;
+    }
+    return d;
+}
+
+static void bench_integrators() {
+    typedef std::chrono::steady_clock clock;
+    static const IntegratorPath PATHS[] = {
+        { "constant arc",     arc_v,  arc_l,  arc_w  },
+        { "varying curvature", wavy_v, wavy_l, wavy_w },
+    };
+    static const int    PERIODS_MS[] = { 5, 10, 20, 50 };
+    static const int    METHODS[]    = { ODOM_INTEGRATOR_MIDPOINT, ODOM_INTEGRATOR_ARC, ODOM_INTEGRATOR_RK2 };
+    static const char*  NAMES[]      = { "midpoint", "arc", "RK2" };
+    const double DURATION_S = 4.0, TRUTH_STEP_S = 0.00001, TARGET_MM = 1.0;
+
+    printf("\n[Odometry integrators: end-point error after a %.0f s path (mm)]\n", DURATION_S);
+    printf("  %-18s  period   %9s  %9s  %9s\n", "path", NAMES[0], NAMES[1], NAMES[2]);
+    double worst[4][3] = { { 0 } };
+    for (unsigned p = 0; p < sizeof(PATHS) / sizeof(PATHS[0]); ++p) {
+        // 真值：10 µs 一步的圆弧积分
+        Pose truth = { 0.0, 0.0, 0.0 };
+        int truth_steps = (int)(DURATION_S / TRUTH_STEP_S + 0.5);
+        for (int i = 0; i < truth_steps; ++i) {
+            OdomDelta d = path_delta(PATHS[p], i * TRUTH_STEP_S, (i + 1) * TRUTH_STEP_S, 1);
+            truth = pose_integrate_with(ODOM_INTEGRATOR_ARC, truth, d);
+        }
+        for (unsigned k = 0; k < sizeof(PERIODS_MS) / sizeof(PERIODS_MS[0]); ++k) {
+            double period = PERIODS_MS[k] / 1000.0;
+            int steps = (int)(DURATION_S / period + 0.5);
+            printf("  %-18s  %3d ms ", PATHS[p].name, PERIODS_MS[k]);
+            for (int m = 0; m < 3; ++m) {
+                Pose est = { 0.0, 0.0, 0.0 };
+                for (int i = 0; i < steps; ++i) {
+                    est = pose_integrate_with(METHODS[m], est, path_delta(PATHS[p], i * period, (i + 1) * period, 200));
+                }
+                double e = 1000.0 * hypot(est.x - truth.x, est.y - truth.y);
+                if (e > worst[k][m]) worst[k][m] = e;
+                printf("  %9.3f", e);
+            }
+            printf("\n");
+        }
+    }
+
+    // 每次调用的耗时（同一组增量反复积分）
+    const int CALLS = 2000000;
+    double ns[3];
+    for (int m = 0; m < 3; ++m) {
+        Pose p = { 0.0, 0.0, 0.0 };
+        OdomDelta d = { 0.012, 0.001, 0.02 };
+        clock::time_point t0 = clock::now();
+        for (int i = 0; i < CALLS; ++i) {
+            p = pose_integrate_with(METHODS[m], p, d);
+            d.dtheta = -d.dtheta;        // 别让编译器把循环算成常数
+        }
+        ns[m] = std::chrono::duration<double, std::nano>(clock::now() - t0).count() / CALLS;
+        if (p.x == 12345.0) printf("!");
+    }
+    printf("  cost per call on this machine: midpoint %.1f ns, arc %.1f ns, RK2 %.1f ns\n", ns[0], ns[1], ns[2]);
+
+    // 满足精度的最长周期
+    for (int m = 0; m < 3; ++m) {
+        int best = -1;
+        for (unsigned k = 0; k < sizeof(PERIODS_MS) / sizeof(PERIODS_MS[0]); ++k) {
+            if (worst[k][m] < TARGET_MM) best = PERIODS_MS[k];
+        }
+        if (best > 0) {
+            printf("  %-8s: longest period under %.0f mm is %2d ms (%.2f us of CPU per second)\n",
+                   NAMES[m], TARGET_MM, best, ns[m] * (1000.0 / best) / 1000.0);
+        } else {
+            printf("  %-8s: no tested period stays under %.0f mm\n", NAMES[m], TARGET_MM);
+        }
+    }
+}
+
+int main() {
+    printf("============================================\n");
+    printf("  Localization fusion benchmark (synthetic replay)\n");
+    printf("============================================\n\n");
+
+    const int steps = (int)(BENCH_DURATION_S / BENCH_DT_S);
+    const double half_fov = atan2(VISION_IMAGE_WIDTH / 2.0, VISION_FOCAL_LENGTH);
+
+    // 起点：真车离左墙 2.4 米、面朝左墙，但大家都以为在 (15 cm, 10 cm, 6°) 以外
+    Pose truth = { 2.4, 1.83, M_PI };
+    Pose start = { truth.x - 0.15, truth.y + 0.10, truth.theta + 0.1 };
+
+    Pose odom_only = start;
+    Pose blend     = start;
+    static PoseEkf ekf;
+    ekf.reset(start);
+    static ParticleFilter pf;
+    pf.init(PF_PARTICLE_COUNT);
+    pf.reset(start);
+
+    BenchResult r_odom  = bench_result("odometry only");
+    BenchResult r_blend = bench_result("complementary blend");
+    BenchResult r_ekf   = bench_result("EKF (range+bearing)");
+    BenchResult r_pf    = bench_result("particle filter");
+
+    double predict_ns = 0, update_ns = 0, blend_ns = 0;
+    int    predict_n  = 0, update_n  = 0, blend_n  = 0;
+    double pf_predict_ns = 0, pf_update_ns = 0;
+    int    pf_update_n   = 0;
+    typedef std::chrono::steady_clock clock;
+
+    for (int i = 0; i < steps; ++i) {
+        double t = i * BENCH_DT_S;
+
+        // ① 真实运动：前进 2 米再倒回来（离墙 0.4 ~ 2.4 米），车头左右摆 ±25°
+        double v     = 0.5 * sin(0.5 * t);
+        double omega = 0.15 * cos(0.35 * t);
+        OdomDelta true_delta = { v * BENCH_DT_S, 0.0, omega * BENCH_DT_S };
+        truth = pose_integrate(truth, true_delta);
+        if (i == (int)(BENCH_SHOVE_AT_S / BENCH_DT_S)) {
+            truth.x     += BENCH_SHOVE.x;
+            truth.y     += BENCH_SHOVE.y;
+            truth.theta += BENCH_SHOVE.theta;
+        }
+
+        // ② 传感器读数 = 真值 + 误差
+        OdomDelta measured;
+        measured.forward = true_delta.forward * (1.0 - BENCH_SLIP) + gauss(BENCH_WHEEL_NOISE_M);
+        measured.lateral = gauss(BENCH_WHEEL_NOISE_M);
+        measured.dtheta  = true_delta.dtheta + BENCH_IMU_DRIFT * BENCH_DT_S + gauss(BENCH_IMU_NOISE);
+
+        odom_only = pose_integrate(odom_only, measured);
+        blend     = pose_integrate(blend, measured);
+
+        clock::time_point p0 = clock::now();
+        ekf.predict(measured);
+        predict_ns += std::chrono::duration<double, std::nano>(clock::now() - p0).count();
+        predict_n++;
+
+        clock::time_point q0 = clock::now();
+        pf.predict(measured);
+        pf_predict_ns += std::chrono::duration<double, std::nano>(clock::now() - q0).count();
+
+        // ③ 每 50 ms 拍一次照
+        if (i % BENCH_VISION_EVERY == 0) {
+            TagMeasurement seen[VISION_MAX_TAGS];
+            int n_seen = 0;
+            double cam_x, cam_y;
+            vision_camera_position(truth, &cam_x, &cam_y);
+            for (int k = 0; k < NUM_FIELD_TAGS && n_seen < VISION_MAX_TAGS; ++k) {
+                const FieldTag& tag = FIELD_TAGS[k];
+                double dx = tag.x - cam_x, dy = tag.y - cam_y;
+                double range   = hypot(dx, dy);
+                double bearing = wrap(atan2(dy, dx) - truth.theta - VISION_CAMERA_ANGLE);
+                if (fabs(bearing) > half_fov || range > MAX_VISION_RANGE) continue;
+
+                TagMeasurement& m = seen[n_seen++];
+                m.id      = tag.id;
+                m.tag_x   = tag.x;
+                m.tag_y   = tag.y;
+                m.range   = range * (1.0 + gauss(BENCH_RANGE_NOISE));
+                m.bearing = bearing + gauss(BENCH_BEARING_NOISE);
+                if (uniform01() < BENCH_OUTLIER_RATE) m.range += 0.5 + uniform01();
+                double pixels = APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH / m.range;
+                m.confidence  = vision_compute_confidence(m.range, pixels);
+            }
+
+            // 互补滤波：和 vision_localizer.cpp 一样，只用置信度最高的那个
+            clock::time_point b0 = clock::now();
+            int best = -1;
+            for (int k = 0; k < n_seen; ++k) {
+                if (best < 0 || seen[k].confidence > seen[best].confidence) best = k;
+            }
+            if (best >= 0 && seen[best].confidence >= VISION_MIN_CONFIDENCE) {
+                const TagMeasurement& m = seen[best];
+                double ex, ey;
+                vision_robot_from_tag(m.tag_x, m.tag_y, m.range, m.bearing, blend.theta, &ex, &ey);
+                Pose corrected = vision_blend_pose(blend, ex, ey, m.confidence);
+                r_blend.tag_updates++;
+                if (hypot(corrected.x - blend.x, corrected.y - blend.y) < VISION_MAX_CORRECTION_M) {
+                    blend = corrected;
+                } else {
+                    r_blend.tag_rejects++;
+                }
+                blend_ns += std::chrono::duration<double, std::nano>(clock::now() - b0).count();
+                blend_n++;
+            }
+
+            // 卡尔曼滤波：每个够格的标签都融合
+            for (int k = 0; k < n_seen; ++k) {
+                if (seen[k].confidence < VISION_MIN_CONFIDENCE) continue;
+                clock::time_point u0 = clock::now();
+                EkfUpdateResult res = ekf.update_tag(seen[k]);
+                update_ns += std::chrono::duration<double, std::nano>(clock::now() - u0).count();
+                update_n++;
+                r_ekf.tag_updates++;
+                if (res != EKF_UPDATE_ACCEPTED) r_ekf.tag_rejects++;
+            }
+
+            // 粒子滤波：这一帧的标签一起加，再决定要不要重采样
+            clock::time_point f0 = clock::now();
+            int used = 0;
+            for (int k = 0; k < n_seen; ++k) {
+                if (seen[k].confidence < VISION_MIN_CONFIDENCE) continue;
+                pf.update_tag(seen[k]);
+                used++;
+            }
+            if (used > 0) {
+                pf.finish_update();
+                r_pf.tag_updates += used;
+                pf_update_ns += std::chrono::duration<double, std::nano>(clock::now() - f0).count();
+                pf_update_n++;
+            }
+        }
+
+        r_odom.add(t, odom_only, truth);
+        r_blend.add(t, blend, truth);
+        r_ekf.add(t, ekf.pose(), truth);
+        r_pf.add(t, pf.estimate(), truth);
+    }
+
+    printf("[Accuracy over %.0f s, %d steps]\n", BENCH_DURATION_S, steps);
+    r_odom.print();
+    r_blend.print();
+    r_ekf.print();
+    r_pf.print();
+
+    printf("\n[Cost per call on this machine]\n");
+    printf("  blend correction       %8.0f ns\n", blend_n   ? blend_ns / blend_n : 0.0);
+    printf("  EKF predict            %8.0f ns\n", predict_n ? predict_ns / predict_n : 0.0);
+    printf("  EKF tag update         %8.0f ns\n", update_n  ? update_ns / update_n : 0.0);
+    printf("  PF predict (%4d)       %8.0f ns\n", PF_PARTICLE_COUNT, pf_predict_ns / steps);
+    printf("  PF tag frame (%4d)     %8.0f ns\n", PF_PARTICLE_COUNT,
+           pf_update_n ? pf_update_ns / pf_update_n : 0.0);
+
+    double sx = sqrt(ekf.covariance()(0, 0)), sy = sqrt(ekf.covariance()(1, 1));
+    double st = sqrt(ekf.covariance()(2, 2));
+    printf("\n  EKF final sigma: x %.1f mm  y %.1f mm  theta %.2f deg\n",
+           1000.0 * sx, 1000.0 * sy, st * 180.0 / M_PI);
+
+    bench_particle_budget();
+    bench_heading_fusion();
+    bench_gyro_bias();
+    bench_integrators();
+    bench_multi_tag();
+    bench_vision_heading();
+    bench_vision_latency();
+    return 0;
+}
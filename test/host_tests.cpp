@@ -21,7 +21,7 @@
 //
 //  【编译与运行】
 //    方法 1（手动）:
-//      g++ -std=c++17 -I include -I src -o build/run_tests test/host_tests.cpp -lm
+//      g++ -std=c++17 -I include -I src -o build/run_tests test/host_tests.cpp -lm -pthread
 //      ./build/run_tests
 //
 //    方法 2（推荐）:
@@ -31,7 +31,7 @@
 //    本文件是一个"全合一"文件，包含：
 //    ① 迷你测试框架（TEST / ASSERT 宏）
 //    ② Mock HAL（模拟硬件层）
-//    ③ 24 个测试用例（覆盖 PID、运动曲线、里程计）
+//    ③ 84 个测试用例（覆盖 PID、运动曲线、里程计、日志、黑匣子、循环计时、时间线、屏幕、串口遥测、运动摘要、差分日志、周期定时器、位姿发布、位姿历史、卡尔曼滤波、粒子滤波、速度估计、航向融合、陀螺仪零漂、积分方法、传感器采集、多标签求解、视觉航向、视觉延迟补偿、视觉帧缓冲、视觉流水线）
 //    ④ main() 函数（运行所有测试、打印结果）
 //
 // ============================================================================
@@ -40,7 +40,11 @@
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <new>
 #include <string>
+#include <thread>
 
 // ============================================================================
 //  迷你测试框架
@@ -118,6 +122,26 @@ static const char* g_current_test = nullptr;  // 当前正在运行的测试名
 // RUN_TEST：运行一个测试（展开成调用 run_test_xxx()）
 #define RUN_TEST(name) run_test_##name()
 
+// ============================================================================
+//  堆内存分配计数器
+// ============================================================================
+//  替换全局的 operator new / delete：每次 new 都让计数器 +1。
+//  测试"某段代码会不会分配内存"时，记下前后的计数差值就知道了。
+// ============================================================================
+static long g_alloc_count = 0;
+
+void* operator new(std::size_t size) {
+    g_alloc_count++;
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+#include "hal/sensor_frame.h"
+#include "hal/vision.h"
+
 // ============================================================================
 //  Mock HAL（模拟硬件抽象层）
 // ============================================================================
@@ -132,58 +156,102 @@ static const char* g_current_test = nullptr;  // 当前正在运行的测试名
 
 static double        mock_time_sec = 0.0;            // 模拟时钟（秒）
 static unsigned long mock_time_ms  = 0;              // 模拟时钟（毫秒）
-static double        mock_left_ticks = 0.0;          // 左电机编码器刻度（预留）
-static double        mock_right_ticks = 0.0;         // 右电机编码器刻度（预留）
+static uint64_t      mock_time_us  = 0;              // 模拟时钟（微秒）
+static double        mock_left_ticks = 0.0;          // 左电机编码器刻度（航向融合用）
+static double        mock_right_ticks = 0.0;         // 右电机编码器刻度（航向融合用）
 static double        mock_imu_heading_rad = 0.0;     // 模拟 IMU 朝向
 static double        mock_imu_rotation_rad = 0.0;    // 模拟 IMU 累计旋转
+static bool          mock_imu_connected = true;      // 模拟 IMU 是否连着
 static double        mock_motor_left_v = 0.0;        // 最后设置的左电机电压
 static double        mock_motor_right_v = 0.0;       // 最后设置的右电机电压
 static double        mock_tracking_forward_dist = 0.0;  // 纵向追踪轮行驶距离
 static double        mock_tracking_lateral_dist = 0.0;   // 横向追踪轮行驶距离
+static double        mock_tracking_parallel_dist = 0.0;  // 平行追踪轮行驶距离
+static bool          mock_has_parallel = false;      // 模拟是否配了平行追踪轮
+static bool          mock_tracking_connected = true; // 模拟追踪轮是否都连着
+static int           mock_sensor_reads = 0;          // 碰了几次设备（读数 + 连接状态，按真机的调用次数算）
 
 // ── 时间 Mock ──
 // wait_ms 不真的等待，只是把模拟时钟往前拨（测试瞬间完成！）
 double        get_time_sec() { return mock_time_sec; }
 unsigned long get_time_ms()  { return mock_time_ms; }
-void          wait_ms(int ms) { mock_time_sec += ms / 1000.0; mock_time_ms += ms; }
+uint64_t      get_time_us()  { return mock_time_us; }
+void          wait_ms(int ms) { mock_time_sec += ms / 1000.0; mock_time_ms += ms; mock_time_us += ms * 1000; }
+void          wait_until_ms(unsigned long t) { if (t > mock_time_ms) wait_ms((int)(t - mock_time_ms)); }
 
 // ── 电机 Mock ──
-double get_left_encoder_ticks()  { return mock_left_ticks; }
-double get_right_encoder_ticks() { return mock_right_ticks; }
+double get_left_encoder_ticks()  { mock_sensor_reads++; return mock_left_ticks; }
+double get_right_encoder_ticks() { mock_sensor_reads++; return mock_right_ticks; }
 void   reset_encoders() { mock_left_ticks = 0; mock_right_ticks = 0; }
 void   set_drive_motors(double lv, double rv) { mock_motor_left_v = lv; mock_motor_right_v = rv; }
 void   stop_drive_motors() { mock_motor_left_v = 0; mock_motor_right_v = 0; }
+double get_left_drive_command()  { return mock_motor_left_v; }
+double get_right_drive_command() { return mock_motor_right_v; }
 
 // ── IMU Mock ──
 double get_imu_heading_rad()  { return mock_imu_heading_rad; }
-double get_imu_rotation_rad() { return mock_imu_rotation_rad; }
+double get_imu_rotation_rad() { mock_sensor_reads++; return mock_imu_rotation_rad; }
 void   reset_imu()            { mock_imu_heading_rad = 0; mock_imu_rotation_rad = 0; }
+bool   imu_connected()        { mock_sensor_reads += 2; return mock_imu_connected; }   // installed() + isCalibrating()
 void   calibrate_imu()        { /* 测试中不需要真的校准 */ }
 
 // ── 追踪轮 Mock ──
 void   tracking_wheels_init()  { }
-void   tracking_wheels_reset() { mock_tracking_forward_dist = 0; mock_tracking_lateral_dist = 0; }
-double tracking_get_forward_distance_m() { return mock_tracking_forward_dist; }
-double tracking_get_lateral_distance_m() { return mock_tracking_lateral_dist; }
-bool   tracking_wheels_connected()     { return true; }
+void   tracking_wheels_reset() { mock_tracking_forward_dist = 0; mock_tracking_lateral_dist = 0; mock_tracking_parallel_dist = 0; }
+double tracking_get_forward_distance_m() { mock_sensor_reads++; return mock_tracking_forward_dist; }
+double tracking_get_lateral_distance_m() { mock_sensor_reads++; return mock_tracking_lateral_dist; }
+bool   tracking_has_parallel_wheel()      { return mock_has_parallel; }
+double tracking_get_parallel_distance_m() { mock_sensor_reads++; return mock_tracking_parallel_dist; }
+bool   tracking_wheels_connected()     { mock_sensor_reads += mock_has_parallel ? 3 : 2; return mock_tracking_connected; }   // 每个轮一次 installed()
+
+// ── 视觉传感器 Mock ──
+// 测试里直接往 mock_tags 里填"假装拍到的标签"，vision_snapshot() 把它们发布成一帧
+// （用真的 FrameBuffer，和机器人上一样）
+static TagDetection             mock_tags[VISION_MAX_TAGS];
+static int                      mock_tag_count = 0;
+static uint64_t                 mock_capture_age_us = 0;   // 画面比"现在"老多少
+static FrameBuffer<VisionFrame> mock_frames;
+static uint32_t                 mock_frame_seq = 0;        // 不随 reset 清零（帧号只增不减）
+void vision_init()         { }
+bool vision_is_connected() { return true; }
+int  vision_snapshot() {
+    VisionFrame* f = mock_frames.begin_write();
+    if (f == nullptr) return 0;
+    f->time_us = mock_time_us - mock_capture_age_us;
+    f->seq     = ++mock_frame_seq;
+    f->count   = mock_tag_count;
+    for (int i = 0; i < mock_tag_count; ++i) f->tags[i] = mock_tags[i];
+    mock_frames.publish();
+    return mock_tag_count;
+}
+VisionFrameView vision_latest_frame() { return mock_frames.latest(); }
+uint32_t        vision_dropped_snapshots() { return mock_frames.dropped(); }
 
-// ── 日志 Mock（不输出任何东西） ──
-void hal_log(const std::string& /*msg*/, bool /*print*/) {}
-void hal_log_level(int, const std::string&, bool) {}
-void hal_log_odom_csv(unsigned long, double, double, double, double) {}
+// ── 日志 ──
+// 文字日志直接用真实的 hal_log.cpp（它只往内存缓冲区里写，不碰 SD 卡），
+// 所以这里不需要 Mock
 
 // 重置所有 Mock 状态（每个测试开始前调用，确保测试互不干扰）
 static void reset_all_mocks() {
     mock_time_sec = 0.0;
     mock_time_ms  = 0;
+    mock_time_us  = 0;
     mock_left_ticks = 0.0;
     mock_right_ticks = 0.0;
     mock_imu_heading_rad = 0.0;
     mock_imu_rotation_rad = 0.0;
+    mock_imu_connected = true;
     mock_motor_left_v = 0.0;
     mock_motor_right_v = 0.0;
     mock_tracking_forward_dist = 0.0;
     mock_tracking_lateral_dist = 0.0;
+    mock_tracking_parallel_dist = 0.0;
+    mock_has_parallel = false;
+    mock_tracking_connected = true;
+    mock_sensor_reads = 0;
+    mock_tag_count = 0;
+    mock_capture_age_us = 0;
+    sensor_frame_refresh_status();   // 上一个测试可能改过连接状态：第一拍就重新查
 }
 
 // ============================================================================
@@ -196,10 +264,48 @@ static void reset_all_mocks() {
 #include "control/pid.h"
 #include "control/motion_profile.h"
 #include "localization/odometry.h"
-
+#include "localization/vision_localizer.h"
+#include "hal/hal_log.h"
+#include "hal/frame_buffer.h"
+#include "hal/ring_buffer.h"
+#include "hal/seqlock.h"
+#include "telemetry/odom_record.h"
+#include "telemetry/block_stream.h"
+#include "telemetry/flight_recorder.h"
+#include "telemetry/loop_stats.h"
+#include "telemetry/trace.h"
+#include "hal/screen_cache.h"
+#include "telemetry/serial_frame.h"
+#include "telemetry/serial_telemetry.h"
+
+#include "../src/hal/hal_log.cpp"
+#include "../src/telemetry/odom_record.cpp"
+#include "../src/telemetry/sd_files.cpp"
+#include "../src/telemetry/flight_recorder.cpp"
+#include "../src/telemetry/loop_stats.cpp"
+#include "../src/telemetry/trace_event.cpp"
+#include "../src/telemetry/trace.cpp"
+#include "../src/hal/screen_cache.cpp"
+#include "../src/telemetry/serial_frame.cpp"
+#include "../src/telemetry/serial_telemetry.cpp"
+#include "../tools/telemetry_rx.cpp"   // 电脑端接收器（用伪终端测试）
+#include "../src/telemetry/running_stats.cpp"
+#include "../src/telemetry/motion_summary.cpp"
+#include "../src/telemetry/channel_log.cpp"
+#include "../src/hal/periodic_timer.cpp"
 #include "../src/control/pid.cpp"
 #include "../src/control/motion_profile.cpp"
+#include "../src/localization/pose_history.cpp"
+#include "../src/localization/vision_geometry.cpp"
+#include "../src/localization/pose_ekf.cpp"
+#include "../src/localization/particle_filter.cpp"
+#include "../src/localization/twist_estimator.cpp"
+#include "../src/localization/heading_fusion.cpp"
+#include "../src/localization/gyro_bias.cpp"
+#include "../src/hal/sensor_frame.cpp"
 #include "../src/localization/odometry.cpp"
+#include "../src/localization/multi_tag.cpp"
+#include "../src/localization/vision_localizer.cpp"
 
 // ============================================================================
 //  PID 控制器基础测试（6 个）
@@ -507,7 +613,7 @@ TEST(Odometry_DriveStraightForward) {
     mock_tracking_lateral_dist = 0.0;
     mock_imu_rotation_rad = 0.0;
 
-    odometry_update();
+    odometry_update(0.01);
     Pose p = get_pose();
     ASSERT_NEAR(p.x, 1.0, 0.02);    // 前进了 1 米
     ASSERT_NEAR(p.y, 0.0, 0.02);    // 没有横移
@@ -527,7 +633,7 @@ TEST(Odometry_PointTurn90Degrees) {
     mock_tracking_lateral_dist = LATERAL_WHEEL_OFFSET * turn_rad;
     mock_imu_rotation_rad = turn_rad;
 
-    odometry_update();
+    odometry_update(0.01);
     Pose p = get_pose();
     ASSERT_NEAR(p.x, 0.0, 0.05);          // 原地转，x 不变
     ASSERT_NEAR(p.y, 0.0, 0.05);          // y 也不变
@@ -543,7 +649,7 @@ TEST(Odometry_DriveBackward) {
     mock_tracking_lateral_dist = 0.0;
     mock_imu_rotation_rad = 0.0;
 
-    odometry_update();
+    odometry_update(0.01);
     Pose p = get_pose();
     ASSERT_NEAR(p.x, -0.5, 0.02);   // 后退了 0.5 米
     ASSERT_NEAR(p.y, 0.0, 0.02);
@@ -558,13 +664,13 @@ TEST(Odometry_MultipleUpdatesAccumulate) {
     mock_tracking_forward_dist = 0.5;
     mock_tracking_lateral_dist = 0.0;
     mock_imu_rotation_rad = 0.0;
-    odometry_update();
+    odometry_update(0.01);
 
     // 第 2 步：累计走了 1.0m（注意：Mock 给的是总量，不是增量）
     mock_tracking_forward_dist = 1.0;
     mock_tracking_lateral_dist = 0.0;
     mock_imu_rotation_rad = 0.0;
-    odometry_update();
+    odometry_update(0.01);
 
     Pose p = get_pose();
     ASSERT_NEAR(p.x, 1.0, 0.02);    // 总共前进 1 米
@@ -581,7 +687,7 @@ TEST(Odometry_LateralSlide) {
     mock_tracking_lateral_dist = 0.3;   // 横向滑了 0.3m
     mock_imu_rotation_rad = 0.0;
 
-    odometry_update();
+    odometry_update(0.01);
     Pose p = get_pose();
     ASSERT_NEAR(p.x, 0.0, 0.02);    // 没有前进
     ASSERT_NEAR(p.y, 0.3, 0.02);    // 向左平移 0.3m
@@ -589,7 +695,1854 @@ TEST(Odometry_LateralSlide) {
 }
 
 // ============================================================================
-//  主函数：运行所有 24 个测试
+//  异步日志（Async Log）测试（6 个）
+// ============================================================================
+
+// 环形缓冲区先进先出：按放入顺序取出
+TEST(RingBuffer_FifoOrder) {
+    RingBuffer<int, 8> ring;
+    for (int i = 0; i < 5; ++i) ASSERT_TRUE(ring.try_push(i));
+    for (int i = 0; i < 5; ++i) {
+        int v = -1;
+        ASSERT_TRUE(ring.try_pop(v));
+        ASSERT_NEAR(v, i, 0.0);
+    }
+    int v;
+    ASSERT_TRUE(!ring.try_pop(v));  // 取空了
+}
+
+// 满了不阻塞，直接返回 false；取走一个后又能放
+TEST(RingBuffer_RejectsWhenFull) {
+    RingBuffer<int, 4> ring;
+    for (int i = 0; i < 4; ++i) ASSERT_TRUE(ring.try_push(i));
+    ASSERT_TRUE(!ring.try_push(99));
+    int v;
+    ASSERT_TRUE(ring.try_pop(v));
+    ASSERT_TRUE(ring.try_push(4));
+    ASSERT_NEAR(ring.size_approx(), 4, 0.0);
+}
+
+// 日志缓冲区满了以后新消息被丢弃并计数，旧消息完整保留
+TEST(HalLog_DropsWhenFullAndCounts) {
+    reset_all_mocks();
+    LogEntry e;
+    while (hal_log_pop(e)) {}  // 先清空
+    LogStats before = hal_log_get_stats();
+
+    for (int i = 0; i < LOG_RING_CAPACITY + 5; ++i) {
+        hal_log_level(LOG_INFO, "msg " + to_str(i));
+    }
+    LogStats after = hal_log_get_stats();
+    ASSERT_NEAR(after.enqueued - before.enqueued, LOG_RING_CAPACITY, 0.0);
+    ASSERT_NEAR(after.dropped - before.dropped, 5, 0.0);
+
+    int popped = 0;
+    while (hal_log_pop(e)) {
+        if (popped == 0) ASSERT_TRUE(strcmp(e.text, "msg 0") == 0);
+        popped++;
+    }
+    ASSERT_NEAR(popped, LOG_RING_CAPACITY, 0.0);
+}
+
+// 级别过滤 + 超长消息截断 + 警告自动上屏
+TEST(HalLog_FiltersLevelAndTruncates) {
+    reset_all_mocks();
+    LogEntry e;
+    while (hal_log_pop(e)) {}
+
+    hal_log_level(LOG_VERBOSITY + 1, "too verbose");
+    ASSERT_TRUE(!hal_log_pop(e));  // 被级别过滤掉，根本没进缓冲区
+
+    mock_time_ms = 1234;
+    hal_log_level(LOG_WARN, std::string(LOG_LINE_MAX * 2, 'x'));
+    ASSERT_TRUE(hal_log_pop(e));
+    ASSERT_NEAR(strlen(e.text), LOG_LINE_MAX - 1, 0.0);
+    ASSERT_NEAR(e.time_ms, 1234, 0.0);
+    ASSERT_TRUE(e.to_screen);
+}
+
+// printf 风格日志宏：格式化进固定缓冲区；级别不够的调用连参数都不计算
+TEST(HalLog_PrintfMacrosFormatAndFilter) {
+    reset_all_mocks();
+    LogEntry e;
+    while (hal_log_pop(e)) {}
+
+    LOG_INFOF("pose (%.2f, %.2f) tags=%d", 1.5, -0.25, 3);
+    ASSERT_TRUE(hal_log_pop(e));
+    ASSERT_TRUE(strcmp(e.text, "pose (1.50, -0.25) tags=3") == 0);
+    ASSERT_TRUE(!e.to_screen);
+
+    int evaluated = 0;
+    LOG_DEBUGF("side effect %d", ++evaluated);
+    if (LOG_DEBUG > LOG_VERBOSITY) {
+        ASSERT_NEAR(evaluated, 0, 0.0);  // 被编译期过滤：参数根本没计算
+        ASSERT_TRUE(!hal_log_pop(e));
+    }
+}
+
+// 热循环零分配：里程计 + 视觉定位 + 视觉修正跑 100 个周期，一次 new 都没有
+TEST(HalLog_HotLoopsDoNotAllocate) {
+    reset_all_mocks();
+    // 机器人朝 -x 方向，正前方约 1 米处是左墙的 1 号标签
+    set_pose({1.0, 1.22, M_PI});
+    mock_tag_count = 1;
+    mock_tags[0] = { 1, 160.0, 120.0, 28.0, 28.0, 0.0, true };
+    ASSERT_TRUE(vision_localizer_update().valid);  // 确认视觉修正这条路径真的会走到
+
+    LogEntry e;
+    while (hal_log_pop(e)) {}
+    long before = g_alloc_count;
+    for (int i = 0; i < 100; ++i) {
+        mock_tracking_forward_dist += 0.001;
+        wait_ms(LOOP_INTERVAL_MS);
+        odometry_update(0.01);
+        VisionEstimate est = vision_localizer_update();
+        vision_correct_odometry(est);
+        LOG_INFOF("tick %d x=%.3f", i, get_pose().x);
+        while (hal_log_pop(e)) {}
+    }
+    ASSERT_NEAR(g_alloc_count - before, 0, 0.0);
+}
+
+// ============================================================================
+//  二进制里程计日志（Odom Record）测试（4 个）
+// ============================================================================
+
+// 编码再解码，所有字段原样还原
+TEST(OdomRecord_EncodeDecodeRoundTrip) {
+    OdomRecord rec = { 123456u, 1.25f, -0.5f, 3.0f, 0.125f, 11.5f, -12.0f, 2.5f, -0.75f, 6.25f };
+    uint8_t bytes[ODOM_RECORD_SIZE];
+    odom_record_encode(rec, bytes);
+
+    OdomRecord out;
+    odom_record_decode(bytes, &out);
+    ASSERT_TRUE(out.time_ms == rec.time_ms);
+    ASSERT_NEAR(out.x, 1.25, 0.0);
+    ASSERT_NEAR(out.y, -0.5, 0.0);
+    ASSERT_NEAR(out.theta, 3.0, 0.0);
+    ASSERT_NEAR(out.target_error, 0.125, 0.0);
+    ASSERT_NEAR(out.left_volts, 11.5, 0.0);
+    ASSERT_NEAR(out.right_volts, -12.0, 0.0);
+    ASSERT_NEAR(out.forward_m, 2.5, 0.0);
+    ASSERT_NEAR(out.lateral_m, -0.75, 0.0);
+    ASSERT_NEAR(out.imu_rad, 6.25, 0.0);
+}
+
+// 字节序固定为小端：时间戳的最低字节在最前面
+TEST(OdomRecord_LittleEndianLayout) {
+    OdomRecord rec = { 0x01020304u, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    uint8_t bytes[ODOM_RECORD_SIZE];
+    odom_record_encode(rec, bytes);
+    ASSERT_TRUE(bytes[0] == 0x04 && bytes[1] == 0x03 && bytes[2] == 0x02 && bytes[3] == 0x01);
+}
+
+// 文件头：能认出自己的魔数、版本和记录长度，认不出别的文件
+TEST(OdomRecord_HeaderValidation) {
+    uint8_t header[ODOM_LOG_HEADER_SIZE];
+    odom_log_encode_header(header);
+    uint16_t version = 0, size = 0;
+    ASSERT_TRUE(odom_log_decode_header(header, &version, &size));
+    ASSERT_NEAR(version, ODOM_LOG_VERSION, 0.0);
+    ASSERT_NEAR(size, ODOM_RECORD_SIZE, 0.0);
+
+    const uint8_t csv_text[ODOM_LOG_HEADER_SIZE] = { 't', 'i', 'm', 'e', '_', 'm', 's', ',' };
+    ASSERT_TRUE(!odom_log_decode_header(csv_text, &version, &size));
+}
+
+// 块缓冲：记录可以跨块；块写满前不交给写卡任务；全部占满后丢弃新记录
+TEST(BlockStream_SpansBlocksAndDropsWhenFull) {
+    BlockStream<64, 2> stream;
+    uint8_t rec[ODOM_RECORD_SIZE];
+    for (int i = 0; i < ODOM_RECORD_SIZE; ++i) rec[i] = (uint8_t)i;
+
+    int len = 0;
+    ASSERT_TRUE(stream.append(rec, ODOM_RECORD_SIZE));       // 块 0: 40/64
+    ASSERT_TRUE(stream.acquire(&len) == nullptr);            // 还没写满
+    ASSERT_TRUE(stream.append(rec, ODOM_RECORD_SIZE));       // 跨块: 块 0 满, 块 1: 16/64
+    const uint8_t* block = stream.acquire(&len);
+    ASSERT_TRUE(block != nullptr);
+    ASSERT_NEAR(len, 64, 0.0);
+    ASSERT_TRUE(block[40] == 0 && block[63] == 23);          // 第二条记录的前 24 字节
+
+    ASSERT_TRUE(stream.append(rec, ODOM_RECORD_SIZE));       // 块 1: 56/64
+    ASSERT_TRUE(!stream.append(rec, ODOM_RECORD_SIZE));      // 块 0 还没写完 → 丢弃
+
+    stream.release();                                        // 写卡任务写完块 0
+    ASSERT_TRUE(stream.append(rec, ODOM_RECORD_SIZE));       // 又能写了
+    stream.seal();
+    ASSERT_TRUE(stream.acquire(&len) != nullptr);            // 块 1（满）
+    stream.release();
+    ASSERT_TRUE(stream.acquire(&len) != nullptr);            // 块 0（刷盘的半块）
+    ASSERT_NEAR(len, 32, 0.0);
+}
+
+// ============================================================================
+//  黑匣子（Flight Recorder）测试（3 个）
+// ============================================================================
+
+// 环形缓冲区只保留最近 N 条，快照按时间顺序（最旧 → 最新）
+TEST(FlightRecorder_KeepsLastSamplesInOrder) {
+    OdomRecord rec = { 0u, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < FLIGHT_RECORDER_SAMPLES + 100; ++i) {
+        rec.time_ms = (uint32_t)i;
+        flight_recorder_record(rec);
+    }
+    static OdomRecord out[FLIGHT_RECORDER_SAMPLES];
+    int n = flight_recorder_snapshot(out, FLIGHT_RECORDER_SAMPLES);
+    ASSERT_NEAR(n, FLIGHT_RECORDER_SAMPLES, 0.0);
+    ASSERT_TRUE(out[0].time_ms == 100u);
+    ASSERT_TRUE(out[n - 1].time_ms == (uint32_t)(FLIGHT_RECORDER_SAMPLES + 99));
+
+    // 只要最新的 10 条
+    n = flight_recorder_snapshot(out, 10);
+    ASSERT_NEAR(n, 10, 0.0);
+    ASSERT_TRUE(out[0].time_ms == (uint32_t)(FLIGHT_RECORDER_SAMPLES + 90));
+}
+
+// 触发后要再录 POST_TRIGGER 毫秒才写出；待写和冷却期间的触发被忽略
+TEST(FlightRecorder_TriggerWaitsAndCoolsDown) {
+    reset_all_mocks();
+    // 先把之前测试（比如视觉修正被拒绝）留下的触发处理掉
+    mock_time_ms = 1000000;
+    flight_recorder_poll();
+    mock_time_ms += FLIGHT_RECORDER_COOLDOWN_MS;
+
+    int dumps_before = flight_recorder_get_stats().dumps;
+    ASSERT_TRUE(flight_recorder_trigger("test"));
+    ASSERT_TRUE(!flight_recorder_trigger("test again"));       // 已经有待写请求
+
+    mock_time_ms += FLIGHT_RECORDER_POST_TRIGGER_MS - 1;
+    flight_recorder_poll();
+    ASSERT_NEAR(flight_recorder_get_stats().dumps, dumps_before, 0.0);  // 还在录"事后"数据
+
+    mock_time_ms += 1;
+    flight_recorder_poll();
+    ASSERT_NEAR(flight_recorder_get_stats().dumps, dumps_before + 1, 0.0);
+
+    ASSERT_TRUE(!flight_recorder_trigger("too soon"));         // 冷却中
+    mock_time_ms += FLIGHT_RECORDER_COOLDOWN_MS;
+    ASSERT_TRUE(flight_recorder_trigger("after cooldown"));
+
+    mock_time_ms += FLIGHT_RECORDER_POST_TRIGGER_MS;
+    flight_recorder_poll();
+    LogEntry e;
+    while (hal_log_pop(e)) {}
+}
+
+// 写出的文件和二进制里程计日志格式相同，odom_bin2csv 能直接读
+TEST(FlightRecorder_DumpUsesOdomLogFormat) {
+    OdomRecord rec = { 0u, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < FLIGHT_RECORDER_SAMPLES; ++i) {
+        rec.time_ms = (uint32_t)(5000 + i);
+        rec.x = (float)i * 0.01f;
+        flight_recorder_record(rec);
+    }
+    const char* path = "build/flight_test.bin";
+    FILE* f = fopen(path, "wb");
+    ASSERT_TRUE(f != nullptr);
+    ASSERT_NEAR(flight_recorder_dump_to(f), FLIGHT_RECORDER_SAMPLES, 0.0);
+
+    f = fopen(path, "rb");
+    ASSERT_TRUE(f != nullptr);
+    uint8_t header[ODOM_LOG_HEADER_SIZE];
+    uint16_t version = 0, size = 0;
+    ASSERT_TRUE(fread(header, 1, sizeof(header), f) == sizeof(header));
+    ASSERT_TRUE(odom_log_decode_header(header, &version, &size));
+    ASSERT_NEAR(size, ODOM_RECORD_SIZE, 0.0);
+
+    uint8_t bytes[ODOM_RECORD_SIZE];
+    OdomRecord last = rec;
+    int count = 0;
+    while (fread(bytes, 1, ODOM_RECORD_SIZE, f) == (size_t)ODOM_RECORD_SIZE) {
+        odom_record_decode(bytes, &last);
+        count++;
+    }
+    fclose(f);
+    remove(path);
+    ASSERT_NEAR(count, FLIGHT_RECORDER_SAMPLES, 0.0);
+    ASSERT_TRUE(last.time_ms == (uint32_t)(5000 + FLIGHT_RECORDER_SAMPLES - 1));
+    ASSERT_NEAR(last.x, (FLIGHT_RECORDER_SAMPLES - 1) * 0.01, 1e-5);
+}
+
+// ============================================================================
+//  循环计时统计（Loop Stats）测试（3 个）
+// ============================================================================
+
+// 对数分桶：2^k ~ 2^(k+1)-1 落在桶 k；百分位数返回桶上界，但不超过最大值
+TEST(LogHistogram_BucketsAndPercentiles) {
+    ASSERT_NEAR(LogHistogram::bucket_of(0), 0, 0.0);
+    ASSERT_NEAR(LogHistogram::bucket_of(1), 0, 0.0);
+    ASSERT_NEAR(LogHistogram::bucket_of(2), 1, 0.0);
+    ASSERT_NEAR(LogHistogram::bucket_of(3), 1, 0.0);
+    ASSERT_NEAR(LogHistogram::bucket_of(1023), 9, 0.0);
+    ASSERT_NEAR(LogHistogram::bucket_of(1024), 10, 0.0);
+    ASSERT_NEAR(LogHistogram::bucket_of(0xFFFFFFFFu), LOOP_HIST_BUCKETS - 1, 0.0);
+
+    LogHistogram h;
+    ASSERT_NEAR(h.percentile(0.99), 0, 0.0);  // 没数据
+    for (int i = 0; i < 99; ++i) h.record(100);
+    h.record(5000);
+    ASSERT_NEAR(h.count(), 100, 0.0);
+    ASSERT_NEAR(h.max(), 5000, 0.0);
+    ASSERT_NEAR(h.percentile(0.50), 127, 0.0);   // 100 在 [64, 127] 桶
+    ASSERT_NEAR(h.percentile(0.99), 127, 0.0);
+    ASSERT_NEAR(h.percentile(1.00), 5000, 0.0);  // 桶上界 8191 被最大值截住
+}
+
+// 执行时间 = begin→end；唤醒延迟 = 实际醒来 - (开始 sleep + 周期)
+TEST(LoopStats_MeasuresExecAndWakeLatency) {
+    reset_all_mocks();
+    static LoopStats loop("test_loop", 10);
+
+    mock_time_us = 1000;
+    loop.begin();
+    mock_time_us += 200;
+    loop.end();
+    ASSERT_NEAR(loop.exec_us().max(), 200, 0.0);
+    ASSERT_NEAR(loop.late_us().count(), 0, 0.0);  // 第一次没有"上一次 sleep"
+
+    mock_time_us += 10000 + 300;                  // sleep(10ms) 却晚醒了 300 µs
+    loop.begin();
+    loop.end();
+    ASSERT_NEAR(loop.late_us().count(), 1, 0.0);
+    ASSERT_NEAR(loop.late_us().max(), 300, 0.0);
+
+    // 新的一次运动命令：中间隔了很久，但不算晚醒
+    loop.restart();
+    mock_time_us += 1000000;
+    loop.begin();
+    loop.end();
+    ASSERT_NEAR(loop.late_us().count(), 1, 0.0);
+    ASSERT_NEAR(loop.exec_us().count(), 3, 0.0);
+}
+
+// 统计对象构造时自动登记，可以按名字找到并格式化成一行
+TEST(LoopStats_RegistryFindAndFormat) {
+    ASSERT_TRUE(loop_stats_find("odom") != nullptr);  // odometry.cpp 里的里程计循环
+    ASSERT_TRUE(loop_stats_find("no_such_loop") == nullptr);
+
+    LoopStats* loop = loop_stats_find("test_loop");
+    ASSERT_TRUE(loop != nullptr);
+    char line[LOG_LINE_MAX];
+    loop_stats_format(*loop, line, sizeof(line));
+    ASSERT_TRUE(strstr(line, "test_loop n=3") == line);
+    ASSERT_TRUE(strstr(line, "late p99=300 max=300us") != nullptr);
+}
+
+// ============================================================================
+//  时间线采集（Trace）测试（3 个）
+// ============================================================================
+
+// 事件和文件头编码再解码，字段原样还原；不认识的文件被拒绝
+TEST(TraceEvent_EncodeDecodeAndHeader) {
+    TraceEvent ev = { 0x01020304u, 250u, (uint8_t)TRACE_PID_CALCULATE };
+    uint8_t bytes[TRACE_EVENT_SIZE];
+    trace_event_encode(ev, bytes);
+    ASSERT_TRUE(bytes[0] == 0x04 && bytes[3] == 0x01);  // 小端序
+
+    TraceEvent out;
+    trace_event_decode(bytes, &out);
+    ASSERT_TRUE(out.start_us == ev.start_us && out.dur_us == 250u);
+    ASSERT_TRUE(out.id == TRACE_PID_CALCULATE);
+
+    uint8_t header[TRACE_FILE_HEADER_SIZE];
+    trace_file_encode_header(header, 42);
+    uint16_t version = 0;
+    uint32_t count = 0;
+    ASSERT_TRUE(trace_file_decode_header(header, &version, &count));
+    ASSERT_NEAR(version, TRACE_FILE_VERSION, 0.0);
+    ASSERT_NEAR(count, 42, 0.0);
+
+    odom_log_encode_header(header);  // 里程计日志不是时间线文件
+    ASSERT_TRUE(!trace_file_decode_header(header, &version, &count));
+}
+
+// TraceScope 记下开始时间和持续时间；没在采集时不记；缓冲区满了自动停止
+TEST(Trace_CaptureRecordsScopesAndStopsWhenFull) {
+    reset_all_mocks();
+    {
+        TraceScope idle(TRACE_ODOMETRY_UPDATE);  // 还没开始采集
+    }
+    trace_capture_start();
+    mock_time_us = 1000;
+    {
+        TraceScope trace(TRACE_ODOMETRY_UPDATE);
+        mock_time_us += 250;
+    }
+    int n = 0;
+    const TraceEvent* events = trace_events(&n);
+    ASSERT_NEAR(n, 1, 0.0);
+    ASSERT_NEAR(events[0].start_us, 1000, 0.0);
+    ASSERT_NEAR(events[0].dur_us, 250, 0.0);
+    ASSERT_TRUE(events[0].id == TRACE_ODOMETRY_UPDATE);
+
+    for (int i = 0; i < TRACE_CAPACITY; ++i) trace_record(TRACE_PID_CALCULATE, i, 1);
+    ASSERT_TRUE(!trace_capture_active());
+    ASSERT_NEAR(trace_dropped(), 1, 0.0);
+    events = trace_events(&n);
+    ASSERT_NEAR(n, TRACE_CAPACITY, 0.0);
+}
+
+// 电脑仿真：跑几个控制周期，直接导出 Chrome trace JSON
+TEST(Trace_HostSimulationExportsChromeJson) {
+    reset_all_mocks();
+    set_pose({0.0, 0.0, 0.0});
+    PIDController pid(2.0, 0.0, 0.0);
+    trace_capture_start();
+    for (int i = 0; i < 10; ++i) {
+        mock_tracking_forward_dist += 0.001;
+        odometry_update(0.01);
+        pid.calculate(1.0, get_pose().x);
+        wait_ms(LOOP_INTERVAL_MS);
+    }
+    const char* path = "build/trace_test.json";
+    ASSERT_TRUE(trace_save_chrome_json(path));
+    ASSERT_TRUE(!trace_capture_active());
+
+    FILE* f = fopen(path, "r");
+    ASSERT_TRUE(f != nullptr);
+    static char json[16384];
+    size_t len = fread(json, 1, sizeof(json) - 1, f);
+    json[len] = '\0';
+    fclose(f);
+    remove(path);
+
+    int odom_events = 0;
+    for (const char* p = json; (p = strstr(p, "\"name\":\"odometry_update\"")) != nullptr; ++p) {
+        odom_events++;
+    }
+    ASSERT_NEAR(odom_events, 10, 0.0);
+    ASSERT_TRUE(strstr(json, "\"name\":\"pid_calculate\"") != nullptr);
+    ASSERT_TRUE(strstr(json, "\"ph\":\"X\"") != nullptr);
+    ASSERT_TRUE(strstr(json, "\"name\":\"odometry task\"") != nullptr);  // 线程名
+    ASSERT_TRUE(json[len - 2] == '}');                                    // 结尾完整
+}
+
+// ============================================================================
+//  屏幕缓存（Screen Cache）测试（3 个）
+// ============================================================================
+
+// 记录 flush() 画了什么，代替真正的 Brain 屏幕
+static int  g_draw_calls = 0;
+static int  g_draw_row = 0, g_draw_col = 0;
+static char g_draw_text[SCREEN_COLS + 1];
+
+static void record_draw(int row, int col, const char* text) {
+    g_draw_calls++;
+    g_draw_row = row;
+    g_draw_col = col;
+    snprintf(g_draw_text, sizeof(g_draw_text), "%s", text);
+}
+
+// 第一次全部画出；内容没变时一个字都不画
+TEST(ScreenCache_UnchangedRowsAreNotRedrawn) {
+    ScreenCache cache;
+    cache.set_row(1, "=== Title ===");
+    cache.set_row(2, "X: %.3f m", 1.0);
+    g_draw_calls = 0;
+    ASSERT_NEAR(cache.flush(record_draw), 2, 0.0);
+    ASSERT_NEAR(g_draw_calls, 2, 0.0);
+
+    g_draw_calls = 0;
+    cache.set_row(2, "X: %.3f m", 1.0);  // 同样的内容
+    ASSERT_NEAR(cache.flush(record_draw), 0, 0.0);
+    ASSERT_NEAR(g_draw_calls, 0, 0.0);
+}
+
+// 只从第一个变了的字符开始重画；变短时用空格盖住旧的尾巴
+TEST(ScreenCache_RedrawsOnlyChangedTail) {
+    ScreenCache cache;
+    cache.set_row(3, "X: 1.000 m");
+    cache.flush(record_draw);
+
+    cache.set_row(3, "X: 1.250 m");
+    g_draw_calls = 0;
+    cache.flush(record_draw);
+    ASSERT_NEAR(g_draw_calls, 1, 0.0);
+    ASSERT_NEAR(g_draw_row, 3, 0.0);
+    ASSERT_NEAR(g_draw_col, 6, 0.0);
+    ASSERT_TRUE(strcmp(g_draw_text, "250 m") == 0);
+
+    cache.set_row(3, "X: 1");
+    cache.flush(record_draw);
+    ASSERT_NEAR(g_draw_col, 5, 0.0);
+    ASSERT_TRUE(strcmp(g_draw_text, "      ") == 0);  // 6 个空格擦掉 ".250 m"
+}
+
+// 超长的行被截断到屏幕宽度；越界的行号被忽略
+TEST(ScreenCache_TruncatesAndIgnoresBadRows) {
+    ScreenCache cache;
+    char long_text[SCREEN_COLS * 2];
+    memset(long_text, 'A', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = '\0';
+    cache.set_row(1, "%s", long_text);
+    ASSERT_NEAR(strlen(cache.pending_row(1)), SCREEN_COLS, 0.0);
+
+    cache.set_row(0, "bad");
+    cache.set_row(SCREEN_ROWS + 1, "bad");
+    g_draw_calls = 0;
+    cache.flush(record_draw);
+    ASSERT_NEAR(g_draw_calls, 1, 0.0);
+    ASSERT_NEAR(cache.stats().chars_drawn, SCREEN_COLS, 0.0);
+}
+
+// ============================================================================
+//  串口遥测（Serial Telemetry）测试（4 个）
+// ============================================================================
+
+// CRC 用标准校验值检查；COBS 编码后没有 0，解码还原
+TEST(SerialFrame_CrcAndCobsRoundTrip) {
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    ASSERT_TRUE(crc16_ccitt(check, 9) == 0x29B1);  // CRC-16/CCITT-FALSE 的标准校验值
+
+    static uint8_t data[300], encoded[310], decoded[310];
+    for (int i = 0; i < 300; ++i) data[i] = (uint8_t)(i < 10 ? 0 : i);  // 开头一串 0 + 长段非零
+    int n = cobs_encode(data, 300, encoded);
+    for (int i = 0; i < n; ++i) ASSERT_TRUE(encoded[i] != 0);
+    ASSERT_NEAR(cobs_decode(encoded, n, decoded), 300, 0.0);
+    ASSERT_TRUE(memcmp(data, decoded, 300) == 0);
+}
+
+// 开头的垃圾字节和中间的坏帧都被扔掉，解帧器能从下一帧重新同步
+TEST(SerialFrame_DecoderResyncsAfterCorruption) {
+    uint8_t stream[3 * SERIAL_FRAME_MAX_ENCODED + 8];
+    int len = 0;
+    stream[len++] = 0x55;                           // 连上串口时收到的半帧垃圾
+    stream[len++] = 0x00;
+    const uint8_t payload[] = { 1, 0, 2, 0, 3 };
+    for (int f = 0; f < 3; ++f) {
+        len += serial_frame_encode(TELEM_CH_ODOM, (uint8_t)f, payload, 5, stream + len);
+    }
+    stream[2 + SERIAL_FRAME_MAX_ENCODED / 8] ^= 0x40;  // 改坏第一帧里的一个字节
+
+    SerialFrameDecoder dec;
+    int good = 0;
+    uint8_t last_seq = 0xFF;
+    for (int i = 0; i < len; ++i) {
+        if (dec.feed(stream[i]) == SerialFrameDecoder::FRAME) {
+            good++;
+            last_seq = dec.seq();
+            ASSERT_NEAR(dec.payload_len(), 5, 0.0);
+            ASSERT_TRUE(memcmp(dec.payload(), payload, 5) == 0);
+        }
+    }
+    ASSERT_NEAR(good, 2, 0.0);
+    ASSERT_NEAR(dec.bad_frames(), 2, 0.0);         // 垃圾半帧 + 改坏的帧
+    ASSERT_NEAR(last_seq, 2, 0.0);
+}
+
+// 每个通道按自己的间隔限速；被限速的调用不占序号
+TEST(SerialTelemetry_RateLimitsPerChannel) {
+    reset_all_mocks();
+    SerialTxFrame frame;
+    while (serial_telemetry_pop(frame)) {}
+
+    OdomRecord rec = { 0u, 1.5f, 0, 0, 0, 0, 0, 0, 0, 0 };
+    mock_time_ms = 5000;
+    ASSERT_TRUE(serial_telemetry_send_odom(rec));
+    ASSERT_TRUE(!serial_telemetry_send_odom(rec));                 // 同一时刻再发 → 限速
+    mock_time_ms += SERIAL_TELEM_ODOM_INTERVAL_MS - 1;
+    ASSERT_TRUE(!serial_telemetry_send_odom(rec));
+    mock_time_ms += 1;
+    ASSERT_TRUE(serial_telemetry_send_odom(rec));
+    ASSERT_TRUE(serial_telemetry_send_loop_stats());               // 别的通道不受影响
+
+    SerialFrameDecoder dec;
+    int odom_frames = 0;
+    uint8_t seqs[2] = { 0, 0 };
+    while (serial_telemetry_pop(frame)) {
+        for (int i = 0; i < frame.len; ++i) {
+            if (dec.feed(frame.bytes[i]) == SerialFrameDecoder::FRAME && dec.channel() == TELEM_CH_ODOM) {
+                OdomRecord out;
+                odom_record_decode(dec.payload(), &out);
+                ASSERT_NEAR(out.x, 1.5, 0.0);
+                if (odom_frames < 2) seqs[odom_frames] = dec.seq();
+                odom_frames++;
+            }
+        }
+    }
+    ASSERT_NEAR(odom_frames, 2, 0.0);
+    ASSERT_NEAR((uint8_t)(seqs[1] - seqs[0]), 1, 0.0);
+    ASSERT_NEAR(dec.bad_frames(), 0, 0.0);
+}
+
+// 接收器通过伪终端（假装成 Brain 的 USB 串口）收帧，写出 CSV 并统计丢帧
+TEST(TelemetryRx_ReadsFramesThroughPty) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_TRUE(master >= 0);
+    ASSERT_TRUE(grantpt(master) == 0 && unlockpt(master) == 0);
+    int slave = telemetry_rx_open(ptsname(master));   // 设置成原始模式
+    ASSERT_TRUE(slave >= 0);
+
+    // "机器人"一端：序号 0、1、3（丢了 2），中间夹一个坏帧
+    uint8_t out[4 * SERIAL_FRAME_MAX_ENCODED];
+    int len = 0;
+    const uint8_t seqs[] = { 0, 1, 3 };
+    for (int i = 0; i < 3; ++i) {
+        OdomRecord rec = { 1000u + i, (float)i, 0, 0, 0, 0, 0, 0, 0, 0 };
+        uint8_t bytes[ODOM_RECORD_SIZE];
+        odom_record_encode(rec, bytes);
+        len += serial_frame_encode(TELEM_CH_ODOM, seqs[i], bytes, ODOM_RECORD_SIZE, out + len);
+        if (i == 0) {
+            int bad = serial_frame_encode(TELEM_CH_ODOM, 9, bytes, ODOM_RECORD_SIZE, out + len);
+            out[len + 10] = (out[len + 10] == 0x7F) ? 0x7E : 0x7F;  // 改坏但不引入 0
+            len += bad;
+        }
+    }
+    ASSERT_NEAR(write(master, out, len), len, 0.0);
+
+    FILE* csv = tmpfile();
+    ASSERT_TRUE(csv != nullptr);
+    TelemetryReceiver rx(csv);
+    uint8_t buf[512];
+    int got = 0;
+    while (got < len) {
+        ssize_t n = read(slave, buf, sizeof(buf));
+        if (n <= 0) break;
+        rx.feed(buf, (int)n);
+        got += (int)n;
+    }
+    close(slave);
+    close(master);
+
+    ASSERT_NEAR(got, len, 0.0);                    // 原始模式下字节原样到达（包括 0x0A、0x0D）
+    ASSERT_NEAR(rx.stats().frames[TELEM_CH_ODOM], 3, 0.0);
+    ASSERT_NEAR(rx.stats().lost[TELEM_CH_ODOM], 1, 0.0);
+    ASSERT_NEAR(rx.stats().bad_frames, 1, 0.0);
+
+    rewind(csv);
+    char line[256];
+    int lines = 0;
+    while (fgets(line, sizeof(line), csv) != nullptr) lines++;
+    fclose(csv);
+    ASSERT_NEAR(lines, 4, 0.0);                    // 表头 + 3 条记录
+}
+
+// ============================================================================
+//  运动命令摘要（Motion Summary）测试（3 个）
+// ============================================================================
+
+// Welford 流式统计和"先存起来再算两遍"的结果一致，大偏移下也不丢精度
+TEST(RunningStats_MatchesTwoPassResult) {
+    RunningStats empty;
+    ASSERT_NEAR(empty.count(), 0, 0.0);
+    ASSERT_NEAR(empty.variance(), 0.0, 0.0);
+
+    static double data[200];
+    RunningStats stats;
+    for (int i = 0; i < 200; ++i) {
+        data[i] = 1.0e6 + sin(i * 0.37) * 0.01;  // 很大的数 + 很小的波动
+        stats.add(data[i]);
+    }
+    double sum = 0.0;
+    for (int i = 0; i < 200; ++i) sum += data[i];
+    double mean = sum / 200;
+    double m2 = 0.0;
+    double lo = data[0], hi = data[0];
+    for (int i = 0; i < 200; ++i) {
+        m2 += (data[i] - mean) * (data[i] - mean);
+        if (data[i] < lo) lo = data[i];
+        if (data[i] > hi) hi = data[i];
+    }
+    ASSERT_NEAR(stats.count(), 200, 0.0);
+    ASSERT_NEAR(stats.mean(), mean, 1e-6);
+    ASSERT_NEAR(stats.variance(), m2 / 199, 1e-9);
+    ASSERT_NEAR(stats.min(), lo, 0.0);
+    ASSERT_NEAR(stats.max(), hi, 0.0);
+
+    stats.reset();
+    stats.add(-2.0);
+    ASSERT_NEAR(stats.min(), -2.0, 0.0);
+    ASSERT_NEAR(stats.max(), -2.0, 0.0);
+    ASSERT_NEAR(stats.stddev(), 0.0, 0.0);
+}
+
+// 进出容差范围的次数、最后一次进入的时刻、峰值都记对
+TEST(MotionSummary_CountsToleranceEntriesAndSettleTime) {
+    reset_all_mocks();
+    MotionSummary summary;
+    summary.begin(MOTION_DRIVE, 0.02);
+    int first_index = summary.record().index;
+
+    // 误差：0.5 → 0.01（进入）→ 0.03（冲出去）→ 0.01（再进入）
+    const double errors[] = { 0.5, 0.3, 0.1, 0.01, 0.03, 0.015, 0.01 };
+    for (int i = 0; i < 7; ++i) {
+        summary.sample(errors[i], (i == 1) ? -0.2 : 0.05, 8.0 - i, -9.5 + i);
+        wait_ms(10);
+    }
+    summary.finish(false);
+
+    const MotionSummaryRecord& rec = summary.record();
+    ASSERT_NEAR(rec.tolerance_entries, 2, 0.0);
+    ASSERT_NEAR(rec.settle_ms, 50, 0.0);          // 第 6 次采样（t=50ms）最后一次进入
+    ASSERT_NEAR(rec.duration_ms, 70, 0.0);
+    ASSERT_NEAR(rec.error.max(), 0.5, 1e-12);
+    ASSERT_NEAR(rec.final_error, 0.01, 1e-12);
+    ASSERT_NEAR(rec.peak_heading_rad, 0.2, 1e-12);
+    ASSERT_NEAR(rec.peak_volts, 9.5, 1e-12);
+    ASSERT_NEAR(motion_summary_last().index, first_index, 0.0);
+
+    // 超时的命令没有 settle 时间，编号递增
+    summary.begin(MOTION_DRIVE, 0.02);
+    summary.sample(0.01, 0.0, 0.0, 0.0);
+    summary.finish(true);
+    ASSERT_NEAR(summary.record().index, first_index + 1, 0.0);
+    ASSERT_NEAR(summary.record().settle_ms, -1, 0.0);
+    ASSERT_TRUE(summary.record().timed_out);
+}
+
+// 每条命令只写一行日志，转弯误差显示成角度
+TEST(MotionSummary_EmitsOneLogLinePerCommand) {
+    reset_all_mocks();
+    LogEntry e;
+    while (hal_log_pop(e)) {}
+
+    MotionSummary summary;
+    summary.begin(MOTION_TURN, TURN_SETTLE_RAD);
+    for (int i = 0; i < 100; ++i) {
+        summary.sample(M_PI / 2 * (1.0 - i / 100.0), 0.0, 6.0, -6.0);
+        wait_ms(10);
+    }
+    summary.finish(false);
+
+    ASSERT_TRUE(hal_log_pop(e));
+    ASSERT_TRUE(!hal_log_pop(e));                   // 100 个周期只有 1 行
+    ASSERT_TRUE(strncmp(e.text, "turn#", 5) == 0);
+    ASSERT_TRUE(strstr(e.text, "1000ms") != nullptr);
+    ASSERT_TRUE(strstr(e.text, "max=90.000") != nullptr);
+    ASSERT_TRUE(strstr(e.text, "to=0") != nullptr);
+    ASSERT_TRUE(strstr(e.text, "in=1") != nullptr);
+}
+
+// ============================================================================
+//  通道表 + 差分编码（Channel Log）测试（4 个）
+// ============================================================================
+
+// varint / zigzag 的边界值，通道表写进去再读出来一样
+TEST(ChannelLog_VarintAndSchemaRoundTrip) {
+    const uint32_t values[] = { 0, 1, 127, 128, 16383, 16384, 0xFFFFFFFFu };
+    const int sizes[]       = { 1, 1, 1,   2,   2,     3,     5 };
+    uint8_t buf[8];
+    for (int i = 0; i < 7; ++i) {
+        uint32_t v = 0;
+        ASSERT_NEAR(put_varint(buf, values[i]), sizes[i], 0.0);
+        ASSERT_NEAR(get_varint(buf, sizes[i], &v), sizes[i], 0.0);
+        ASSERT_TRUE(v == values[i]);
+        ASSERT_NEAR(get_varint(buf, sizes[i] - 1, &v), 0, 0.0);  // 少一个字节 → 不完整
+    }
+    ASSERT_TRUE(zigzag_encode(-1) == 1 && zigzag_encode(1) == 2);
+    ASSERT_TRUE(zigzag_decode(zigzag_encode(-2147483647 - 1)) == -2147483647 - 1);
+
+    uint8_t header[ODOM_LOG_DELTA_HEADER_MAX];
+    int len = odom_log_encode_delta_header(header);
+    uint16_t version = 0, schema_len = 0;
+    ASSERT_TRUE(odom_log_decode_header(header, &version, &schema_len));
+    ASSERT_NEAR(version, ODOM_LOG_VERSION_DELTA, 0.0);
+    ASSERT_NEAR(len, ODOM_LOG_HEADER_SIZE + schema_len, 0.0);
+
+    ChannelInfo channels[CHANNEL_MAX];
+    int count = channel_schema_decode(header + ODOM_LOG_HEADER_SIZE, schema_len, channels, CHANNEL_MAX);
+    ASSERT_NEAR(count, ODOM_CHANNEL_COUNT, 0.0);
+    ASSERT_TRUE(strcmp(channels[2].name, "theta") == 0);
+    ASSERT_TRUE(strcmp(channels[2].unit, "rad") == 0);
+    ASSERT_NEAR(channels[4].quantum, 1e-3, 1e-9);
+    ASSERT_NEAR(channel_schema_decode(header + ODOM_LOG_HEADER_SIZE, schema_len - 1,
+                                      channels, CHANNEL_MAX), -1, 0.0);  // 截断的 schema
+}
+
+// 里程计记录差分编码再解码，误差不超过半个分辨率；停着不动时一帧只有 2 字节；
+// 中间丢一帧后靠关键帧恢复
+TEST(ChannelLog_OdomFramesRoundTripAndShrink) {
+    ChannelInfo channels[CHANNEL_MAX];
+    uint8_t header[ODOM_LOG_DELTA_HEADER_MAX];
+    int hlen = odom_log_encode_delta_header(header);
+    int count = channel_schema_decode(header + ODOM_LOG_HEADER_SIZE, hlen - ODOM_LOG_HEADER_SIZE,
+                                      channels, CHANNEL_MAX);
+    ASSERT_NEAR(count, ODOM_CHANNEL_COUNT, 0.0);
+
+    OdomFrameEncoder encoder(ODOM_CHANNELS, 100);
+    ChannelFrameDecoder decoder(channels, count);
+    static uint8_t stream[300 * OdomFrameEncoder::MAX_FRAME_BYTES];
+    int total = 0, stationary_bytes = 0;
+    OdomRecord sent[300];
+
+    for (int i = 0; i < 300; ++i) {
+        OdomRecord rec;
+        double t = (i < 200) ? i * 0.01 : 2.0;   // 后 100 帧机器人停住
+        rec.time_ms      = 1000 + i * 10;
+        rec.x            = (float)(0.8 * t);
+        rec.y            = (float)(0.3 * t * t);
+        rec.theta        = (float)(0.5 * sin(t));
+        rec.target_error = (float)(1.6 - 0.8 * t);
+        rec.left_volts   = (i < 200) ? 6.0f + 0.01f * (i % 7) : 0.0f;
+        rec.right_volts  = (i < 200) ? -6.0f : 0.0f;
+        rec.forward_m    = rec.x;
+        rec.lateral_m    = -0.001f;
+        rec.imu_rad      = rec.theta;
+        sent[i] = rec;
+
+        uint8_t frame[OdomFrameEncoder::MAX_FRAME_BYTES];
+        int n = encoder.encode(rec.time_ms, rec, frame);
+        if (i == 150) {               // 模拟这一帧因为缓冲区满被丢掉
+            encoder.force_keyframe();
+            continue;
+        }
+        memcpy(stream + total, frame, n);
+        total += n;
+        if (i >= 201 && i != 251) stationary_bytes += n;  // 第 251 帧是关键帧（第 151 帧起重新计数）
+    }
+
+    ASSERT_NEAR(stationary_bytes, 98 * 2, 0.0);          // 停住以后每帧只有时间 + 空掩码
+    ASSERT_TRUE(total < 300 * ODOM_RECORD_SIZE / 3);     // 比固定 40 字节小得多
+
+    int pos = 0, decoded = 0;
+    for (int i = 0; i < 300; ++i) {
+        if (i == 150) continue;
+        uint32_t time_ms;
+        double v[CHANNEL_MAX];
+        int n = decoder.decode(stream + pos, total - pos, &time_ms, v);
+        ASSERT_TRUE(n > 0);
+        pos += n;
+        ASSERT_NEAR(time_ms, sent[i].time_ms, 0.0);
+        for (int c = 0; c < ODOM_CHANNEL_COUNT; ++c) {
+            ASSERT_NEAR(v[c], sent[i].*(ODOM_CHANNELS[c].field), ODOM_CHANNELS[c].quantum * 0.51);
+        }
+        decoded++;
+    }
+    ASSERT_NEAR(pos, total, 0.0);
+    ASSERT_NEAR(decoded, 299, 0.0);
+}
+
+// 采样分频：慢通道只在第 0、4、8… 帧出现；不完整的帧等数据齐了再解
+TEST(ChannelLog_RateDividerAndTruncatedFrame) {
+    struct Sample { float fast; float slow; };
+    static const ChannelDef<Sample> defs[2] = {
+        { "fast", "m", &Sample::fast, 0.01f, 1 },
+        { "slow", "C", &Sample::slow, 0.5f,  4 },
+    };
+    uint8_t schema[channel_schema_max_bytes(2)];
+    int slen = channel_schema_encode(defs, schema, sizeof(schema));
+    ChannelInfo channels[2];
+    ASSERT_NEAR(channel_schema_decode(schema, slen, channels, 2), 2, 0.0);
+    ASSERT_NEAR(channels[1].rate_div, 4, 0.0);
+
+    ChannelFrameEncoder<Sample, 2> encoder(defs, 1000);
+    ChannelFrameDecoder decoder(channels, 2);
+    for (int i = 0; i < 9; ++i) {
+        Sample s = { (float)i, 20.0f + i };      // 两个通道每帧都在变
+        uint8_t frame[ChannelFrameEncoder<Sample, 2>::MAX_FRAME_BYTES];
+        int n = encoder.encode(i * 10, s, frame);
+
+        uint32_t t;
+        double v[2];
+        ASSERT_NEAR(decoder.decode(frame, n - 1, &t, v), 0, 0.0);  // 少最后一个字节
+        ASSERT_NEAR(decoder.decode(frame, n, &t, v), n, 0.0);
+        ASSERT_NEAR(t, i * 10, 0.0);
+        ASSERT_NEAR(v[0], i, 1e-6);
+        ASSERT_NEAR(v[1], 20.0 + (i / 4) * 4, 1e-6);  // 慢通道保持上一次采样的值
+        ASSERT_TRUE(((frame[1] & 2) != 0) == (i % 4 == 0));  // 掩码里慢通道那一位
+    }
+}
+
+// int32 通道：类型写进 schema，解码结果和原值完全一样（float 表示不了的大整数、
+// 正负来回跳也一样）；schema 里不认识的类型直接报错
+TEST(ChannelLog_IntChannelIsExact) {
+    struct Sample { float volts; int32_t state; int32_t ticks; };
+    static const ChannelDef<Sample> defs[3] = {
+        { "volts", "V", &Sample::volts, 0.01f, 1 },
+        { "state", "",  &Sample::state, 1 },
+        { "ticks", "",  &Sample::ticks, 1 },
+    };
+    uint8_t schema[channel_schema_max_bytes(3)];
+    int slen = channel_schema_encode(defs, schema, sizeof(schema));
+    ChannelInfo channels[3];
+    ASSERT_NEAR(channel_schema_decode(schema, slen, channels, 3), 3, 0.0);
+    ASSERT_TRUE(channels[0].type == CHANNEL_F32);
+    ASSERT_TRUE(channels[1].type == CHANNEL_I32 && channels[2].type == CHANNEL_I32);
+    ASSERT_NEAR(channels[2].quantum, 1.0, 0.0);
+
+    ChannelFrameEncoder<Sample, 3> encoder(defs, 4);
+    ChannelFrameDecoder decoder(channels, 3);
+    const int32_t ticks[6] = { 16777217, 16777219, -2147483647 - 1, 2147483647, 7, 7 };
+    for (int i = 0; i < 6; ++i) {
+        Sample s = { 12.0f + 0.013f * i, i % 3, ticks[i] };
+        uint8_t frame[ChannelFrameEncoder<Sample, 3>::MAX_FRAME_BYTES];
+        int n = encoder.encode(i * 10, s, frame);
+        uint32_t t;
+        double v[3];
+        ASSERT_NEAR(decoder.decode(frame, n, &t, v), n, 0.0);
+        ASSERT_NEAR(v[0], s.volts, 0.01 * 0.51);
+        ASSERT_TRUE((int32_t)v[1] == s.state && v[1] == (double)s.state);
+        ASSERT_TRUE((int32_t)v[2] == ticks[i] && v[2] == (double)ticks[i]);
+    }
+
+    schema[1] = 7;   // 第一个通道的类型字节
+    ASSERT_NEAR(channel_schema_decode(schema, slen, channels, 3), -1, 0.0);
+}
+
+// ============================================================================
+//  周期定时器（Periodic Timer）测试（2 个）
+// ============================================================================
+
+// 计算时间忽长忽短，唤醒时刻仍然严格落在 10 ms 的整数倍上，dt 是真实间隔
+TEST(PeriodicTimer_WakesOnAbsoluteDeadlines) {
+    reset_all_mocks();
+    wait_ms(1000);
+    PeriodicTimer period(10);
+    period.start();
+
+    const int work_ms[] = { 3, 7, 1, 9, 0, 5 };
+    for (int i = 0; i < 6; ++i) {
+        double dt = period.wait();
+        ASSERT_NEAR(get_time_ms(), 1000 + 10 * (i + 1), 0.0);  // 不漂移
+        ASSERT_NEAR(dt, 0.010, 1e-9);
+        wait_ms(work_ms[i]);                                   // 模拟这一轮的计算时间
+    }
+    ASSERT_NEAR(period.ticks(), 6, 0.0);
+    ASSERT_NEAR(period.overruns(), 0, 0.0);
+    ASSERT_NEAR(period.measured_period_ms(), 10.0, 1e-9);
+}
+
+// 计算超时：不睡、计数；落后超过一个周期就重新对齐，不连着"补课"；
+// 唤醒延迟按截止时间统计
+TEST(PeriodicTimer_CountsOverrunsAndResyncs) {
+    reset_all_mocks();
+    static LoopStats stats("periodic_test", 10);   // 注册后不会注销：必须活到程序结束
+    PeriodicTimer period(10, &stats);
+    period.start();                       // 截止时间 10, 20, 30 …
+
+    period.wait();                        // t = 10
+    stats.begin();
+    wait_ms(14);                          // 超时 4 ms（截止 20，现在 24）
+    stats.end();
+    double dt = period.wait();            // 不睡，立刻返回
+    ASSERT_NEAR(get_time_ms(), 24, 0.0);
+    ASSERT_NEAR(dt, 0.014, 1e-9);
+    ASSERT_NEAR(period.overruns(), 1, 0.0);
+    stats.begin();
+    ASSERT_NEAR(stats.late_us().max(), 4000, 0.0);  // 比截止时间 20 晚了 4 ms
+
+    period.wait();                        // 下一个截止时间仍是 30：相位不变
+    ASSERT_NEAR(get_time_ms(), 30, 0.0);
+
+    wait_ms(35);                          // 卡了 35 ms（错过 40、50、60 三个周期）
+    period.wait();
+    ASSERT_NEAR(get_time_ms(), 65, 0.0);
+    ASSERT_NEAR(period.overruns(), 2, 0.0);
+    period.wait();                        // 从 65 重新对齐 → 75，而不是连跑 3 轮追赶
+    ASSERT_NEAR(get_time_ms(), 75, 0.0);
+    ASSERT_NEAR(period.last_dt(), 0.010, 1e-9);
+}
+
+// ============================================================================
+//  位姿发布（SeqLock）测试（2 个）
+// ============================================================================
+
+// 真线程压力测试：一个写者不停发布，三个读者不停读，读到的快照永远是"同一次写入"的
+TEST(SeqLock_ThreadedReadersNeverSeeTornSnapshots) {
+    static SeqLock<PoseSnapshot> lock;
+    static std::atomic<bool> done(false);
+    static std::atomic<int>  torn(0), backwards(0);
+    static std::atomic<long> reads(0);
+    const uint32_t WRITES = 200000;
+
+    // 每次写入的所有字段都由同一个 i 算出来，读者据此检查有没有"拼接"出来的快照
+    std::thread writer([&]() {
+        for (uint32_t i = 1; i <= WRITES; ++i) {
+            PoseSnapshot s;
+            s.pose.x     = i;
+            s.pose.y     = -2.0 * i;
+            s.pose.theta = i * 0.5;
+            s.seq        = i;
+            s.reserved   = ~i;
+            s.time_us    = (uint64_t)i * 10000;
+            lock.write(s);
+        }
+        done.store(true);
+    });
+
+    std::thread readers[3];
+    for (int r = 0; r < 3; ++r) {
+        readers[r] = std::thread([&]() {
+            uint32_t last = 0;
+            do {                                     // 写者可能在读者起来之前就写完了：至少读一次
+                PoseSnapshot s = lock.read();
+                uint32_t i = s.seq;
+                if (s.pose.x != i || s.pose.y != -2.0 * i || s.pose.theta != i * 0.5 ||
+                    s.reserved != (i ? ~i : 0u) || s.time_us != (uint64_t)i * 10000) {
+                    torn++;
+                }
+                if (i < last) backwards++;
+                last = i;
+                reads++;
+            } while (!done.load());
+        });
+    }
+    writer.join();
+    for (int r = 0; r < 3; ++r) readers[r].join();
+
+    ASSERT_NEAR(torn.load(), 0, 0.0);
+    ASSERT_NEAR(backwards.load(), 0, 0.0);          // 序号单调不减
+    ASSERT_TRUE(reads.load() > 0);
+    ASSERT_NEAR(lock.version(), WRITES, 0.0);
+    ASSERT_NEAR(lock.read().seq, WRITES, 0.0);
+}
+
+// 每次更新/设置位姿都发布一份带序号和时间戳的快照
+TEST(Odometry_PublishesSnapshotWithSeqAndTime) {
+    reset_all_mocks();
+    set_pose({1.0, 2.0, 0.0});
+    PoseSnapshot first = get_pose_snapshot();
+    ASSERT_NEAR(first.pose.x, 1.0, 1e-12);
+
+    wait_ms(10);
+    mock_tracking_forward_dist = 0.5;
+    odometry_update(0.01);
+    PoseSnapshot second = get_pose_snapshot();
+    ASSERT_NEAR(second.seq, first.seq + 1, 0.0);
+    ASSERT_NEAR((double)(second.time_us - first.time_us), 10000, 0.0);
+    ASSERT_NEAR(second.pose.x, 1.5, 1e-9);
+    ASSERT_NEAR(get_pose().x, 1.5, 1e-9);
+    ASSERT_NEAR(odometry_get_raw_inputs(nullptr).forward_m, 0.5, 1e-12);
+    ASSERT_NEAR(odometry_get_raw_inputs(nullptr).dt_s, 0.01, 1e-12);
+
+    set_pose_no_reset({0.0, 0.0, 1.0});              // 视觉修正也是一次发布
+    ASSERT_NEAR(get_pose_snapshot().seq, second.seq + 1, 0.0);
+    ASSERT_NEAR(get_pose().theta, 1.0, 1e-12);
+}
+
+// ============================================================================
+//  位姿历史（Pose History）测试（3 个）
+// ============================================================================
+
+// 二分查找 + 线性插值；写满一圈后最旧的被覆盖
+TEST(PoseHistory_InterpolatesAndWrapsAround) {
+    static PoseHistory h;
+    h.clear();
+    Pose out;
+    ASSERT_TRUE(!h.pose_at(0, &out));                      // 空的
+
+    const int N = POSE_HISTORY_CAPACITY + 30;              // 多写 30 条，绕过一圈
+    for (int i = 0; i < N; ++i) {
+        Pose p = { 0.01 * i, -0.02 * i, 0.001 * i };
+        OdomDelta d = { 0.01, 0.0, 0.001 };
+        h.push(1000000 + (uint64_t)i * 10000, p, d);       // 每 10 ms 一条
+    }
+    ASSERT_NEAR(h.size(), POSE_HISTORY_CAPACITY, 0.0);
+    ASSERT_NEAR(h.at(0).time_us, 1000000 + 30 * 10000, 0.0);  // 最旧的是第 30 条
+
+    ASSERT_TRUE(h.pose_at(1000000 + 100 * 10000 + 2500, &out)); // 第 100 和 101 条之间 1/4 处
+    ASSERT_NEAR(out.x, 0.01 * 100.25, 1e-12);
+    ASSERT_NEAR(out.y, -0.02 * 100.25, 1e-12);
+    ASSERT_NEAR(out.theta, 0.001 * 100.25, 1e-12);
+
+    ASSERT_TRUE(h.pose_at(1000000 + 50 * 10000, &out));   // 正好落在一条记录上
+    ASSERT_NEAR(out.x, 0.5, 1e-12);
+    ASSERT_TRUE(h.pose_at(99999999, &out));                // 比最新还晚 → 最新位姿
+    ASSERT_NEAR(out.x, 0.01 * (N - 1), 1e-12);
+    ASSERT_TRUE(!h.pose_at(1000000 + 29 * 10000, &out));  // 已经被覆盖
+}
+
+// 在过去修正位姿后，之后的增量按新航向重新积分
+TEST(PoseHistory_CorrectAtReplaysLaterDeltas) {
+    static PoseHistory h;
+    h.clear();
+    Pose p = { 0.0, 0.0, 0.0 };
+    OdomDelta forward = { 0.1, 0.0, 0.0 };                 // 每步直走 0.1 米
+    for (int i = 0; i < 10; ++i) {
+        p = pose_integrate(p, forward);
+        h.push((uint64_t)(i + 1) * 10000, p, forward);
+    }
+    ASSERT_NEAR(p.x, 1.0, 1e-12);
+
+    // 在第 5 步（t=50ms，x=0.5）发现其实朝向是 90°、位置是 (0.5, 0.2)
+    Pose newest;
+    ASSERT_TRUE(h.correct_at(55000, { 0.5, 0.2, M_PI / 2 }, &newest));  // 55 ms → 修正落在 50 ms 那条
+    ASSERT_NEAR(newest.x, 0.5, 1e-9);                      // 后 5 步沿 +y 走
+    ASSERT_NEAR(newest.y, 0.2 + 0.5, 1e-9);
+    ASSERT_NEAR(newest.theta, M_PI / 2, 1e-12);
+    ASSERT_NEAR(h.at(3).pose.x, 0.4, 1e-12);               // 修正之前的历史不动
+
+    ASSERT_TRUE(!h.correct_at(5000, { 9, 9, 9 }, &newest)); // 早于历史 → 拒绝，不改任何东西
+    ASSERT_NEAR(h.at(0).pose.x, 0.1, 1e-12);
+}
+
+// 里程计：每次更新自动记历史；在过去修正后，现在的位姿跟着变并发布
+TEST(Odometry_CorrectAtPastTimeUpdatesCurrentPose) {
+    reset_all_mocks();
+    set_pose({0, 0, 0});
+    for (int i = 1; i <= 10; ++i) {
+        wait_ms(10);
+        mock_tracking_forward_dist = 0.05 * i;             // 每 10 ms 前进 5 cm
+        odometry_update(0.01);
+    }
+    uint64_t capture_us = get_time_us() - 40000;           // "摄像头 40 ms 前拍的照"
+    Pose then;
+    ASSERT_TRUE(odometry_pose_at(capture_us, &then));
+    ASSERT_NEAR(then.x, 0.30, 1e-9);
+
+    uint32_t seq = get_pose_snapshot().seq;
+    ASSERT_TRUE(odometry_correct_at(capture_us, { then.x + 0.1, then.y, then.theta }));
+    ASSERT_NEAR(get_pose().x, 0.60, 1e-9);                 // 现在的位置整体平移 +0.1
+    ASSERT_NEAR(get_pose_snapshot().seq, seq + 1, 0.0);
+
+    mock_tracking_forward_dist = 0.55;                     // 之后的更新接着修正后的位置走
+    wait_ms(10);
+    odometry_update(0.01);
+    ASSERT_NEAR(get_pose().x, 0.65, 1e-9);
+    ASSERT_TRUE(!odometry_correct_at(0, { 0, 0, 0 }));     // 太久以前
+}
+
+// ============================================================================
+//  卡尔曼滤波（Pose EKF）测试（4 个）
+// ============================================================================
+
+// 从真实位姿算出一个标签"应该"测到的距离和方位（和 pose_ekf.cpp 的测量模型一致）
+static TagMeasurement ideal_tag_measurement(const Pose& truth, int tag_id) {
+    const FieldTag* t = find_field_tag(tag_id);
+    double cx, cy;
+    vision_camera_position(truth, &cx, &cy);
+    TagMeasurement m;
+    m.id         = tag_id;
+    m.tag_x      = t->x;
+    m.tag_y      = t->y;
+    m.range      = hypot(t->x - cx, t->y - cy);
+    m.bearing    = atan2(t->y - cy, t->x - cx) - truth.theta - VISION_CAMERA_ANGLE;
+    m.bearing    = atan2(sin(m.bearing), cos(m.bearing));
+    m.confidence = 1.0;
+    return m;
+}
+
+// 小矩阵：乘法、转置、求逆；奇异矩阵求逆失败
+TEST(Matrix_MultiplyTransposeInvert) {
+    Matrix<2, 3> a;
+    a(0, 0) = 1; a(0, 1) = 2; a(0, 2) = 3;
+    a(1, 0) = 4; a(1, 1) = 5; a(1, 2) = 6;
+    Matrix<2, 2> aat = a * a.transpose();
+    ASSERT_NEAR(aat(0, 0), 14, 1e-12);
+    ASSERT_NEAR(aat(0, 1), 32, 1e-12);
+    ASSERT_NEAR(aat(1, 1), 77, 1e-12);
+
+    Matrix<3, 3> m = Matrix<3, 3>::zero();
+    m(0, 1) = 2; m(0, 2) = 1;                 // 第一列主元是 0 → 必须换行
+    m(1, 0) = 1; m(1, 1) = 1;
+    m(2, 0) = 3; m(2, 1) = 1; m(2, 2) = 4;
+    Matrix<3, 3> inv;
+    ASSERT_TRUE(matrix_invert(m, &inv));
+    Matrix<3, 3> id = m * inv;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) ASSERT_NEAR(id(i, j), i == j ? 1.0 : 0.0, 1e-12);
+
+    Matrix<2, 2> singular;
+    singular(0, 0) = 1; singular(0, 1) = 2;
+    singular(1, 0) = 2; singular(1, 1) = 4;
+    Matrix<2, 2> singular_inv;
+    ASSERT_TRUE(!matrix_invert(singular, &singular_inv));
+}
+
+// 预测让协方差变大；两个标签的测量把位置和航向都拉回真值，协方差变小
+TEST(PoseEkf_PredictGrowsAndTagsCorrectHeading) {
+    static PoseEkf ekf;
+    Pose truth = { 1.0, 1.80, M_PI };              // 面朝左墙，1 号和 3 号标签都在前方
+    ekf.reset({ truth.x + 0.04, truth.y - 0.03, truth.theta + 0.05 });
+    double p0 = ekf.covariance()(0, 0);
+
+    OdomDelta still = { 0.0, 0.0, 0.0 };
+    OdomDelta moving = { 0.01, 0.0, 0.0 };
+    ekf.predict(still);
+    double p_still = ekf.covariance()(0, 0);
+    ASSERT_TRUE(p_still > p0);                     // 静止也有底噪
+    ekf.predict(moving);
+    ekf.set_pose({ truth.x + 0.04, truth.y - 0.03, truth.theta + 0.05 });  // 只看协方差，位姿放回去
+    ASSERT_TRUE(ekf.covariance()(0, 0) - p_still > p_still - p0);  // 走动时长得更快
+
+    double sigma_theta_before = sqrt(ekf.covariance()(2, 2));
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(ekf.update_tag(ideal_tag_measurement(truth, 1)) == EKF_UPDATE_ACCEPTED);
+        ASSERT_TRUE(ekf.update_tag(ideal_tag_measurement(truth, 3)) == EKF_UPDATE_ACCEPTED);
+    }
+    ASSERT_NEAR(ekf.pose().x, truth.x, 0.005);
+    ASSERT_NEAR(ekf.pose().y, truth.y, 0.005);
+    ASSERT_NEAR(ekf.pose().theta, truth.theta, 0.005);   // 航向也被方位角修正了
+    ASSERT_TRUE(sqrt(ekf.covariance()(2, 2)) < sigma_theta_before / 2);
+    ASSERT_NEAR(ekf.stats().accepted, 20, 0.0);
+}
+
+// 离谱的测量被门限拒绝：位姿和协方差都不变；里程计接口同样拒绝
+TEST(PoseEkf_GateRejectsOutlier) {
+    static PoseEkf ekf;
+    Pose truth = { 1.0, 1.22, M_PI };
+    ekf.reset(truth);
+    TagMeasurement bad = ideal_tag_measurement(truth, 1);
+    bad.range += 0.8;                              // 误检：远了 80 cm
+    double pxx = ekf.covariance()(0, 0);
+    ASSERT_TRUE(ekf.update_tag(bad) == EKF_UPDATE_GATED);
+    ASSERT_TRUE(ekf.stats().last_nis > EKF_GATE_CHI2);
+    ASSERT_NEAR(ekf.pose().x, truth.x, 0.0);
+    ASSERT_NEAR(ekf.covariance()(0, 0), pxx, 0.0);
+    ASSERT_NEAR(ekf.stats().gated, 1, 0.0);
+
+    reset_all_mocks();
+    set_pose(truth);
+    uint32_t seq = get_pose_snapshot().seq;
+    ASSERT_TRUE(!odometry_ekf_update(bad));
+    ASSERT_NEAR(get_pose_snapshot().seq, seq, 0.0);  // 被拒绝 → 不发布
+    TagMeasurement good = ideal_tag_measurement({ 1.02, 1.22, M_PI }, 1);
+    ASSERT_TRUE(odometry_ekf_update(good));
+    ASSERT_TRUE(get_pose().x > truth.x);             // 往测量那边挪了一点
+    ASSERT_NEAR(get_pose_snapshot().seq, seq + 1, 0.0);
+}
+
+// 被撞偏 30 cm（里程计看不见）：先几个标签被拒绝，连续够数后放大协方差，
+// 之后的标签把位姿拉回 10 cm 以内；零星的误检凑不够数，不会触发
+TEST(PoseEkf_RecoversAfterShove) {
+    static PoseEkf ekf;
+    Pose believed = { 1.0, 1.80, M_PI };
+    ekf.reset(believed);
+    TagMeasurement bad = ideal_tag_measurement(believed, 1);
+    bad.range += 0.8;
+    for (int i = 0; i < 3 * EKF_RECOVERY_GATED_TAGS; ++i) {   // 误检夹在好的测量中间
+        ekf.update_tag(i % 2 ? ideal_tag_measurement(believed, 3) : bad);
+    }
+    ASSERT_NEAR(ekf.stats().recoveries, 0, 0.0);
+
+    Pose truth = { believed.x + 0.25, believed.y - 0.20, believed.theta + 0.05 };
+    OdomDelta still = { 0.0, 0.0, 0.0 };
+    for (int i = 0; i < EKF_RECOVERY_GATED_TAGS - 1; ++i) {
+        ASSERT_TRUE(ekf.update_tag(ideal_tag_measurement(truth, 1 + 2 * (i % 2))) == EKF_UPDATE_GATED);
+    }
+    ASSERT_NEAR(ekf.pose().x, believed.x, 0.0);
+
+    for (int frame = 0; frame < 20; ++frame) {                 // 20 帧 = 1 秒
+        ekf.predict(still);
+        ekf.update_tag(ideal_tag_measurement(truth, 1));
+        ekf.update_tag(ideal_tag_measurement(truth, 3));
+    }
+    ASSERT_NEAR(ekf.stats().recoveries, 1, 0.0);
+    ASSERT_TRUE(hypot(ekf.pose().x - truth.x, ekf.pose().y - truth.y) < 0.10);
+    ASSERT_NEAR(ekf.pose().theta, truth.theta, 0.02);
+}
+
+// ============================================================================
+//  粒子滤波（Particle Filter）测试（3 个）
+// ============================================================================
+
+// 粒子的加权平均和散布（测试用）
+static void particle_spread(const ParticleFilter& pf, double* sx, double* sy) {
+    Pose m = pf.estimate();
+    double vx = 0, vy = 0;
+    for (int i = 0; i < pf.count(); ++i) {
+        vx += (pf.x()[i] - m.x) * (pf.x()[i] - m.x);
+        vy += (pf.y()[i] - m.y) * (pf.y()[i] - m.y);
+    }
+    *sx = sqrt(vx / pf.count());
+    *sy = sqrt(vy / pf.count());
+}
+
+// 只分配一次；预测时粒子云跟着里程计走，并且越走越散
+TEST(ParticleFilter_PredictMovesAndSpreadsCloud) {
+    static ParticleFilter pf;
+    ASSERT_TRUE(pf.init(1000));
+    ASSERT_TRUE(!pf.init(2000));                   // 第二次不再分配
+    ASSERT_NEAR(pf.count(), 1000, 0.0);
+
+    pf.reset({ 1.0, 1.0, M_PI / 2 });
+    double sx0, sy0;
+    particle_spread(pf, &sx0, &sy0);
+    ASSERT_NEAR(sx0, PF_INIT_SIGMA_XY, 0.01);
+
+    OdomDelta step = { 0.01, 0.0, 0.0 };           // 朝 +y 直走 1 米
+    for (int i = 0; i < 100; ++i) pf.predict(step);
+    Pose m = pf.estimate();
+    ASSERT_NEAR(m.x, 1.0, 0.02);
+    ASSERT_NEAR(m.y, 2.0, 0.02);
+    ASSERT_NEAR(m.theta, M_PI / 2, 0.01);
+    double sx, sy;
+    particle_spread(pf, &sx, &sy);
+    ASSERT_TRUE(sy > sy0);                         // 沿走的方向散得更开
+
+    OdomDelta turn = { 0.0, 0.0, M_PI / 200 };     // 原地转 180° 再走 0.5 米：
+    for (int i = 0; i < 200; ++i) pf.predict(turn);  // 粒子里的 cos/sin 是增量旋转的，不能走样
+    for (int i = 0; i < 50; ++i) pf.predict(step);
+    m = pf.estimate();
+    ASSERT_NEAR(m.theta, 3 * M_PI / 2, 0.02);
+    ASSERT_NEAR(m.x, 1.0, 0.03);
+    ASSERT_NEAR(m.y, 1.5, 0.03);
+}
+
+// 标签把偏了的粒子云拉回真值，并触发系统重采样
+TEST(ParticleFilter_TagsPullCloudToTruth) {
+    static ParticleFilter pf;
+    pf.init(1000, 7);
+    Pose truth = { 1.0, 1.80, M_PI };
+    pf.reset({ truth.x + 0.06, truth.y - 0.05, truth.theta + 0.04 });
+    OdomDelta still = { 0.0, 0.0, 0.0 };
+    for (int k = 0; k < 15; ++k) {
+        pf.predict(still);
+        pf.update_tag(ideal_tag_measurement(truth, 1));
+        pf.update_tag(ideal_tag_measurement(truth, 3));
+        pf.finish_update();
+    }
+    Pose m = pf.estimate();
+    ASSERT_NEAR(m.x, truth.x, 0.02);
+    ASSERT_NEAR(m.y, truth.y, 0.02);
+    ASSERT_NEAR(m.theta, truth.theta, 0.02);
+    ASSERT_TRUE(pf.stats().resamples > 0);
+    ASSERT_TRUE(pf.stats().ess > 0 && pf.stats().ess <= pf.count());
+}
+
+// 被撞偏 30 cm（里程计没看见）后，恢复粒子让估计自己找回来；里程计接口同样生效
+TEST(ParticleFilter_RecoversAfterShove) {
+    static ParticleFilter pf;
+    pf.init(1000, 99);
+    Pose before = { 1.0, 1.80, M_PI };
+    pf.reset(before);
+    OdomDelta still = { 0.0, 0.0, 0.0 };
+    for (int k = 0; k < 10; ++k) {
+        pf.predict(still);
+        pf.update_tag(ideal_tag_measurement(before, 1));
+        pf.update_tag(ideal_tag_measurement(before, 3));
+        pf.finish_update();
+    }
+    Pose shoved = { 1.25, 1.65, M_PI - 0.15 };
+    int frames = 0;
+    while (frames < 60 && hypot(pf.estimate().x - shoved.x, pf.estimate().y - shoved.y) > 0.10) {
+        pf.predict(still);
+        pf.update_tag(ideal_tag_measurement(shoved, 1));
+        pf.update_tag(ideal_tag_measurement(shoved, 3));
+        pf.finish_update();
+        frames++;
+    }
+    ASSERT_TRUE(frames < 60);                      // 20 Hz 视觉下 3 秒以内
+    ASSERT_TRUE(pf.stats().injected > 0);
+
+    reset_all_mocks();
+    set_pose(before);
+    odometry_particle_filter_init(500);
+    set_pose(before);                               // 重新撒粒子
+    TagMeasurement seen[2] = { ideal_tag_measurement(shoved, 1), ideal_tag_measurement(shoved, 3) };
+    uint32_t seq = get_pose_snapshot().seq;
+    ASSERT_TRUE(odometry_particle_update(seen, 2));
+    ASSERT_NEAR(get_pose_snapshot().seq, seq + 1, 0.0);
+    ASSERT_TRUE(!odometry_particle_update(seen, 0));
+}
+
+// ============================================================================
+//  速度估计（Twist）测试（2 个）
+// ============================================================================
+
+// 匀速 → 速度收敛到真值、加速度回到 0；突然加速 → 加速度为正；dt <= 0 被忽略
+TEST(TwistEstimator_FiltersVelocityAndAccel) {
+    TwistEstimator est;
+    OdomDelta step = { 0.005, -0.001, 0.01 };          // 每 10 ms：0.5 m/s、-0.1 m/s、1 rad/s
+    est.update(step, 0.01);
+    ASSERT_NEAR(est.velocity().forward, 0.5, 1e-9);     // 第一拍直接用，不从 0 爬
+    ASSERT_NEAR(est.accel().forward, 0.0, 1e-12);
+    for (int i = 0; i < 100; ++i) est.update(step, 0.01);
+    ASSERT_NEAR(est.velocity().forward, 0.5, 1e-6);
+    ASSERT_NEAR(est.velocity().lateral, -0.1, 1e-6);
+    ASSERT_NEAR(est.velocity().omega, 1.0, 1e-6);
+    ASSERT_NEAR(est.accel().forward, 0.0, 1e-3);
+
+    OdomDelta faster = { 0.010, -0.001, 0.01 };        // 1 m/s
+    for (int i = 0; i < 5; ++i) est.update(faster, 0.01);
+    ASSERT_TRUE(est.velocity().forward > 0.7 && est.velocity().forward < 1.0);  // 跟上但有滞后
+    ASSERT_TRUE(est.accel().forward > 1.0);
+
+    Twist before = est.velocity();
+    est.update(faster, 0.0);
+    ASSERT_NEAR(est.velocity().forward, before.forward, 0.0);
+    est.reset();
+    ASSERT_NEAR(est.velocity().forward, 0.0, 0.0);
+}
+
+// 速度和位姿在同一份快照里发布；视觉修正（跳位姿）不产生假速度，set_pose 清零
+TEST(Odometry_PublishesVelocityInSnapshot) {
+    reset_all_mocks();
+    set_pose({0.0, 0.0, 0.0});
+    const double ticks_per_rad = WHEEL_TRACK / (WHEEL_CIRCUMFERENCE / TICKS_PER_REV);
+    for (int i = 1; i <= 50; ++i) {
+        mock_tracking_forward_dist = 0.004 * i;         // 0.4 m/s
+        mock_imu_rotation_rad      = 0.002 * i;         // 0.2 rad/s（驱动电机也这么说）
+        mock_right_ticks           =  0.001 * i * ticks_per_rad;
+        mock_left_ticks            = -0.001 * i * ticks_per_rad;
+        odometry_update(0.01);
+    }
+    PoseSnapshot snap = get_pose_snapshot();
+    ASSERT_NEAR(snap.velocity.forward, 0.4 - 0.2 * FORWARD_WHEEL_OFFSET, 1e-3);
+    ASSERT_NEAR(snap.velocity.omega, 0.2, 1e-3);
+    ASSERT_NEAR(get_velocity().forward, snap.velocity.forward, 0.0);
+
+    set_pose_no_reset({snap.pose.x + 0.3, snap.pose.y, snap.pose.theta});
+    ASSERT_NEAR(get_velocity().forward, snap.velocity.forward, 0.0);
+
+    set_pose({0.0, 0.0, 0.0});
+    ASSERT_NEAR(get_velocity().forward, 0.0, 0.0);
+    ASSERT_NEAR(get_pose_snapshot().accel.forward, 0.0, 0.0);
+}
+
+// ============================================================================
+//  航向融合（Heading Fusion）测试（2 个）
+// ============================================================================
+
+// 15 秒：IMU 有零漂，轮子没有 → 融合后的航向几乎不漂；打滑的一下被忽略
+TEST(HeadingFusion_WheelsCancelImuDrift) {
+    HeadingFusion fusion(IMU_FUSION_ALPHA, 0.01, true);
+    const double bias = 0.003;                       // IMU 零漂 0.003 rad/s（15 秒 ≈ 2.6°）
+    double truth = 0.0, imu_only = 0.0;
+    for (int i = 0; i < 1500; ++i) {
+        double rate = (i % 300 < 100) ? 0.3 : 0.0;   // 每 3 秒慢慢转 1 秒
+        truth    += rate * 0.01;
+        imu_only += rate * 0.01 + bias * 0.01;
+        double wheel = rate * 0.01;
+        if (i == 700) wheel += 0.2;                  // 打滑：轮子一下子多转了 0.2 rad
+        fusion.update(rate * 0.01 + bias * 0.01, true, wheel, true, 0.01);
+    }
+    ASSERT_NEAR(imu_only - truth, 0.045, 1e-9);
+    ASSERT_NEAR(fusion.heading(), truth, 0.005);
+    ASSERT_TRUE(fusion.stats().slip_ticks >= 1);
+    ASSERT_TRUE(fusion.stats().wheel_ticks > 1000);
+
+    // 驱动电机原地快转时轮子在蹭地：只听 IMU
+    HeadingFusion spin(IMU_FUSION_ALPHA, 0.01, true);
+    for (int i = 0; i < 100; ++i) spin.update(0.03, true, 0.027, true, 0.01);
+    ASSERT_NEAR(spin.heading(), 3.0, 1e-9);
+    ASSERT_NEAR(spin.stats().wheel_ticks, 0, 0.0);
+}
+
+// IMU 掉线时用驱动电机编码器接着算航向；重新插上（读数从 0 开始）、读数突然跳变也不会跳；
+// 反过来平行追踪轮掉线时，不拿它的转角去拉航向
+TEST(Odometry_ImuDropoutBridgesWithWheels) {
+    reset_all_mocks();
+    set_pose({0.0, 0.0, 0.0});
+    const double ticks_per_rad = WHEEL_TRACK / (WHEEL_CIRCUMFERENCE / TICKS_PER_REV);
+    double max_step = 0.0, last = 0.0;
+    for (int i = 1; i <= 60; ++i) {
+        double truth = 0.003 * i;                    // 0.3 rad/s
+        mock_right_ticks =  0.5 * truth * ticks_per_rad;
+        mock_left_ticks  = -0.5 * truth * ticks_per_rad;
+        mock_imu_connected    = (i <= 20 || i > 40);
+        if (i == 21 || i == 41) sensor_frame_refresh_status();   // 掉线 / 插回去的这一拍就查到
+        mock_imu_rotation_rad = (i <= 20) ? truth : (i <= 40 ? 0.0 : 0.003 * (i - 40));
+        odometry_update(0.01);
+        double theta = get_pose().theta;
+        if (std::abs(theta - last) > max_step) max_step = std::abs(theta - last);
+        last = theta;
+        if (i == 40) ASSERT_NEAR(theta, 0.12, 1e-3);  // 掉线期间靠轮子
+    }
+    ASSERT_NEAR(get_pose().theta, 0.18, 1e-3);
+
+    // 没报掉线，但读数一下子从 0.36 跳回 0（拔插太快）：这一拍不用 IMU，航向照样不跳
+    for (int i = 61; i <= 180; ++i) {
+        double truth = 0.003 * i;
+        mock_right_ticks =  0.5 * truth * ticks_per_rad;
+        mock_left_ticks  = -0.5 * truth * ticks_per_rad;
+        mock_imu_rotation_rad = (i <= 160) ? 0.003 * (i - 40) : 0.003 * (i - 161);
+        odometry_update(0.01);
+        double theta = get_pose().theta;
+        if (std::abs(theta - last) > max_step) max_step = std::abs(theta - last);
+        last = theta;
+    }
+    ASSERT_NEAR(get_pose().theta, 0.54, 1e-3);
+    ASSERT_TRUE(max_step < 0.004);                    // 每拍最多转 0.003，没有跳变
+
+    // 配了平行轮但追踪轮掉线（平行轮读数停在 0）：慢慢直行时不能把它的"转角"融合进来
+    set_pose({0.0, 0.0, 0.0});
+    mock_has_parallel       = true;
+    mock_tracking_connected = false;
+    sensor_frame_refresh_status();
+    for (int i = 1; i <= 200; ++i) {
+        mock_tracking_forward_dist = 0.0002 * i;     // 0.02 m/s → 假转角 0.17 rad/s，低于打滑门限
+        odometry_update(0.01);
+    }
+    ASSERT_NEAR(get_pose().theta, 0.0, 1e-9);
+}
+
+// ============================================================================
+//  陀螺仪零漂（Gyro Bias）测试（2 个）
+// ============================================================================
+
+// 停稳 STATIONARY_SETTLE_MS 之后才开始学；学到的零漂被减掉；一动（或给电压）就停止学习
+TEST(GyroBias_LearnsOnlyWhileStationary) {
+    GyroBiasEstimator est;
+    StationaryInputs still = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    const double bias = 0.004;                        // 0.004 rad/s
+    for (int i = 0; i < STATIONARY_SETTLE_MS / 10 - 1; ++i) est.correct(bias * 0.01, still, 0.01);
+    ASSERT_TRUE(!est.stationary());
+    ASSERT_NEAR(est.bias(), 0.0, 0.0);
+
+    for (int i = 0; i < 500; ++i) est.correct(bias * 0.01, still, 0.01);   // 5 秒
+    ASSERT_TRUE(est.stationary());
+    ASSERT_NEAR(est.bias(), bias, 1e-4);
+    ASSERT_NEAR(est.correct(bias * 0.01, still, 0.01), 0.0, 1e-6);
+
+    // 开动：追踪轮在走，IMU 在转 → 立刻不算静止，零漂估计不变，但照样减掉
+    StationaryInputs moving = { 0.005, 0.0, 0.005, 0.005, 6.0 };
+    double learned = est.bias();
+    double out = est.correct(0.01 + bias * 0.01, moving, 0.01);
+    ASSERT_TRUE(!est.stationary());
+    ASSERT_NEAR(est.bias(), learned, 0.0);
+    ASSERT_NEAR(out, 0.01, 1e-5);
+
+    // 只是给了电压（下一拍就要动）也不算静止
+    StationaryInputs commanded = { 0.0, 0.0, 0.0, 0.0, 3.0 };
+    for (int i = 0; i < 100; ++i) est.correct(0.0, commanded, 0.01);
+    ASSERT_NEAR(est.bias(), learned, 0.0);
+}
+
+// 里程计里：停着 3 秒学会零漂，之后再停 10 秒航向几乎不漂；IMU 重新插上后重新学
+TEST(Odometry_StationaryBiasStopsHeadingDrift) {
+    reset_all_mocks();
+    set_pose({0.0, 0.0, 0.0});
+    const double bias = 0.003;
+    double imu = 0.0;
+    for (int i = 0; i < 300; ++i) {
+        imu += bias * 0.01;
+        mock_imu_rotation_rad = imu;
+        odometry_update(0.01);
+    }
+    bool stationary = false;
+    ASSERT_NEAR(odometry_get_gyro_bias(&stationary), bias, 2e-4);
+    ASSERT_TRUE(stationary);
+
+    double theta0 = get_pose().theta;
+    for (int i = 0; i < 1000; ++i) {
+        imu += bias * 0.01;
+        mock_imu_rotation_rad = imu;
+        odometry_update(0.01);
+    }
+    ASSERT_NEAR(get_pose().theta, theta0, 0.001);    // 只积分 IMU 会漂 0.03 rad
+
+    mock_imu_connected = false;
+    sensor_frame_refresh_status();
+    odometry_update(0.01);
+    mock_imu_connected = true;
+    sensor_frame_refresh_status();
+    odometry_update(0.01);
+    ASSERT_NEAR(odometry_get_gyro_bias(nullptr), 0.0, 0.0);
+}
+
+// ============================================================================
+//  里程计积分方法（Odometry Integrator）测试（1 个）
+// ============================================================================
+
+// 直线三种方法一样；1/4 圆分 9 步走：圆弧法精确，中点法和 RK2 会差一点
+TEST(PoseIntegrate_ArcExactOnCircle) {
+    const int methods[] = { ODOM_INTEGRATOR_MIDPOINT, ODOM_INTEGRATOR_ARC, ODOM_INTEGRATOR_RK2 };
+    Pose start = { 0.0, 0.0, 0.0 };
+    OdomDelta straight = { 0.3, 0.0, 0.0 };
+    for (int m = 0; m < 3; ++m) {
+        Pose p = pose_integrate_with(methods[m], start, straight);
+        ASSERT_NEAR(p.x, 0.3, 1e-12);
+        ASSERT_NEAR(p.y, 0.0, 1e-12);
+    }
+
+    // 半径 1 m 的 1/4 圆：终点 (1, 1)，朝 90°
+    const double R = 1.0, step = (M_PI / 2.0) / 9.0;
+    OdomDelta arc = { R * step, 0.0, step };
+    double err[3];
+    for (int m = 0; m < 3; ++m) {
+        Pose p = start;
+        for (int i = 0; i < 9; ++i) p = pose_integrate_with(methods[m], p, arc);
+        ASSERT_NEAR(p.theta, M_PI / 2.0, 1e-12);
+        err[m] = hypot(p.x - R, p.y - R);
+    }
+    ASSERT_TRUE(err[1] < 1e-12);
+    ASSERT_TRUE(err[0] > 1e-3);     // 中点法沿切线走，每步多走一点
+    ASSERT_TRUE(err[2] > err[0]);   // RK2 在恒定曲率上反而比中点差
+
+    // 带侧滑的圆弧法：OdomDelta 的横向分量也按同一个弦长比例旋转
+    OdomDelta slide = { 0.0, 0.2, 0.0 };
+    Pose q = pose_integrate_with(ODOM_INTEGRATOR_ARC, start, slide);
+    ASSERT_NEAR(q.x, 0.0, 1e-12);
+    ASSERT_NEAR(q.y, 0.2, 1e-12);
+}
+
+// ============================================================================
+//  传感器采集（Sensor Frame）测试（1 个）
+// ============================================================================
+
+// 一拍里每个传感器只读一次；连接状态隔几拍才查；屏幕 / 日志拿最新帧不再碰硬件；
+// 日志拿到的读数和位姿是同一拍的；IMU 读出 NaN 当掉线
+TEST(SensorFrame_OneReadPerSensorPerTick) {
+    reset_all_mocks();
+    set_pose({0.0, 0.0, 0.0});
+    mock_sensor_reads = 0;
+    mock_time_us = 5000;
+    mock_tracking_forward_dist = 0.02;
+    mock_motor_left_v = 4.0;
+    odometry_update(0.01);
+    // 读数：纵向、横向、IMU、左、右各一次；连接状态（第一拍要查）：追踪轮 2 次、IMU 2 次
+    ASSERT_TRUE(mock_sensor_reads == 5 + 4);
+
+    SensorFrame a = sensor_frame_latest();
+    SensorFrame b = sensor_frame_latest();
+    ASSERT_TRUE(mock_sensor_reads == 5 + 4);           // 读最新帧不碰硬件
+    ASSERT_TRUE(a.seq == b.seq);
+    ASSERT_NEAR(a.forward_m, 0.02, 1e-12);
+    ASSERT_NEAR(a.left_command_v, 4.0, 1e-12);
+    ASSERT_TRUE(a.imu_ok && a.tracking_ok && !a.has_parallel);
+    ASSERT_TRUE(a.time_us == 5000);
+    ASSERT_TRUE(get_pose_snapshot().time_us == a.time_us);   // 位姿盖的是采集时刻
+
+    // 新的一帧已经发布、位姿还没算（里程计正算到一半）：原始值和位姿仍然是同一拍的
+    PoseSnapshot snap;
+    mock_tracking_forward_dist = 0.05;
+    mock_motor_left_v = 6.0;
+    wait_ms(10);
+    sensor_frame_acquire();
+    OdomRawInputs raw = odometry_get_raw_inputs(&snap);
+    ASSERT_TRUE(sensor_frame_latest().seq == a.seq + 1);
+    ASSERT_TRUE(raw.frame_seq == a.seq);
+    ASSERT_TRUE(snap.time_us == a.time_us);
+    ASSERT_NEAR(raw.forward_m, 0.02, 1e-12);
+    ASSERT_NEAR(raw.left_command_v, 4.0, 1e-12);
+    ASSERT_NEAR(snap.pose.x, 0.02, 1e-9);
+
+    mock_imu_rotation_rad = NAN;
+    odometry_update(0.01);
+    SensorFrame c = sensor_frame_latest();
+    ASSERT_TRUE(c.seq == a.seq + 2);
+    ASSERT_TRUE(!c.imu_ok);
+    ASSERT_NEAR(c.imu_rotation_rad, 0.0, 0.0);
+    ASSERT_TRUE(std::isfinite(get_pose().theta));
+
+    // 连续 SENSOR_STATUS_POLL_TICKS 拍里连接状态只查一次
+    mock_imu_rotation_rad = 0.0;
+    mock_sensor_reads = 0;
+    for (int i = 0; i < SENSOR_STATUS_POLL_TICKS; ++i) odometry_update(0.01);
+    ASSERT_TRUE(mock_sensor_reads == 5 * SENSOR_STATUS_POLL_TICKS + 4);
+}
+
+// ============================================================================
+//  多标签联合求解（Multi-Tag）测试（1 个）
+// ============================================================================
+
+// 三个标签、测量没有误差：从偏了 15 cm / 0.08 rad 的里程计出发也能解回真值（航向也解出来）；
+// 只有一个标签不解；有一个标签差了 50 cm 就判定互相矛盾
+TEST(MultiTag_SolvesPoseAndRejectsDisagreement) {
+    Pose truth = { 0.8, 1.5, M_PI };
+    const int ids[] = { 1, 3, 5 };
+    TagMeasurement tags[3];
+    for (int i = 0; i < 3; ++i) {
+        const FieldTag* t = find_field_tag(ids[i]);
+        tags[i].id = t->id;
+        tags[i].tag_x = t->x;
+        tags[i].tag_y = t->y;
+        ASSERT_TRUE(vision_predict_tag(truth, t->x, t->y, &tags[i].range, &tags[i].bearing, nullptr));
+        tags[i].confidence = 0.5;
+    }
+    Pose odom = { truth.x + 0.15, truth.y - 0.10, truth.theta + 0.08 };
+
+    MultiTagSolution sol = multi_tag_solve(tags, 3, odom);
+    ASSERT_TRUE(sol.ok);
+    ASSERT_TRUE(sol.tags_used == 3);
+    ASSERT_NEAR(sol.pose.x, truth.x, 0.005);        // 只剩很弱的里程计先验拉的一点点
+    ASSERT_NEAR(sol.pose.y, truth.y, 0.005);
+    ASSERT_NEAR(sol.pose.theta, truth.theta, 0.005);
+    ASSERT_TRUE(sol.rms < 1.0);
+    ASSERT_TRUE(sol.sigma_xy > 0.0 && sol.sigma_xy < 0.1);
+
+    ASSERT_TRUE(!multi_tag_solve(tags, 1, odom).ok);   // 一个标签不够
+
+    tags[0].range += 0.5;                               // 误检
+    ASSERT_TRUE(!multi_tag_solve(tags, 3, odom).ok);
+}
+
+// ============================================================================
+//  视觉航向（Vision Heading）测试（1 个）
+// ============================================================================
+
+// 斜着看 1 号标签：从宽高比 + 朝向 + 方位解出航向（不需要位置）；
+// 正对着看时不确定度大得多；航向修正每帧有上限，差太多直接不改
+TEST(VisionHeading_FromTagAspectWithBoundedCorrection) {
+    reset_all_mocks();
+    Pose truth = { 1.2, 1.8, M_PI - 0.2 };
+    const FieldTag* tag = find_field_tag(1);
+    double cam_x, cam_y, range, bearing;
+    vision_camera_position(truth, &cam_x, &cam_y);
+    ASSERT_TRUE(vision_predict_tag(truth, tag->x, tag->y, &range, &bearing, nullptr));
+    double view   = atan2(cam_y - tag->y, cam_x - tag->x) - tag->facing;
+    double height = APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH / range;
+    double width  = height * cos(view);
+
+    double heading, sigma;
+    ASSERT_TRUE(vision_heading_from_tag(tag->facing, width, height, bearing, truth.theta + 0.05, &heading, &sigma));
+    ASSERT_NEAR(heading, truth.theta, 1e-9);
+    double face_on_sigma;
+    ASSERT_TRUE(vision_heading_from_tag(tag->facing, height, height, bearing, truth.theta, &heading, &face_on_sigma));
+    ASSERT_TRUE(face_on_sigma > 2.0 * sigma);
+
+    // 走完整条视觉定位：模拟摄像头拍到这个标签，航向估计带置信度
+    set_pose({ truth.x, truth.y, truth.theta + 0.05 });
+    mock_tag_count = 1;
+    mock_tags[0] = { 1, VISION_IMAGE_WIDTH / 2.0 + VISION_FOCAL_LENGTH * tan(bearing), 120.0,
+                     width, height, 0.0, true };
+    VisionEstimate est = vision_localizer_update();
+    ASSERT_TRUE(est.valid);
+    ASSERT_NEAR(est.heading, truth.theta, 1e-6);
+    ASSERT_TRUE(est.heading_confidence > 0.0);
+    mock_tags[0].angle = 30.0;                       // 标签在图片里歪了 → 不估航向
+    ASSERT_NEAR(vision_localizer_update().heading_confidence, 0.0, 0.0);
+
+    // 有上限的修正：每次最多 VISION_HEADING_MAX_STEP_RAD；差太多不改
+    Pose cur = { 1.0, 1.0, 0.0 };
+    ASSERT_NEAR(vision_blend_heading(cur, 0.1, 1.0).theta, VISION_HEADING_MAX_STEP_RAD, 1e-12);
+    ASSERT_NEAR(vision_blend_heading(cur, -0.1, 1.0).theta, -VISION_HEADING_MAX_STEP_RAD, 1e-12);
+    ASSERT_NEAR(vision_blend_heading(cur, 0.5, 1.0).theta, 0.0, 0.0);
+    ASSERT_NEAR(vision_blend_heading(cur, 0.01, 0.5).x, 1.0, 0.0);
+}
+
+// ============================================================================
+//  视觉延迟补偿（Vision Latency）测试（1 个）
+// ============================================================================
+
+// 1.5 m/s 冲向 1 号标签，画面是 60 ms 前拍的：按拍摄时刻的位姿算，
+// 里程计本来就对 → 修正几乎为零（不补偿的话会把车往回拽 9 cm）
+TEST(VisionLatency_EstimatesAtCaptureTimeAndCarriesForward) {
+    reset_all_mocks();
+    set_pose({ 1.2, 1.22, M_PI });                 // 面朝左墙，1 号标签在正前方
+    for (int i = 1; i <= 10; ++i) {
+        wait_ms(10);
+        mock_tracking_forward_dist = 0.015 * i;    // 每 10 ms 前进 1.5 cm
+        odometry_update(0.01);
+    }
+    ASSERT_NEAR(get_pose().x, 1.05, 1e-9);
+
+    // 60 ms 前车在 x = 1.14，摄像头（车前 10 cm）离标签 1.04 米
+    mock_capture_age_us = 60000;
+    mock_tag_count = 1;
+    double pixels = APRILTAG_REAL_SIZE * VISION_FOCAL_LENGTH / 1.04;
+    mock_tags[0] = { 1, VISION_IMAGE_WIDTH / 2.0, 120.0, pixels, pixels, 0.0, true };
+    VisionEstimate est = vision_localizer_update();
+    ASSERT_TRUE(est.valid);
+    ASSERT_TRUE(est.capture_time_us == get_time_us() - 60000);
+    ASSERT_NEAR(est.capture_pose.x, 1.14, 1e-9);
+    ASSERT_NEAR(est.x, 1.14, 1e-9);                // 和拍摄时刻的位姿一致
+
+    // 测量搬到现在：从 x = 1.05 看过去标签应该在 0.95 米
+    TagMeasurement moved = vision_carry_forward(est.tags[0], est.capture_pose, get_pose());
+    ASSERT_NEAR(moved.range, 0.95, 1e-9);
+    ASSERT_NEAR(moved.bearing, 0.0, 1e-9);
+
+    vision_correct_odometry(est);
+    ASSERT_NEAR(get_pose().x, 1.05, 1e-3);
+    ASSERT_NEAR(get_pose().y, 1.22, 1e-3);
+
+    // 修正量加在拍摄时刻，之后的路程原样重放
+    ASSERT_TRUE(odometry_shift_at(est.capture_time_us + 5000, { 0.0, 0.02, 0.0 }));
+    ASSERT_NEAR(get_pose().y, 1.24, 1e-3);
+    ASSERT_TRUE(!odometry_shift_at(1, { 0.0, 0.02, 0.0 }));  // 早于历史
+}
+
+// ============================================================================
+//  视觉帧缓冲（Frame Buffer）测试（1 个）
+// ============================================================================
+
+// 借着的帧不会被改；空闲缓冲用完就丢帧；真线程下读者看到的永远是完整的一帧
+TEST(FrameBuffer_ViewsStayIntactAndThreadedReadersNeverSeeTornFrames) {
+    static FrameBuffer<VisionFrame> buf;
+    ASSERT_NEAR(buf.latest()->seq, 0, 0.0);          // 还没发布过：全 0 的帧
+
+    VisionFrame* f = buf.begin_write();
+    f->seq = 1; f->count = 1; f->tags[0].id = 1;
+    buf.publish();
+    FrameBuffer<VisionFrame>::View held = buf.latest();
+    f = buf.begin_write();
+    f->seq = 2; f->count = 1; f->tags[0].id = 2;
+    buf.publish();
+    FrameBuffer<VisionFrame>::View held2 = buf.latest();
+    f = buf.begin_write();                           // 第 3 块（开始时贴着的全 0 帧）
+    f->seq = 3;
+    buf.publish();
+    ASSERT_TRUE(buf.begin_write() == nullptr);       // 3 块：一块贴着、两块被借着 → 丢帧
+    ASSERT_NEAR(buf.dropped(), 1, 0.0);
+    ASSERT_TRUE(held->seq == 1 && held->tags[0].id == 1);  // 借着的第 1 帧没被覆盖
+    held.release();
+    ASSERT_TRUE(buf.begin_write() != nullptr);       // 还回来以后又有空闲缓冲
+    ASSERT_NEAR(held2->seq, 2, 0.0);
+    held2.release();
+
+    // 一个写者不停发布，三个读者借看：每一帧所有字段都由同一个帧号算出来，
+    // 借着期间（再读一遍）也不能变
+    static std::atomic<bool> done(false);
+    static std::atomic<int>  torn(0), backwards(0);
+    static std::atomic<long> reads(0);
+    const uint32_t FRAMES = 100000;
+    std::thread writer([&]() {
+        for (uint32_t i = 4; i <= FRAMES; ++i) {
+            VisionFrame* w = buf.begin_write();
+            if (w == nullptr) continue;
+            w->seq     = i;
+            w->time_us = (uint64_t)i * 50000;
+            w->count   = (int)(i % VISION_MAX_TAGS);
+            for (int k = 0; k < VISION_MAX_TAGS; ++k) w->tags[k].id = (int)i + k;
+            buf.publish();
+        }
+        done.store(true);
+    });
+    std::thread readers[3];
+    for (int r = 0; r < 3; ++r) {
+        readers[r] = std::thread([&]() {
+            uint32_t last = 0;
+            do {                                     // 写者可能在读者起来之前就写完了：至少读一次
+                FrameBuffer<VisionFrame>::View v = buf.latest();
+                uint32_t i = v->seq;
+                for (int pass = 0; pass < 2; ++pass) {
+                    bool ok = v->seq == i && v->time_us == (uint64_t)i * 50000 &&
+                              v->count == (int)(i % VISION_MAX_TAGS);
+                    for (int k = 0; k < VISION_MAX_TAGS; ++k) ok = ok && v->tags[k].id == (int)i + k;
+                    if (!ok) torn++;
+                }
+                if (i < last) backwards++;
+                last = i;
+                reads++;
+            } while (!done.load());
+        });
+    }
+    writer.join();
+    for (int r = 0; r < 3; ++r) readers[r].join();
+
+    ASSERT_NEAR(torn.load(), 0, 0.0);
+    ASSERT_NEAR(backwards.load(), 0, 0.0);
+    ASSERT_TRUE(reads.load() > 0);
+}
+
+// ============================================================================
+//  视觉流水线（Vision Pipeline）测试（1 个）
+// ============================================================================
+
+// 拍照比估算快：估算只处理最新的一帧，中间的记为过期；同一帧不算两遍；太老的帧不算
+TEST(VisionPipeline_EstimatesNewestFrameAndCountsDrops) {
+    reset_all_mocks();
+    set_pose({ 1.0, 1.22, M_PI });
+    mock_tag_count = 1;
+    mock_tags[0] = { 1, 160.0, 120.0, 28.0, 28.0, 0.0, true };
+    vision_localizer_update();                               // 先追上最新的帧
+    VisionPipelineStats before = vision_localizer_stats();
+
+    for (int i = 0; i < 3; ++i) {                            // 拍了 3 帧才轮到估算
+        wait_ms(VISION_CAPTURE_INTERVAL_MS);
+        odometry_update(VISION_CAPTURE_INTERVAL_MS / 1000.0);   // 让位姿历史覆盖拍摄时刻
+        vision_snapshot();
+    }
+    VisionEstimate est = vision_localizer_estimate_latest();
+    ASSERT_TRUE(est.valid);
+    ASSERT_TRUE(est.capture_time_us == get_time_us());      // 用的是最新那一帧
+    ASSERT_TRUE(!vision_localizer_estimate_latest().valid); // 没有新帧：不重复计算
+
+    mock_capture_age_us = (uint64_t)(VISION_MAX_FRAME_AGE_MS + 1) * 1000;
+    ASSERT_TRUE(!vision_localizer_update().valid);          // 帧太老：不算
+
+    VisionPipelineStats after = vision_localizer_stats();
+    ASSERT_NEAR(after.captured - before.captured, 4, 0.0);
+    ASSERT_NEAR(after.processed - before.processed, 1, 0.0);
+    ASSERT_NEAR(after.stale - before.stale, 3, 0.0);        // 顶掉 2 帧 + 太老 1 帧
+    ASSERT_TRUE(after.age_us.count() > before.age_us.count());
+}
+
+// ============================================================================
+//  主函数：运行所有 84 个测试
 // ============================================================================
 
 int main() {
@@ -634,6 +2587,131 @@ int main() {
     RUN_TEST(Odometry_MultipleUpdatesAccumulate);
     RUN_TEST(Odometry_LateralSlide);
 
+    // ── 异步日志测试 ──
+    printf("\n[Async Log]\n");
+    RUN_TEST(RingBuffer_FifoOrder);
+    RUN_TEST(RingBuffer_RejectsWhenFull);
+    RUN_TEST(HalLog_DropsWhenFullAndCounts);
+    RUN_TEST(HalLog_FiltersLevelAndTruncates);
+    RUN_TEST(HalLog_PrintfMacrosFormatAndFilter);
+    RUN_TEST(HalLog_HotLoopsDoNotAllocate);
+
+    // ── 二进制日志测试 ──
+    printf("\n[Binary Odom Log]\n");
+    RUN_TEST(OdomRecord_EncodeDecodeRoundTrip);
+    RUN_TEST(OdomRecord_LittleEndianLayout);
+    RUN_TEST(OdomRecord_HeaderValidation);
+    RUN_TEST(BlockStream_SpansBlocksAndDropsWhenFull);
+
+    // ── 黑匣子测试 ──
+    printf("\n[Flight Recorder]\n");
+    RUN_TEST(FlightRecorder_KeepsLastSamplesInOrder);
+    RUN_TEST(FlightRecorder_TriggerWaitsAndCoolsDown);
+    RUN_TEST(FlightRecorder_DumpUsesOdomLogFormat);
+
+    // ── 循环计时测试 ──
+    printf("\n[Loop Stats]\n");
+    RUN_TEST(LogHistogram_BucketsAndPercentiles);
+    RUN_TEST(LoopStats_MeasuresExecAndWakeLatency);
+    RUN_TEST(LoopStats_RegistryFindAndFormat);
+
+    // ── 时间线测试 ──
+    printf("\n[Trace]\n");
+    RUN_TEST(TraceEvent_EncodeDecodeAndHeader);
+    RUN_TEST(Trace_CaptureRecordsScopesAndStopsWhenFull);
+    RUN_TEST(Trace_HostSimulationExportsChromeJson);
+
+    // ── 屏幕缓存测试 ──
+    printf("\n[Screen Cache]\n");
+    RUN_TEST(ScreenCache_UnchangedRowsAreNotRedrawn);
+    RUN_TEST(ScreenCache_RedrawsOnlyChangedTail);
+    RUN_TEST(ScreenCache_TruncatesAndIgnoresBadRows);
+
+    // ── 串口遥测测试 ──
+    printf("\n[Serial Telemetry]\n");
+    RUN_TEST(SerialFrame_CrcAndCobsRoundTrip);
+    RUN_TEST(SerialFrame_DecoderResyncsAfterCorruption);
+    RUN_TEST(SerialTelemetry_RateLimitsPerChannel);
+    RUN_TEST(TelemetryRx_ReadsFramesThroughPty);
+
+    // ── 运动命令摘要测试 ──
+    printf("\n[Motion Summary]\n");
+    RUN_TEST(RunningStats_MatchesTwoPassResult);
+    RUN_TEST(MotionSummary_CountsToleranceEntriesAndSettleTime);
+    RUN_TEST(MotionSummary_EmitsOneLogLinePerCommand);
+
+    // ── 差分日志测试 ──
+    printf("\n[Channel Log]\n");
+    RUN_TEST(ChannelLog_VarintAndSchemaRoundTrip);
+    RUN_TEST(ChannelLog_OdomFramesRoundTripAndShrink);
+    RUN_TEST(ChannelLog_RateDividerAndTruncatedFrame);
+    RUN_TEST(ChannelLog_IntChannelIsExact);
+
+    // ── 周期定时器测试 ──
+    printf("\n[Periodic Timer]\n");
+    RUN_TEST(PeriodicTimer_WakesOnAbsoluteDeadlines);
+    RUN_TEST(PeriodicTimer_CountsOverrunsAndResyncs);
+
+    // ── 位姿发布测试 ──
+    printf("\n[Pose Publication]\n");
+    RUN_TEST(SeqLock_ThreadedReadersNeverSeeTornSnapshots);
+    RUN_TEST(Odometry_PublishesSnapshotWithSeqAndTime);
+
+    // ── 位姿历史测试 ──
+    printf("\n[Pose History]\n");
+    RUN_TEST(PoseHistory_InterpolatesAndWrapsAround);
+    RUN_TEST(PoseHistory_CorrectAtReplaysLaterDeltas);
+    RUN_TEST(Odometry_CorrectAtPastTimeUpdatesCurrentPose);
+
+    // ── 卡尔曼滤波测试 ──
+    printf("\n[Pose EKF]\n");
+    RUN_TEST(Matrix_MultiplyTransposeInvert);
+    RUN_TEST(PoseEkf_PredictGrowsAndTagsCorrectHeading);
+    RUN_TEST(PoseEkf_GateRejectsOutlier);
+    RUN_TEST(PoseEkf_RecoversAfterShove);
+
+    // ── 粒子滤波测试 ──
+    printf("\n[Particle Filter]\n");
+    RUN_TEST(ParticleFilter_PredictMovesAndSpreadsCloud);
+    RUN_TEST(ParticleFilter_TagsPullCloudToTruth);
+    RUN_TEST(ParticleFilter_RecoversAfterShove);
+
+    // ── 速度估计测试 ──
+    printf("\n[Twist]\n");
+    RUN_TEST(TwistEstimator_FiltersVelocityAndAccel);
+    RUN_TEST(Odometry_PublishesVelocityInSnapshot);
+
+    // ── 航向融合测试 ──
+    printf("\n[Heading Fusion]\n");
+    RUN_TEST(HeadingFusion_WheelsCancelImuDrift);
+    RUN_TEST(Odometry_ImuDropoutBridgesWithWheels);
+
+    // ── 陀螺仪零漂测试 ──
+    printf("\n[Gyro Bias]\n");
+    RUN_TEST(GyroBias_LearnsOnlyWhileStationary);
+    RUN_TEST(Odometry_StationaryBiasStopsHeadingDrift);
+
+    printf("\n[Odometry Integrator]\n");
+    RUN_TEST(PoseIntegrate_ArcExactOnCircle);
+
+    printf("\n[Sensor Frame]\n");
+    RUN_TEST(SensorFrame_OneReadPerSensorPerTick);
+
+    printf("\n[Multi-Tag]\n");
+    RUN_TEST(MultiTag_SolvesPoseAndRejectsDisagreement);
+
+    printf("\n[Vision Heading]\n");
+    RUN_TEST(VisionHeading_FromTagAspectWithBoundedCorrection);
+
+    printf("\n[Vision Latency]\n");
+    RUN_TEST(VisionLatency_EstimatesAtCaptureTimeAndCarriesForward);
+
+    printf("\n[Frame Buffer]\n");
+    RUN_TEST(FrameBuffer_ViewsStayIntactAndThreadedReadersNeverSeeTornFrames);
+
+    printf("\n[Vision Pipeline]\n");
+    RUN_TEST(VisionPipeline_EstimatesNewestFrameAndCountsDrops);
+
     // ── 汇总 ──
     printf("\n============================================\n");
     printf("  Results: %d passed, %d failed, %d total\n",
@@ -20,7 +20,12 @@ public:
 /// Minimal task stub
 class task {
 public:
+    static const int taskPrioritylow    = 1;
+    static const int taskPriorityNormal = 7;
+    static const int taskPriorityHigh   = 15;
+
     task(int (*)()) {}                   // launch callback (no-op)
+    task(int (*)(), int /*priority*/) {}
     void stop() {}
     static void sleep(int /*ms*/) {}
 };
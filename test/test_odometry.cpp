@@ -29,7 +29,7 @@ namespace test {
         mock_tracking_left  = 1.0;
         mock_tracking_right = 1.0;
         mock_imu_rotation   = 0.0;
-        odometry_update();
+        odometry_update(0.01);
         Pose pose1 = get_pose();
         assert_equal(pose1.x, 1.0, 0.02, "Odom should track straight distance in X");
         assert_equal(pose1.y, 0.0, 0.02, "Odom should not change Y when driving straight");
@@ -42,7 +42,7 @@ namespace test {
         mock_tracking_left  = -arc_len;
         mock_tracking_right =  arc_len;
         mock_imu_rotation   = turn_rad;
-        odometry_update();
+        odometry_update(0.01);
         Pose pose2 = get_pose();
         assert_equal(pose2.x, 0.0, 0.05, "Odom should not change X on point turn");
         assert_equal(pose2.y, 0.0, 0.05, "Odom should not change Y on point turn");
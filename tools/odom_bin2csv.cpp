@@ -0,0 +1,172 @@
+// ============================================================================
+//  tools/odom_bin2csv.cpp — 电脑端工具：把二进制里程计日志转成 CSV
+// ============================================================================
+//
+//  【用法】
+//    make tools
+//    ./build/odom_bin2csv odom_000.bin > odom.csv
+//    ./build/odom_bin2csv odom_000.bin odom.csv
+//
+//  【做了什么？】
+//    1. 读文件头，检查魔数和版本号
+//    2. v1（黑匣子）：按文件头里写的"记录长度"逐条读取
+//       （新版本记录变长也能读前面的字段）
+//    3. v2（连续日志）：读文件头后面的通道表（schema），按表逐帧差分解码。
+//       CSV 的列名、小数位数全部来自通道表，机器人端加了通道这里不用改
+//    4. 每条记录输出一行 CSV
+//    文件末尾不完整的半条记录（比如比赛中途断电）会被忽略并提示。
+//
+// ============================================================================
+#include "telemetry/channel_log.h"
+#include "telemetry/odom_record.h"
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ---- v1：固定长度记录 ----
+static int convert_fixed(FILE* in, FILE* out, uint16_t record_size) {
+    if (record_size < ODOM_RECORD_SIZE || record_size > 1024) {
+        fprintf(stderr, "unsupported record size %u\n", record_size);
+        return 1;
+    }
+    fprintf(out, "%s\n", ODOM_CSV_HEADER);
+    uint8_t buf[1024];
+    char line[256];
+    unsigned long count = 0;
+    size_t got;
+    while ((got = fread(buf, 1, record_size, in)) == record_size) {
+        OdomRecord rec;
+        odom_record_decode(buf, &rec);
+        odom_record_to_csv(rec, line, sizeof(line));
+        fprintf(out, "%s\n", line);
+        count++;
+    }
+    if (got != 0) {
+        fprintf(stderr, "warning: ignored %zu trailing byte(s) (truncated record)\n", got);
+    }
+    fprintf(stderr, "%lu record(s), format v1\n", count);
+    return 0;
+}
+
+// ---- v2：通道表 + 差分编码帧 ----
+static int convert_delta(FILE* in, FILE* out, uint16_t schema_len) {
+    // 日志文件不大（100 Hz × 2 分钟 ≈ 200 KB），整个读进内存再解码
+    uint8_t* data = nullptr;
+    size_t size = 0, cap = 0;
+    while (true) {
+        if (size == cap) {
+            cap = cap ? cap * 2 : 65536;
+            uint8_t* grown = (uint8_t*)realloc(data, cap);
+            if (grown == nullptr) {
+                fprintf(stderr, "out of memory reading log (%zu bytes)\n", cap);
+                free(data);
+                return 1;
+            }
+            data = grown;
+        }
+        size_t got = fread(data + size, 1, cap - size, in);
+        if (got == 0) break;
+        size += got;
+    }
+
+    ChannelInfo channels[CHANNEL_MAX];
+    int count = (schema_len <= size)
+                    ? channel_schema_decode(data, schema_len, channels, CHANNEL_MAX) : -1;
+    if (count < 0) {
+        fprintf(stderr, "bad channel schema\n");
+        free(data);
+        return 1;
+    }
+
+    // 表头和每列的小数位数都由通道表决定（分辨率 0.001 → 3 位小数，整数通道不带小数）
+    int decimals[CHANNEL_MAX];
+    fprintf(out, "time_ms");
+    for (int i = 0; i < count; ++i) {
+        fprintf(out, ",%s", channels[i].name);
+        int d = (int)ceil(-log10(channels[i].quantum) - 1e-6);
+        decimals[i] = channels[i].type == CHANNEL_I32 ? 0 : (d < 0 ? 0 : (d > 9 ? 9 : d));
+    }
+    fprintf(out, "\n");
+
+    ChannelFrameDecoder decoder(channels, count);
+    double values[CHANNEL_MAX];
+    unsigned long frames = 0, skipped = 0;
+    size_t pos = schema_len;
+    while (pos < size) {
+        uint32_t time_ms;
+        int n = decoder.decode(data + pos, (int)(size - pos), &time_ms, values);
+        if (n == 0) {
+            fprintf(stderr, "warning: ignored %zu trailing byte(s) (truncated frame)\n", size - pos);
+            break;
+        }
+        if (n < 0) {
+            fprintf(stderr, "error: corrupt frame at byte %zu\n", pos + ODOM_LOG_HEADER_SIZE);
+            break;
+        }
+        pos += n;
+        if (!decoder.synced()) {
+            skipped++;
+            continue;
+        }
+        fprintf(out, "%lu", (unsigned long)time_ms);
+        for (int i = 0; i < count; ++i) fprintf(out, ",%.*f", decimals[i], values[i]);
+        fprintf(out, "\n");
+        frames++;
+    }
+
+    fprintf(stderr, "%lu frame(s), format v2, %d channel(s):", frames, count);
+    for (int i = 0; i < count; ++i) fprintf(stderr, " %s[%s]", channels[i].name, channels[i].unit);
+    fprintf(stderr, "\n");
+    if (skipped > 0) fprintf(stderr, "warning: %lu frame(s) before the first keyframe\n", skipped);
+    free(data);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <odom_NNN.bin> [out.csv]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (in == nullptr) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    FILE* out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (out == nullptr) {
+            fprintf(stderr, "cannot create %s\n", argv[2]);
+            fclose(in);
+            return 1;
+        }
+    }
+
+    // ---- 文件头 ----
+    uint8_t header[ODOM_LOG_HEADER_SIZE];
+    uint16_t version = 0, size = 0;
+    if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+        !odom_log_decode_header(header, &version, &size)) {
+        fprintf(stderr, "%s: not an odometry log (bad header)\n", argv[1]);
+        fclose(in);
+        if (out != stdout) fclose(out);
+        return 1;
+    }
+
+    int rc;
+    if (version == ODOM_LOG_VERSION_DELTA) {
+        rc = convert_delta(in, out, size);
+    } else {
+        if (version > ODOM_LOG_VERSION_DELTA) {
+            fprintf(stderr, "warning: log version %u is newer than this tool (%u), "
+                            "decoding as fixed-size records\n", version, ODOM_LOG_VERSION_DELTA);
+        }
+        rc = convert_fixed(in, out, size);
+    }
+
+    fclose(in);
+    if (out != stdout) fclose(out);
+    return rc;
+}
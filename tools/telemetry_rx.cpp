@@ -0,0 +1,88 @@
+// ============================================================================
+//  tools/telemetry_rx.cpp — 电脑端串口遥测接收器的实现
+// ============================================================================
+#include "telemetry_rx.h"
+#include "telemetry/odom_record.h"
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+int telemetry_rx_open(const char* path) {
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) return -1;
+
+    if (isatty(fd)) {
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            cfsetispeed(&tio, B115200);  // USB CDC 其实不看波特率，真串口才需要
+            tio.c_cc[VMIN]  = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+    return fd;
+}
+
+TelemetryReceiver::TelemetryReceiver(FILE* csv_out)
+    : _csv(csv_out), _header_written(false) {
+    memset(&_stats, 0, sizeof(_stats));
+    memset(&_last_printed, 0, sizeof(_last_printed));
+    memset(_seen, 0, sizeof(_seen));
+    memset(_last_seq, 0, sizeof(_last_seq));
+    memset(&_last_loop, 0, sizeof(_last_loop));
+}
+
+void TelemetryReceiver::feed(const uint8_t* data, int len) {
+    for (int i = 0; i < len; ++i) {
+        SerialFrameDecoder::Result r = _decoder.feed(data[i]);
+        if (r == SerialFrameDecoder::FRAME) {
+            handle_frame();
+        } else if (r == SerialFrameDecoder::BAD_FRAME) {
+            _stats.bad_frames++;
+        }
+    }
+}
+
+void TelemetryReceiver::handle_frame() {
+    uint8_t ch = _decoder.channel();
+    if (ch == 0 || ch >= TELEM_CH_COUNT) {
+        _stats.unknown_channel++;
+        return;
+    }
+
+    // 序号跳了几个 = 中间丢了几帧（8 位序号，自动回绕）
+    uint8_t seq = _decoder.seq();
+    if (_seen[ch]) _stats.lost[ch] += (uint8_t)(seq - _last_seq[ch] - 1);
+    _seen[ch]     = true;
+    _last_seq[ch] = seq;
+    _stats.frames[ch]++;
+
+    if (ch == TELEM_CH_ODOM && _decoder.payload_len() >= ODOM_RECORD_SIZE) {
+        if (_csv == nullptr) return;
+        if (!_header_written) {
+            fprintf(_csv, "%s\n", ODOM_CSV_HEADER);
+            _header_written = true;
+        }
+        OdomRecord rec;
+        odom_record_decode(_decoder.payload(), &rec);
+        char line[256];
+        odom_record_to_csv(rec, line, sizeof(line));
+        fprintf(_csv, "%s\n", line);
+    } else if (ch == TELEM_CH_LOOP && _decoder.payload_len() >= TELEM_LOOP_SAMPLE_SIZE) {
+        telem_loop_decode(_decoder.payload(), &_last_loop);
+    }
+}
+
+void TelemetryReceiver::print_stats(FILE* out, double seconds) {
+    if (seconds <= 0) seconds = 1;
+    unsigned long odom = _stats.frames[TELEM_CH_ODOM] - _last_printed.frames[TELEM_CH_ODOM];
+    fprintf(out, "odom %.1f Hz (lost %lu) | odom loop exec p99 %lu max %lu us, "
+                 "late p99 %lu max %lu us | bad frames %lu\n",
+            odom / seconds, _stats.lost[TELEM_CH_ODOM],
+            (unsigned long)_last_loop.exec_p99_us, (unsigned long)_last_loop.exec_max_us,
+            (unsigned long)_last_loop.late_p99_us, (unsigned long)_last_loop.late_max_us,
+            _stats.bad_frames);
+    _last_printed = _stats;
+}
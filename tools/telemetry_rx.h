@@ -0,0 +1,54 @@
+#pragma once
+// ============================================================================
+//  tools/telemetry_rx.h — 电脑端串口遥测接收器（解帧 + 输出 CSV + 统计）
+// ============================================================================
+//
+//  接收逻辑和 main() 分开放，这样单元测试可以用伪终端（pty）
+//  假装成 Brain 的串口，把这里的代码完整跑一遍。
+//
+// ============================================================================
+#include "telemetry/serial_frame.h"
+#include <stdio.h>
+
+/// 打开串口设备（或伪终端、普通文件），是终端就设置成原始模式（raw）
+/// 原始模式：不做换行转换、不回显、不处理 Ctrl-C 之类的特殊字节——二进制数据必须这样
+/// @return 文件描述符；失败返回 -1
+int telemetry_rx_open(const char* path);
+
+/// 接收统计
+struct TelemetryRxStats {
+    unsigned long frames[TELEM_CH_COUNT];  ///< 每个通道收到的好帧数
+    unsigned long lost[TELEM_CH_COUNT];    ///< 从序号跳变推算出的丢帧数
+    unsigned long bad_frames;              ///< CRC 错误 / 格式错误的帧
+    unsigned long unknown_channel;         ///< 通道号不认识的帧
+};
+
+class TelemetryReceiver {
+public:
+    /// @param csv_out  里程计记录写成 CSV 的地方（nullptr = 不写）
+    explicit TelemetryReceiver(FILE* csv_out);
+
+    /// 处理一段收到的字节
+    void feed(const uint8_t* data, int len);
+
+    const TelemetryRxStats& stats() const { return _stats; }
+
+    /// 最近一次收到的循环计时
+    const TelemLoopSample& last_loop() const { return _last_loop; }
+
+    /// 打印一行统计（给 --stats 用）
+    /// @param seconds  距离上次打印过了多少秒（用来算频率）
+    void print_stats(FILE* out, double seconds);
+
+private:
+    void handle_frame();
+
+    SerialFrameDecoder _decoder;
+    FILE*              _csv;
+    bool               _header_written;
+    TelemetryRxStats   _stats;
+    TelemetryRxStats   _last_printed;
+    bool               _seen[TELEM_CH_COUNT];
+    uint8_t            _last_seq[TELEM_CH_COUNT];
+    TelemLoopSample    _last_loop;
+};
@@ -0,0 +1,88 @@
+// ============================================================================
+//  tools/telemetry_rx_main.cpp — 电脑端工具：接收机器人的 USB 串口遥测
+// ============================================================================
+//
+//  【用法】
+//    make tools
+//    ./build/telemetry_rx /dev/ttyACM1                 # CSV 输出到屏幕
+//    ./build/telemetry_rx /dev/ttyACM1 live.csv        # CSV 写进文件
+//    ./build/telemetry_rx /dev/ttyACM1 live.csv --stats  # 每秒在 stderr 打印频率和丢帧
+//    也可以读一个录下来的原始字节文件（比如 cat /dev/ttyACM1 > raw.bin）。
+//
+//  按 Ctrl-C 退出；设备断开（读到文件尾或出错）时也会退出。
+//
+// ============================================================================
+#include "telemetry_rx.h"
+#include <string.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static double now_sec() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    const char* device = nullptr;
+    const char* csv_path = nullptr;
+    bool show_stats = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stats") == 0) show_stats = true;
+        else if (device == nullptr) device = argv[i];
+        else if (csv_path == nullptr) csv_path = argv[i];
+    }
+    if (device == nullptr) {
+        fprintf(stderr, "usage: %s <serial device> [out.csv] [--stats]\n", argv[0]);
+        return 2;
+    }
+
+    int fd = telemetry_rx_open(device);
+    if (fd < 0) {
+        fprintf(stderr, "cannot open %s\n", device);
+        return 1;
+    }
+    FILE* csv = stdout;
+    if (csv_path != nullptr) {
+        csv = fopen(csv_path, "w");
+        if (csv == nullptr) {
+            fprintf(stderr, "cannot create %s\n", csv_path);
+            close(fd);
+            return 1;
+        }
+    }
+
+    TelemetryReceiver rx(csv);
+    double last_print = now_sec();
+    uint8_t buf[512];
+    while (true) {
+        // 最多等 200 ms，没数据也要按时打印统计
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        struct timeval timeout = { 0, 200000 };
+        int ready = select(fd + 1, &fds, nullptr, nullptr, &timeout);
+        if (ready > 0) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n <= 0) break;  // 文件读完 / 设备断开
+            rx.feed(buf, (int)n);
+            fflush(csv);
+        } else if (ready < 0) {
+            break;
+        }
+
+        double now = now_sec();
+        if (show_stats && now - last_print >= 1.0) {
+            rx.print_stats(stderr, now - last_print);
+            last_print = now;
+        }
+    }
+
+    const TelemetryRxStats& s = rx.stats();
+    fprintf(stderr, "%lu odom frame(s), %lu lost, %lu bad\n",
+            s.frames[TELEM_CH_ODOM], s.lost[TELEM_CH_ODOM], s.bad_frames);
+    close(fd);
+    if (csv != stdout) fclose(csv);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// ============================================================================
+//  tools/trace2json.cpp — 电脑端工具：把机器人上采集的时间线转成 Chrome trace JSON
+// ============================================================================
+//
+//  【用法】
+//    make tools
+//    ./build/trace2json trace_000.bin > trace.json
+//    ./build/trace2json trace_000.bin trace.json
+//    然后把 trace.json 拖进 https://ui.perfetto.dev 查看。
+//
+//  【做了什么？】
+//    1. 读文件头，检查魔数和事件长度
+//    2. 逐个读 12 字节的事件（文件被截断时只转换完整的部分）
+//    3. 写成 Chrome trace-event JSON（每个任务一行时间线）
+//
+// ============================================================================
+#include "telemetry/trace_event.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <trace_NNN.bin> [out.json]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (in == nullptr) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    // ---- 文件头 ----
+    uint8_t header[TRACE_FILE_HEADER_SIZE];
+    uint16_t version = 0;
+    uint32_t expected = 0;
+    if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+        !trace_file_decode_header(header, &version, &expected)) {
+        fprintf(stderr, "%s: not a trace capture (bad header)\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+
+    // ---- 事件 ----
+    if (expected > (1u << 24)) {
+        fprintf(stderr, "%s: implausible event count %lu\n", argv[1], (unsigned long)expected);
+        fclose(in);
+        return 1;
+    }
+    TraceEvent* events = (TraceEvent*)malloc(sizeof(TraceEvent) * (expected > 0 ? expected : 1));
+    if (events == nullptr) {
+        fprintf(stderr, "out of memory (%lu events)\n", (unsigned long)expected);
+        fclose(in);
+        return 1;
+    }
+    uint8_t bytes[TRACE_EVENT_SIZE];
+    uint32_t count = 0;
+    while (count < expected && fread(bytes, 1, TRACE_EVENT_SIZE, in) == (size_t)TRACE_EVENT_SIZE) {
+        trace_event_decode(bytes, &events[count]);
+        count++;
+    }
+    fclose(in);
+    if (count < expected) {
+        fprintf(stderr, "warning: file truncated, %lu of %lu event(s) read\n",
+                (unsigned long)count, (unsigned long)expected);
+    }
+
+    FILE* out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (out == nullptr) {
+            fprintf(stderr, "cannot create %s\n", argv[2]);
+            free(events);
+            return 1;
+        }
+    }
+    trace_write_chrome_json(out, events, (int)count);
+    fprintf(stderr, "%lu event(s), format v%u\n", (unsigned long)count, version);
+
+    if (out != stdout) fclose(out);
+    free(events);
+    return 0;
+}